@@ -125,6 +125,9 @@ bool ApiVulkanSample::resize(const uint32_t _width, const uint32_t _height)
 	// Ensure all operations on the device have been finished before destroying resources
 	device->wait_idle();
 
+	// The frames of the render context are not used, so the resources it retired are destroyed here
+	get_render_context().destroy_deferred_resources();
+
 	create_swapchain_buffers();
 
 	// Recreate the frame buffers
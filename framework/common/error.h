@@ -54,6 +54,15 @@
 		__pragma(warning(pop))
 #endif
 
+// [[nodiscard]] is a C++17 attribute, older standards get the compiler specific equivalent if there is one
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#	define VKBP_NODISCARD [[nodiscard]]
+#elif defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
+#	define VKBP_NODISCARD __attribute__((warn_unused_result))
+#else
+#	define VKBP_NODISCARD
+#endif
+
 namespace vkb
 {
 /**
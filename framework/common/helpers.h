@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
@@ -175,6 +176,30 @@ inline void hash_combine(size_t &seed, const T &v)
 	glm::detail::hash_combine(seed, hasher(v));
 }
 
+/**
+ * @brief Mixes the bits of a 64-bit value, with the finalizer of MurmurHash3
+ */
+inline uint64_t hash_mix(uint64_t value)
+{
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdULL;
+	value ^= value >> 33;
+	value *= 0xc4ceb9fe1a85ec53ULL;
+	value ^= value >> 33;
+
+	return value;
+}
+
+/**
+ * @brief Helper function to combine a given 64-bit hash with a 64-bit value.
+ *        Unlike hash_combine, every bit of the value affects every bit of the result,
+ *        where std::hash is the identity for integers in the common standard libraries.
+ */
+inline void hash_combine_64(uint64_t &seed, uint64_t value)
+{
+	seed = hash_mix(seed + 0x9e3779b97f4a7c15ULL + hash_mix(value));
+}
+
 /**
  * @brief Helper function to convert a data type
  *        to string using output stream operator.
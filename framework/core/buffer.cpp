@@ -35,6 +35,14 @@ Buffer::Buffer(Device const &device, VkDeviceSize size, VkBufferUsageFlags buffe
 
 	persistent = (flags & VMA_ALLOCATION_CREATE_MAPPED_BIT) != 0;
 
+	// Descriptor buffers reference the buffers they describe by device address
+	if (device.uses_descriptor_buffers() &&
+	    (buffer_usage & (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+	                     VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT)))
+	{
+		buffer_usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+	}
+
 	VkBufferCreateInfo buffer_info{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
 	buffer_info.usage = buffer_usage;
 	buffer_info.size  = size;
@@ -137,12 +145,17 @@ void Buffer::flush() const
 	vmaFlushAllocation(device->get_memory_allocator(), allocation, 0, size);
 }
 
+void Buffer::invalidate() const
+{
+	vmaInvalidateAllocation(device->get_memory_allocator(), allocation, 0, size);
+}
+
 void Buffer::update(const std::vector<uint8_t> &data, size_t offset)
 {
 	update(data.data(), data.size(), offset);
 }
 
-uint64_t Buffer::get_device_address()
+uint64_t Buffer::get_device_address() const
 {
 	VkBufferDeviceAddressInfoKHR buffer_device_address_info{};
 	buffer_device_address_info.sType  = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
@@ -93,6 +93,11 @@ class Buffer : public VulkanResource<VkBuffer, VK_OBJECT_TYPE_BUFFER, const Devi
 	 */
 	void flush() const;
 
+	/**
+	 * @brief Invalidates memory if it is HOST_VISIBLE and not HOST_COHERENT, so that device writes are visible to the host
+	 */
+	void invalidate() const;
+
 	/**
 	 * @brief Maps vulkan memory if it isn't already mapped to an host visible address
 	 * @return Pointer to host visible memory
@@ -151,7 +156,7 @@ class Buffer : public VulkanResource<VkBuffer, VK_OBJECT_TYPE_BUFFER, const Devi
 	/**
 	 * @return Return the buffer's device address (note: requires that the buffer has been created with the VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT usage fla)
 	 */
-	uint64_t get_device_address();
+	uint64_t get_device_address() const;
 
   private:
 	VmaAllocation allocation{VK_NULL_HANDLE};
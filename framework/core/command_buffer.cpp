@@ -17,6 +17,9 @@
 
 #include "command_buffer.h"
 
+#include <algorithm>
+#include <tuple>
+
 #include "command_pool.h"
 #include "common/error.h"
 #include "device.h"
@@ -29,6 +32,118 @@ VKBP_ENABLE_WARNINGS()
 
 namespace vkb
 {
+namespace
+{
+std::vector<SubpassInfo> get_subpass_infos(const std::vector<Subpass *> &subpasses)
+{
+	std::vector<SubpassInfo> subpass_infos(subpasses.size());
+	auto                     subpass_info_it = subpass_infos.begin();
+	for (auto &subpass : subpasses)
+	{
+		subpass_info_it->input_attachments                = subpass->get_input_attachments();
+		subpass_info_it->output_attachments               = subpass->get_output_attachments();
+		subpass_info_it->color_resolve_attachments        = subpass->get_color_resolve_attachments();
+		subpass_info_it->disable_depth_stencil_attachment = subpass->get_disable_depth_stencil_attachment();
+		subpass_info_it->depth_stencil_resolve_mode       = subpass->get_depth_stencil_resolve_mode();
+		subpass_info_it->depth_stencil_resolve_attachment = subpass->get_depth_stencil_resolve_attachment();
+		subpass_info_it->debug_name                       = subpass->get_debug_name();
+
+		++subpass_info_it;
+	}
+
+	return subpass_infos;
+}
+
+/**
+ * @brief Attachments of the dynamic rendering scope of a subpass, chosen as RenderPass references them
+ */
+struct ScopeAttachments
+{
+	std::vector<uint32_t> colors;
+
+	/// Resolve attachment of each color attachment, if any
+	std::vector<uint32_t> color_resolves;
+
+	uint32_t depth_stencil{VK_ATTACHMENT_UNUSED};
+
+	uint32_t depth_stencil_resolve{VK_ATTACHMENT_UNUSED};
+
+	std::vector<uint32_t> get_all() const
+	{
+		std::vector<uint32_t> all{colors};
+		all.insert(all.end(), color_resolves.begin(), color_resolves.end());
+
+		for (uint32_t attachment : {depth_stencil, depth_stencil_resolve})
+		{
+			if (attachment != VK_ATTACHMENT_UNUSED)
+			{
+				all.push_back(attachment);
+			}
+		}
+
+		return all;
+	}
+
+	bool uses(uint32_t attachment) const
+	{
+		auto all = get_all();
+		return std::find(all.begin(), all.end(), attachment) != all.end();
+	}
+};
+
+ScopeAttachments get_scope_attachments(const SubpassInfo &subpass, const std::vector<Attachment> &attachments)
+{
+	ScopeAttachments scope;
+
+	for (uint32_t output : subpass.output_attachments)
+	{
+		if (!is_depth_format(attachments[output].format))
+		{
+			scope.colors.push_back(output);
+		}
+	}
+
+	scope.color_resolves = subpass.color_resolve_attachments;
+
+	if (!subpass.disable_depth_stencil_attachment)
+	{
+		auto it = std::find_if(attachments.begin(), attachments.end(), [](const Attachment &attachment) { return is_depth_format(attachment.format); });
+		if (it != attachments.end())
+		{
+			scope.depth_stencil = to_u32(std::distance(attachments.begin(), it));
+
+			if (subpass.depth_stencil_resolve_mode != VK_RESOLVE_MODE_NONE)
+			{
+				scope.depth_stencil_resolve = subpass.depth_stencil_resolve_attachment;
+			}
+		}
+	}
+
+	return scope;
+}
+
+bool supports_dynamic_rendering(const RenderTarget &render_target, const std::vector<SubpassInfo> &subpasses)
+{
+	// Dynamic rendering scopes cannot read input attachments
+	for (auto &subpass : subpasses)
+	{
+		if (!subpass.input_attachments.empty())
+		{
+			return false;
+		}
+	}
+
+	// Transient attachments would be stored by a scope and loaded by the next one
+	if (subpasses.size() > 1)
+	{
+		const auto &attachments = render_target.get_attachments();
+		return std::none_of(attachments.begin(), attachments.end(), [](const Attachment &attachment) { return attachment.transient; });
+	}
+
+	return true;
+}
+}        // namespace
+
 CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel level) :
     VulkanResource{VK_NULL_HANDLE, &command_pool.get_device()},
     command_pool{command_pool},
@@ -63,6 +178,7 @@ CommandBuffer::CommandBuffer(CommandBuffer &&other) :
     level(other.level),
     command_pool(other.command_pool),
     current_render_pass(std::exchange(other.current_render_pass, {})),
+    dynamic_rendering(std::exchange(other.dynamic_rendering, {})),
     pipeline_state(std::exchange(other.pipeline_state, {})),
     resource_binding_state(std::exchange(other.resource_binding_state, {})),
     stored_push_constants(std::exchange(other.stored_push_constants, {})),
@@ -70,7 +186,16 @@ CommandBuffer::CommandBuffer(CommandBuffer &&other) :
     last_framebuffer_extent(std::exchange(other.last_framebuffer_extent, {})),
     last_render_area_extent(std::exchange(other.last_render_area_extent, {})),
     update_after_bind(std::exchange(other.update_after_bind, {})),
-    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {}))
+    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {})),
+    bound_descriptor_buffer(std::exchange(other.bound_descriptor_buffer, {})),
+    external_descriptor_sets(std::exchange(other.external_descriptor_sets, {})),
+    dirty_external_descriptor_sets(std::exchange(other.dirty_external_descriptor_sets, {})),
+    external_descriptor_set_pipeline_layout(std::exchange(other.external_descriptor_set_pipeline_layout, {})),
+    recorded_rasterization_state(std::exchange(other.recorded_rasterization_state, {})),
+    recorded_input_assembly_state(std::exchange(other.recorded_input_assembly_state, {})),
+    recorded_depth_stencil_state(std::exchange(other.recorded_depth_stencil_state, {})),
+    recorded_color_blend_attachments(std::exchange(other.recorded_color_blend_attachments, {})),
+    extended_dynamic_state_recorded(std::exchange(other.extended_dynamic_state_recorded, {}))
 {}
 
 void CommandBuffer::clear(VkClearAttachment attachment, VkClearRect rect)
@@ -85,9 +210,16 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, CommandBuffer *pr
 		assert(primary_cmd_buf && "A primary command buffer pointer must be provided when calling begin from a secondary one");
 		auto render_pass_binding = primary_cmd_buf->get_current_render_pass();
 
+		// Secondary command buffers continuing a dynamic rendering scope are begun with the formats of its attachments
+		dynamic_rendering                 = {};
+		dynamic_rendering.rendering_state = primary_cmd_buf->dynamic_rendering.rendering_state;
+		dynamic_rendering.samples         = primary_cmd_buf->dynamic_rendering.samples;
+
 		return begin(flags, render_pass_binding.render_pass, render_pass_binding.framebuffer, primary_cmd_buf->get_current_subpass_index());
 	}
 
+	dynamic_rendering = {};
+
 	return begin(flags, nullptr, nullptr, 0);
 }
 
@@ -96,23 +228,48 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 	// Reset state
 	pipeline_state.reset();
 	resource_binding_state.reset();
-	descriptor_set_layout_binding_state.clear();
+	descriptor_set_layout_binding_state.fill(nullptr);
 	stored_push_constants.clear();
+	bound_descriptor_buffer = VK_NULL_HANDLE;
+	external_descriptor_sets.fill(VK_NULL_HANDLE);
+	dirty_external_descriptor_sets          = 0;
+	external_descriptor_set_pipeline_layout = VK_NULL_HANDLE;
+	extended_dynamic_state_recorded         = false;
+	recorded_draw_count                     = 0;
+
+	pipeline_state.set_extended_dynamic_state(get_device().get_extended_dynamic_state());
 
-	VkCommandBufferBeginInfo       begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-	VkCommandBufferInheritanceInfo inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
-	begin_info.flags                           = flags;
+	VkCommandBufferBeginInfo                   begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	VkCommandBufferInheritanceInfo             inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+	VkCommandBufferInheritanceRenderingInfoKHR inheritance_rendering{VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR};
+	begin_info.flags                                       = flags;
 
 	if (level == VK_COMMAND_BUFFER_LEVEL_SECONDARY)
 	{
-		assert((render_pass && framebuffer) && "Render pass and framebuffer must be provided when calling begin from a secondary one");
+		assert(((render_pass && framebuffer) || (!render_pass && get_device().uses_dynamic_rendering())) &&
+		       "Render pass and framebuffer must be provided when calling begin from a secondary one, unless it continues a dynamic rendering scope");
 
 		current_render_pass.render_pass = render_pass;
 		current_render_pass.framebuffer = framebuffer;
 
-		inheritance.renderPass  = current_render_pass.render_pass->get_handle();
-		inheritance.framebuffer = current_render_pass.framebuffer->get_handle();
-		inheritance.subpass     = subpass_index;
+		if (render_pass)
+		{
+			inheritance.renderPass  = current_render_pass.render_pass->get_handle();
+			inheritance.framebuffer = current_render_pass.framebuffer->get_handle();
+			inheritance.subpass     = subpass_index;
+		}
+		else
+		{
+			const auto &rendering_state = dynamic_rendering.rendering_state;
+
+			inheritance_rendering.colorAttachmentCount    = to_u32(rendering_state.color_attachment_formats.size());
+			inheritance_rendering.pColorAttachmentFormats = rendering_state.color_attachment_formats.data();
+			inheritance_rendering.depthAttachmentFormat   = rendering_state.depth_attachment_format;
+			inheritance_rendering.stencilAttachmentFormat = rendering_state.stencil_attachment_format;
+			inheritance_rendering.rasterizationSamples    = dynamic_rendering.samples;
+
+			inheritance.pNext = &inheritance_rendering;
+		}
 
 		begin_info.pInheritanceInfo = &inheritance;
 	}
@@ -134,14 +291,48 @@ void CommandBuffer::flush(VkPipelineBindPoint pipeline_bind_point)
 	flush_push_constants();
 
 	flush_descriptor_state(pipeline_bind_point);
+
+	if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+	{
+		flush_extended_dynamic_state();
+	}
 }
 
 void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values, const std::vector<std::unique_ptr<Subpass>> &subpasses, VkSubpassContents contents)
+{
+	std::vector<Subpass *> subpass_ptrs(subpasses.size());
+	std::transform(subpasses.begin(), subpasses.end(), subpass_ptrs.begin(), [](const std::unique_ptr<Subpass> &subpass) { return subpass.get(); });
+
+	begin_render_pass(render_target, load_store_infos, clear_values, subpass_ptrs, contents);
+}
+
+void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values, const std::vector<Subpass *> &subpasses, VkSubpassContents contents)
 {
 	// Reset state
 	pipeline_state.reset();
 	resource_binding_state.reset();
-	descriptor_set_layout_binding_state.clear();
+	descriptor_set_layout_binding_state.fill(nullptr);
+
+	if (get_device().uses_dynamic_rendering())
+	{
+		auto subpass_infos = get_subpass_infos(subpasses);
+
+		if (supports_dynamic_rendering(render_target, subpass_infos))
+		{
+			current_render_pass = {};
+
+			dynamic_rendering.render_target    = &render_target;
+			dynamic_rendering.load_store_infos = load_store_infos;
+			dynamic_rendering.clear_values     = clear_values;
+			dynamic_rendering.subpasses        = std::move(subpass_infos);
+			dynamic_rendering.contents         = contents;
+			dynamic_rendering.subpass_index    = 0;
+
+			begin_rendering_scope();
+
+			return;
+		}
+	}
 
 	auto &render_pass = get_render_pass(render_target, load_store_infos, subpasses);
 	auto &framebuffer = get_device().get_resource_cache().request_framebuffer(render_target, render_pass);
@@ -151,6 +342,8 @@ void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const s
 
 void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const RenderPass &render_pass, const Framebuffer &framebuffer, const std::vector<VkClearValue> &clear_values, VkSubpassContents contents)
 {
+	dynamic_rendering = {};
+
 	current_render_pass.render_pass = &render_pass;
 	current_render_pass.framebuffer = &framebuffer;
 
@@ -188,27 +381,220 @@ void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const R
 
 void CommandBuffer::next_subpass()
 {
-	// Increment subpass index
-	pipeline_state.set_subpass_index(pipeline_state.get_subpass_index() + 1);
+	if (dynamic_rendering.render_target)
+	{
+		// Each subpass is recorded as its own dynamic rendering scope
+		vkCmdEndRenderingKHR(get_handle());
 
-	// Update blend state attachments
-	auto blend_state = pipeline_state.get_color_blend_state();
-	blend_state.attachments.resize(current_render_pass.render_pass->get_color_output_count(pipeline_state.get_subpass_index()));
-	pipeline_state.set_color_blend_state(blend_state);
+		dynamic_rendering.subpass_index++;
+	}
+	else
+	{
+		// Increment subpass index
+		pipeline_state.set_subpass_index(pipeline_state.get_subpass_index() + 1);
+
+		// Update blend state attachments
+		auto blend_state = pipeline_state.get_color_blend_state();
+		blend_state.attachments.resize(current_render_pass.render_pass->get_color_output_count(pipeline_state.get_subpass_index()));
+		pipeline_state.set_color_blend_state(blend_state);
+	}
 
 	// Reset descriptor sets
 	resource_binding_state.reset();
-	descriptor_set_layout_binding_state.clear();
+	descriptor_set_layout_binding_state.fill(nullptr);
 
 	// Clear stored push constants
 	stored_push_constants.clear();
 
-	vkCmdNextSubpass(get_handle(), VK_SUBPASS_CONTENTS_INLINE);
+	if (dynamic_rendering.render_target)
+	{
+		begin_rendering_scope();
+	}
+	else
+	{
+		vkCmdNextSubpass(get_handle(), VK_SUBPASS_CONTENTS_INLINE);
+	}
+}
+
+void CommandBuffer::begin_rendering_scope()
+{
+	const auto &render_target = *dynamic_rendering.render_target;
+	const auto &attachments   = render_target.get_attachments();
+	const auto &views         = render_target.get_views();
+	const auto  subpass_index = dynamic_rendering.subpass_index;
+
+	std::vector<ScopeAttachments> scopes;
+	for (auto &subpass : dynamic_rendering.subpasses)
+	{
+		scopes.push_back(get_scope_attachments(subpass, attachments));
+	}
+
+	const auto &scope = scopes[subpass_index];
+
+	auto used_in_scopes = [&scopes](uint32_t attachment, size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i)
+		{
+			if (scopes[i].uses(attachment))
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	// Attachments are rendered to in the layouts the render pass of the subpasses would reference them with
+	auto get_layout = [&attachments](uint32_t attachment) {
+		if (attachments[attachment].initial_layout != VK_IMAGE_LAYOUT_UNDEFINED)
+		{
+			return attachments[attachment].initial_layout;
+		}
+
+		return is_depth_format(attachments[attachment].format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	};
+
+	// Make the writes of the previous scopes visible to this one
+	if (subpass_index > 0)
+	{
+		for (uint32_t attachment : scope.get_all())
+		{
+			if (!used_in_scopes(attachment, 0, subpass_index))
+			{
+				continue;
+			}
+
+			ImageMemoryBarrier barrier{};
+			barrier.old_layout = get_layout(attachment);
+			barrier.new_layout = barrier.old_layout;
+
+			if (is_depth_format(attachments[attachment].format))
+			{
+				barrier.src_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+				barrier.dst_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+				barrier.src_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+				barrier.dst_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			}
+			else
+			{
+				barrier.src_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+				barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+				barrier.src_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+				barrier.dst_access_mask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			}
+
+			image_memory_barrier(views[attachment], barrier);
+		}
+	}
+
+	// The first scope rendering to an attachment loads it as the render pass would, and the last one stores it
+	auto get_attachment_info = [&](uint32_t attachment) {
+		LoadStoreInfo load_store{VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE};
+		if (attachment < dynamic_rendering.load_store_infos.size())
+		{
+			load_store = dynamic_rendering.load_store_infos[attachment];
+		}
+
+		VkRenderingAttachmentInfoKHR attachment_info{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR};
+		attachment_info.imageView   = views[attachment].get_handle();
+		attachment_info.imageLayout = get_layout(attachment);
+		attachment_info.loadOp      = used_in_scopes(attachment, 0, subpass_index) ? VK_ATTACHMENT_LOAD_OP_LOAD : load_store.load_op;
+		attachment_info.storeOp     = used_in_scopes(attachment, subpass_index + 1, scopes.size()) ? VK_ATTACHMENT_STORE_OP_STORE : load_store.store_op;
+
+		if (attachment < dynamic_rendering.clear_values.size())
+		{
+			attachment_info.clearValue = dynamic_rendering.clear_values[attachment];
+		}
+
+		return attachment_info;
+	};
+
+	RenderingState rendering_state;
+
+	std::vector<VkRenderingAttachmentInfoKHR> color_attachments;
+
+	for (size_t k = 0; k < scope.colors.size(); ++k)
+	{
+		auto attachment_info = get_attachment_info(scope.colors[k]);
+
+		if (k < scope.color_resolves.size())
+		{
+			attachment_info.resolveMode        = VK_RESOLVE_MODE_AVERAGE_BIT_KHR;
+			attachment_info.resolveImageView   = views[scope.color_resolves[k]].get_handle();
+			attachment_info.resolveImageLayout = get_layout(scope.color_resolves[k]);
+		}
+
+		color_attachments.push_back(attachment_info);
+		rendering_state.color_attachment_formats.push_back(attachments[scope.colors[k]].format);
+	}
+
+	VkRenderingAttachmentInfoKHR depth_stencil_attachment{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR};
+
+	if (scope.depth_stencil != VK_ATTACHMENT_UNUSED)
+	{
+		depth_stencil_attachment = get_attachment_info(scope.depth_stencil);
+
+		if (scope.depth_stencil_resolve != VK_ATTACHMENT_UNUSED)
+		{
+			depth_stencil_attachment.resolveMode        = dynamic_rendering.subpasses[subpass_index].depth_stencil_resolve_mode;
+			depth_stencil_attachment.resolveImageView   = views[scope.depth_stencil_resolve].get_handle();
+			depth_stencil_attachment.resolveImageLayout = get_layout(scope.depth_stencil_resolve);
+		}
+
+		VkFormat depth_stencil_format           = attachments[scope.depth_stencil].format;
+		rendering_state.depth_attachment_format = depth_stencil_format;
+
+		if (is_depth_stencil_format(depth_stencil_format))
+		{
+			rendering_state.stencil_attachment_format = depth_stencil_format;
+		}
+	}
+
+	VkRenderingInfoKHR rendering_info{VK_STRUCTURE_TYPE_RENDERING_INFO_KHR};
+	rendering_info.renderArea.extent    = render_target.get_extent();
+	rendering_info.layerCount           = 1;
+	rendering_info.colorAttachmentCount = to_u32(color_attachments.size());
+	rendering_info.pColorAttachments    = color_attachments.empty() ? nullptr : color_attachments.data();
+
+	if (rendering_state.depth_attachment_format != VK_FORMAT_UNDEFINED)
+	{
+		rendering_info.pDepthAttachment = &depth_stencil_attachment;
+	}
+
+	if (rendering_state.stencil_attachment_format != VK_FORMAT_UNDEFINED)
+	{
+		rendering_info.pStencilAttachment = &depth_stencil_attachment;
+	}
+
+	// Only the first scope may be recorded by secondary command buffers, as only the first subpass of a render pass can
+	if (subpass_index == 0 && dynamic_rendering.contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS)
+	{
+		rendering_info.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR;
+	}
+
+	vkCmdBeginRenderingKHR(get_handle(), &rendering_info);
+
+	if (!scope.colors.empty())
+	{
+		dynamic_rendering.samples = attachments[scope.colors[0]].samples;
+	}
+	else if (scope.depth_stencil != VK_ATTACHMENT_UNUSED)
+	{
+		dynamic_rendering.samples = attachments[scope.depth_stencil].samples;
+	}
+
+	dynamic_rendering.rendering_state = std::move(rendering_state);
+
+	// Update blend state attachments for the scope
+	auto blend_state = pipeline_state.get_color_blend_state();
+	blend_state.attachments.resize(scope.colors.size());
+	pipeline_state.set_color_blend_state(blend_state);
 }
 
 void CommandBuffer::execute_commands(CommandBuffer &secondary_command_buffer)
 {
 	vkCmdExecuteCommands(get_handle(), 1, &secondary_command_buffer.get_handle());
+
+	// The dynamic state is undefined after executing secondary command buffers
+	extended_dynamic_state_recorded = false;
 }
 
 void CommandBuffer::execute_commands(std::vector<CommandBuffer *> &secondary_command_buffers)
@@ -217,10 +603,22 @@ void CommandBuffer::execute_commands(std::vector<CommandBuffer *> &secondary_com
 	std::transform(secondary_command_buffers.begin(), secondary_command_buffers.end(), sec_cmd_buf_handles.begin(),
 	               [](const vkb::CommandBuffer *sec_cmd_buf) { return sec_cmd_buf->get_handle(); });
 	vkCmdExecuteCommands(get_handle(), to_u32(sec_cmd_buf_handles.size()), sec_cmd_buf_handles.data());
+
+	// The dynamic state is undefined after executing secondary command buffers
+	extended_dynamic_state_recorded = false;
 }
 
 void CommandBuffer::end_render_pass()
 {
+	if (dynamic_rendering.render_target)
+	{
+		vkCmdEndRenderingKHR(get_handle());
+
+		dynamic_rendering = {};
+
+		return;
+	}
+
 	vkCmdEndRenderPass(get_handle());
 }
 
@@ -291,6 +689,18 @@ void CommandBuffer::bind_lighting(LightingState &lighting_state, uint32_t set, u
 	set_specialization_constant(2, to_u32(lighting_state.spot_lights.size()));
 }
 
+void CommandBuffer::bind_descriptor_set(uint32_t set, VkDescriptorSet descriptor_set)
+{
+	assert(set < max_resource_sets && "Descriptor set index out of range");
+	assert(!get_device().uses_descriptor_buffers() && "Descriptor sets can't be bound if the device uses descriptor buffers");
+
+	if (external_descriptor_sets[set] != descriptor_set)
+	{
+		external_descriptor_sets[set] = descriptor_set;
+		dirty_external_descriptor_sets |= 1u << set;
+	}
+}
+
 void CommandBuffer::set_viewport_state(const ViewportState &state_info)
 {
 	pipeline_state.set_viewport_state(state_info);
@@ -360,6 +770,8 @@ void CommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count, uint32_
 {
 	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
 
+	recorded_draw_count++;
+
 	vkCmdDraw(get_handle(), vertex_count, instance_count, first_vertex, first_instance);
 }
 
@@ -367,6 +779,8 @@ void CommandBuffer::draw_indexed(uint32_t index_count, uint32_t instance_count,
 {
 	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
 
+	recorded_draw_count++;
+
 	vkCmdDrawIndexed(get_handle(), index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
@@ -374,9 +788,29 @@ void CommandBuffer::draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSi
 {
 	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
 
+	recorded_draw_count++;
+
 	vkCmdDrawIndexedIndirect(get_handle(), buffer.get_handle(), offset, draw_count, stride);
 }
 
+void CommandBuffer::draw_indexed_indirect_count(const core::Buffer &buffer, VkDeviceSize offset, const core::Buffer &count_buffer, VkDeviceSize count_buffer_offset, uint32_t max_draw_count, uint32_t stride)
+{
+	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+	recorded_draw_count++;
+
+	vkCmdDrawIndexedIndirectCountKHR(get_handle(), buffer.get_handle(), offset, count_buffer.get_handle(), count_buffer_offset, max_draw_count, stride);
+}
+
+void CommandBuffer::draw_mesh_tasks(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
+{
+	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+	recorded_draw_count++;
+
+	vkCmdDrawMeshTasksEXT(get_handle(), group_count_x, group_count_y, group_count_z);
+}
+
 void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
 {
 	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
@@ -497,7 +931,15 @@ void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point
 	// Create and bind pipeline
 	if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
 	{
-		pipeline_state.set_render_pass(*current_render_pass.render_pass);
+		if (current_render_pass.render_pass)
+		{
+			pipeline_state.set_render_pass(*current_render_pass.render_pass);
+		}
+		else
+		{
+			pipeline_state.set_rendering_state(dynamic_rendering.rendering_state);
+		}
+
 		auto &pipeline = get_device().get_resource_cache().request_graphics_pipeline(pipeline_state);
 
 		vkCmdBindPipeline(get_handle(),
@@ -518,180 +960,461 @@ void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point
 	}
 }
 
-void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point)
+void CommandBuffer::flush_extended_dynamic_state()
 {
-	assert(command_pool.get_render_frame() && "The command pool must be associated to a render frame");
+	const auto &extended_dynamic_state = pipeline_state.get_extended_dynamic_state();
 
-	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
+	if (!extended_dynamic_state.extended_dynamic_state && !extended_dynamic_state.extended_dynamic_state2 && !extended_dynamic_state.color_blend)
+	{
+		return;
+	}
+
+	if (!pipeline_state.is_dynamic_state_dirty() && extended_dynamic_state_recorded)
+	{
+		return;
+	}
 
-	std::unordered_set<uint32_t> update_descriptor_sets;
+	pipeline_state.clear_dynamic_state_dirty();
 
-	// Iterate over the shader sets to check if they have already been bound
-	// If they have, add the set so that the command buffer later updates it
-	for (auto &set_it : pipeline_layout.get_shader_sets())
+	// Nothing is known of the dynamic state before it is first recorded
+	bool record_all = !extended_dynamic_state_recorded;
+
+	extended_dynamic_state_recorded = true;
+
+	const auto &rasterization_state  = pipeline_state.get_rasterization_state();
+	const auto &input_assembly_state = pipeline_state.get_input_assembly_state();
+	const auto &depth_stencil_state  = pipeline_state.get_depth_stencil_state();
+	const auto &color_blend_state    = pipeline_state.get_color_blend_state();
+
+	if (extended_dynamic_state.extended_dynamic_state)
 	{
-		uint32_t descriptor_set_id = set_it.first;
+		if (record_all || rasterization_state.cull_mode != recorded_rasterization_state.cull_mode)
+		{
+			vkCmdSetCullModeEXT(get_handle(), rasterization_state.cull_mode);
+		}
+
+		if (record_all || rasterization_state.front_face != recorded_rasterization_state.front_face)
+		{
+			vkCmdSetFrontFaceEXT(get_handle(), rasterization_state.front_face);
+		}
+
+		if (record_all || depth_stencil_state.depth_test_enable != recorded_depth_stencil_state.depth_test_enable)
+		{
+			vkCmdSetDepthTestEnableEXT(get_handle(), depth_stencil_state.depth_test_enable);
+		}
+
+		if (record_all || depth_stencil_state.depth_write_enable != recorded_depth_stencil_state.depth_write_enable)
+		{
+			vkCmdSetDepthWriteEnableEXT(get_handle(), depth_stencil_state.depth_write_enable);
+		}
 
-		auto descriptor_set_layout_it = descriptor_set_layout_binding_state.find(descriptor_set_id);
+		if (record_all || depth_stencil_state.depth_compare_op != recorded_depth_stencil_state.depth_compare_op)
+		{
+			vkCmdSetDepthCompareOpEXT(get_handle(), depth_stencil_state.depth_compare_op);
+		}
 
-		if (descriptor_set_layout_it != descriptor_set_layout_binding_state.end())
+		if (record_all || depth_stencil_state.depth_bounds_test_enable != recorded_depth_stencil_state.depth_bounds_test_enable)
 		{
-			if (descriptor_set_layout_it->second->get_handle() != pipeline_layout.get_descriptor_set_layout(descriptor_set_id).get_handle())
+			vkCmdSetDepthBoundsTestEnableEXT(get_handle(), depth_stencil_state.depth_bounds_test_enable);
+		}
+
+		if (record_all || depth_stencil_state.stencil_test_enable != recorded_depth_stencil_state.stencil_test_enable)
+		{
+			vkCmdSetStencilTestEnableEXT(get_handle(), depth_stencil_state.stencil_test_enable);
+		}
+
+		auto set_stencil_op = [&](VkStencilFaceFlags face_mask, const StencilOpState &stencil, const StencilOpState &recorded_stencil) {
+			if (record_all || std::tie(stencil.fail_op, stencil.pass_op, stencil.depth_fail_op, stencil.compare_op) !=
+			                      std::tie(recorded_stencil.fail_op, recorded_stencil.pass_op, recorded_stencil.depth_fail_op, recorded_stencil.compare_op))
 			{
-				update_descriptor_sets.emplace(descriptor_set_id);
+				vkCmdSetStencilOpEXT(get_handle(), face_mask, stencil.fail_op, stencil.pass_op, stencil.depth_fail_op, stencil.compare_op);
 			}
+		};
+
+		set_stencil_op(VK_STENCIL_FACE_FRONT_BIT, depth_stencil_state.front, recorded_depth_stencil_state.front);
+		set_stencil_op(VK_STENCIL_FACE_BACK_BIT, depth_stencil_state.back, recorded_depth_stencil_state.back);
+	}
+
+	if (extended_dynamic_state.extended_dynamic_state2)
+	{
+		if (record_all || rasterization_state.depth_bias_enable != recorded_rasterization_state.depth_bias_enable)
+		{
+			vkCmdSetDepthBiasEnableEXT(get_handle(), rasterization_state.depth_bias_enable);
+		}
+
+		if (record_all || rasterization_state.rasterizer_discard_enable != recorded_rasterization_state.rasterizer_discard_enable)
+		{
+			vkCmdSetRasterizerDiscardEnableEXT(get_handle(), rasterization_state.rasterizer_discard_enable);
+		}
+
+		if (record_all || input_assembly_state.primitive_restart_enable != recorded_input_assembly_state.primitive_restart_enable)
+		{
+			vkCmdSetPrimitiveRestartEnableEXT(get_handle(), input_assembly_state.primitive_restart_enable);
 		}
 	}
 
-	// Validate that the bound descriptor set layouts exist in the pipeline layout
-	for (auto set_it = descriptor_set_layout_binding_state.begin(); set_it != descriptor_set_layout_binding_state.end();)
+	if (extended_dynamic_state.color_blend && !color_blend_state.attachments.empty())
 	{
-		if (!pipeline_layout.has_descriptor_set_layout(set_it->first))
+		const auto &attachments = color_blend_state.attachments;
+
+		bool same_count = !record_all && attachments.size() == recorded_color_blend_attachments.size();
+
+		auto attachments_equal = [&](auto member_equal) {
+			return same_count && std::equal(attachments.begin(), attachments.end(), recorded_color_blend_attachments.begin(), member_equal);
+		};
+
+		if (!attachments_equal([](const ColorBlendAttachmentState &lhs, const ColorBlendAttachmentState &rhs) { return lhs.blend_enable == rhs.blend_enable; }))
 		{
-			set_it = descriptor_set_layout_binding_state.erase(set_it);
+			std::vector<VkBool32> blend_enables(attachments.size());
+			std::transform(attachments.begin(), attachments.end(), blend_enables.begin(),
+			               [](const ColorBlendAttachmentState &attachment) { return attachment.blend_enable; });
+
+			vkCmdSetColorBlendEnableEXT(get_handle(), 0, to_u32(blend_enables.size()), blend_enables.data());
 		}
-		else
+
+		if (!attachments_equal([](const ColorBlendAttachmentState &lhs, const ColorBlendAttachmentState &rhs) {
+			    return std::tie(lhs.src_color_blend_factor, lhs.dst_color_blend_factor, lhs.color_blend_op, lhs.src_alpha_blend_factor, lhs.dst_alpha_blend_factor, lhs.alpha_blend_op) ==
+			           std::tie(rhs.src_color_blend_factor, rhs.dst_color_blend_factor, rhs.color_blend_op, rhs.src_alpha_blend_factor, rhs.dst_alpha_blend_factor, rhs.alpha_blend_op);
+		    }))
+		{
+			std::vector<VkColorBlendEquationEXT> blend_equations(attachments.size());
+			std::transform(attachments.begin(), attachments.end(), blend_equations.begin(), [](const ColorBlendAttachmentState &attachment) {
+				return VkColorBlendEquationEXT{attachment.src_color_blend_factor, attachment.dst_color_blend_factor, attachment.color_blend_op,
+				                               attachment.src_alpha_blend_factor, attachment.dst_alpha_blend_factor, attachment.alpha_blend_op};
+			});
+
+			vkCmdSetColorBlendEquationEXT(get_handle(), 0, to_u32(blend_equations.size()), blend_equations.data());
+		}
+
+		if (!attachments_equal([](const ColorBlendAttachmentState &lhs, const ColorBlendAttachmentState &rhs) { return lhs.color_write_mask == rhs.color_write_mask; }))
 		{
-			++set_it;
+			std::vector<VkColorComponentFlags> write_masks(attachments.size());
+			std::transform(attachments.begin(), attachments.end(), write_masks.begin(),
+			               [](const ColorBlendAttachmentState &attachment) { return attachment.color_write_mask; });
+
+			vkCmdSetColorWriteMaskEXT(get_handle(), 0, to_u32(write_masks.size()), write_masks.data());
 		}
+
+		recorded_color_blend_attachments = attachments;
 	}
 
-	// Check if a descriptor set needs to be created
-	if (resource_binding_state.is_dirty() || !update_descriptor_sets.empty())
+	recorded_rasterization_state  = rasterization_state;
+	recorded_input_assembly_state = input_assembly_state;
+	recorded_depth_stencil_state  = depth_stencil_state;
+}
+
+uint32_t CommandBuffer::get_descriptor_sets_to_flush(const PipelineLayout &pipeline_layout)
+{
+	// Mask of the sets whose bound descriptor set layout differs from the pipeline layout
+	uint32_t update_descriptor_sets = 0;
+
+	for (uint32_t descriptor_set_id = 0; descriptor_set_id < max_resource_sets; ++descriptor_set_id)
 	{
-		resource_binding_state.clear_dirty();
+		auto &bound_layout = descriptor_set_layout_binding_state[descriptor_set_id];
+
+		if (bound_layout == nullptr)
+		{
+			continue;
+		}
 
-		// Iterate over all of the resource sets bound by the command buffer
-		for (auto &resource_set_it : resource_binding_state.get_resource_sets())
+		// Validate that the bound descriptor set layouts exist in the pipeline layout
+		if (!pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
 		{
-			uint32_t descriptor_set_id = resource_set_it.first;
-			auto    &resource_set      = resource_set_it.second;
+			bound_layout = nullptr;
+		}
+		else if (bound_layout->get_handle() != pipeline_layout.get_descriptor_set_layout(descriptor_set_id).get_handle())
+		{
+			update_descriptor_sets |= 1u << descriptor_set_id;
+		}
+	}
+
+	// Don't update resource sets if they're not in the update list AND their state hasn't changed
+	return (resource_binding_state.get_dirty_sets() | update_descriptor_sets) & resource_binding_state.get_bound_sets();
+}
+
+void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point)
+{
+	if (get_device().uses_descriptor_buffers())
+	{
+		flush_descriptor_buffers(pipeline_bind_point);
+		return;
+	}
+
+	assert(command_pool.get_render_frame() && "The command pool must be associated to a render frame");
+
+	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
+
+	uint32_t flush_sets = get_descriptor_sets_to_flush(pipeline_layout);
+
+	for (uint32_t descriptor_set_id = 0; flush_sets >> descriptor_set_id != 0; ++descriptor_set_id)
+	{
+		if (!(flush_sets & (1u << descriptor_set_id)))
+		{
+			continue;
+		}
+
+		// Clear dirty flag for resource set
+		resource_binding_state.clear_dirty(descriptor_set_id);
+
+		// Skip resource set if a descriptor set layout doesn't exist for it
+		if (!pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+		{
+			continue;
+		}
+
+		auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(descriptor_set_id);
 
-			// Don't update resource set if it's not in the update list OR its state hasn't changed
-			if (!resource_set.is_dirty() && (update_descriptor_sets.find(descriptor_set_id) == update_descriptor_sets.end()))
+		// Make descriptor set layout bound for current set
+		descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
+
+		const auto &resource_set = resource_binding_state.get_resource_set(descriptor_set_id);
+
+		VkDescriptorSet descriptor_set_handle = VK_NULL_HANDLE;
+
+		// Look the descriptor set up by the hashes of the bound resources, update-after-bind sets are updated per binding
+		if (!update_after_bind)
+		{
+			descriptor_set_handle = command_pool.get_render_frame()->request_descriptor_set(descriptor_set_layout, resource_set, command_pool.get_thread_index());
+		}
+
+		// Descriptor infos are only collected if the descriptor set couldn't be requested from the resource set.
+		// Only this fallback allocates: the BindingMaps below are keyed like the descriptor set cache, and are
+		// built for layouts without an update template, partially bound sets, update-after-bind sets and the
+		// CreateDirectly strategy
+		bool collect_infos = descriptor_set_handle == VK_NULL_HANDLE;
+
+		BindingMap<VkDescriptorBufferInfo> buffer_infos;
+		BindingMap<VkDescriptorImageInfo>  image_infos;
+
+		uint32_t dynamic_offset_count = 0;
+
+		uint32_t bound_bindings = resource_set.get_bound_bindings();
+
+		// Iterate over all resource bindings
+		for (uint32_t binding_index = 0; bound_bindings >> binding_index != 0; ++binding_index)
+		{
+			if (!(bound_bindings & (1u << binding_index)))
 			{
 				continue;
 			}
 
-			// Clear dirty flag for resource set
-			resource_binding_state.clear_dirty(descriptor_set_id);
+			// Check if binding exists in the pipeline layout
+			auto binding_info = descriptor_set_layout.find_layout_binding(binding_index);
 
-			// Skip resource set if a descriptor set layout doesn't exist for it
-			if (!pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+			if (!binding_info || (!collect_infos && !is_dynamic_buffer_descriptor_type(binding_info->descriptorType)))
 			{
 				continue;
 			}
 
-			auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(descriptor_set_id);
-
-			// Make descriptor set layout bound for current set
-			descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
+			uint32_t bound_array_elements = resource_set.get_bound_array_elements(binding_index);
 
-			BindingMap<VkDescriptorBufferInfo> buffer_infos;
-			BindingMap<VkDescriptorImageInfo>  image_infos;
+			// Iterate over all binding resources
+			for (uint32_t array_element = 0; bound_array_elements >> array_element != 0; ++array_element)
+			{
+				if (!(bound_array_elements & (1u << array_element)))
+				{
+					continue;
+				}
 
-			std::vector<uint32_t> dynamic_offsets;
+				auto &resource_info = resource_set.get_resource(binding_index, array_element);
 
-			// Iterate over all resource bindings
-			for (auto &binding_it : resource_set.get_resource_bindings())
-			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+				// Pointer references
+				auto &buffer     = resource_info.buffer;
+				auto &sampler    = resource_info.sampler;
+				auto &image_view = resource_info.image_view;
 
-				// Check if binding exists in the pipeline layout
-				if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
+				// Get buffer info
+				if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
 				{
-					// Iterate over all binding resources
-					for (auto &element_it : binding_resources)
-					{
-						auto  array_element = element_it.first;
-						auto &resource_info = element_it.second;
+					VkDescriptorBufferInfo buffer_info{};
 
-						// Pointer references
-						auto &buffer     = resource_info.buffer;
-						auto &sampler    = resource_info.sampler;
-						auto &image_view = resource_info.image_view;
+					buffer_info.buffer = resource_info.buffer->get_handle();
+					buffer_info.offset = resource_info.offset;
+					buffer_info.range  = resource_info.range;
 
-						// Get buffer info
-						if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
-						{
-							VkDescriptorBufferInfo buffer_info{};
-
-							buffer_info.buffer = resource_info.buffer->get_handle();
-							buffer_info.offset = resource_info.offset;
-							buffer_info.range  = resource_info.range;
+					if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
+					{
+						dynamic_offsets[dynamic_offset_count++] = to_u32(buffer_info.offset);
 
-							if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
-							{
-								dynamic_offsets.push_back(to_u32(buffer_info.offset));
+						buffer_info.offset = 0;
+					}
 
-								buffer_info.offset = 0;
-							}
+					if (collect_infos)
+					{
+						buffer_infos[binding_index][array_element] = buffer_info;
+					}
+				}
 
-							buffer_infos[binding_index][array_element] = buffer_info;
-						}
+				// Get image info
+				else if (image_view != nullptr || sampler != nullptr)
+				{
+					// Can be null for input attachments
+					VkDescriptorImageInfo image_info{};
+					image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
+					image_info.imageView = image_view->get_handle();
 
-						// Get image info
-						else if (image_view != nullptr || sampler != nullptr)
+					if (image_view != nullptr)
+					{
+						// Add image layout info based on descriptor type
+						switch (binding_info->descriptorType)
 						{
-							// Can be null for input attachments
-							VkDescriptorImageInfo image_info{};
-							image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
-							image_info.imageView = image_view->get_handle();
-
-							if (image_view != nullptr)
-							{
-								// Add image layout info based on descriptor type
-								switch (binding_info->descriptorType)
+							case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+								image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+								break;
+							case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+								if (is_depth_format(image_view->get_format()))
+								{
+									image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+								}
+								else
 								{
-									case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										break;
-									case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-										if (is_depth_format(image_view->get_format()))
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-										}
-										else
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										}
-										break;
-									case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-										break;
-
-									default:
-										continue;
+									image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 								}
-							}
+								break;
+							case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+								image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+								break;
 
-							image_infos[binding_index][array_element] = image_info;
+							default:
+								continue;
 						}
 					}
 
-					assert((!update_after_bind ||
-					        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
-					       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
+					image_infos[binding_index][array_element] = image_info;
 				}
 			}
 
-			VkDescriptorSet descriptor_set_handle =
-			    command_pool.get_render_frame()->request_descriptor_set(descriptor_set_layout,
-			                                                            buffer_infos,
-			                                                            image_infos,
-			                                                            update_after_bind,
-			                                                            command_pool.get_thread_index());
+			assert((!update_after_bind ||
+			        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
+			       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
+		}
+
+		if (collect_infos)
+		{
+			descriptor_set_handle = command_pool.get_render_frame()->request_descriptor_set(descriptor_set_layout,
+			                                                                                buffer_infos,
+			                                                                                image_infos,
+			                                                                                update_after_bind,
+			                                                                                command_pool.get_thread_index());
+		}
 
-			// Bind descriptor set
+		// Bind descriptor set
+		vkCmdBindDescriptorSets(get_handle(),
+		                        pipeline_bind_point,
+		                        pipeline_layout.get_handle(),
+		                        descriptor_set_id,
+		                        1, &descriptor_set_handle,
+		                        dynamic_offset_count,
+		                        dynamic_offsets.data());
+	}
+
+	// Binding a set with an incompatible layout disturbs the sets above it, so external sets are rebound after
+	// any lower set was, as well as when the pipeline layout changes
+	bool pipeline_layout_changed = external_descriptor_set_pipeline_layout != pipeline_layout.get_handle();
+
+	for (uint32_t descriptor_set_id = 0; descriptor_set_id < max_resource_sets; ++descriptor_set_id)
+	{
+		VkDescriptorSet descriptor_set_handle = external_descriptor_sets[descriptor_set_id];
+
+		if (descriptor_set_handle == VK_NULL_HANDLE || !pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+		{
+			continue;
+		}
+
+		bool lower_set_flushed = (flush_sets & ((1u << descriptor_set_id) - 1)) != 0;
+
+		if (pipeline_layout_changed || lower_set_flushed || (dirty_external_descriptor_sets & (1u << descriptor_set_id)))
+		{
 			vkCmdBindDescriptorSets(get_handle(),
 			                        pipeline_bind_point,
 			                        pipeline_layout.get_handle(),
 			                        descriptor_set_id,
 			                        1, &descriptor_set_handle,
-			                        to_u32(dynamic_offsets.size()),
-			                        dynamic_offsets.data());
+			                        0, nullptr);
+		}
+	}
+
+	dirty_external_descriptor_sets          = 0;
+	external_descriptor_set_pipeline_layout = pipeline_layout.get_handle();
+}
+
+void CommandBuffer::flush_descriptor_buffers(VkPipelineBindPoint pipeline_bind_point)
+{
+	assert(command_pool.get_render_frame() && "The command pool must be associated to a render frame");
+
+	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
+
+	uint32_t flush_sets = get_descriptor_sets_to_flush(pipeline_layout);
+
+	while (flush_sets != 0)
+	{
+		// Flush the lowest set first, rebinding the descriptor buffer below may add sets to flush
+		uint32_t descriptor_set_id = 0;
+		while (!(flush_sets & (1u << descriptor_set_id)))
+		{
+			++descriptor_set_id;
+		}
+
+		flush_sets &= ~(1u << descriptor_set_id);
+
+		// Clear dirty flag for resource set
+		resource_binding_state.clear_dirty(descriptor_set_id);
+
+		// Skip resource set if a descriptor set layout doesn't exist for it
+		if (!pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+		{
+			continue;
+		}
+
+		auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(descriptor_set_id);
+
+		auto allocation = command_pool.get_render_frame()->write_descriptor_buffer(descriptor_set_layout,
+		                                                                          resource_binding_state.get_resource_set(descriptor_set_id),
+		                                                                          command_pool.get_thread_index());
+
+		if (allocation.empty())
+		{
+			continue;
 		}
+
+		auto &descriptor_buffer = allocation.get_buffer();
+
+		// A single descriptor buffer is bound at a time. When the frame moves on to another block,
+		// the sets written to the previous one are written again to the new one.
+		if (descriptor_buffer.get_handle() != bound_descriptor_buffer)
+		{
+			VkDescriptorBufferBindingInfoEXT binding_info{VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT};
+			binding_info.address = descriptor_buffer.get_device_address();
+			binding_info.usage   = RenderFrame::DESCRIPTOR_BUFFER_USAGE;
+
+			vkCmdBindDescriptorBuffersEXT(get_handle(), 1, &binding_info);
+
+			if (bound_descriptor_buffer != VK_NULL_HANDLE)
+			{
+				for (uint32_t bound_set_id = 0; bound_set_id < max_resource_sets; ++bound_set_id)
+				{
+					if (bound_set_id != descriptor_set_id && descriptor_set_layout_binding_state[bound_set_id] != nullptr)
+					{
+						flush_sets |= 1u << bound_set_id;
+					}
+				}
+			}
+
+			bound_descriptor_buffer = descriptor_buffer.get_handle();
+		}
+
+		// Make descriptor set layout bound for current set
+		descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
+
+		uint32_t     buffer_index = 0;
+		VkDeviceSize offset       = allocation.get_offset();
+
+		vkCmdSetDescriptorBufferOffsetsEXT(get_handle(),
+		                                   pipeline_bind_point,
+		                                   pipeline_layout.get_handle(),
+		                                   descriptor_set_id,
+		                                   1, &buffer_index,
+		                                   &offset);
 	}
 }
 
@@ -777,26 +1500,24 @@ VkResult CommandBuffer::reset(ResetMode reset_mode)
 	return result;
 }
 
+uint32_t CommandBuffer::get_draw_count() const
+{
+	return recorded_draw_count;
+}
+
 RenderPass &CommandBuffer::get_render_pass(const vkb::RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<std::unique_ptr<Subpass>> &subpasses)
 {
-	// Create render pass
-	assert(subpasses.size() > 0 && "Cannot create a render pass without any subpass");
+	std::vector<Subpass *> subpass_ptrs(subpasses.size());
+	std::transform(subpasses.begin(), subpasses.end(), subpass_ptrs.begin(), [](const std::unique_ptr<Subpass> &subpass) { return subpass.get(); });
 
-	std::vector<vkb::SubpassInfo> subpass_infos(subpasses.size());
-	auto                          subpass_info_it = subpass_infos.begin();
-	for (auto &subpass : subpasses)
-	{
-		subpass_info_it->input_attachments                = subpass->get_input_attachments();
-		subpass_info_it->output_attachments               = subpass->get_output_attachments();
-		subpass_info_it->color_resolve_attachments        = subpass->get_color_resolve_attachments();
-		subpass_info_it->disable_depth_stencil_attachment = subpass->get_disable_depth_stencil_attachment();
-		subpass_info_it->depth_stencil_resolve_mode       = subpass->get_depth_stencil_resolve_mode();
-		subpass_info_it->depth_stencil_resolve_attachment = subpass->get_depth_stencil_resolve_attachment();
-		subpass_info_it->debug_name                       = subpass->get_debug_name();
+	return get_render_pass(render_target, load_store_infos, subpass_ptrs);
+}
 
-		++subpass_info_it;
-	}
+RenderPass &CommandBuffer::get_render_pass(const vkb::RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<Subpass *> &subpasses)
+{
+	// Create render pass
+	assert(subpasses.size() > 0 && "Cannot create a render pass without any subpass");
 
-	return get_device().get_resource_cache().request_render_pass(render_target.get_attachments(), load_store_infos, subpass_infos);
+	return get_device().get_resource_cache().request_render_pass(render_target.get_attachments(), load_store_infos, get_subpass_infos(subpasses));
 }
 }        // namespace vkb
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 
 #include "common/helpers.h"
@@ -113,6 +114,15 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 
 	void begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values, const std::vector<std::unique_ptr<Subpass>> &subpasses, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
+	/**
+	 * @brief Begins a render pass for subpasses owned by several render pipelines
+	 * @remarks If the device uses dynamic rendering, the subpasses are recorded as dynamic rendering scopes, and no
+	 *          render pass nor framebuffer is requested from the resource cache. Render passes are still used for
+	 *          subpasses reading input attachments, which dynamic rendering scopes cannot, and for render targets with
+	 *          transient attachments shared by several subpasses, which separate scopes would store.
+	 */
+	void begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values, const std::vector<Subpass *> &subpasses, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
+
 	void begin_render_pass(const RenderTarget &render_target, const RenderPass &render_pass, const Framebuffer &framebuffer, const std::vector<VkClearValue> &clear_values, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
 	void next_subpass();
@@ -166,6 +176,15 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 
 	void bind_lighting(LightingState &lighting_state, uint32_t set, uint32_t binding);
 
+	/**
+	 * @brief Binds a descriptor set allocated and written by the caller, in place of the resources bound to the set.
+	 *        It stays bound until the command buffer is reset, and is rebound on the next draw or dispatch whenever
+	 *        binding a lower set may have disturbed it. Not supported if the device uses descriptor buffers.
+	 * @param set The set index, no resources should be bound to it
+	 * @param descriptor_set The descriptor set, its layout must match the set layout of the pipeline layouts it is used with
+	 */
+	void bind_descriptor_set(uint32_t set, VkDescriptorSet descriptor_set);
+
 	void set_viewport_state(const ViewportState &state_info);
 
 	void set_vertex_input_state(const VertexInputState &state_info);
@@ -198,6 +217,16 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 
 	void draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride);
 
+	/**
+	 * @brief Draws indexed with a draw count read from a buffer, requires VK_KHR_draw_indirect_count
+	 */
+	void draw_indexed_indirect_count(const core::Buffer &buffer, VkDeviceSize offset, const core::Buffer &count_buffer, VkDeviceSize count_buffer_offset, uint32_t max_draw_count, uint32_t stride);
+
+	/**
+	 * @brief Draws with task and mesh shaders, requires VK_EXT_mesh_shader
+	 */
+	void draw_mesh_tasks(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
+
 	void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
 
 	void dispatch_indirect(const core::Buffer &buffer, VkDeviceSize offset);
@@ -236,8 +265,18 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 	 */
 	VkResult reset(ResetMode reset_mode);
 
+	/**
+	 * @return The number of draw commands recorded since the command buffer began
+	 */
+	uint32_t get_draw_count() const;
+
 	RenderPass &get_render_pass(const vkb::RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<std::unique_ptr<Subpass>> &subpasses);
 
+	/**
+	 * @brief Gets a render pass for subpasses owned by several render pipelines
+	 */
+	RenderPass &get_render_pass(const vkb::RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<Subpass *> &subpasses);
+
 	const VkCommandBufferLevel level;
 
   private:
@@ -245,6 +284,32 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 
 	RenderPassBinding current_render_pass;
 
+	/**
+	 * @brief Subpasses recorded as dynamic rendering scopes, in place of a render pass
+	 */
+	struct DynamicRenderingBinding
+	{
+		const RenderTarget *render_target{nullptr};
+
+		std::vector<LoadStoreInfo> load_store_infos;
+
+		std::vector<VkClearValue> clear_values;
+
+		std::vector<SubpassInfo> subpasses;
+
+		VkSubpassContents contents{VK_SUBPASS_CONTENTS_INLINE};
+
+		/// Index of the subpass whose scope is active
+		uint32_t subpass_index{0};
+
+		/// Attachment formats of the active scope, which its pipelines are created with
+		RenderingState rendering_state;
+
+		VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+	};
+
+	DynamicRenderingBinding dynamic_rendering;
+
 	PipelineState pipeline_state;
 
 	ResourceBindingState resource_binding_state;
@@ -253,6 +318,8 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 
 	uint32_t max_push_constants_size;
 
+	uint32_t recorded_draw_count{0};
+
 	VkExtent2D last_framebuffer_extent{};
 
 	VkExtent2D last_render_area_extent{};
@@ -261,12 +328,44 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 	// that contain update after bind, as they wont be implicitly updated
 	bool update_after_bind{false};
 
-	std::unordered_map<uint32_t, DescriptorSetLayout *> descriptor_set_layout_binding_state;
+	// The descriptor set layout each set was last flushed with
+	std::array<DescriptorSetLayout *, max_resource_sets> descriptor_set_layout_binding_state{};
+
+	// Dynamic offsets of the descriptor set being flushed
+	std::array<uint32_t, max_resource_bindings * max_resource_array_elements> dynamic_offsets{};
+
+	// The descriptor buffer bound to the command buffer, if the device uses descriptor buffers
+	VkBuffer bound_descriptor_buffer{VK_NULL_HANDLE};
+
+	// Descriptor sets bound with bind_descriptor_set, and the mask of those not bound since
+	std::array<VkDescriptorSet, max_resource_sets> external_descriptor_sets{};
+
+	uint32_t dirty_external_descriptor_sets{0};
+
+	// The pipeline layout the external descriptor sets were last bound with
+	VkPipelineLayout external_descriptor_set_pipeline_layout{VK_NULL_HANDLE};
+
+	// The states last recorded as extended dynamic state, to skip redundant commands
+	RasterizationState recorded_rasterization_state{};
+
+	InputAssemblyState recorded_input_assembly_state{};
+
+	DepthStencilState recorded_depth_stencil_state{};
+
+	std::vector<ColorBlendAttachmentState> recorded_color_blend_attachments;
+
+	// False until extended dynamic state is recorded, and after executing secondary command buffers
+	bool extended_dynamic_state_recorded{false};
 
 	const RenderPassBinding &get_current_render_pass() const;
 
 	const uint32_t get_current_subpass_index() const;
 
+	/**
+	 * @brief Begins the dynamic rendering scope of the active subpass of dynamic_rendering
+	 */
+	void begin_rendering_scope();
+
 	/**
 	 * @brief Check that the render area is an optimal size by comparing to the render area granularity
 	 */
@@ -282,10 +381,29 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 	 */
 	void flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point);
 
+	/**
+	 * @brief Flush the descriptor state to descriptor buffers, used in place of flush_descriptor_state
+	 *        if the device uses descriptor buffers
+	 */
+	void flush_descriptor_buffers(VkPipelineBindPoint pipeline_bind_point);
+
+	/**
+	 * @brief Finds the sets to flush, which changed since they were last flushed or were flushed
+	 *        with a different descriptor set layout than the one of the pipeline layout
+	 * @return A mask of the sets to flush
+	 */
+	uint32_t get_descriptor_sets_to_flush(const PipelineLayout &pipeline_layout);
+
 	/**
 	 * @brief Flush the push constant state
 	 */
 	void flush_push_constants();
+
+	/**
+	 * @brief Records the pipeline states the device uses extended dynamic state for, skipping those
+	 *        already recorded with the same value
+	 */
+	void flush_extended_dynamic_state();
 };
 
 template <class T>
@@ -17,16 +17,36 @@
 
 #include "descriptor_pool.h"
 
+#include <algorithm>
+
 #include "descriptor_set_layout.h"
 #include "device.h"
 
 namespace vkb
 {
+namespace
+{
+uint32_t next_power_of_two(uint32_t value)
+{
+	uint32_t result = 1;
+	while (result < value)
+	{
+		result <<= 1;
+	}
+	return result;
+}
+}        // namespace
+
+const uint32_t DescriptorPool::MAX_GROWN_SETS_PER_POOL;
+
+const VkDeviceSize DescriptorPool::ESTIMATED_DESCRIPTOR_SIZE;
+
 DescriptorPool::DescriptorPool(Device &                   device,
                                const DescriptorSetLayout &descriptor_set_layout,
                                uint32_t                   pool_size) :
     device{device},
-    descriptor_set_layout{&descriptor_set_layout}
+    descriptor_set_layout{&descriptor_set_layout},
+    initial_max_sets{pool_size}
 {
 	const auto &bindings = descriptor_set_layout.get_bindings();
 
@@ -38,49 +58,75 @@ DescriptorPool::DescriptorPool(Device &                   device,
 		descriptor_type_counts[binding.descriptorType] += binding.descriptorCount;
 	}
 
-	// Allocate pool sizes array
-	pool_sizes.resize(descriptor_type_counts.size());
+	// Allocate set sizes array, the pool sizes are these counts multiplied by the sets of each pool
+	set_sizes.resize(descriptor_type_counts.size());
 
-	auto pool_size_it = pool_sizes.begin();
+	auto set_size_it = set_sizes.begin();
 
-	// Fill pool size for each descriptor type count multiplied by the pool size
 	for (auto &it : descriptor_type_counts)
 	{
-		pool_size_it->type = it.first;
+		set_size_it->type = it.first;
 
-		pool_size_it->descriptorCount = it.second * pool_size;
+		set_size_it->descriptorCount = it.second;
 
-		++pool_size_it;
+		++set_size_it;
 	}
 
-	pool_max_sets = pool_size;
+	// We do not set FREE_DESCRIPTOR_SET_BIT as we do not need to free individual descriptor sets
+	// Check descriptor set layout and enable the required flags
+	auto &binding_flags = descriptor_set_layout.get_binding_flags();
+	for (auto binding_flag : binding_flags)
+	{
+		if (binding_flag & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT)
+		{
+			pool_flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+		}
+	}
 }
 
 DescriptorPool::~DescriptorPool()
 {
-	// Destroy all descriptor pools
-	for (auto pool : pools)
-	{
-		vkDestroyDescriptorPool(device.get_handle(), pool, nullptr);
-	}
+	destroy_pools();
 }
 
 void DescriptorPool::reset()
 {
-	// Reset all descriptor pools
-	for (auto pool : pools)
+	record_usage();
+
+	uint32_t target_sets = get_learned_max_sets();
+
+	// Replace the pools by a single one sized for the learned demand when the frame needed several of them,
+	// or when the pool is much larger than what is used
+	if (pools.size() > 1 || (pools.size() == 1 && pool_max_sets[0] >= target_sets * 4))
+	{
+		destroy_pools();
+
+		create_pool(target_sets);
+	}
+	else
 	{
-		vkResetDescriptorPool(device.get_handle(), pool, 0);
+		// Reset all descriptor pools
+		for (auto pool : pools)
+		{
+			vkResetDescriptorPool(device.get_handle(), pool, 0);
+		}
 	}
 
 	// Clear internal tracking of descriptor set allocations
 	std::fill(pool_sets_count.begin(), pool_sets_count.end(), 0);
 	set_pool_mapping.clear();
+	allocated_sets = 0;
 
 	// Reset the pool index from which descriptor sets are allocated
 	pool_index = 0;
 }
 
+void DescriptorPool::record_usage()
+{
+	// Grow the learned demand immediately, and let it decay slowly so that a quiet frame doesn't shrink the pools
+	learned_sets = std::max(allocated_sets, learned_sets - learned_sets / 8);
+}
+
 const DescriptorSetLayout &DescriptorPool::get_descriptor_set_layout() const
 {
 	assert(descriptor_set_layout && "Descriptor set layout is invalid");
@@ -116,11 +162,16 @@ VkDescriptorSet DescriptorPool::allocate()
 		// Decrement allocated set count for the current pool
 		--pool_sets_count[pool_index];
 
-		return VK_NULL_HANDLE;
+		throw VulkanException{result, "Failed to allocate descriptor set"};
 	}
 
-	// Store mapping between the descriptor set and the pool
-	set_pool_mapping.emplace(handle, pool_index);
+	++allocated_sets;
+
+	// Store mapping between the descriptor set and the pool, only needed to free individual descriptor sets
+	if (pool_flags & VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)
+	{
+		set_pool_mapping.emplace(handle, pool_index);
+	}
 
 	return handle;
 }
@@ -152,49 +203,43 @@ VkResult DescriptorPool::free(VkDescriptorSet descriptor_set)
 	return VK_SUCCESS;
 }
 
-std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
+uint32_t DescriptorPool::get_pool_creation_count() const
 {
-	// Create a new pool
-	if (pools.size() <= search_index)
-	{
-		VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
-
-		create_info.poolSizeCount = to_u32(pool_sizes.size());
-		create_info.pPoolSizes    = pool_sizes.data();
-		create_info.maxSets       = pool_max_sets;
+	return pool_creation_count;
+}
 
-		// We do not set FREE_DESCRIPTOR_SET_BIT as we do not need to free individual descriptor sets
-		create_info.flags = 0;
+VkDeviceSize DescriptorPool::get_estimated_memory_size() const
+{
+	VkDeviceSize descriptor_count = 0;
 
-		// Check descriptor set layout and enable the required flags
-		auto &binding_flags = descriptor_set_layout->get_binding_flags();
-		for (auto binding_flag : binding_flags)
+	for (auto max_sets : pool_max_sets)
+	{
+		for (auto &set_size : set_sizes)
 		{
-			if (binding_flag & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT)
-			{
-				create_info.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
-			}
+			descriptor_count += static_cast<VkDeviceSize>(set_size.descriptorCount) * max_sets;
 		}
+	}
 
-		VkDescriptorPool handle = VK_NULL_HANDLE;
+	return descriptor_count * ESTIMATED_DESCRIPTOR_SIZE;
+}
 
-		// Create the Vulkan descriptor pool
-		auto result = vkCreateDescriptorPool(device.get_handle(), &create_info, nullptr, &handle);
+std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
+{
+	// Create a new pool, twice as large as the previous one and at least as large as the learned demand
+	if (pools.size() <= search_index)
+	{
+		uint32_t max_sets = get_learned_max_sets();
 
-		if (result != VK_SUCCESS)
+		if (!pools.empty())
 		{
-			return 0;
+			max_sets = std::max(max_sets, std::min(pool_max_sets.back() * 2, std::max(MAX_GROWN_SETS_PER_POOL, pool_max_sets.back())));
 		}
 
-		// Store internally the Vulkan handle
-		pools.push_back(handle);
-
-		// Add set count for the descriptor pool
-		pool_sets_count.push_back(0);
+		create_pool(max_sets);
 
 		return search_index;
 	}
-	else if (pool_sets_count[search_index] < pool_max_sets)
+	else if (pool_sets_count[search_index] < pool_max_sets[search_index])
 	{
 		return search_index;
 	}
@@ -202,4 +247,60 @@ std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
 	// Increment pool index
 	return find_available_pool(++search_index);
 }
+
+uint32_t DescriptorPool::get_learned_max_sets() const
+{
+	return std::min(next_power_of_two(std::max(learned_sets, initial_max_sets)), std::max(MAX_GROWN_SETS_PER_POOL, initial_max_sets));
+}
+
+void DescriptorPool::create_pool(uint32_t max_sets)
+{
+	std::vector<VkDescriptorPoolSize> pool_sizes{set_sizes};
+
+	// Fill pool size for each descriptor type count multiplied by the pool size
+	for (auto &pool_size : pool_sizes)
+	{
+		pool_size.descriptorCount *= max_sets;
+	}
+
+	VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+
+	create_info.poolSizeCount = to_u32(pool_sizes.size());
+	create_info.pPoolSizes    = pool_sizes.data();
+	create_info.maxSets       = max_sets;
+	create_info.flags         = pool_flags;
+
+	VkDescriptorPool handle = VK_NULL_HANDLE;
+
+	// Create the Vulkan descriptor pool
+	auto result = vkCreateDescriptorPool(device.get_handle(), &create_info, nullptr, &handle);
+
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Failed to create descriptor pool"};
+	}
+
+	// Store internally the Vulkan handle
+	pools.push_back(handle);
+
+	pool_max_sets.push_back(max_sets);
+
+	// Add set count for the descriptor pool
+	pool_sets_count.push_back(0);
+
+	++pool_creation_count;
+}
+
+void DescriptorPool::destroy_pools()
+{
+	// Destroy all descriptor pools
+	for (auto pool : pools)
+	{
+		vkDestroyDescriptorPool(device.get_handle(), pool, nullptr);
+	}
+
+	pools.clear();
+	pool_max_sets.clear();
+	pool_sets_count.clear();
+}
 }        // namespace vkb
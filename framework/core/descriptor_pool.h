@@ -28,13 +28,24 @@ class Device;
 class DescriptorSetLayout;
 
 /**
- * @brief Manages an array of fixed size VkDescriptorPool and is able to allocate descriptor sets
+ * @brief Manages an array of VkDescriptorPool and is able to allocate descriptor sets.
+ *        Each new pool holds twice the sets of the previous one, so a growing demand needs few pools.
+ *        The pool learns the number of sets allocated from it, and thereby the descriptors of each type
+ *        its layout needs, on every reset and once per frame when its sets are kept across frames. New
+ *        pools are sized for that demand, and a reset replaces several pools with a single one, so steady
+ *        state frames allocate all their sets from one pool which is reset in bulk.
  */
 class DescriptorPool
 {
   public:
 	static const uint32_t MAX_SETS_PER_POOL = 16;
 
+	/// Upper bound of the sets of a single pool when growing
+	static const uint32_t MAX_GROWN_SETS_PER_POOL = 4096;
+
+	/// Nominal size of a descriptor used to estimate the memory of the pools, drivers don't report it
+	static const VkDeviceSize ESTIMATED_DESCRIPTOR_SIZE = 32;
+
 	DescriptorPool(Device &                   device,
 	               const DescriptorSetLayout &descriptor_set_layout,
 	               uint32_t                   pool_size = MAX_SETS_PER_POOL);
@@ -51,6 +62,12 @@ class DescriptorPool
 
 	void reset();
 
+	/**
+	 * @brief Learns the sets allocated since the last reset as the demand of the pool, without resetting it.
+	 *        Called by reset(), and every frame for pools whose descriptor sets are cached across frames.
+	 */
+	void record_usage();
+
 	const DescriptorSetLayout &get_descriptor_set_layout() const;
 
 	void set_descriptor_set_layout(const DescriptorSetLayout &set_layout);
@@ -59,20 +76,36 @@ class DescriptorPool
 
 	VkResult free(VkDescriptorSet descriptor_set);
 
+	/**
+	 * @return The number of Vulkan descriptor pools created since construction
+	 */
+	uint32_t get_pool_creation_count() const;
+
+	/**
+	 * @return An estimate of the memory held by the Vulkan descriptor pools, based on ESTIMATED_DESCRIPTOR_SIZE
+	 */
+	VkDeviceSize get_estimated_memory_size() const;
+
   private:
 	Device &device;
 
 	const DescriptorSetLayout *descriptor_set_layout{nullptr};
 
-	// Descriptor pool size
-	std::vector<VkDescriptorPoolSize> pool_sizes;
+	// Number of descriptors of each type in a descriptor set
+	std::vector<VkDescriptorPoolSize> set_sizes;
 
-	// Number of sets to allocate for each pool
-	uint32_t pool_max_sets{0};
+	// Flags of the pools, required by the descriptor set layout
+	VkDescriptorPoolCreateFlags pool_flags{0};
+
+	// Number of sets of the first pool, before any demand is learned
+	uint32_t initial_max_sets{0};
 
 	// Total descriptor pools created
 	std::vector<VkDescriptorPool> pools;
 
+	// Number of sets to allocate for each pool
+	std::vector<uint32_t> pool_max_sets;
+
 	// Count sets for each pool
 	std::vector<uint32_t> pool_sets_count;
 
@@ -82,7 +115,23 @@ class DescriptorPool
 	// Map between descriptor set and pool index
 	std::unordered_map<VkDescriptorSet, uint32_t> set_pool_mapping;
 
+	// Sets allocated since the last reset
+	uint32_t allocated_sets{0};
+
+	// Steady state number of sets per reset, learned from previous resets
+	uint32_t learned_sets{0};
+
+	uint32_t pool_creation_count{0};
+
 	// Find next pool index or create new pool
 	uint32_t find_available_pool(uint32_t pool_index);
+
+	// Number of sets of a pool sized for the learned demand
+	uint32_t get_learned_max_sets() const;
+
+	// Create a pool for the given number of sets, throws on failure
+	void create_pool(uint32_t max_sets);
+
+	void destroy_pools();
 };
 }        // namespace vkb
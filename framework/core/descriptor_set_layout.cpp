@@ -75,6 +75,23 @@ inline bool validate_binding(const VkDescriptorSetLayoutBinding &binding, const
 	return !(std::find_if(blacklist.begin(), blacklist.end(), [binding](const VkDescriptorType &type) { return type == binding.descriptorType; }) != blacklist.end());
 }
 
+inline bool is_update_template_descriptor_type(VkDescriptorType descriptor_type)
+{
+	switch (descriptor_type)
+	{
+		case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+		case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+		case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+		case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+		case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+		case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+		case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+			return true;
+		default:
+			return false;
+	}
+}
+
 inline bool validate_flags(const PhysicalDevice &gpu, const std::vector<VkDescriptorSetLayoutBinding> &bindings, const std::vector<VkDescriptorBindingFlagsEXT> &flags)
 {
 	// Assume bindings are valid if there are no flags
@@ -102,6 +119,8 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
     set_index{set_index},
     shader_modules{shader_modules}
 {
+	bool descriptor_buffers = device.uses_descriptor_buffers();
+
 	// NOTE: `shader_modules` is passed in mainly for hashing their handles in `request_resource`.
 	//        This way, different pipelines (with different shaders / shader variants) will get
 	//        different descriptor set layouts (incl. appropriate name -> binding lookups)
@@ -118,9 +137,11 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 		}
 
 		// Convert from ShaderResourceType to VkDescriptorType.
-		auto descriptor_type = find_descriptor_type(resource.type, resource.mode == ShaderResourceMode::Dynamic);
+		// Descriptor buffers have no dynamic descriptors, the offsets are written into the descriptors instead
+		auto descriptor_type = find_descriptor_type(resource.type, resource.mode == ShaderResourceMode::Dynamic && !descriptor_buffers);
 
-		if (resource.mode == ShaderResourceMode::UpdateAfterBind)
+		// Descriptor buffer memory can always be written after binding, so update-after-bind is ignored
+		if (resource.mode == ShaderResourceMode::UpdateAfterBind && !descriptor_buffers)
 		{
 			binding_flags.push_back(VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT);
 		}
@@ -155,9 +176,13 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 	create_info.bindingCount = to_u32(bindings.size());
 	create_info.pBindings    = bindings.data();
 
+	if (descriptor_buffers)
+	{
+		create_info.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
 	// Handle update-after-bind extensions
-	if (std::find_if(resource_set.begin(), resource_set.end(),
-	                 [](const ShaderResource &shader_resource) { return shader_resource.mode == ShaderResourceMode::UpdateAfterBind; }) != resource_set.end())
+	else if (std::find_if(resource_set.begin(), resource_set.end(),
+	                      [](const ShaderResource &shader_resource) { return shader_resource.mode == ShaderResourceMode::UpdateAfterBind; }) != resource_set.end())
 	{
 		// Spec states you can't have ANY dynamic resources if you have one of the bindings set to update-after-bind
 		if (std::find_if(resource_set.begin(), resource_set.end(),
@@ -186,6 +211,82 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 	{
 		throw VulkanException{result, "Cannot create DescriptorSetLayout"};
 	}
+
+	if (descriptor_buffers)
+	{
+		query_descriptor_buffer_layout();
+	}
+	else if ((create_info.flags & VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT) == 0 &&
+	         device.is_enabled(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME))
+	{
+		create_update_template();
+	}
+}
+
+void DescriptorSetLayout::query_descriptor_buffer_layout()
+{
+	vkGetDescriptorSetLayoutSizeEXT(device.get_handle(), handle, &descriptor_buffer_size);
+
+	for (auto &binding : bindings)
+	{
+		VkDeviceSize offset = 0;
+		vkGetDescriptorSetLayoutBindingOffsetEXT(device.get_handle(), handle, binding.binding, &offset);
+
+		descriptor_buffer_bindings.push_back({binding.binding, binding.descriptorType, binding.descriptorCount, offset});
+	}
+}
+
+void DescriptorSetLayout::create_update_template()
+{
+	// Only layouts whose descriptors can all be described by a DescriptorUpdateInfo get a template
+	if (std::find_if(bindings.begin(), bindings.end(),
+	                 [](const VkDescriptorSetLayoutBinding &binding) { return !is_update_template_descriptor_type(binding.descriptorType); }) != bindings.end())
+	{
+		return;
+	}
+
+	std::vector<VkDescriptorUpdateTemplateEntryKHR> entries;
+
+	for (auto &binding : bindings)
+	{
+		if (binding.descriptorCount == 0)
+		{
+			continue;
+		}
+
+		VkDescriptorUpdateTemplateEntryKHR entry{};
+		entry.dstBinding      = binding.binding;
+		entry.dstArrayElement = 0;
+		entry.descriptorCount = binding.descriptorCount;
+		entry.descriptorType  = binding.descriptorType;
+		entry.offset          = update_template_info_count * sizeof(DescriptorUpdateInfo);
+		entry.stride          = sizeof(DescriptorUpdateInfo);
+
+		entries.push_back(entry);
+
+		update_template_bindings.push_back({binding.binding, binding.descriptorType, binding.descriptorCount, update_template_info_count});
+
+		update_template_info_count += binding.descriptorCount;
+	}
+
+	if (entries.empty())
+	{
+		update_template_bindings.clear();
+		return;
+	}
+
+	VkDescriptorUpdateTemplateCreateInfoKHR create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR};
+	create_info.descriptorUpdateEntryCount = to_u32(entries.size());
+	create_info.pDescriptorUpdateEntries   = entries.data();
+	create_info.templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+	create_info.descriptorSetLayout        = handle;
+
+	VkResult result = vkCreateDescriptorUpdateTemplateKHR(device.get_handle(), &create_info, nullptr, &update_template);
+
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Cannot create DescriptorUpdateTemplate"};
+	}
 }
 
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
@@ -197,13 +298,24 @@ DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
     binding_flags{std::move(other.binding_flags)},
     bindings_lookup{std::move(other.bindings_lookup)},
     binding_flags_lookup{std::move(other.binding_flags_lookup)},
-    resources_lookup{std::move(other.resources_lookup)}
+    resources_lookup{std::move(other.resources_lookup)},
+    update_template{other.update_template},
+    update_template_bindings{std::move(other.update_template_bindings)},
+    update_template_info_count{other.update_template_info_count},
+    descriptor_buffer_size{other.descriptor_buffer_size},
+    descriptor_buffer_bindings{std::move(other.descriptor_buffer_bindings)}
 {
-	other.handle = VK_NULL_HANDLE;
+	other.handle          = VK_NULL_HANDLE;
+	other.update_template = VK_NULL_HANDLE;
 }
 
 DescriptorSetLayout::~DescriptorSetLayout()
 {
+	if (update_template != VK_NULL_HANDLE)
+	{
+		vkDestroyDescriptorUpdateTemplateKHR(device.get_handle(), update_template, nullptr);
+	}
+
 	// Destroy descriptor set layout
 	if (handle != VK_NULL_HANDLE)
 	{
@@ -226,6 +338,16 @@ const std::vector<VkDescriptorSetLayoutBinding> &DescriptorSetLayout::get_bindin
 	return bindings;
 }
 
+VkDeviceSize DescriptorSetLayout::get_descriptor_buffer_size() const
+{
+	return descriptor_buffer_size;
+}
+
+const std::vector<DescriptorBufferBinding> &DescriptorSetLayout::get_descriptor_buffer_bindings() const
+{
+	return descriptor_buffer_bindings;
+}
+
 const std::vector<VkDescriptorBindingFlagsEXT> &DescriptorSetLayout::get_binding_flags() const
 {
 	return binding_flags;
@@ -243,6 +365,33 @@ std::unique_ptr<VkDescriptorSetLayoutBinding> DescriptorSetLayout::get_layout_bi
 	return std::make_unique<VkDescriptorSetLayoutBinding>(it->second);
 }
 
+const VkDescriptorSetLayoutBinding *DescriptorSetLayout::find_layout_binding(const uint32_t binding_index) const
+{
+	auto it = bindings_lookup.find(binding_index);
+
+	if (it == bindings_lookup.end())
+	{
+		return nullptr;
+	}
+
+	return &it->second;
+}
+
+VkDescriptorUpdateTemplate DescriptorSetLayout::get_update_template() const
+{
+	return update_template;
+}
+
+const std::vector<DescriptorUpdateTemplateBinding> &DescriptorSetLayout::get_update_template_bindings() const
+{
+	return update_template_bindings;
+}
+
+uint32_t DescriptorSetLayout::get_update_template_info_count() const
+{
+	return update_template_info_count;
+}
+
 std::unique_ptr<VkDescriptorSetLayoutBinding> DescriptorSetLayout::get_layout_binding(const std::string &name) const
 {
 	auto it = resources_lookup.find(name);
@@ -28,6 +28,47 @@ class ShaderModule;
 
 struct ShaderResource;
 
+/**
+ * @brief A descriptor written through a descriptor update template, the template entries
+ *        of a DescriptorSetLayout read an array of them
+ */
+union DescriptorUpdateInfo
+{
+	VkDescriptorBufferInfo buffer_info;
+
+	VkDescriptorImageInfo image_info;
+};
+
+/**
+ * @brief A binding written by the update template of a DescriptorSetLayout
+ */
+struct DescriptorUpdateTemplateBinding
+{
+	uint32_t binding;
+
+	VkDescriptorType descriptor_type;
+
+	uint32_t descriptor_count;
+
+	/// Index of the first DescriptorUpdateInfo of the binding
+	uint32_t first_info;
+};
+
+/**
+ * @brief A binding of a DescriptorSetLayout created for descriptor buffers
+ */
+struct DescriptorBufferBinding
+{
+	uint32_t binding;
+
+	VkDescriptorType descriptor_type;
+
+	uint32_t descriptor_count;
+
+	/// Offset of the first descriptor of the binding in the descriptor buffer memory of a set
+	VkDeviceSize offset;
+};
+
 /**
  * @brief Caches DescriptorSet objects for the shader's set index.
  *        Creates a DescriptorPool to allocate the DescriptorSet objects
@@ -67,6 +108,34 @@ class DescriptorSetLayout
 
 	std::unique_ptr<VkDescriptorSetLayoutBinding> get_layout_binding(const std::string &name) const;
 
+	/**
+	 * @brief Looks up a binding without copying it
+	 * @return The binding, or nullptr if the layout has no such binding
+	 */
+	const VkDescriptorSetLayoutBinding *find_layout_binding(const uint32_t binding_index) const;
+
+	/**
+	 * @return A template writing every binding of the layout from an array of DescriptorUpdateInfo,
+	 *         or VK_NULL_HANDLE if templates are not supported or the layout has update-after-bind
+	 *         bindings or descriptor types the templates don't handle
+	 */
+	VkDescriptorUpdateTemplate get_update_template() const;
+
+	const std::vector<DescriptorUpdateTemplateBinding> &get_update_template_bindings() const;
+
+	/**
+	 * @return The number of DescriptorUpdateInfo the update template reads
+	 */
+	uint32_t get_update_template_info_count() const;
+
+	/**
+	 * @return The size of the descriptor buffer memory of a set with this layout,
+	 *         or 0 if the layout was not created for descriptor buffers
+	 */
+	VkDeviceSize get_descriptor_buffer_size() const;
+
+	const std::vector<DescriptorBufferBinding> &get_descriptor_buffer_bindings() const;
+
 	const std::vector<VkDescriptorBindingFlagsEXT> &get_binding_flags() const;
 
 	VkDescriptorBindingFlagsEXT get_layout_binding_flag(const uint32_t binding_index) const;
@@ -91,5 +160,19 @@ class DescriptorSetLayout
 	std::unordered_map<std::string, uint32_t> resources_lookup;
 
 	std::vector<ShaderModule *> shader_modules;
+
+	VkDescriptorUpdateTemplate update_template{VK_NULL_HANDLE};
+
+	std::vector<DescriptorUpdateTemplateBinding> update_template_bindings;
+
+	uint32_t update_template_info_count{0};
+
+	VkDeviceSize descriptor_buffer_size{0};
+
+	std::vector<DescriptorBufferBinding> descriptor_buffer_bindings;
+
+	void create_update_template();
+
+	void query_descriptor_buffer_layout();
 };
 }        // namespace vkb
@@ -183,6 +183,109 @@ Device::Device(PhysicalDevice &                       gpu,
 		throw VulkanException{result, "Cannot create device"};
 	}
 
+	// Descriptor buffers replace descriptor sets if they were requested and their features are enabled
+	if (gpu.has_descriptor_buffers() && is_enabled(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) && is_enabled(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME))
+	{
+		bool descriptor_buffer_feature     = false;
+		bool buffer_device_address_feature = false;
+
+		auto *feature = static_cast<const VkBaseInStructure *>(gpu.get_extension_feature_chain());
+		while (feature)
+		{
+			if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT)
+			{
+				descriptor_buffer_feature = reinterpret_cast<const VkPhysicalDeviceDescriptorBufferFeaturesEXT *>(feature)->descriptorBuffer == VK_TRUE;
+			}
+			else if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES)
+			{
+				buffer_device_address_feature = reinterpret_cast<const VkPhysicalDeviceBufferDeviceAddressFeatures *>(feature)->bufferDeviceAddress == VK_TRUE;
+			}
+			feature = feature->pNext;
+		}
+
+		if (descriptor_buffer_feature && buffer_device_address_feature)
+		{
+			VkPhysicalDeviceProperties2KHR device_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+			device_properties.pNext = &descriptor_buffer_properties;
+			vkGetPhysicalDeviceProperties2KHR(gpu.get_handle(), &device_properties);
+
+			descriptor_buffers = true;
+
+			LOGI("Descriptor buffers enabled");
+		}
+	}
+
+	// Pipeline states covered by the enabled extended dynamic state features are recorded as dynamic state
+	if (gpu.has_extended_dynamic_state())
+	{
+		auto *feature = static_cast<const VkBaseInStructure *>(gpu.get_extension_feature_chain());
+		while (feature)
+		{
+			if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT)
+			{
+				auto *features                                = reinterpret_cast<const VkPhysicalDeviceExtendedDynamicStateFeaturesEXT *>(feature);
+				extended_dynamic_state.extended_dynamic_state = is_enabled(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME) && features->extendedDynamicState;
+			}
+			else if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT)
+			{
+				auto *features                                 = reinterpret_cast<const VkPhysicalDeviceExtendedDynamicState2FeaturesEXT *>(feature);
+				extended_dynamic_state.extended_dynamic_state2 = is_enabled(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME) && features->extendedDynamicState2;
+			}
+			else if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT)
+			{
+				auto *features                     = reinterpret_cast<const VkPhysicalDeviceExtendedDynamicState3FeaturesEXT *>(feature);
+				extended_dynamic_state.color_blend = is_enabled(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME) &&
+				                                     features->extendedDynamicState3ColorBlendEnable &&
+				                                     features->extendedDynamicState3ColorBlendEquation &&
+				                                     features->extendedDynamicState3ColorWriteMask;
+			}
+			feature = feature->pNext;
+		}
+
+		LOGI("Extended dynamic state enabled: {}{}{}",
+		     extended_dynamic_state.extended_dynamic_state ? "rasterization and depth stencil, " : "",
+		     extended_dynamic_state.extended_dynamic_state2 ? "depth bias, primitive restart and rasterizer discard, " : "",
+		     extended_dynamic_state.color_blend ? "color blend" : "");
+	}
+
+	// Frames are paced with timeline semaphores if they were requested and their feature is enabled
+	if (gpu.has_timeline_semaphores() && is_enabled(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+	{
+		auto *feature = static_cast<const VkBaseInStructure *>(gpu.get_extension_feature_chain());
+		while (feature)
+		{
+			if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR)
+			{
+				timeline_semaphores = reinterpret_cast<const VkPhysicalDeviceTimelineSemaphoreFeaturesKHR *>(feature)->timelineSemaphore == VK_TRUE;
+			}
+			feature = feature->pNext;
+		}
+
+		if (timeline_semaphores)
+		{
+			LOGI("Timeline semaphores enabled");
+		}
+	}
+
+	// Render pipelines are recorded with dynamic rendering if it was requested and its feature is enabled
+	if (gpu.has_dynamic_rendering() && is_enabled(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
+	{
+		auto *feature = static_cast<const VkBaseInStructure *>(gpu.get_extension_feature_chain());
+		while (feature)
+		{
+			if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR)
+			{
+				dynamic_rendering = reinterpret_cast<const VkPhysicalDeviceDynamicRenderingFeaturesKHR *>(feature)->dynamicRendering == VK_TRUE;
+			}
+			feature = feature->pNext;
+		}
+
+		if (dynamic_rendering)
+		{
+			LOGI("Dynamic rendering enabled");
+		}
+	}
+
 	queues.resize(queue_family_properties_count);
 
 	for (uint32_t queue_family_index = 0U; queue_family_index < queue_family_properties_count; ++queue_family_index)
@@ -290,6 +393,31 @@ bool Device::is_enabled(const char *extension)
 	return std::find_if(enabled_extensions.begin(), enabled_extensions.end(), [extension](const char *enabled_extension) { return strcmp(extension, enabled_extension) == 0; }) != enabled_extensions.end();
 }
 
+bool Device::uses_descriptor_buffers() const
+{
+	return descriptor_buffers;
+}
+
+const VkPhysicalDeviceDescriptorBufferPropertiesEXT &Device::get_descriptor_buffer_properties() const
+{
+	return descriptor_buffer_properties;
+}
+
+const ExtendedDynamicState &Device::get_extended_dynamic_state() const
+{
+	return extended_dynamic_state;
+}
+
+bool Device::uses_timeline_semaphores() const
+{
+	return timeline_semaphores;
+}
+
+bool Device::uses_dynamic_rendering() const
+{
+	return dynamic_rendering;
+}
+
 const PhysicalDevice &Device::get_gpu() const
 {
 	return gpu;
@@ -132,6 +132,39 @@ class Device : public core::VulkanResource<VkDevice, VK_OBJECT_TYPE_DEVICE>
 
 	bool is_enabled(const char *extension);
 
+	/**
+	 * @brief Whether the framework writes descriptors to descriptor buffers instead of descriptor sets.
+	 *        Descriptor buffers are used if they were requested on the physical device, and VK_EXT_descriptor_buffer
+	 *        and VK_KHR_buffer_device_address are enabled along with the descriptorBuffer and bufferDeviceAddress features.
+	 */
+	bool uses_descriptor_buffers() const;
+
+	/**
+	 * @return The descriptor buffer properties of the GPU, only valid if descriptor buffers are used
+	 */
+	const VkPhysicalDeviceDescriptorBufferPropertiesEXT &get_descriptor_buffer_properties() const;
+
+	/**
+	 * @brief The pipeline states command buffers record as dynamic state. Extended dynamic state is used if it was
+	 *        requested on the physical device, for each of the VK_EXT_extended_dynamic_state extensions enabled along
+	 *        with its features.
+	 */
+	const ExtendedDynamicState &get_extended_dynamic_state() const;
+
+	/**
+	 * @brief Whether the RenderContext signals a timeline semaphore per queue to track the completion of frames,
+	 *        instead of a fence per submission. Timeline semaphores are used if they were requested on the physical
+	 *        device, and VK_KHR_timeline_semaphore is enabled along with the timelineSemaphore feature.
+	 */
+	bool uses_timeline_semaphores() const;
+
+	/**
+	 * @brief Whether command buffers begin dynamic rendering scopes instead of render passes for the subpasses of
+	 *        render pipelines. Dynamic rendering is used if it was requested on the physical device, and
+	 *        VK_KHR_dynamic_rendering is enabled along with the dynamicRendering feature.
+	 */
+	bool uses_dynamic_rendering() const;
+
 	uint32_t get_queue_family_index(VkQueueFlagBits queue_flag);
 
 	uint32_t get_num_queues_for_queue_family(uint32_t queue_family_index);
@@ -236,6 +269,16 @@ class Device : public core::VulkanResource<VkDevice, VK_OBJECT_TYPE_DEVICE>
 
 	std::vector<const char *> enabled_extensions{};
 
+	bool descriptor_buffers{false};
+
+	VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
+
+	ExtendedDynamicState extended_dynamic_state{};
+
+	bool timeline_semaphores{false};
+
+	bool dynamic_rendering{false};
+
 	VmaAllocator memory_allocator{VK_NULL_HANDLE};
 
 	std::vector<std::vector<Queue>> queues;
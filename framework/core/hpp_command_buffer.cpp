@@ -567,13 +567,15 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 	// Check if a descriptor set needs to be created
 	if (resource_binding_state.is_dirty() || !update_descriptor_sets.empty())
 	{
-		resource_binding_state.clear_dirty();
-
 		// Iterate over all of the resource sets bound by the command buffer
-		for (auto &resource_set_it : resource_binding_state.get_resource_sets())
+		for (uint32_t descriptor_set_id = 0; descriptor_set_id < vkb::max_resource_sets; ++descriptor_set_id)
 		{
-			uint32_t descriptor_set_id = resource_set_it.first;
-			auto    &resource_set      = resource_set_it.second;
+			if (!(resource_binding_state.get_bound_sets() & (1u << descriptor_set_id)))
+			{
+				continue;
+			}
+
+			auto &resource_set = resource_binding_state.get_resource_set(descriptor_set_id);
 
 			// Don't update resource set if it's not in the update list OR its state hasn't changed
 			if (!resource_set.is_dirty() && (update_descriptor_sets.find(descriptor_set_id) == update_descriptor_sets.end()))
@@ -601,19 +603,25 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 			std::vector<uint32_t> dynamic_offsets;
 
 			// Iterate over all resource bindings
-			for (auto &binding_it : resource_set.get_resource_bindings())
+			for (uint32_t binding_index = 0; binding_index < vkb::max_resource_bindings; ++binding_index)
 			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+				if (!(resource_set.get_bound_bindings() & (1u << binding_index)))
+				{
+					continue;
+				}
 
 				// Check if binding exists in the pipeline layout
 				if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
 				{
 					// Iterate over all binding resources
-					for (auto &element_it : binding_resources)
+					for (uint32_t array_element = 0; array_element < vkb::max_resource_array_elements; ++array_element)
 					{
-						auto  array_element = element_it.first;
-						auto &resource_info = element_it.second;
+						if (!(resource_set.get_bound_array_elements(binding_index) & (1u << array_element)))
+						{
+							continue;
+						}
+
+						auto &resource_info = resource_set.get_resource(binding_index, array_element);
 
 						// Pointer references
 						auto &buffer     = resource_info.buffer;
@@ -267,6 +267,11 @@ bool HPPDevice::is_enabled(std::string const &extension) const
 	                    [extension](const char *enabled_extension) { return extension == enabled_extension; }) != enabled_extensions.end();
 }
 
+bool HPPDevice::uses_descriptor_buffers() const
+{
+	return descriptor_buffers;
+}
+
 vkb::core::HPPPhysicalDevice const &HPPDevice::get_gpu() const
 {
 	return gpu;
@@ -22,6 +22,7 @@
 #include <core/hpp_physical_device.h>
 #include <core/hpp_queue.h>
 #include <core/hpp_vulkan_resource.h>
+#include <rendering/pipeline_state.h>
 #include <hpp_fence_pool.h>
 #include <hpp_resource_cache.h>
 #include <vulkan/vulkan.hpp>
@@ -83,6 +84,11 @@ class HPPDevice : public vkb::core::HPPVulkanResource<vk::Device>
 
 	bool is_enabled(std::string const &extension) const;
 
+	/**
+	 * @brief The vulkan.hpp framework always uses descriptor sets, see vkb::Device::uses_descriptor_buffers
+	 */
+	bool uses_descriptor_buffers() const;
+
 	uint32_t get_queue_family_index(vk::QueueFlagBits queue_flag) const;
 
 	vkb::core::HPPCommandPool &get_command_pool();
@@ -149,6 +155,20 @@ class HPPDevice : public vkb::core::HPPVulkanResource<vk::Device>
 
 	std::vector<const char *> enabled_extensions{};
 
+	// Mirrors vkb::Device, which the vulkan.hpp facades reinterpret this class as
+	bool descriptor_buffers{false};
+
+	vk::PhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties;
+
+	// The vulkan.hpp framework always bakes all states into its pipelines
+	vkb::ExtendedDynamicState extended_dynamic_state{};
+
+	// The vulkan.hpp framework always paces frames with fences
+	bool timeline_semaphores{false};
+
+	// The vulkan.hpp framework always begins render passes
+	bool dynamic_rendering{false};
+
 	VmaAllocator memory_allocator{VK_NULL_HANDLE};
 
 	std::vector<std::vector<vkb::core::HPPQueue>> queues;
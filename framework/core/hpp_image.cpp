@@ -39,6 +39,18 @@ inline vk::ImageType find_image_type(vk::Extent3D const &extent)
 			return vk::ImageType();
 	}
 }
+
+bool has_lazily_allocated_memory(vk::PhysicalDeviceMemoryProperties const &memory_properties)
+{
+	for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i)
+	{
+		if (memory_properties.memoryTypes[i].propertyFlags & vk::MemoryPropertyFlagBits::eLazilyAllocated)
+		{
+			return true;
+		}
+	}
+	return false;
+}
 }        // namespace
 
 namespace core
@@ -82,17 +94,33 @@ HPPImage::HPPImage(HPPDevice              &device,
 	VmaAllocationCreateInfo memory_info{};
 	memory_info.usage = memory_usage;
 
-	if (image_usage & vk::ImageUsageFlagBits::eTransientAttachment)
+	VkResult result = VK_ERROR_FEATURE_NOT_PRESENT;
+
+	// Transient attachments can live in lazily allocated memory, if the image supports it
+	if ((image_usage & vk::ImageUsageFlagBits::eTransientAttachment) && has_lazily_allocated_memory(device.get_gpu().get_memory_properties()))
 	{
-		memory_info.preferredFlags = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+		VmaAllocationCreateInfo lazy_memory_info{memory_info};
+		lazy_memory_info.requiredFlags = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+
+		result = vmaCreateImage(device.get_memory_allocator(),
+		                        reinterpret_cast<VkImageCreateInfo const *>(&image_info),
+		                        &lazy_memory_info,
+		                        const_cast<VkImage *>(reinterpret_cast<VkImage const *>(&get_handle())),
+		                        &memory,
+		                        nullptr);
+
+		lazily_allocated = result == VK_SUCCESS;
 	}
 
-	auto result = vmaCreateImage(device.get_memory_allocator(),
-	                             reinterpret_cast<VkImageCreateInfo const *>(&image_info),
-	                             &memory_info,
-	                             const_cast<VkImage *>(reinterpret_cast<VkImage const *>(&get_handle())),
-	                             &memory,
-	                             nullptr);
+	if (result != VK_SUCCESS)
+	{
+		result = vmaCreateImage(device.get_memory_allocator(),
+		                        reinterpret_cast<VkImageCreateInfo const *>(&image_info),
+		                        &memory_info,
+		                        const_cast<VkImage *>(reinterpret_cast<VkImage const *>(&get_handle())),
+		                        &memory,
+		                        nullptr);
+	}
 
 	if (result != VK_SUCCESS)
 	{
@@ -124,7 +152,8 @@ HPPImage::HPPImage(HPPImage &&other) :
     subresource(std::exchange(other.subresource, {})),
     views(std::exchange(other.views, {})),
     mapped_data(std::exchange(other.mapped_data, {})),
-    mapped(std::exchange(other.mapped, {}))
+    mapped(std::exchange(other.mapped, {})),
+    lazily_allocated(std::exchange(other.lazily_allocated, {}))
 {
 	// Update image views references to this image to avoid dangling pointers
 	for (auto &view : views)
@@ -211,6 +240,11 @@ uint32_t HPPImage::get_array_layer_count() const
 	return array_layer_count;
 }
 
+bool HPPImage::is_lazily_allocated() const
+{
+	return lazily_allocated;
+}
+
 std::unordered_set<vkb::core::HPPImageView *> &HPPImage::get_views()
 {
 	return views;
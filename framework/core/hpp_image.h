@@ -82,6 +82,7 @@ class HPPImage : public vkb::core::HPPVulkanResource<vk::Image>
 	vk::ImageTiling                                get_tiling() const;
 	vk::ImageSubresource                           get_subresource() const;
 	uint32_t                                       get_array_layer_count() const;
+	bool                                           is_lazily_allocated() const;
 	std::unordered_set<vkb::core::HPPImageView *> &get_views();
 
   private:
@@ -95,8 +96,9 @@ class HPPImage : public vkb::core::HPPVulkanResource<vk::Image>
 	vk::ImageSubresource                          subresource;
 	uint32_t                                      array_layer_count = 0;
 	std::unordered_set<vkb::core::HPPImageView *> views;        /// HPPImage views referring to this image
-	uint8_t                                      *mapped_data = nullptr;
-	bool                                          mapped      = false;        /// Whether it was mapped with vmaMapMemory
+	uint8_t                                      *mapped_data      = nullptr;
+	bool                                          mapped           = false;        /// Whether it was mapped with vmaMapMemory
+	bool                                          lazily_allocated = false;        /// Whether it is a transient attachment in lazily allocated memory
 };
 }        // namespace core
 }        // namespace vkb
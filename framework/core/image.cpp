@@ -63,6 +63,19 @@ inline VkImageType find_image_type(VkExtent3D extent)
 
 	return result;
 }
+
+bool has_lazily_allocated_memory(const VkPhysicalDeviceMemoryProperties &memory_properties)
+{
+	for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i)
+	{
+		if (memory_properties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
 }        // namespace
 
 namespace core
@@ -115,15 +128,31 @@ Image::Image(Device const         &device,
 	VmaAllocationCreateInfo memory_info{};
 	memory_info.usage = memory_usage;
 
-	if (image_usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+	VkResult result = VK_ERROR_FEATURE_NOT_PRESENT;
+
+	// Transient attachments are neither loaded nor stored, on tile-based GPUs they can live in
+	// lazily allocated memory which is never backed. Not every memory type of the image may be
+	// lazily allocated, in which case the image falls back to the requested memory usage.
+	if ((image_usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) && has_lazily_allocated_memory(device.get_gpu().get_memory_properties()))
 	{
-		memory_info.preferredFlags = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+		VmaAllocationCreateInfo lazy_memory_info{memory_info};
+		lazy_memory_info.requiredFlags = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+
+		result = vmaCreateImage(device.get_memory_allocator(),
+		                        &image_info, &lazy_memory_info,
+		                        &handle, &memory,
+		                        nullptr);
+
+		lazily_allocated = result == VK_SUCCESS;
 	}
 
-	auto result = vmaCreateImage(device.get_memory_allocator(),
-	                             &image_info, &memory_info,
-	                             &handle, &memory,
-	                             nullptr);
+	if (result != VK_SUCCESS)
+	{
+		result = vmaCreateImage(device.get_memory_allocator(),
+		                        &image_info, &memory_info,
+		                        &handle, &memory,
+		                        nullptr);
+	}
 
 	if (result != VK_SUCCESS)
 	{
@@ -155,7 +184,8 @@ Image::Image(Image &&other) :
     subresource{other.subresource},
     views(std::exchange(other.views, {})),
     mapped_data{other.mapped_data},
-    mapped{other.mapped}
+    mapped{other.mapped},
+    lazily_allocated{other.lazily_allocated}
 {
 	other.memory      = VK_NULL_HANDLE;
 	other.mapped_data = nullptr;
@@ -246,6 +276,11 @@ uint32_t Image::get_array_layer_count() const
 	return array_layer_count;
 }
 
+bool Image::is_lazily_allocated() const
+{
+	return lazily_allocated;
+}
+
 std::unordered_set<ImageView *> &Image::get_views()
 {
 	return views;
@@ -92,6 +92,11 @@ class Image : public VulkanResource<VkImage, VK_OBJECT_TYPE_IMAGE, const Device>
 
 	uint32_t get_array_layer_count() const;
 
+	/**
+	 * @return Whether the image is a transient attachment bound to lazily allocated memory
+	 */
+	bool is_lazily_allocated() const;
+
 	std::unordered_set<ImageView *> &get_views();
 
   private:
@@ -120,6 +125,8 @@ class Image : public VulkanResource<VkImage, VK_OBJECT_TYPE_IMAGE, const Device>
 
 	/// Whether it was mapped with vmaMapMemory
 	bool mapped{false};
+
+	bool lazily_allocated{false};
 };
 }        // namespace core
 }        // namespace vkb
@@ -148,6 +148,78 @@ class PhysicalDevice
 		return high_priority_graphics_queue;
 	}
 
+	/**
+	 * @brief Sets whether the logical device should write descriptors to descriptor buffers, if the
+	 *        VK_EXT_descriptor_buffer extension and its features are enabled.
+	 * @param enable If true, descriptor buffers replace descriptor sets.
+	 */
+	void set_descriptor_buffers_enable(bool enable)
+	{
+		descriptor_buffers = enable;
+	}
+
+	/**
+	 * @brief Returns whether descriptor buffers were requested.
+	 */
+	bool has_descriptor_buffers() const
+	{
+		return descriptor_buffers;
+	}
+
+	/**
+	 * @brief Sets whether the logical device should record the states of its pipelines covered by the
+	 *        enabled VK_EXT_extended_dynamic_state extensions as dynamic state.
+	 * @param enable If true, these states are left out of the pipelines.
+	 */
+	void set_extended_dynamic_state_enable(bool enable)
+	{
+		extended_dynamic_state = enable;
+	}
+
+	/**
+	 * @brief Returns whether extended dynamic state was requested.
+	 */
+	bool has_extended_dynamic_state() const
+	{
+		return extended_dynamic_state;
+	}
+
+	/**
+	 * @brief Sets whether the logical device should pace frames with VK_KHR_timeline_semaphore
+	 *        timelines instead of fences, if the extension and its feature are enabled.
+	 * @param enable If true, submissions signal a timeline semaphore per queue.
+	 */
+	void set_timeline_semaphores_enable(bool enable)
+	{
+		timeline_semaphores = enable;
+	}
+
+	/**
+	 * @brief Returns whether timeline semaphores were requested.
+	 */
+	bool has_timeline_semaphores() const
+	{
+		return timeline_semaphores;
+	}
+
+	/**
+	 * @brief Sets whether the logical device should begin VK_KHR_dynamic_rendering scopes in place of
+	 *        render passes and framebuffers, if the extension and its feature are enabled.
+	 * @param enable If true, render pipelines are recorded with dynamic rendering where possible.
+	 */
+	void set_dynamic_rendering_enable(bool enable)
+	{
+		dynamic_rendering = enable;
+	}
+
+	/**
+	 * @brief Returns whether dynamic rendering was requested.
+	 */
+	bool has_dynamic_rendering() const
+	{
+		return dynamic_rendering;
+	}
+
   private:
 	// Handle to the Vulkan instance
 	Instance &instance;
@@ -177,5 +249,13 @@ class PhysicalDevice
 	std::map<VkStructureType, std::shared_ptr<void>> extension_features;
 
 	bool high_priority_graphics_queue{};
+
+	bool descriptor_buffers{};
+
+	bool extended_dynamic_state{};
+
+	bool timeline_semaphores{};
+
+	bool dynamic_rendering{};
 };
 }        // namespace vkb
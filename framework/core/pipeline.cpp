@@ -112,6 +112,11 @@ ComputePipeline::ComputePipeline(Device &        device,
 	create_info.layout = pipeline_state.get_pipeline_layout().get_handle();
 	create_info.stage  = stage;
 
+	if (device.uses_descriptor_buffers())
+	{
+		create_info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
+
 	result = vkCreateComputePipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
 
 	if (result != VK_SUCCESS)
@@ -259,7 +264,7 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
 	color_blend_state.blendConstants[2] = 1.0f;
 	color_blend_state.blendConstants[3] = 1.0f;
 
-	std::array<VkDynamicState, 9> dynamic_states{
+	std::vector<VkDynamicState> dynamic_states{
 	    VK_DYNAMIC_STATE_VIEWPORT,
 	    VK_DYNAMIC_STATE_SCISSOR,
 	    VK_DYNAMIC_STATE_LINE_WIDTH,
@@ -271,6 +276,35 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
 	    VK_DYNAMIC_STATE_STENCIL_REFERENCE,
 	};
 
+	// States recorded as extended dynamic state by the command buffer, they are not part of the pipeline state hash
+	const auto &extended_dynamic_state = pipeline_state.get_extended_dynamic_state();
+
+	if (extended_dynamic_state.extended_dynamic_state)
+	{
+		dynamic_states.insert(dynamic_states.end(), {VK_DYNAMIC_STATE_CULL_MODE_EXT,
+		                                             VK_DYNAMIC_STATE_FRONT_FACE_EXT,
+		                                             VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT,
+		                                             VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT,
+		                                             VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT,
+		                                             VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT,
+		                                             VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT,
+		                                             VK_DYNAMIC_STATE_STENCIL_OP_EXT});
+	}
+
+	if (extended_dynamic_state.extended_dynamic_state2)
+	{
+		dynamic_states.insert(dynamic_states.end(), {VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT,
+		                                             VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT,
+		                                             VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT});
+	}
+
+	if (extended_dynamic_state.color_blend && color_blend_state.attachmentCount > 0)
+	{
+		dynamic_states.insert(dynamic_states.end(), {VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT,
+		                                             VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT,
+		                                             VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT});
+	}
+
 	VkPipelineDynamicStateCreateInfo dynamic_state{VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO};
 
 	dynamic_state.pDynamicStates    = dynamic_states.data();
@@ -285,9 +319,32 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
 	create_info.pColorBlendState    = &color_blend_state;
 	create_info.pDynamicState       = &dynamic_state;
 
-	create_info.layout     = pipeline_state.get_pipeline_layout().get_handle();
-	create_info.renderPass = pipeline_state.get_render_pass()->get_handle();
-	create_info.subpass    = pipeline_state.get_subpass_index();
+	create_info.layout = pipeline_state.get_pipeline_layout().get_handle();
+
+	// Pipelines of dynamic rendering scopes are created with the formats of their attachments instead of a render pass
+	VkPipelineRenderingCreateInfoKHR rendering_info{VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR};
+
+	if (auto render_pass = pipeline_state.get_render_pass())
+	{
+		create_info.renderPass = render_pass->get_handle();
+		create_info.subpass    = pipeline_state.get_subpass_index();
+	}
+	else
+	{
+		const auto &rendering_state = pipeline_state.get_rendering_state();
+
+		rendering_info.colorAttachmentCount    = to_u32(rendering_state.color_attachment_formats.size());
+		rendering_info.pColorAttachmentFormats = rendering_state.color_attachment_formats.data();
+		rendering_info.depthAttachmentFormat   = rendering_state.depth_attachment_format;
+		rendering_info.stencilAttachmentFormat = rendering_state.stencil_attachment_format;
+
+		create_info.pNext = &rendering_info;
+	}
+
+	if (device.uses_descriptor_buffers())
+	{
+		create_info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
 
 	auto result = vkCreateGraphicsPipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
 
@@ -19,6 +19,7 @@
 
 #include <numeric>
 
+#include "common/logging.h"
 #include "device.h"
 #include "rendering/render_target.h"
 
@@ -129,6 +130,12 @@ std::vector<T> get_attachment_descriptions(const std::vector<Attachment> &attach
 			attachment.storeOp        = load_store_infos[i].store_op;
 			attachment.stencilLoadOp  = load_store_infos[i].load_op;
 			attachment.stencilStoreOp = load_store_infos[i].store_op;
+
+			// Loading or storing a transient attachment forces it out of tile memory
+			if (attachments[i].transient && (attachment.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD || attachment.storeOp == VK_ATTACHMENT_STORE_OP_STORE))
+			{
+				LOGW("Transient attachment {} is loaded or stored, use clear or don't care operations instead", i);
+			}
 		}
 
 		attachment_descriptions.push_back(std::move(attachment));
@@ -0,0 +1,482 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace vkb
+{
+namespace mesh_optimizer
+{
+namespace
+{
+/// Size of the LRU cache modelled when scoring vertices, larger than typical FIFO caches on purpose
+constexpr uint32_t score_cache_size = 32;
+
+float vertex_score(int32_t cache_position, uint32_t live_triangles)
+{
+	if (live_triangles == 0)
+	{
+		// No triangle left to emit with this vertex
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+
+	if (cache_position >= 0)
+	{
+		if (cache_position < 3)
+		{
+			// Vertices of the last triangle get a fixed score so that its neighbours are not favoured over a fan
+			score = 0.75f;
+		}
+		else
+		{
+			float scaler = 1.0f / (score_cache_size - 3);
+			score        = std::pow(1.0f - (cache_position - 3) * scaler, 1.5f);
+		}
+	}
+
+	// Boost vertices with few triangles left, so that isolated triangles are not left behind
+	score += 2.0f * std::pow(static_cast<float>(live_triangles), -0.5f);
+
+	return score;
+}
+
+/**
+ * @brief Minimal FIFO cache simulation, matching the behaviour of most post-transform caches
+ */
+class FifoCache
+{
+  public:
+	FifoCache(size_t vertex_count, uint32_t cache_size) :
+	    timestamps(vertex_count, 0),
+	    cache_size{cache_size},
+	    time{cache_size + 1}
+	{
+	}
+
+	/**
+	 * @return Whether the vertex had to be transformed
+	 */
+	bool access(uint32_t vertex)
+	{
+		if (time - timestamps[vertex] > cache_size)
+		{
+			timestamps[vertex] = time++;
+			return true;
+		}
+
+		return false;
+	}
+
+	uint32_t triangle_misses(const uint32_t *triangle)
+	{
+		return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+	}
+
+	void reset()
+	{
+		// Moving the clock past the cache size evicts every vertex
+		time += cache_size + 1;
+	}
+
+  private:
+	std::vector<uint32_t> timestamps;
+
+	uint32_t cache_size;
+
+	uint32_t time;
+};
+}        // namespace
+
+float analyze_vertex_cache(const std::vector<uint32_t> &indices, size_t vertex_count, uint32_t cache_size)
+{
+	if (indices.size() < 3)
+	{
+		return 0.0f;
+	}
+
+	FifoCache cache{vertex_count, cache_size};
+
+	size_t misses = 0;
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		misses += cache.triangle_misses(&indices[i]);
+	}
+
+	return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+std::vector<uint32_t> optimize_vertex_cache(const std::vector<uint32_t> &indices, size_t vertex_count)
+{
+	assert(indices.size() % 3 == 0 && "Index count must be a multiple of 3");
+
+	size_t triangle_count = indices.size() / 3;
+
+	// Triangles adjacent to each vertex, the first live_triangles[v] entries of a range are not emitted yet
+	std::vector<uint32_t> live_triangles(vertex_count, 0);
+	std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+	std::vector<uint32_t> adjacency(indices.size());
+
+	for (auto index : indices)
+	{
+		live_triangles[index]++;
+	}
+
+	for (size_t v = 0; v < vertex_count; ++v)
+	{
+		adjacency_offsets[v + 1] = adjacency_offsets[v] + live_triangles[v];
+	}
+
+	{
+		std::vector<uint32_t> fill_offsets(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			adjacency[fill_offsets[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	std::vector<int32_t> cache_positions(vertex_count, -1);
+	std::vector<float>   vertex_scores(vertex_count);
+
+	for (size_t v = 0; v < vertex_count; ++v)
+	{
+		vertex_scores[v] = vertex_score(-1, live_triangles[v]);
+	}
+
+	std::vector<float> triangle_scores(triangle_count);
+	std::vector<bool>  emitted(triangle_count, false);
+
+	int64_t best_triangle = -1;
+	float   best_score    = -1.0f;
+
+	for (size_t t = 0; t < triangle_count; ++t)
+	{
+		triangle_scores[t] = vertex_scores[indices[t * 3]] + vertex_scores[indices[t * 3 + 1]] + vertex_scores[indices[t * 3 + 2]];
+
+		if (triangle_scores[t] > best_score)
+		{
+			best_score    = triangle_scores[t];
+			best_triangle = static_cast<int64_t>(t);
+		}
+	}
+
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> new_cache;
+	cache.reserve(score_cache_size + 3);
+	new_cache.reserve(score_cache_size + 3);
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	size_t input_cursor = 0;
+
+	while (best_triangle >= 0)
+	{
+		auto triangle = static_cast<size_t>(best_triangle);
+
+		const uint32_t *triangle_indices = &indices[triangle * 3];
+
+		result.insert(result.end(), triangle_indices, triangle_indices + 3);
+		emitted[triangle] = true;
+
+		// Remove the triangle from the adjacency of its vertices
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			uint32_t vertex = triangle_indices[corner];
+
+			uint32_t *begin = &adjacency[adjacency_offsets[vertex]];
+			uint32_t *end   = begin + live_triangles[vertex];
+			uint32_t *it    = std::find(begin, end, static_cast<uint32_t>(triangle));
+
+			if (it != end)
+			{
+				std::swap(*it, *(end - 1));
+				live_triangles[vertex]--;
+			}
+		}
+
+		// Move the vertices of the triangle to the front of the cache
+		new_cache.assign(triangle_indices, triangle_indices + 3);
+
+		for (auto vertex : cache)
+		{
+			if (vertex != triangle_indices[0] && vertex != triangle_indices[1] && vertex != triangle_indices[2])
+			{
+				new_cache.push_back(vertex);
+			}
+		}
+
+		for (size_t i = 0; i < new_cache.size(); ++i)
+		{
+			uint32_t vertex = new_cache[i];
+
+			cache_positions[vertex] = i < score_cache_size ? static_cast<int32_t>(i) : -1;
+			vertex_scores[vertex]   = vertex_score(cache_positions[vertex], live_triangles[vertex]);
+		}
+
+		// Only triangles around cached vertices changed score, so the next triangle is searched among them
+		best_triangle = -1;
+		best_score    = -1.0f;
+
+		for (auto vertex : new_cache)
+		{
+			for (uint32_t i = 0; i < live_triangles[vertex]; ++i)
+			{
+				uint32_t adjacent = adjacency[adjacency_offsets[vertex] + i];
+
+				const uint32_t *adjacent_indices = &indices[adjacent * 3];
+
+				triangle_scores[adjacent] = vertex_scores[adjacent_indices[0]] + vertex_scores[adjacent_indices[1]] + vertex_scores[adjacent_indices[2]];
+
+				if (cache_positions[vertex] >= 0 && triangle_scores[adjacent] > best_score)
+				{
+					best_score    = triangle_scores[adjacent];
+					best_triangle = adjacent;
+				}
+			}
+		}
+
+		if (new_cache.size() > score_cache_size)
+		{
+			new_cache.resize(score_cache_size);
+		}
+
+		std::swap(cache, new_cache);
+
+		if (best_triangle < 0)
+		{
+			// Dead end, continue with the next triangle in input order
+			while (input_cursor < triangle_count && emitted[input_cursor])
+			{
+				input_cursor++;
+			}
+
+			if (input_cursor < triangle_count)
+			{
+				best_triangle = static_cast<int64_t>(input_cursor);
+			}
+		}
+	}
+
+	return result;
+}
+
+std::vector<uint32_t> optimize_overdraw(const std::vector<uint32_t> &indices, const std::vector<glm::vec3> &positions, float threshold)
+{
+	assert(indices.size() % 3 == 0 && "Index count must be a multiple of 3");
+
+	size_t triangle_count = indices.size() / 3;
+
+	if (triangle_count == 0)
+	{
+		return indices;
+	}
+
+	const uint32_t cache_size = 16;
+
+	FifoCache cache{positions.size(), cache_size};
+
+	// A triangle with all of its vertices missing the cache starts a hard cluster, reordering
+	// at these points does not change the number of transformed vertices
+	std::vector<size_t> hard_clusters;
+
+	for (size_t t = 0; t < triangle_count; ++t)
+	{
+		if (cache.triangle_misses(&indices[t * 3]) == 3 || t == 0)
+		{
+			hard_clusters.push_back(t);
+		}
+	}
+
+	hard_clusters.push_back(triangle_count);
+
+	// Split hard clusters further while their ACMR, starting from a cold cache, stays within the threshold
+	std::vector<size_t> clusters;
+
+	for (size_t c = 0; c + 1 < hard_clusters.size(); ++c)
+	{
+		size_t begin = hard_clusters[c];
+		size_t end   = hard_clusters[c + 1];
+
+		cache.reset();
+
+		size_t cluster_misses = 0;
+
+		for (size_t t = begin; t < end; ++t)
+		{
+			cluster_misses += cache.triangle_misses(&indices[t * 3]);
+		}
+
+		float cluster_threshold = threshold * static_cast<float>(cluster_misses) / static_cast<float>(end - begin);
+
+		cache.reset();
+
+		clusters.push_back(begin);
+
+		size_t running_misses    = 0;
+		size_t running_triangles = 0;
+
+		for (size_t t = begin; t < end; ++t)
+		{
+			running_misses += cache.triangle_misses(&indices[t * 3]);
+			running_triangles++;
+
+			if (t + 1 < end && static_cast<float>(running_misses) <= cluster_threshold * static_cast<float>(running_triangles))
+			{
+				clusters.push_back(t + 1);
+
+				cache.reset();
+
+				running_misses    = 0;
+				running_triangles = 0;
+			}
+		}
+	}
+
+	clusters.push_back(triangle_count);
+
+	size_t cluster_count = clusters.size() - 1;
+
+	// Area weighted centroid and normal of each cluster, and the centroid of the whole mesh
+	std::vector<glm::vec3> cluster_centroids(cluster_count, glm::vec3(0.0f));
+	std::vector<glm::vec3> cluster_normals(cluster_count, glm::vec3(0.0f));
+
+	glm::vec3 mesh_centroid(0.0f);
+	float     mesh_area = 0.0f;
+
+	for (size_t c = 0; c < cluster_count; ++c)
+	{
+		float cluster_area = 0.0f;
+
+		for (size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+		{
+			const glm::vec3 &p0 = positions[indices[t * 3 + 0]];
+			const glm::vec3 &p1 = positions[indices[t * 3 + 1]];
+			const glm::vec3 &p2 = positions[indices[t * 3 + 2]];
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float     area   = glm::length(normal);
+
+			cluster_centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+			cluster_normals[c] += normal;
+			cluster_area += area;
+		}
+
+		mesh_centroid += cluster_centroids[c];
+		mesh_area += cluster_area;
+
+		if (cluster_area > 0.0f)
+		{
+			cluster_centroids[c] /= cluster_area;
+		}
+
+		float normal_length = glm::length(cluster_normals[c]);
+		if (normal_length > 0.0f)
+		{
+			cluster_normals[c] /= normal_length;
+		}
+	}
+
+	if (mesh_area > 0.0f)
+	{
+		mesh_centroid /= mesh_area;
+	}
+
+	// Clusters facing away from the center are more likely to occlude the others, so they are drawn first
+	std::vector<float>  cluster_sort_keys(cluster_count);
+	std::vector<size_t> cluster_order(cluster_count);
+
+	for (size_t c = 0; c < cluster_count; ++c)
+	{
+		cluster_sort_keys[c] = glm::dot(cluster_centroids[c] - mesh_centroid, cluster_normals[c]);
+		cluster_order[c]     = c;
+	}
+
+	std::stable_sort(cluster_order.begin(), cluster_order.end(), [&cluster_sort_keys](size_t a, size_t b) {
+		return cluster_sort_keys[a] > cluster_sort_keys[b];
+	});
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	for (auto c : cluster_order)
+	{
+		result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+	}
+
+	return result;
+}
+
+std::vector<uint32_t> optimize_vertex_fetch(std::vector<uint32_t> &indices, size_t vertex_count)
+{
+	const uint32_t unused = std::numeric_limits<uint32_t>::max();
+
+	std::vector<uint32_t> new_indices(vertex_count, unused);
+
+	uint32_t next_vertex = 0;
+
+	for (auto &index : indices)
+	{
+		if (new_indices[index] == unused)
+		{
+			new_indices[index] = next_vertex++;
+		}
+
+		index = new_indices[index];
+	}
+
+	for (auto &new_index : new_indices)
+	{
+		if (new_index == unused)
+		{
+			new_index = next_vertex++;
+		}
+	}
+
+	std::vector<uint32_t> remap(vertex_count);
+
+	for (uint32_t old_index = 0; old_index < vertex_count; ++old_index)
+	{
+		remap[new_indices[old_index]] = old_index;
+	}
+
+	return remap;
+}
+
+std::vector<uint8_t> remap_vertex_data(const std::vector<uint8_t> &data, size_t stride, const std::vector<uint32_t> &remap)
+{
+	assert(data.size() >= remap.size() * stride && "Vertex data is smaller than the remap table");
+
+	std::vector<uint8_t> result(data.size());
+
+	for (size_t i = 0; i < remap.size(); ++i)
+	{
+		std::memcpy(result.data() + i * stride, data.data() + remap[i] * stride, stride);
+	}
+
+	return result;
+}
+}        // namespace mesh_optimizer
+}        // namespace vkb
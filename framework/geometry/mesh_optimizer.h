@@ -0,0 +1,87 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/error.h"
+
+VKBP_DISABLE_WARNINGS()
+#include "common/glm_common.h"
+VKBP_ENABLE_WARNINGS()
+
+namespace vkb
+{
+/**
+ * @brief Reorders indexed triangle lists and their vertices for more efficient rendering.
+ *
+ * The passes are meant to be run in order: vertex cache optimization, then overdraw
+ * optimization (which keeps most of the cache efficiency), then vertex fetch optimization.
+ * None of them change the rendered result.
+ */
+namespace mesh_optimizer
+{
+/**
+ * @brief Simulates a FIFO post-transform vertex cache
+ * @param indices Triangle list
+ * @param vertex_count Number of vertices referenced by the indices
+ * @param cache_size Number of entries in the simulated cache
+ * @return The average cache miss ratio (ACMR), i.e. transformed vertices per triangle
+ */
+float analyze_vertex_cache(const std::vector<uint32_t> &indices, size_t vertex_count, uint32_t cache_size = 16);
+
+/**
+ * @brief Reorders triangles to improve post-transform vertex cache hits, following
+ *        Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+ * @param indices Triangle list
+ * @param vertex_count Number of vertices referenced by the indices
+ * @return The reordered triangle list
+ */
+std::vector<uint32_t> optimize_vertex_cache(const std::vector<uint32_t> &indices, size_t vertex_count);
+
+/**
+ * @brief Reorders clusters of a cache optimized triangle list so that outward facing clusters
+ *        are drawn first, following Sander et al. "Fast Triangle Reordering for Vertex Locality
+ *        and Reduced Overdraw"
+ * @param indices Triangle list, previously ordered by optimize_vertex_cache()
+ * @param positions Vertex positions referenced by the indices
+ * @param threshold How much the ACMR of each cluster may grow to allow splitting it into smaller clusters
+ * @return The reordered triangle list
+ */
+std::vector<uint32_t> optimize_overdraw(const std::vector<uint32_t> &indices, const std::vector<glm::vec3> &positions, float threshold = 1.05f);
+
+/**
+ * @brief Renumbers vertices in the order they are first referenced, to improve vertex fetch locality
+ * @param indices Triangle list, rewritten to reference the new vertex order
+ * @param vertex_count Number of vertices referenced by the indices
+ * @return For each new vertex, the index of the old vertex it is copied from. Unreferenced
+ *         vertices are kept at the end so the vertex count does not change.
+ */
+std::vector<uint32_t> optimize_vertex_fetch(std::vector<uint32_t> &indices, size_t vertex_count);
+
+/**
+ * @brief Reorders the elements of a vertex stream according to a remap table
+ * @param data Vertex data, with elements of stride bytes
+ * @param stride Size of an element
+ * @param remap Table returned by optimize_vertex_fetch()
+ * @return The reordered vertex data
+ */
+std::vector<uint8_t> remap_vertex_data(const std::vector<uint8_t> &data, size_t stride, const std::vector<uint32_t> &remap);
+}        // namespace mesh_optimizer
+}        // namespace vkb
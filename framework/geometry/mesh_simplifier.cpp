@@ -0,0 +1,352 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mesh_simplifier.h"
+
+#include <algorithm>
+#include <array>
+#include <queue>
+#include <unordered_map>
+
+namespace vkb
+{
+namespace
+{
+/**
+ * @brief Symmetric 4x4 error quadric, stored as its upper triangle, together with
+ *        the accumulated area of the planes it was built from
+ */
+struct Quadric
+{
+	std::array<double, 10> m{};
+
+	double weight{0.0};
+
+	void add_plane(const glm::dvec3 &normal, double distance, double area)
+	{
+		m[0] += area * normal.x * normal.x;
+		m[1] += area * normal.x * normal.y;
+		m[2] += area * normal.x * normal.z;
+		m[3] += area * normal.x * distance;
+		m[4] += area * normal.y * normal.y;
+		m[5] += area * normal.y * normal.z;
+		m[6] += area * normal.y * distance;
+		m[7] += area * normal.z * normal.z;
+		m[8] += area * normal.z * distance;
+		m[9] += area * distance * distance;
+
+		weight += area;
+	}
+
+	void add(const Quadric &other)
+	{
+		for (size_t i = 0; i < m.size(); ++i)
+		{
+			m[i] += other.m[i];
+		}
+
+		weight += other.weight;
+	}
+
+	/**
+	 * @return The mean squared distance of a point to the planes of the quadric
+	 */
+	double evaluate(const glm::vec3 &point) const
+	{
+		double x = point.x;
+		double y = point.y;
+		double z = point.z;
+
+		double error = m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x +
+		               m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y +
+		               m[7] * z * z + 2.0 * m[8] * z +
+		               m[9];
+
+		return weight > 0.0 ? std::abs(error) / weight : 0.0;
+	}
+};
+
+struct Collapse
+{
+	double cost;
+
+	uint32_t from;
+
+	uint32_t to;
+
+	uint32_t from_version;
+
+	uint32_t to_version;
+
+	bool operator>(const Collapse &other) const
+	{
+		return cost > other.cost;
+	}
+};
+
+inline uint64_t edge_key(uint32_t a, uint32_t b)
+{
+	return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+}
+}        // namespace
+
+MeshSimplifier::MeshSimplifier(const std::vector<glm::vec3> &positions) :
+    positions{positions}
+{
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(const std::vector<uint32_t> &indices, size_t target_index_count, float target_error)
+{
+	assert(indices.size() % 3 == 0 && "Index count must be a multiple of 3");
+
+	result_error = 0.0f;
+
+	std::vector<uint32_t> triangles = indices;
+
+	size_t triangle_count = triangles.size() / 3;
+
+	std::vector<bool> triangle_alive(triangle_count, true);
+
+	std::vector<Quadric> quadrics(positions.size());
+
+	std::vector<std::vector<uint32_t>> vertex_triangles(positions.size());
+
+	std::unordered_map<uint64_t, uint32_t> edge_use_count;
+
+	for (uint32_t t = 0; t < triangle_count; ++t)
+	{
+		uint32_t i0 = triangles[t * 3 + 0];
+		uint32_t i1 = triangles[t * 3 + 1];
+		uint32_t i2 = triangles[t * 3 + 2];
+
+		glm::dvec3 p0 = positions[i0];
+		glm::dvec3 p1 = positions[i1];
+		glm::dvec3 p2 = positions[i2];
+
+		glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+		double     length = glm::length(normal);
+
+		if (length > 0.0)
+		{
+			normal /= length;
+
+			double area     = length * 0.5;
+			double distance = -glm::dot(normal, p0);
+
+			quadrics[i0].add_plane(normal, distance, area);
+			quadrics[i1].add_plane(normal, distance, area);
+			quadrics[i2].add_plane(normal, distance, area);
+		}
+
+		vertex_triangles[i0].push_back(t);
+		vertex_triangles[i1].push_back(t);
+		vertex_triangles[i2].push_back(t);
+
+		edge_use_count[edge_key(i0, i1)]++;
+		edge_use_count[edge_key(i1, i2)]++;
+		edge_use_count[edge_key(i2, i0)]++;
+	}
+
+	// Vertices on an edge used by a single triangle lie on a border or an attribute seam
+	std::vector<bool> locked(positions.size(), false);
+
+	for (auto &edge : edge_use_count)
+	{
+		if (edge.second == 1)
+		{
+			locked[static_cast<uint32_t>(edge.first >> 32)]         = true;
+			locked[static_cast<uint32_t>(edge.first & 0xffffffff)] = true;
+		}
+	}
+
+	std::vector<uint32_t> versions(positions.size(), 0);
+
+	std::vector<bool> removed(positions.size(), false);
+
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+
+	auto push_collapse = [&](uint32_t from, uint32_t to) {
+		if (locked[from] || from == to)
+		{
+			return;
+		}
+
+		Quadric quadric = quadrics[from];
+		quadric.add(quadrics[to]);
+
+		collapses.push({quadric.evaluate(positions[to]), from, to, versions[from], versions[to]});
+	};
+
+	auto push_vertex_edges = [&](uint32_t vertex) {
+		for (auto t : vertex_triangles[vertex])
+		{
+			if (!triangle_alive[t])
+			{
+				continue;
+			}
+
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				uint32_t other = triangles[t * 3 + corner];
+
+				if (other != vertex)
+				{
+					push_collapse(vertex, other);
+					push_collapse(other, vertex);
+				}
+			}
+		}
+	};
+
+	for (uint32_t t = 0; t < triangle_count; ++t)
+	{
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			uint32_t a = triangles[t * 3 + corner];
+			uint32_t b = triangles[t * 3 + (corner + 1) % 3];
+
+			push_collapse(a, b);
+			push_collapse(b, a);
+		}
+	}
+
+	// Rejects collapses that would flip the facing of a triangle around the moved vertex
+	auto collapse_flips_triangles = [&](uint32_t from, uint32_t to) {
+		const glm::vec3 &target = positions[to];
+
+		for (auto t : vertex_triangles[from])
+		{
+			if (!triangle_alive[t])
+			{
+				continue;
+			}
+
+			uint32_t *triangle = &triangles[t * 3];
+
+			if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+			{
+				// Triangle becomes degenerate and is removed
+				continue;
+			}
+
+			glm::vec3 p[3];
+			glm::vec3 q[3];
+
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				p[corner] = positions[triangle[corner]];
+				q[corner] = triangle[corner] == from ? target : p[corner];
+			}
+
+			glm::vec3 normal_before = glm::cross(p[1] - p[0], p[2] - p[0]);
+			glm::vec3 normal_after  = glm::cross(q[1] - q[0], q[2] - q[0]);
+
+			if (glm::dot(normal_before, normal_after) <= 0.0f)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	};
+
+	size_t index_count = triangles.size();
+
+	double max_error      = 0.0;
+	double target_error_2 = static_cast<double>(target_error) * static_cast<double>(target_error);
+
+	while (index_count > target_index_count && !collapses.empty())
+	{
+		Collapse collapse = collapses.top();
+		collapses.pop();
+
+		if (removed[collapse.from] || removed[collapse.to] ||
+		    versions[collapse.from] != collapse.from_version || versions[collapse.to] != collapse.to_version)
+		{
+			// Stale entry, a fresh one was queued when the vertices changed
+			continue;
+		}
+
+		if (collapse.cost > target_error_2)
+		{
+			break;
+		}
+
+		if (collapse_flips_triangles(collapse.from, collapse.to))
+		{
+			continue;
+		}
+
+		for (auto t : vertex_triangles[collapse.from])
+		{
+			if (!triangle_alive[t])
+			{
+				continue;
+			}
+
+			uint32_t *triangle = &triangles[t * 3];
+
+			if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+			{
+				triangle_alive[t] = false;
+				index_count -= 3;
+				continue;
+			}
+
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				if (triangle[corner] == collapse.from)
+				{
+					triangle[corner] = collapse.to;
+				}
+			}
+
+			vertex_triangles[collapse.to].push_back(t);
+		}
+
+		vertex_triangles[collapse.from].clear();
+		removed[collapse.from] = true;
+
+		quadrics[collapse.to].add(quadrics[collapse.from]);
+		versions[collapse.to]++;
+
+		max_error = std::max(max_error, collapse.cost);
+
+		push_vertex_edges(collapse.to);
+	}
+
+	std::vector<uint32_t> result;
+	result.reserve(index_count);
+
+	for (uint32_t t = 0; t < triangle_count; ++t)
+	{
+		if (triangle_alive[t])
+		{
+			result.insert(result.end(), triangles.begin() + t * 3, triangles.begin() + t * 3 + 3);
+		}
+	}
+
+	result_error = static_cast<float>(std::sqrt(max_error));
+
+	return result;
+}
+
+float MeshSimplifier::get_result_error() const
+{
+	return result_error;
+}
+}        // namespace vkb
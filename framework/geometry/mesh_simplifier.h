@@ -0,0 +1,69 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "common/error.h"
+
+VKBP_DISABLE_WARNINGS()
+#include "common/glm_common.h"
+VKBP_ENABLE_WARNINGS()
+
+namespace vkb
+{
+/**
+ * @brief Reduces the triangle count of an indexed triangle list using quadric error metrics.
+ *
+ * Edges are collapsed in order of increasing quadric error. A vertex is always collapsed onto
+ * one of its neighbours, so the result only references existing vertices and can share the
+ * vertex buffers of the source mesh. Vertices on open borders (including attribute seams) are
+ * never moved, which keeps the silhouette and texture seams intact.
+ */
+class MeshSimplifier
+{
+  public:
+	/**
+	 * @brief Constructs a simplifier for a set of vertex positions
+	 * @param positions The vertex positions, referenced by the indices passed to simplify()
+	 */
+	explicit MeshSimplifier(const std::vector<glm::vec3> &positions);
+
+	/**
+	 * @brief Simplifies a triangle list
+	 * @param indices Triangle list indexing the positions given on construction
+	 * @param target_index_count Simplification stops once the result has this many indices or fewer
+	 * @param target_error Simplification stops before a collapse would exceed this object space error
+	 * @return The simplified triangle list, which may be larger than the target if the error limit was hit
+	 */
+	std::vector<uint32_t> simplify(const std::vector<uint32_t> &indices, size_t target_index_count, float target_error = std::numeric_limits<float>::max());
+
+	/**
+	 * @return The object space error of the last simplify() result, measured as the
+	 *         root mean square distance of a collapsed vertex to its original planes
+	 */
+	float get_result_error() const;
+
+  private:
+	const std::vector<glm::vec3> &positions;
+
+	float result_error{0.0f};
+};
+}        // namespace vkb
@@ -0,0 +1,164 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "meshlet_builder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace vkb
+{
+namespace
+{
+void compute_meshlet_bounds(Meshlet &meshlet, const MeshletData &data, const std::vector<glm::vec3> &positions)
+{
+	glm::vec3 min(std::numeric_limits<float>::max());
+	glm::vec3 max(std::numeric_limits<float>::lowest());
+
+	for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+	{
+		const glm::vec3 &position = positions[data.vertices[meshlet.vertex_offset + i]];
+
+		min = glm::min(min, position);
+		max = glm::max(max, position);
+	}
+
+	glm::vec3 center = (min + max) * 0.5f;
+	float     radius = 0.0f;
+
+	for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+	{
+		radius = std::max(radius, glm::length(positions[data.vertices[meshlet.vertex_offset + i]] - center));
+	}
+
+	meshlet.bounding_sphere = glm::vec4(center, radius);
+
+	// The cone axis is the average triangle normal, its spread the largest angle to any of them
+	std::vector<glm::vec3> normals;
+	normals.reserve(meshlet.triangle_count);
+
+	glm::vec3 axis(0.0f);
+
+	for (uint32_t i = 0; i < meshlet.triangle_count; ++i)
+	{
+		uint32_t triangle = data.triangles[meshlet.triangle_offset + i];
+
+		const glm::vec3 &p0 = positions[data.vertices[meshlet.vertex_offset + (triangle & 0xff)]];
+		const glm::vec3 &p1 = positions[data.vertices[meshlet.vertex_offset + ((triangle >> 8) & 0xff)]];
+		const glm::vec3 &p2 = positions[data.vertices[meshlet.vertex_offset + ((triangle >> 16) & 0xff)]];
+
+		glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+		float     length = glm::length(normal);
+
+		if (length > 0.0f)
+		{
+			normals.push_back(normal / length);
+			axis += normals.back();
+		}
+	}
+
+	float axis_length = glm::length(axis);
+
+	if (axis_length == 0.0f)
+	{
+		meshlet.normal_cone = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		return;
+	}
+
+	axis /= axis_length;
+
+	float min_dot = 1.0f;
+
+	for (auto &normal : normals)
+	{
+		min_dot = std::min(min_dot, glm::dot(axis, normal));
+	}
+
+	// Cones wider than about 84 degrees are hardly ever culled, so culling is disabled for them
+	float cutoff = min_dot <= 0.1f ? 1.0f : std::sqrt(1.0f - min_dot * min_dot);
+
+	meshlet.normal_cone = glm::vec4(axis, cutoff);
+}
+}        // namespace
+
+MeshletData build_meshlets(const std::vector<uint32_t> &indices, const std::vector<glm::vec3> &positions)
+{
+	assert(indices.size() % 3 == 0 && "Index count must be a multiple of 3");
+
+	const uint32_t unused = std::numeric_limits<uint32_t>::max();
+
+	MeshletData data;
+
+	// Index of each mesh vertex within the current meshlet
+	std::vector<uint32_t> local_indices(positions.size(), unused);
+
+	Meshlet meshlet{};
+
+	auto finish_meshlet = [&]() {
+		for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+		{
+			local_indices[data.vertices[meshlet.vertex_offset + i]] = unused;
+		}
+
+		compute_meshlet_bounds(meshlet, data, positions);
+
+		data.meshlets.push_back(meshlet);
+
+		meshlet                 = {};
+		meshlet.vertex_offset   = static_cast<uint32_t>(data.vertices.size());
+		meshlet.triangle_offset = static_cast<uint32_t>(data.triangles.size());
+	};
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		uint32_t new_vertices = (local_indices[indices[i]] == unused) +
+		                        (local_indices[indices[i + 1]] == unused) +
+		                        (local_indices[indices[i + 2]] == unused);
+
+		if (meshlet.vertex_count + new_vertices > max_meshlet_vertices || meshlet.triangle_count == max_meshlet_triangles)
+		{
+			finish_meshlet();
+		}
+
+		uint32_t triangle = 0;
+
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			uint32_t &local_index = local_indices[indices[i + corner]];
+
+			if (local_index == unused)
+			{
+				local_index = meshlet.vertex_count++;
+				data.vertices.push_back(indices[i + corner]);
+			}
+
+			triangle |= local_index << (corner * 8);
+		}
+
+		data.triangles.push_back(triangle);
+		meshlet.triangle_count++;
+	}
+
+	if (meshlet.triangle_count > 0)
+	{
+		finish_meshlet();
+	}
+
+	return data;
+}
+}        // namespace vkb
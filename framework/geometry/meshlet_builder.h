@@ -0,0 +1,83 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/error.h"
+
+VKBP_DISABLE_WARNINGS()
+#include "common/glm_common.h"
+VKBP_ENABLE_WARNINGS()
+
+namespace vkb
+{
+/// Maximum number of vertices of a meshlet, must match the meshlet mesh shader output limits
+constexpr uint32_t max_meshlet_vertices = 64;
+
+/// Maximum number of triangles of a meshlet, must match the meshlet mesh shader output limits
+constexpr uint32_t max_meshlet_triangles = 124;
+
+/**
+ * @brief A small cluster of triangles of a submesh, processed by a single mesh shader workgroup.
+ *        The layout matches the meshlet storage buffer read by the meshlet shaders.
+ */
+struct alignas(16) Meshlet
+{
+	/// Object space bounding sphere, center in xyz and radius in w
+	glm::vec4 bounding_sphere;
+
+	/// Normal cone axis in xyz and cutoff in w. The meshlet faces away from a viewpoint v if
+	/// dot(center - v, axis) >= cutoff * length(center - v) + radius, a cutoff of 1 never culls.
+	glm::vec4 normal_cone;
+
+	/// First entry of the meshlet in the meshlet vertex array
+	uint32_t vertex_offset;
+
+	/// First entry of the meshlet in the meshlet triangle array
+	uint32_t triangle_offset;
+
+	uint32_t vertex_count;
+
+	uint32_t triangle_count;
+};
+
+/**
+ * @brief The meshlets of a triangle list
+ */
+struct MeshletData
+{
+	std::vector<Meshlet> meshlets;
+
+	/// Vertex indices of the mesh referenced by each meshlet
+	std::vector<uint32_t> vertices;
+
+	/// Triangles of each meshlet, as three 8 bit indices into the meshlet's vertices
+	std::vector<uint32_t> triangles;
+};
+
+/**
+ * @brief Splits a triangle list into meshlets, in index order. The triangle list should be
+ *        optimized for the vertex cache beforehand so that consecutive triangles share vertices.
+ * @param indices Triangle list
+ * @param positions Vertex positions referenced by the indices, used to compute the meshlet bounds
+ * @return The meshlets with their bounding spheres and normal cones
+ */
+MeshletData build_meshlets(const std::vector<uint32_t> &indices, const std::vector<glm::vec3> &positions);
+}        // namespace vkb
@@ -19,13 +19,19 @@
 #define TINYGLTF_IMPLEMENTATION
 #include "gltf_loader.h"
 
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <limits>
+#include <map>
 #include <queue>
+#include <tuple>
 
 #include "common/error.h"
 
 VKBP_DISABLE_WARNINGS()
 #include "common/glm_common.h"
+#include <glm/gtc/packing.hpp>
 #include <glm/gtc/type_ptr.hpp>
 VKBP_ENABLE_WARNINGS()
 
@@ -35,6 +41,9 @@ VKBP_ENABLE_WARNINGS()
 #include "common/vk_common.h"
 #include "core/device.h"
 #include "core/image.h"
+#include "geometry/mesh_optimizer.h"
+#include "geometry/meshlet_builder.h"
+#include "geometry/mesh_simplifier.h"
 #include "platform/filesystem.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
@@ -165,7 +174,19 @@ inline VkFormat get_attribute_format(const tinygltf::Model *model, uint32_t acce
 			                                                      {TINYGLTF_TYPE_VEC3, VK_FORMAT_R8G8B8_SINT},
 			                                                      {TINYGLTF_TYPE_VEC4, VK_FORMAT_R8G8B8A8_SINT}};
 
-			format = mapped_format.at(accessor.type);
+			static const std::map<int, VkFormat> mapped_format_normalize = {{TINYGLTF_TYPE_SCALAR, VK_FORMAT_R8_SNORM},
+			                                                                {TINYGLTF_TYPE_VEC2, VK_FORMAT_R8G8_SNORM},
+			                                                                {TINYGLTF_TYPE_VEC3, VK_FORMAT_R8G8B8_SNORM},
+			                                                                {TINYGLTF_TYPE_VEC4, VK_FORMAT_R8G8B8A8_SNORM}};
+
+			if (accessor.normalized)
+			{
+				format = mapped_format_normalize.at(accessor.type);
+			}
+			else
+			{
+				format = mapped_format.at(accessor.type);
+			}
 
 			break;
 		}
@@ -194,12 +215,24 @@ inline VkFormat get_attribute_format(const tinygltf::Model *model, uint32_t acce
 		}
 		case TINYGLTF_COMPONENT_TYPE_SHORT:
 		{
-			static const std::map<int, VkFormat> mapped_format = {{TINYGLTF_TYPE_SCALAR, VK_FORMAT_R8_SINT},
-			                                                      {TINYGLTF_TYPE_VEC2, VK_FORMAT_R8G8_SINT},
-			                                                      {TINYGLTF_TYPE_VEC3, VK_FORMAT_R8G8B8_SINT},
-			                                                      {TINYGLTF_TYPE_VEC4, VK_FORMAT_R8G8B8A8_SINT}};
+			static const std::map<int, VkFormat> mapped_format = {{TINYGLTF_TYPE_SCALAR, VK_FORMAT_R16_SINT},
+			                                                      {TINYGLTF_TYPE_VEC2, VK_FORMAT_R16G16_SINT},
+			                                                      {TINYGLTF_TYPE_VEC3, VK_FORMAT_R16G16B16_SINT},
+			                                                      {TINYGLTF_TYPE_VEC4, VK_FORMAT_R16G16B16A16_SINT}};
 
-			format = mapped_format.at(accessor.type);
+			static const std::map<int, VkFormat> mapped_format_normalize = {{TINYGLTF_TYPE_SCALAR, VK_FORMAT_R16_SNORM},
+			                                                                {TINYGLTF_TYPE_VEC2, VK_FORMAT_R16G16_SNORM},
+			                                                                {TINYGLTF_TYPE_VEC3, VK_FORMAT_R16G16B16_SNORM},
+			                                                                {TINYGLTF_TYPE_VEC4, VK_FORMAT_R16G16B16A16_SNORM}};
+
+			if (accessor.normalized)
+			{
+				format = mapped_format_normalize.at(accessor.type);
+			}
+			else
+			{
+				format = mapped_format.at(accessor.type);
+			}
 
 			break;
 		}
@@ -269,6 +302,63 @@ inline VkFormat get_attribute_format(const tinygltf::Model *model, uint32_t acce
 	return format;
 };
 
+/**
+ * @brief Checks whether an attribute is read as floats by the shaders, and may be stored quantized
+ *        as allowed by KHR_mesh_quantization
+ */
+inline bool is_quantizable_attribute(const std::string &attrib_name)
+{
+	return attrib_name == "position" || attrib_name == "normal" || attrib_name == "tangent" || attrib_name.compare(0, 9, "texcoord_") == 0;
+}
+
+/**
+ * @brief Gets the vertex input format of an attribute read as floats by the shaders. Integer data
+ *        is converted to floats by the vertex fetch, and 3 component 8 and 16 bit data, which glTF
+ *        pads to 4 byte elements, uses the 4 component formats all devices support for vertex input.
+ */
+inline VkFormat get_vertex_attribute_format(const tinygltf::Model *model, uint32_t accessorId)
+{
+	assert(accessorId < model->accessors.size());
+	auto &accessor = model->accessors[accessorId];
+
+	// Formats indexed by component count - 1, non normalized then normalized
+	static const std::map<int, std::array<std::array<VkFormat, 4>, 2>> mapped_formats = {
+	    {TINYGLTF_COMPONENT_TYPE_BYTE,
+	     {{{VK_FORMAT_R8_SSCALED, VK_FORMAT_R8G8_SSCALED, VK_FORMAT_R8G8B8_SSCALED, VK_FORMAT_R8G8B8A8_SSCALED},
+	       {VK_FORMAT_R8_SNORM, VK_FORMAT_R8G8_SNORM, VK_FORMAT_R8G8B8_SNORM, VK_FORMAT_R8G8B8A8_SNORM}}}},
+	    {TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE,
+	     {{{VK_FORMAT_R8_USCALED, VK_FORMAT_R8G8_USCALED, VK_FORMAT_R8G8B8_USCALED, VK_FORMAT_R8G8B8A8_USCALED},
+	       {VK_FORMAT_R8_UNORM, VK_FORMAT_R8G8_UNORM, VK_FORMAT_R8G8B8_UNORM, VK_FORMAT_R8G8B8A8_UNORM}}}},
+	    {TINYGLTF_COMPONENT_TYPE_SHORT,
+	     {{{VK_FORMAT_R16_SSCALED, VK_FORMAT_R16G16_SSCALED, VK_FORMAT_R16G16B16_SSCALED, VK_FORMAT_R16G16B16A16_SSCALED},
+	       {VK_FORMAT_R16_SNORM, VK_FORMAT_R16G16_SNORM, VK_FORMAT_R16G16B16_SNORM, VK_FORMAT_R16G16B16A16_SNORM}}}},
+	    {TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT,
+	     {{{VK_FORMAT_R16_USCALED, VK_FORMAT_R16G16_USCALED, VK_FORMAT_R16G16B16_USCALED, VK_FORMAT_R16G16B16A16_USCALED},
+	       {VK_FORMAT_R16_UNORM, VK_FORMAT_R16G16_UNORM, VK_FORMAT_R16G16B16_UNORM, VK_FORMAT_R16G16B16A16_UNORM}}}}};
+
+	auto formats_it = mapped_formats.find(accessor.componentType);
+
+	if (formats_it == mapped_formats.end())
+	{
+		return get_attribute_format(model, accessorId);
+	}
+
+	auto component_count = tinygltf::GetNumComponentsInType(static_cast<uint32_t>(accessor.type));
+	auto component_size  = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType));
+
+	if (component_count < 1 || component_count > 4)
+	{
+		return VK_FORMAT_UNDEFINED;
+	}
+
+	if (component_count == 3 && get_attribute_stride(model, accessorId) >= static_cast<size_t>(4 * component_size))
+	{
+		component_count = 4;
+	}
+
+	return formats_it->second[accessor.normalized ? 1 : 0][component_count - 1];
+}
+
 inline std::vector<uint8_t> convert_underlying_data_stride(const std::vector<uint8_t> &src_data, uint32_t src_stride, uint32_t dst_stride)
 {
 	auto elem_count = to_u32(src_data.size()) / src_stride;
@@ -285,6 +375,530 @@ inline std::vector<uint8_t> convert_underlying_data_stride(const std::vector<uin
 	return result;
 }
 
+inline std::vector<glm::vec3> get_position_data(const tinygltf::Model *model, uint32_t accessorId)
+{
+	auto vertex_data = get_attribute_data(model, accessorId);
+	auto stride      = get_attribute_stride(model, accessorId);
+
+	std::vector<glm::vec3> positions(get_attribute_size(model, accessorId));
+
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		std::memcpy(&positions[i], vertex_data.data() + i * stride, sizeof(glm::vec3));
+	}
+
+	return positions;
+}
+
+/**
+ * @brief Reads the min or max bounds of a quantized position accessor. Normalized integer bounds
+ *        are converted to the [-1, 1] or [0, 1] range the vertex fetch sees, as the glTF
+ *        specification stores them in the unnormalized component range
+ */
+inline glm::vec3 get_accessor_bound(const tinygltf::Accessor &accessor, const std::vector<double> &values)
+{
+	glm::vec3 bound(static_cast<float>(values[0]), static_cast<float>(values[1]), static_cast<float>(values[2]));
+
+	if (accessor.normalized)
+	{
+		switch (accessor.componentType)
+		{
+			case TINYGLTF_COMPONENT_TYPE_BYTE:
+				bound = glm::max(bound / 127.0f, glm::vec3(-1.0f));
+				break;
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+				bound /= 255.0f;
+				break;
+			case TINYGLTF_COMPONENT_TYPE_SHORT:
+				bound = glm::max(bound / 32767.0f, glm::vec3(-1.0f));
+				break;
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+				bound /= 65535.0f;
+				break;
+			default:
+				break;
+		}
+	}
+
+	return bound;
+}
+
+inline std::vector<uint32_t> unpack_indices(const std::vector<uint8_t> &index_data, VkIndexType index_type)
+{
+	std::vector<uint32_t> indices;
+
+	if (index_type == VK_INDEX_TYPE_UINT16)
+	{
+		const uint16_t *data = reinterpret_cast<const uint16_t *>(index_data.data());
+		indices.assign(data, data + index_data.size() / sizeof(uint16_t));
+	}
+	else
+	{
+		const uint32_t *data = reinterpret_cast<const uint32_t *>(index_data.data());
+		indices.assign(data, data + index_data.size() / sizeof(uint32_t));
+	}
+
+	return indices;
+}
+
+inline std::vector<uint8_t> pack_indices(const std::vector<uint32_t> &indices, VkIndexType index_type)
+{
+	if (index_type == VK_INDEX_TYPE_UINT16)
+	{
+		std::vector<uint16_t> narrow_indices(indices.begin(), indices.end());
+
+		const uint8_t *data = reinterpret_cast<const uint8_t *>(narrow_indices.data());
+		return {data, data + narrow_indices.size() * sizeof(uint16_t)};
+	}
+	else
+	{
+		const uint8_t *data = reinterpret_cast<const uint8_t *>(indices.data());
+		return {data, data + indices.size() * sizeof(uint32_t)};
+	}
+}
+
+/**
+ * @brief Simplifies a submesh repeatedly, appending each level to its indices
+ * @return The levels of detail stored in the indices, starting with the full resolution one
+ */
+inline std::vector<sg::SubMeshLod> append_lod_chain(const std::vector<glm::vec3> &positions, std::vector<uint32_t> &indices, uint32_t max_lod_count, float reduction_ratio)
+{
+	std::vector<sg::SubMeshLod> lods{{0, to_u32(indices.size()), 0.0f}};
+
+	MeshSimplifier simplifier{positions};
+
+	std::vector<uint32_t> level_indices{indices};
+
+	for (uint32_t level = 1; level <= max_lod_count; ++level)
+	{
+		size_t target_index_count = static_cast<size_t>(static_cast<float>(level_indices.size()) * reduction_ratio) / 3 * 3;
+
+		auto simplified_indices = simplifier.simplify(level_indices, target_index_count);
+
+		// Stop when the simplifier cannot make meaningful progress, e.g. if most vertices lie on seams
+		if (simplified_indices.empty() || simplified_indices.size() * 10 > level_indices.size() * 9)
+		{
+			break;
+		}
+
+		sg::SubMeshLod lod;
+		lod.first_index = to_u32(indices.size());
+		lod.index_count = to_u32(simplified_indices.size());
+
+		// Every level is simplified from the previous one, so the errors add up
+		lod.error = lods.back().error + simplifier.get_result_error();
+
+		lods.push_back(lod);
+
+		indices.insert(indices.end(), simplified_indices.begin(), simplified_indices.end());
+
+		level_indices = std::move(simplified_indices);
+	}
+
+	return lods;
+}
+
+/**
+ * @brief Creates a device local buffer and records the upload of its data from a staging buffer
+ */
+template <typename T>
+inline std::unique_ptr<core::Buffer> create_device_local_buffer(Device const &device, CommandBuffer &command_buffer, std::vector<core::Buffer> &staging_buffers,
+                                                                const std::vector<T> &data, VkBufferUsageFlags usage)
+{
+	auto size = data.size() * sizeof(T);
+
+	core::Buffer stage_buffer{device,
+	                          size,
+	                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+	                          VMA_MEMORY_USAGE_CPU_ONLY};
+	stage_buffer.update(reinterpret_cast<const uint8_t *>(data.data()), size);
+
+	auto buffer = std::make_unique<core::Buffer>(device,
+	                                             size,
+	                                             usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                             VMA_MEMORY_USAGE_GPU_ONLY);
+
+	command_buffer.copy_buffer(stage_buffer, *buffer, size);
+
+	staging_buffers.push_back(std::move(stage_buffer));
+
+	return buffer;
+}
+
+struct VertexAttributeData
+{
+	std::vector<uint8_t> data;
+
+	VkFormat format{VK_FORMAT_UNDEFINED};
+
+	uint32_t stride{0};
+};
+
+/**
+ * @brief CPU side data of a glTF primitive, prepared on a worker thread before it is uploaded
+ */
+struct PrimitiveData
+{
+	std::map<std::string, VertexAttributeData> attributes;
+
+	uint32_t vertices_count{0};
+
+	std::vector<glm::vec3> positions;
+
+	bool indexed{false};
+
+	std::vector<uint8_t> index_data;
+
+	VkIndexType index_type{};
+
+	uint32_t vertex_indices{0};
+
+	std::vector<sg::SubMeshLod> lods;
+
+	bool optimized{false};
+
+	float acmr_before{0.0f};
+
+	float acmr_after{0.0f};
+
+	MeshletData meshlets;
+};
+
+/**
+ * @brief Reorders the triangles and vertices of a primitive, then the simplified levels if any
+ * @param primitive The primitive, whose vertex data is remapped to the new vertex order
+ * @param indices The indices of the primitive, the full resolution level first
+ * @param overdraw_threshold How much ACMR may be traded for less overdraw
+ */
+inline void optimize_primitive(PrimitiveData &primitive, std::vector<uint32_t> &indices, float overdraw_threshold)
+{
+	size_t vertex_count = primitive.positions.size();
+
+	uint32_t full_index_count = primitive.lods.empty() ? to_u32(indices.size()) : primitive.lods[0].index_count;
+
+	std::vector<uint32_t> full_indices(indices.begin(), indices.begin() + full_index_count);
+
+	primitive.acmr_before = mesh_optimizer::analyze_vertex_cache(full_indices, vertex_count);
+
+	full_indices = mesh_optimizer::optimize_vertex_cache(full_indices, vertex_count);
+	full_indices = mesh_optimizer::optimize_overdraw(full_indices, primitive.positions, overdraw_threshold);
+
+	primitive.acmr_after = mesh_optimizer::analyze_vertex_cache(full_indices, vertex_count);
+
+	std::copy(full_indices.begin(), full_indices.end(), indices.begin());
+
+	// Distant simplified levels are small on screen, so they are only ordered for the vertex cache
+	for (size_t i = 1; i < primitive.lods.size(); ++i)
+	{
+		auto level_begin = indices.begin() + primitive.lods[i].first_index;
+		auto level_end   = level_begin + primitive.lods[i].index_count;
+
+		auto level_indices = mesh_optimizer::optimize_vertex_cache(std::vector<uint32_t>(level_begin, level_end), vertex_count);
+
+		std::copy(level_indices.begin(), level_indices.end(), level_begin);
+	}
+
+	// Vertices are renumbered in order of first use by the full resolution level
+	auto remap = mesh_optimizer::optimize_vertex_fetch(indices, vertex_count);
+
+	for (auto &attribute : primitive.attributes)
+	{
+		attribute.second.data = mesh_optimizer::remap_vertex_data(attribute.second.data, attribute.second.stride, remap);
+	}
+
+	std::vector<glm::vec3> positions(vertex_count);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		positions[i] = primitive.positions[remap[i]];
+	}
+
+	primitive.positions = std::move(positions);
+	primitive.optimized = true;
+}
+
+/**
+ * @brief Quantization of the vertex positions of a mesh, which maps its bounds to the snorm range
+ */
+struct PositionQuantization
+{
+	bool enabled{false};
+
+	glm::vec3 offset{0.0f};
+
+	/// A single scale for all axes keeps normals transformed by the model matrix unskewed
+	float scale{1.0f};
+
+	glm::mat4 get_dequantization() const
+	{
+		return glm::translate(offset) * glm::scale(glm::vec3(scale));
+	}
+};
+
+inline int16_t quantize_snorm16(float value)
+{
+	return static_cast<int16_t>(std::round(glm::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+inline glm::vec2 encode_octahedral(glm::vec3 normal)
+{
+	normal /= std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+
+	glm::vec2 encoded(normal.x, normal.y);
+
+	if (normal.z < 0.0f)
+	{
+		// Fold the lower hemisphere over the diagonals
+		encoded.x = (1.0f - std::abs(normal.y)) * (normal.x >= 0.0f ? 1.0f : -1.0f);
+		encoded.y = (1.0f - std::abs(normal.x)) * (normal.y >= 0.0f ? 1.0f : -1.0f);
+	}
+
+	return encoded;
+}
+
+/**
+ * @brief Computes the quantization range of the positions of a mesh from the bounds of its
+ *        position accessors. Quantization is disabled unless all positions are float vectors.
+ */
+inline PositionQuantization get_position_quantization(const tinygltf::Model &model, const tinygltf::Mesh &gltf_mesh)
+{
+	PositionQuantization quantization;
+
+	glm::vec3 min(std::numeric_limits<float>::max());
+	glm::vec3 max(std::numeric_limits<float>::lowest());
+
+	for (auto &gltf_primitive : gltf_mesh.primitives)
+	{
+		auto position_it = gltf_primitive.attributes.find("POSITION");
+		if (position_it == gltf_primitive.attributes.end())
+		{
+			return quantization;
+		}
+
+		auto &accessor = model.accessors[position_it->second];
+		if (accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT || accessor.type != TINYGLTF_TYPE_VEC3 ||
+		    accessor.minValues.size() != 3 || accessor.maxValues.size() != 3)
+		{
+			return quantization;
+		}
+
+		min = glm::min(min, glm::vec3(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]));
+		max = glm::max(max, glm::vec3(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2]));
+	}
+
+	glm::vec3 half_extent = (max - min) * 0.5f;
+
+	float scale = std::max(half_extent.x, std::max(half_extent.y, half_extent.z));
+
+	if (gltf_mesh.primitives.empty() || !(scale > 0.0f))
+	{
+		return quantization;
+	}
+
+	quantization.enabled = true;
+	quantization.offset  = (min + max) * 0.5f;
+	quantization.scale   = scale;
+
+	return quantization;
+}
+
+/**
+ * @brief Converts the float positions, normals and texture coordinates of a primitive to compact formats:
+ *        snorm16 positions, octahedral snorm16 normals and half float texture coordinates
+ */
+inline void quantize_primitive(PrimitiveData &primitive, const PositionQuantization &position_quantization)
+{
+	size_t vertex_count = primitive.vertices_count;
+
+	for (auto &attribute : primitive.attributes)
+	{
+		auto &data = attribute.second;
+
+		if (attribute.first == "position" && position_quantization.enabled && data.format == VK_FORMAT_R32G32B32_SFLOAT)
+		{
+			// Padded to 4 components, 3 component 16 bit formats are not required for vertex input
+			std::vector<int16_t> quantized(vertex_count * 4, 0);
+
+			for (size_t i = 0; i < vertex_count; ++i)
+			{
+				glm::vec3 position;
+				std::memcpy(&position, data.data.data() + i * data.stride, sizeof(glm::vec3));
+
+				position = (position - position_quantization.offset) / position_quantization.scale;
+
+				quantized[i * 4 + 0] = quantize_snorm16(position.x);
+				quantized[i * 4 + 1] = quantize_snorm16(position.y);
+				quantized[i * 4 + 2] = quantize_snorm16(position.z);
+			}
+
+			const uint8_t *bytes = reinterpret_cast<const uint8_t *>(quantized.data());
+
+			data.data   = {bytes, bytes + quantized.size() * sizeof(int16_t)};
+			data.format = VK_FORMAT_R16G16B16A16_SNORM;
+			data.stride = 4 * sizeof(int16_t);
+		}
+		else if (attribute.first == "normal" && data.format == VK_FORMAT_R32G32B32_SFLOAT)
+		{
+			std::vector<int16_t> quantized(vertex_count * 2);
+
+			for (size_t i = 0; i < vertex_count; ++i)
+			{
+				glm::vec3 normal;
+				std::memcpy(&normal, data.data.data() + i * data.stride, sizeof(glm::vec3));
+
+				glm::vec2 encoded = glm::dot(normal, normal) > 0.0f ? encode_octahedral(normal) : glm::vec2(0.0f, 0.0f);
+
+				quantized[i * 2 + 0] = quantize_snorm16(encoded.x);
+				quantized[i * 2 + 1] = quantize_snorm16(encoded.y);
+			}
+
+			const uint8_t *bytes = reinterpret_cast<const uint8_t *>(quantized.data());
+
+			data.data   = {bytes, bytes + quantized.size() * sizeof(int16_t)};
+			data.format = VK_FORMAT_R16G16_SNORM;
+			data.stride = 2 * sizeof(int16_t);
+		}
+		else if (attribute.first.compare(0, 9, "texcoord_") == 0 && data.format == VK_FORMAT_R32G32_SFLOAT)
+		{
+			std::vector<uint16_t> quantized(vertex_count * 2);
+
+			for (size_t i = 0; i < vertex_count; ++i)
+			{
+				glm::vec2 texcoord;
+				std::memcpy(&texcoord, data.data.data() + i * data.stride, sizeof(glm::vec2));
+
+				quantized[i * 2 + 0] = glm::packHalf1x16(texcoord.x);
+				quantized[i * 2 + 1] = glm::packHalf1x16(texcoord.y);
+			}
+
+			const uint8_t *bytes = reinterpret_cast<const uint8_t *>(quantized.data());
+
+			data.data   = {bytes, bytes + quantized.size() * sizeof(uint16_t)};
+			data.format = VK_FORMAT_R16G16_SFLOAT;
+			data.stride = 2 * sizeof(uint16_t);
+		}
+	}
+}
+
+/**
+ * @brief Checks that the vertex attributes used by the meshlet shaders are stored as floats
+ */
+inline bool supports_meshlet_attributes(const PrimitiveData &primitive)
+{
+	for (auto &attribute : primitive.attributes)
+	{
+		if ((attribute.first == "normal" && attribute.second.format != VK_FORMAT_R32G32B32_SFLOAT) ||
+		    (attribute.first == "texcoord_0" && attribute.second.format != VK_FORMAT_R32G32_SFLOAT))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Reads the data of a glTF primitive and applies the mesh processing requested by the options
+ */
+inline PrimitiveData prepare_primitive(const tinygltf::Model *model, const tinygltf::Primitive &gltf_primitive, const GLTFLoaderOptions &options,
+                                       const PositionQuantization &position_quantization)
+{
+	PrimitiveData primitive;
+
+	for (auto &attribute : gltf_primitive.attributes)
+	{
+		std::string attrib_name = attribute.first;
+		std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
+
+		VertexAttributeData attribute_data;
+		attribute_data.data   = get_attribute_data(model, attribute.second);
+		attribute_data.format = is_quantizable_attribute(attrib_name) ? get_vertex_attribute_format(model, attribute.second) : get_attribute_format(model, attribute.second);
+		attribute_data.stride = to_u32(get_attribute_stride(model, attribute.second));
+
+		if (attrib_name == "position")
+		{
+			assert(attribute.second < model->accessors.size());
+			primitive.vertices_count = to_u32(model->accessors[attribute.second].count);
+
+			if (attribute_data.format == VK_FORMAT_R32G32B32_SFLOAT)
+			{
+				primitive.positions = get_position_data(model, attribute.second);
+			}
+		}
+
+		primitive.attributes.emplace(attrib_name, std::move(attribute_data));
+	}
+
+	if (gltf_primitive.indices >= 0)
+	{
+		primitive.indexed        = true;
+		primitive.vertex_indices = to_u32(get_attribute_size(model, gltf_primitive.indices));
+
+		auto format = get_attribute_format(model, gltf_primitive.indices);
+
+		primitive.index_data = get_attribute_data(model, gltf_primitive.indices);
+
+		switch (format)
+		{
+			case VK_FORMAT_R8_UINT:
+				// Converts uint8 data into uint16 data, still represented by a uint8 vector
+				primitive.index_data = convert_underlying_data_stride(primitive.index_data, 1, 2);
+				primitive.index_type = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R16_UINT:
+				primitive.index_type = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R32_UINT:
+				primitive.index_type = VK_INDEX_TYPE_UINT32;
+				break;
+			default:
+				LOGE("gltf primitive has invalid format type");
+				break;
+		}
+
+		bool can_process = !primitive.positions.empty() && gltf_primitive.mode == TINYGLTF_MODE_TRIANGLES &&
+		                   (format == VK_FORMAT_R8_UINT || format == VK_FORMAT_R16_UINT || format == VK_FORMAT_R32_UINT);
+
+		if (can_process && (options.generate_lods || options.optimize_meshes || options.generate_meshlets))
+		{
+			auto indices = unpack_indices(primitive.index_data, primitive.index_type);
+
+			if (options.generate_lods)
+			{
+				// The levels share the index buffer of the full resolution mesh
+				primitive.lods = append_lod_chain(primitive.positions, indices, options.max_lod_count, options.lod_reduction_ratio);
+			}
+
+			if (options.optimize_meshes)
+			{
+				optimize_primitive(primitive, indices, options.overdraw_threshold);
+			}
+
+			if (options.generate_meshlets && supports_meshlet_attributes(primitive))
+			{
+				// Meshlets are built for the full resolution level only
+				uint32_t full_index_count = primitive.lods.empty() ? to_u32(indices.size()) : primitive.lods[0].index_count;
+
+				primitive.meshlets = build_meshlets(std::vector<uint32_t>(indices.begin(), indices.begin() + full_index_count), primitive.positions);
+			}
+
+			primitive.index_data = pack_indices(indices, primitive.index_type);
+		}
+	}
+	else
+	{
+		primitive.vertices_count = to_u32(get_attribute_size(model, gltf_primitive.attributes.at("POSITION")));
+	}
+
+	// Last, as the other processing reads the float positions
+	if (options.quantize_vertices && !options.generate_meshlets)
+	{
+		quantize_primitive(primitive, position_quantization);
+	}
+
+	return primitive;
+}
+
 inline void upload_image_to_gpu(CommandBuffer &command_buffer, core::Buffer &staging_buffer, sg::Image &image)
 {
 	// Clean up the image data, as they are copied in the staging buffer
@@ -397,10 +1011,12 @@ static inline bool texture_needs_srgb_colorspace(const std::string &name)
 }        // namespace
 
 std::unordered_map<std::string, bool> GLTFLoader::supported_extensions = {
-    {KHR_LIGHTS_PUNCTUAL_EXTENSION, false}};
+    {KHR_LIGHTS_PUNCTUAL_EXTENSION, false},
+    {KHR_MESH_QUANTIZATION_EXTENSION, false}};
 
-GLTFLoader::GLTFLoader(Device const &device) :
-    device{device}
+GLTFLoader::GLTFLoader(Device const &device, const GLTFLoaderOptions &options) :
+    device{device},
+    options{options}
 {
 }
 
@@ -563,6 +1179,46 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		image_component_futures.push_back(std::move(fut));
 	}
 
+	// Prepare the mesh data while the images are uploaded. Primitives referencing the same
+	// accessors are only processed once, and the result is shared by their submeshes.
+	// Positions are quantized per mesh, so the key includes the quantization range.
+	using PrimitiveKey = std::tuple<int, int, std::map<std::string, int>, std::array<float, 4>>;
+
+	std::map<PrimitiveKey, std::shared_future<PrimitiveData>> primitive_cache;
+
+	std::vector<std::vector<std::shared_future<PrimitiveData>>> primitive_futures(model.meshes.size());
+
+	std::vector<PositionQuantization> mesh_quantizations(model.meshes.size());
+
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); mesh_index++)
+	{
+		if (options.quantize_vertices && !options.generate_meshlets)
+		{
+			mesh_quantizations[mesh_index] = get_position_quantization(model, model.meshes[mesh_index]);
+		}
+
+		const PositionQuantization &quantization = mesh_quantizations[mesh_index];
+
+		for (auto &gltf_primitive : model.meshes[mesh_index].primitives)
+		{
+			PrimitiveKey key{gltf_primitive.mode, gltf_primitive.indices, gltf_primitive.attributes,
+			                 {quantization.offset.x, quantization.offset.y, quantization.offset.z, quantization.enabled ? quantization.scale : 0.0f}};
+
+			auto it = primitive_cache.find(key);
+			if (it == primitive_cache.end())
+			{
+				auto fut = thread_pool.push(
+				    [this, &gltf_primitive, quantization](size_t) {
+					    return prepare_primitive(&model, gltf_primitive, options, quantization);
+				    });
+
+				it = primitive_cache.emplace(std::move(key), fut.share()).first;
+			}
+
+			primitive_futures[mesh_index].push_back(it->second);
+		}
+	}
+
 	std::vector<std::unique_ptr<sg::Image>> image_components;
 
 	// Upload images to GPU. We do this in batches of 64MB of data to avoid needing
@@ -711,10 +1367,47 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 	// Load meshes
 	auto materials = scene.get_components<sg::PBRMaterial>();
 
-	for (auto &gltf_mesh : model.meshes)
+	timer.start();
+
+	size_t lod_count = 0;
+
+	size_t optimized_count       = 0;
+	double acmr_before_triangles = 0.0;
+	double acmr_after_triangles  = 0.0;
+	double optimized_triangles   = 0.0;
+
+	size_t meshlet_count = 0;
+
+	// Meshlet data is uploaded to device local memory in a single submission
+	CommandBuffer *meshlet_command_buffer = nullptr;
+
+	std::vector<core::Buffer> meshlet_staging_buffers;
+
+	if (options.generate_meshlets)
+	{
+		meshlet_command_buffer = &device.request_command_buffer();
+		meshlet_command_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+	}
+
+	// Mesh shaders fetch the vertex attributes from storage buffers
+	VkBufferUsageFlags vertex_buffer_usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+
+	if (options.generate_meshlets)
+	{
+		vertex_buffer_usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+	}
+
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); mesh_index++)
 	{
+		auto &gltf_mesh = model.meshes[mesh_index];
+
 		auto mesh = parse_mesh(gltf_mesh);
 
+		if (mesh_quantizations[mesh_index].enabled)
+		{
+			mesh->set_dequantization(mesh_quantizations[mesh_index].get_dequantization());
+		}
+
 		for (size_t i_primitive = 0; i_primitive < gltf_mesh.primitives.size(); i_primitive++)
 		{
 			const auto &gltf_primitive = gltf_mesh.primitives[i_primitive];
@@ -722,74 +1415,94 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 			auto submesh_name = fmt::format("'{}' mesh, primitive #{}", gltf_mesh.name, i_primitive);
 			auto submesh      = std::make_unique<sg::SubMesh>(std::move(submesh_name));
 
-			for (auto &attribute : gltf_primitive.attributes)
-			{
-				std::string attrib_name = attribute.first;
-				std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
-
-				auto vertex_data = get_attribute_data(&model, attribute.second);
-
-				if (attrib_name == "position")
-				{
-					assert(attribute.second < model.accessors.size());
-					submesh->vertices_count = to_u32(model.accessors[attribute.second].count);
-				}
+			// Wait for the primitive data to be prepared by the worker threads
+			const PrimitiveData &primitive = primitive_futures[mesh_index][i_primitive].get();
 
+			for (auto &attribute : primitive.attributes)
+			{
 				core::Buffer buffer{device,
-				                    vertex_data.size(),
-				                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+				                    attribute.second.data.size(),
+				                    vertex_buffer_usage,
 				                    VMA_MEMORY_USAGE_CPU_TO_GPU};
-				buffer.update(vertex_data);
+				buffer.update(attribute.second.data);
 				buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
-				                                  gltf_mesh.name, i_primitive, attrib_name));
+				                                  gltf_mesh.name, i_primitive, attribute.first));
 
-				submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
+				submesh->vertex_buffers.insert(std::make_pair(attribute.first, std::move(buffer)));
 
 				sg::VertexAttribute attrib;
-				attrib.format = get_attribute_format(&model, attribute.second);
-				attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
+				attrib.format = attribute.second.format;
+				attrib.stride = attribute.second.stride;
 
-				submesh->set_attribute(attrib_name, attrib);
+				submesh->set_attribute(attribute.first, attrib);
 			}
 
-			if (gltf_primitive.indices >= 0)
-			{
-				submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
-
-				auto format = get_attribute_format(&model, gltf_primitive.indices);
+			submesh->vertices_count = primitive.vertices_count;
 
-				auto index_data = get_attribute_data(&model, gltf_primitive.indices);
+			if (!primitive.positions.empty())
+			{
+				mesh->update_bounds(primitive.positions);
+			}
+			else
+			{
+				// Quantized positions, the accessor bounds are required by the glTF specification
+				auto &accessor = model.accessors[gltf_primitive.attributes.at("POSITION")];
 
-				switch (format)
+				if (accessor.minValues.size() >= 3 && accessor.maxValues.size() >= 3)
 				{
-					case VK_FORMAT_R8_UINT:
-						// Converts uint8 data into uint16 data, still represented by a uint8 vector
-						index_data          = convert_underlying_data_stride(index_data, 1, 2);
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R16_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R32_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT32;
-						break;
-					default:
-						LOGE("gltf primitive has invalid format type");
-						break;
+					mesh->update_bounds({get_accessor_bound(accessor, accessor.minValues),
+					                     get_accessor_bound(accessor, accessor.maxValues)});
 				}
+			}
+
+			if (primitive.indexed)
+			{
+				submesh->vertex_indices = primitive.vertex_indices;
+				submesh->index_type     = primitive.index_type;
+				submesh->lods           = primitive.lods;
+
+				lod_count += primitive.lods.empty() ? 0 : primitive.lods.size() - 1;
 
 				submesh->index_buffer = std::make_unique<core::Buffer>(device,
-				                                                       index_data.size(),
+				                                                       primitive.index_data.size(),
 				                                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
 				                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
 				submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
 				                                                  gltf_mesh.name, i_primitive));
 
-				submesh->index_buffer->update(index_data);
+				submesh->index_buffer->update(primitive.index_data);
 			}
-			else
+
+			if (!primitive.meshlets.meshlets.empty())
 			{
-				submesh->vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
+				submesh->meshlet_count = to_u32(primitive.meshlets.meshlets.size());
+
+				submesh->meshlet_buffer = create_device_local_buffer(device, *meshlet_command_buffer, meshlet_staging_buffers,
+				                                                     primitive.meshlets.meshlets, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+				submesh->meshlet_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: meshlet buffer",
+				                                                    gltf_mesh.name, i_primitive));
+
+				submesh->meshlet_vertex_buffer = create_device_local_buffer(device, *meshlet_command_buffer, meshlet_staging_buffers,
+				                                                            primitive.meshlets.vertices, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+				submesh->meshlet_vertex_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: meshlet vertex buffer",
+				                                                           gltf_mesh.name, i_primitive));
+
+				submesh->meshlet_triangle_buffer = create_device_local_buffer(device, *meshlet_command_buffer, meshlet_staging_buffers,
+				                                                              primitive.meshlets.triangles, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+				submesh->meshlet_triangle_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: meshlet triangle buffer",
+				                                                             gltf_mesh.name, i_primitive));
+
+				meshlet_count += submesh->meshlet_count;
+			}
+
+			if (primitive.optimized)
+			{
+				double triangles = static_cast<double>(primitive.vertex_indices / 3);
+
+				optimized_count++;
+				acmr_before_triangles += primitive.acmr_before * triangles;
+				acmr_after_triangles += primitive.acmr_after * triangles;
+				optimized_triangles += triangles;
 			}
 
 			if (gltf_primitive.material < 0)
@@ -810,6 +1523,38 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		scene.add_component(std::move(mesh));
 	}
 
+	if (meshlet_command_buffer)
+	{
+		meshlet_command_buffer->end();
+
+		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+		queue.submit(*meshlet_command_buffer, device.request_fence());
+	}
+
+	elapsed_time = timer.stop();
+
+	LOGI("Time spent loading meshes: {} seconds across {} threads.", vkb::to_string(elapsed_time), thread_count);
+
+	if (options.generate_lods)
+	{
+		LOGI("Generated {} mesh LODs.", lod_count);
+	}
+
+	if (options.generate_meshlets)
+	{
+		LOGI("Generated {} meshlets.", meshlet_count);
+	}
+
+	if (optimized_count > 0)
+	{
+		// ACMR of a 16 entry FIFO cache, weighted by the triangle count of each submesh
+		LOGI("Optimized {} submeshes, ACMR {:.3f} before, {:.3f} after.",
+		     optimized_count,
+		     acmr_before_triangles / optimized_triangles,
+		     acmr_after_triangles / optimized_triangles);
+	}
+
 	device.get_fence_pool().wait();
 	device.get_fence_pool().reset();
 	device.get_command_pool().reset_pool();
@@ -29,6 +29,7 @@
 #include "timer.h"
 
 #define KHR_LIGHTS_PUNCTUAL_EXTENSION "KHR_lights_punctual"
+#define KHR_MESH_QUANTIZATION_EXTENSION "KHR_mesh_quantization"
 
 namespace vkb
 {
@@ -63,13 +64,42 @@ struct TypeCast
 	}
 };
 
+/**
+ * @brief Optional processing applied to the meshes of a scene while it is loaded
+ */
+struct GLTFLoaderOptions
+{
+	/// Generate a chain of simplified index ranges for each submesh, used for LOD selection
+	bool generate_lods{false};
+
+	/// Maximum number of simplified levels generated per submesh
+	uint32_t max_lod_count{4};
+
+	/// Fraction of the previous level's triangles targeted by each simplified level
+	float lod_reduction_ratio{0.5f};
+
+	/// Reorder triangles and vertices of each submesh for vertex cache, overdraw and vertex fetch efficiency
+	bool optimize_meshes{false};
+
+	/// How much the vertex cache efficiency may be traded for less overdraw, as a ratio of ACMR
+	float overdraw_threshold{1.05f};
+
+	/// Split each submesh into meshlets with culling bounds, stored in device local buffers for mesh shading
+	bool generate_meshlets{false};
+
+	/// Store float positions as snorm16 with a dequantization transform per mesh, normals as octahedral
+	/// snorm16 and texture coordinates as half floats. Not applied when generating meshlets, as the
+	/// meshlet shaders read float attributes.
+	bool quantize_vertices{false};
+};
+
 /// Read a gltf file and return a scene object. Converts the gltf objects
 /// to our internal scene implementation. Mesh data is copied to vulkan buffers and
 /// images are loaded from the folder of gltf file to vulkan images.
 class GLTFLoader
 {
   public:
-	GLTFLoader(Device const &device);
+	GLTFLoader(Device const &device, const GLTFLoaderOptions &options = {});
 
 	virtual ~GLTFLoader() = default;
 
@@ -124,6 +154,8 @@ class GLTFLoader
 
 	Device const &device;
 
+	GLTFLoaderOptions options;
+
 	tinygltf::Model model;
 
 	std::string model_path;
@@ -42,12 +42,14 @@ struct HPPResourceInfo
 class HPPResourceSet : private vkb::ResourceSet
 {
   public:
+	using vkb::ResourceSet::get_bound_array_elements;
+	using vkb::ResourceSet::get_bound_bindings;
 	using vkb::ResourceSet::is_dirty;
 
   public:
-	const BindingMap<HPPResourceInfo> &get_resource_bindings() const
+	const HPPResourceInfo &get_resource(uint32_t binding, uint32_t array_element) const
 	{
-		return reinterpret_cast<BindingMap<HPPResourceInfo> const &>(vkb::ResourceSet::get_resource_bindings());
+		return reinterpret_cast<HPPResourceInfo const &>(vkb::ResourceSet::get_resource(binding, array_element));
 	}
 };
 
@@ -55,6 +57,8 @@ class HPPResourceBindingState : private vkb::ResourceBindingState
 {
   public:
 	using vkb::ResourceBindingState::clear_dirty;
+	using vkb::ResourceBindingState::get_bound_sets;
+	using vkb::ResourceBindingState::get_dirty_sets;
 	using vkb::ResourceBindingState::is_dirty;
 	using vkb::ResourceBindingState::reset;
 
@@ -85,9 +89,9 @@ class HPPResourceBindingState : private vkb::ResourceBindingState
 		vkb::ResourceBindingState::bind_input(reinterpret_cast<vkb::core::ImageView const &>(image_view), set, binding, array_element);
 	}
 
-	const std::unordered_map<uint32_t, vkb::HPPResourceSet> &get_resource_sets()
+	const vkb::HPPResourceSet &get_resource_set(uint32_t set) const
 	{
-		return reinterpret_cast<std::unordered_map<uint32_t, vkb::HPPResourceSet> const &>(vkb::ResourceBindingState::get_resource_sets());
+		return reinterpret_cast<vkb::HPPResourceSet const &>(vkb::ResourceBindingState::get_resource_set(set));
 	}
 };
 }        // namespace vkb
@@ -17,6 +17,9 @@
 
 #include "pipeline_state.h"
 
+#include <cstring>
+#include <type_traits>
+
 bool operator==(const VkVertexInputAttributeDescription &lhs, const VkVertexInputAttributeDescription &rhs)
 {
 	return std::tie(lhs.binding, lhs.format, lhs.location, lhs.offset) == std::tie(rhs.binding, rhs.format, rhs.location, rhs.offset);
@@ -84,11 +87,197 @@ bool operator!=(const vkb::ColorBlendState &lhs, const vkb::ColorBlendState &rhs
 
 namespace vkb
 {
+namespace
+{
+template <class T>
+inline void hash_field(uint64_t &seed, const T &value)
+{
+	hash_combine_64(seed, static_cast<uint64_t>(value));
+}
+
+inline void hash_field(uint64_t &seed, float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	hash_combine_64(seed, bits);
+}
+
+template <class THandle>
+inline void hash_handle(uint64_t &seed, THandle handle)
+{
+	// Non-dispatchable handles might be 32-bit pointers
+	using UintHandle = typename std::conditional<sizeof(THandle) == sizeof(uint32_t), uint32_t, uint64_t>::type;
+
+	hash_combine_64(seed, static_cast<uint64_t>(reinterpret_cast<UintHandle>(handle)));
+}
+
+inline void hash_field(uint64_t &seed, const StencilOpState &stencil)
+{
+	hash_field(seed, stencil.compare_op);
+	hash_field(seed, stencil.depth_fail_op);
+	hash_field(seed, stencil.fail_op);
+	hash_field(seed, stencil.pass_op);
+}
+
+uint64_t hash_state(const PipelineLayout &pipeline_layout)
+{
+	uint64_t result = 0;
+
+	hash_handle(result, pipeline_layout.get_handle());
+
+	for (auto shader_module : pipeline_layout.get_shader_modules())
+	{
+		hash_field(result, shader_module->get_id());
+	}
+
+	return result;
+}
+
+uint64_t hash_state(const VertexInputState &vertex_input_state)
+{
+	uint64_t result = 0;
+
+	for (auto &attribute : vertex_input_state.attributes)
+	{
+		hash_field(result, attribute.binding);
+		hash_field(result, attribute.format);
+		hash_field(result, attribute.location);
+		hash_field(result, attribute.offset);
+	}
+
+	// Separates the attributes from the bindings
+	hash_field(result, vertex_input_state.attributes.size());
+
+	for (auto &binding : vertex_input_state.bindings)
+	{
+		hash_field(result, binding.binding);
+		hash_field(result, binding.inputRate);
+		hash_field(result, binding.stride);
+	}
+
+	return result;
+}
+
+uint64_t hash_state(const InputAssemblyState &input_assembly_state, const ExtendedDynamicState &extended_dynamic_state)
+{
+	uint64_t result = 0;
+
+	if (!extended_dynamic_state.extended_dynamic_state2)
+	{
+		hash_field(result, input_assembly_state.primitive_restart_enable);
+	}
+
+	hash_field(result, input_assembly_state.topology);
+
+	return result;
+}
+
+uint64_t hash_state(const RasterizationState &rasterization_state, const ExtendedDynamicState &extended_dynamic_state)
+{
+	uint64_t result = 0;
+
+	if (!extended_dynamic_state.extended_dynamic_state)
+	{
+		hash_field(result, rasterization_state.cull_mode);
+		hash_field(result, rasterization_state.front_face);
+	}
+
+	if (!extended_dynamic_state.extended_dynamic_state2)
+	{
+		hash_field(result, rasterization_state.depth_bias_enable);
+		hash_field(result, rasterization_state.rasterizer_discard_enable);
+	}
+
+	hash_field(result, rasterization_state.depth_clamp_enable);
+	hash_field(result, rasterization_state.polygon_mode);
+
+	return result;
+}
+
+uint64_t hash_state(const ViewportState &viewport_state)
+{
+	uint64_t result = 0;
+
+	hash_field(result, viewport_state.viewport_count);
+	hash_field(result, viewport_state.scissor_count);
+
+	return result;
+}
+
+uint64_t hash_state(const MultisampleState &multisample_state)
+{
+	uint64_t result = 0;
+
+	hash_field(result, multisample_state.alpha_to_coverage_enable);
+	hash_field(result, multisample_state.alpha_to_one_enable);
+	hash_field(result, multisample_state.min_sample_shading);
+	hash_field(result, multisample_state.rasterization_samples);
+	hash_field(result, multisample_state.sample_shading_enable);
+	hash_field(result, multisample_state.sample_mask);
+
+	return result;
+}
+
+uint64_t hash_state(const DepthStencilState &depth_stencil_state, const ExtendedDynamicState &extended_dynamic_state)
+{
+	uint64_t result = 0;
+
+	// The whole depth stencil state is dynamic state
+	if (extended_dynamic_state.extended_dynamic_state)
+	{
+		return result;
+	}
+
+	hash_field(result, depth_stencil_state.back);
+	hash_field(result, depth_stencil_state.depth_bounds_test_enable);
+	hash_field(result, depth_stencil_state.depth_compare_op);
+	hash_field(result, depth_stencil_state.depth_test_enable);
+	hash_field(result, depth_stencil_state.depth_write_enable);
+	hash_field(result, depth_stencil_state.front);
+	hash_field(result, depth_stencil_state.stencil_test_enable);
+
+	return result;
+}
+
+uint64_t hash_state(const ColorBlendState &color_blend_state, const ExtendedDynamicState &extended_dynamic_state)
+{
+	uint64_t result = 0;
+
+	hash_field(result, color_blend_state.logic_op);
+	hash_field(result, color_blend_state.logic_op_enable);
+
+	// Only the number of attachments is part of the pipeline if the attachment states are dynamic state
+	if (extended_dynamic_state.color_blend)
+	{
+		hash_field(result, color_blend_state.attachments.size());
+
+		return result;
+	}
+
+	for (auto &attachment : color_blend_state.attachments)
+	{
+		hash_field(result, attachment.alpha_blend_op);
+		hash_field(result, attachment.blend_enable);
+		hash_field(result, attachment.color_blend_op);
+		hash_field(result, attachment.color_write_mask);
+		hash_field(result, attachment.dst_alpha_blend_factor);
+		hash_field(result, attachment.dst_color_blend_factor);
+		hash_field(result, attachment.src_alpha_blend_factor);
+		hash_field(result, attachment.src_color_blend_factor);
+	}
+
+	return result;
+}
+}        // namespace
+
 void SpecializationConstantState::reset()
 {
 	if (dirty)
 	{
 		specialization_constant_state.clear();
+
+		update_hash();
 	}
 
 	dirty = false;
@@ -116,11 +305,15 @@ void SpecializationConstantState::set_constant(uint32_t constant_id, const std::
 	dirty = true;
 
 	specialization_constant_state[constant_id] = value;
+
+	update_hash();
 }
 
 void SpecializationConstantState::set_specialization_constant_state(const std::map<uint32_t, std::vector<uint8_t>> &state)
 {
 	specialization_constant_state = state;
+
+	update_hash();
 }
 
 const std::map<uint32_t, std::vector<uint8_t>> &SpecializationConstantState::get_specialization_constant_state() const
@@ -128,6 +321,50 @@ const std::map<uint32_t, std::vector<uint8_t>> &SpecializationConstantState::get
 	return specialization_constant_state;
 }
 
+uint64_t SpecializationConstantState::get_hash() const
+{
+	return hash;
+}
+
+void SpecializationConstantState::update_hash()
+{
+	hash = 0;
+
+	for (auto &constant : specialization_constant_state)
+	{
+		hash_field(hash, constant.first);
+		hash_field(hash, constant.second.size());
+
+		for (auto data : constant.second)
+		{
+			hash_field(hash, data);
+		}
+	}
+}
+
+uint64_t hash_state(const RenderingState &rendering_state)
+{
+	uint64_t result = 0;
+
+	for (auto format : rendering_state.color_attachment_formats)
+	{
+		hash_field(result, format);
+	}
+
+	// Separates the color formats from the depth and stencil formats
+	hash_field(result, rendering_state.color_attachment_formats.size());
+
+	hash_field(result, rendering_state.depth_attachment_format);
+	hash_field(result, rendering_state.stencil_attachment_format);
+
+	return result;
+}
+
+PipelineState::PipelineState()
+{
+	reset();
+}
+
 void PipelineState::reset()
 {
 	clear_dirty();
@@ -136,6 +373,8 @@ void PipelineState::reset()
 
 	render_pass = nullptr;
 
+	rendering_state = {};
+
 	specialization_constant_state.reset();
 
 	vertex_input_state = {};
@@ -151,6 +390,24 @@ void PipelineState::reset()
 	color_blend_state = {};
 
 	subpass_index = {0U};
+
+	pipeline_layout_hash = 0;
+
+	dynamic_state_dirty = true;
+
+	update_hashes();
+}
+
+void PipelineState::update_hashes()
+{
+	vertex_input_state_hash   = hash_state(vertex_input_state);
+	input_assembly_state_hash = hash_state(input_assembly_state, extended_dynamic_state);
+	rasterization_state_hash  = hash_state(rasterization_state, extended_dynamic_state);
+	viewport_state_hash       = hash_state(viewport_state);
+	multisample_state_hash    = hash_state(multisample_state);
+	depth_stencil_state_hash  = hash_state(depth_stencil_state, extended_dynamic_state);
+	color_blend_state_hash    = hash_state(color_blend_state, extended_dynamic_state);
+	rendering_state_hash      = hash_state(rendering_state);
 }
 
 void PipelineState::set_pipeline_layout(PipelineLayout &new_pipeline_layout)
@@ -159,14 +416,16 @@ void PipelineState::set_pipeline_layout(PipelineLayout &new_pipeline_layout)
 	{
 		if (pipeline_layout->get_handle() != new_pipeline_layout.get_handle())
 		{
-			pipeline_layout = &new_pipeline_layout;
+			pipeline_layout      = &new_pipeline_layout;
+			pipeline_layout_hash = hash_state(new_pipeline_layout);
 
 			dirty = true;
 		}
 	}
 	else
 	{
-		pipeline_layout = &new_pipeline_layout;
+		pipeline_layout      = &new_pipeline_layout;
+		pipeline_layout_hash = hash_state(new_pipeline_layout);
 
 		dirty = true;
 	}
@@ -191,6 +450,20 @@ void PipelineState::set_render_pass(const RenderPass &new_render_pass)
 	}
 }
 
+void PipelineState::set_rendering_state(const RenderingState &new_rendering_state)
+{
+	auto hash = hash_state(new_rendering_state);
+
+	if (render_pass || hash != rendering_state_hash)
+	{
+		render_pass          = nullptr;
+		rendering_state      = new_rendering_state;
+		rendering_state_hash = hash;
+
+		dirty = true;
+	}
+}
+
 void PipelineState::set_specialization_constant(uint32_t constant_id, const std::vector<uint8_t> &data)
 {
 	specialization_constant_state.set_constant(constant_id, data);
@@ -205,7 +478,8 @@ void PipelineState::set_vertex_input_state(const VertexInputState &new_vertex_in
 {
 	if (vertex_input_state != new_vertex_input_state)
 	{
-		vertex_input_state = new_vertex_input_state;
+		vertex_input_state      = new_vertex_input_state;
+		vertex_input_state_hash = hash_state(vertex_input_state);
 
 		dirty = true;
 	}
@@ -217,7 +491,13 @@ void PipelineState::set_input_assembly_state(const InputAssemblyState &new_input
 	{
 		input_assembly_state = new_input_assembly_state;
 
-		dirty = true;
+		uint64_t hash = hash_state(input_assembly_state, extended_dynamic_state);
+
+		// Changes of states recorded as dynamic state don't need another pipeline
+		dirty               = dirty || hash != input_assembly_state_hash;
+		dynamic_state_dirty = true;
+
+		input_assembly_state_hash = hash;
 	}
 }
 
@@ -227,7 +507,13 @@ void PipelineState::set_rasterization_state(const RasterizationState &new_raster
 	{
 		rasterization_state = new_rasterization_state;
 
-		dirty = true;
+		uint64_t hash = hash_state(rasterization_state, extended_dynamic_state);
+
+		// Changes of states recorded as dynamic state don't need another pipeline
+		dirty               = dirty || hash != rasterization_state_hash;
+		dynamic_state_dirty = true;
+
+		rasterization_state_hash = hash;
 	}
 }
 
@@ -235,7 +521,8 @@ void PipelineState::set_viewport_state(const ViewportState &new_viewport_state)
 {
 	if (viewport_state != new_viewport_state)
 	{
-		viewport_state = new_viewport_state;
+		viewport_state      = new_viewport_state;
+		viewport_state_hash = hash_state(viewport_state);
 
 		dirty = true;
 	}
@@ -245,7 +532,8 @@ void PipelineState::set_multisample_state(const MultisampleState &new_multisampl
 {
 	if (multisample_state != new_multisample_state)
 	{
-		multisample_state = new_multisample_state;
+		multisample_state      = new_multisample_state;
+		multisample_state_hash = hash_state(multisample_state);
 
 		dirty = true;
 	}
@@ -257,7 +545,13 @@ void PipelineState::set_depth_stencil_state(const DepthStencilState &new_depth_s
 	{
 		depth_stencil_state = new_depth_stencil_state;
 
-		dirty = true;
+		uint64_t hash = hash_state(depth_stencil_state, extended_dynamic_state);
+
+		// Changes of states recorded as dynamic state don't need another pipeline
+		dirty               = dirty || hash != depth_stencil_state_hash;
+		dynamic_state_dirty = true;
+
+		depth_stencil_state_hash = hash;
 	}
 }
 
@@ -267,7 +561,27 @@ void PipelineState::set_color_blend_state(const ColorBlendState &new_color_blend
 	{
 		color_blend_state = new_color_blend_state;
 
-		dirty = true;
+		uint64_t hash = hash_state(color_blend_state, extended_dynamic_state);
+
+		// Changes of states recorded as dynamic state don't need another pipeline
+		dirty               = dirty || hash != color_blend_state_hash;
+		dynamic_state_dirty = true;
+
+		color_blend_state_hash = hash;
+	}
+}
+
+void PipelineState::set_extended_dynamic_state(const ExtendedDynamicState &new_extended_dynamic_state)
+{
+	if (std::tie(extended_dynamic_state.extended_dynamic_state, extended_dynamic_state.extended_dynamic_state2, extended_dynamic_state.color_blend) !=
+	    std::tie(new_extended_dynamic_state.extended_dynamic_state, new_extended_dynamic_state.extended_dynamic_state2, new_extended_dynamic_state.color_blend))
+	{
+		extended_dynamic_state = new_extended_dynamic_state;
+
+		update_hashes();
+
+		dirty               = true;
+		dynamic_state_dirty = true;
 	}
 }
 
@@ -292,6 +606,11 @@ const RenderPass *PipelineState::get_render_pass() const
 	return render_pass;
 }
 
+const RenderingState &PipelineState::get_rendering_state() const
+{
+	return rendering_state;
+}
+
 const SpecializationConstantState &PipelineState::get_specialization_constant_state() const
 {
 	return specialization_constant_state;
@@ -337,6 +656,11 @@ uint32_t PipelineState::get_subpass_index() const
 	return subpass_index;
 }
 
+const ExtendedDynamicState &PipelineState::get_extended_dynamic_state() const
+{
+	return extended_dynamic_state;
+}
+
 bool PipelineState::is_dirty() const
 {
 	return dirty || specialization_constant_state.is_dirty();
@@ -347,4 +671,41 @@ void PipelineState::clear_dirty()
 	dirty = false;
 	specialization_constant_state.clear_dirty();
 }
+
+bool PipelineState::is_dynamic_state_dirty() const
+{
+	return dynamic_state_dirty;
+}
+
+void PipelineState::clear_dynamic_state_dirty()
+{
+	dynamic_state_dirty = false;
+}
+
+uint64_t PipelineState::get_hash() const
+{
+	uint64_t result = pipeline_layout_hash;
+
+	// For graphics only
+	if (render_pass)
+	{
+		hash_combine_64(result, render_pass->get_handle_u64());
+	}
+	else
+	{
+		hash_combine_64(result, rendering_state_hash);
+	}
+
+	hash_combine_64(result, specialization_constant_state.get_hash());
+	hash_field(result, subpass_index);
+	hash_combine_64(result, vertex_input_state_hash);
+	hash_combine_64(result, input_assembly_state_hash);
+	hash_combine_64(result, viewport_state_hash);
+	hash_combine_64(result, rasterization_state_hash);
+	hash_combine_64(result, multisample_state_hash);
+	hash_combine_64(result, depth_stencil_state_hash);
+	hash_combine_64(result, color_blend_state_hash);
+
+	return result;
+}
 }        // namespace vkb
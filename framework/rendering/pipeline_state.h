@@ -25,6 +25,22 @@
 
 namespace vkb
 {
+/**
+ * @brief The groups of pipeline states recorded with extended dynamic state commands, instead of
+ *        being baked into the pipelines. These states then don't multiply the pipelines of the cache.
+ */
+struct ExtendedDynamicState
+{
+	/// Cull mode, front face and the depth stencil state, from VK_EXT_extended_dynamic_state
+	bool extended_dynamic_state{false};
+
+	/// Depth bias enable, primitive restart enable and rasterizer discard enable, from VK_EXT_extended_dynamic_state2
+	bool extended_dynamic_state2{false};
+
+	/// Color blend enables, equations and write masks, from VK_EXT_extended_dynamic_state3
+	bool color_blend{false};
+};
+
 struct VertexInputState
 {
 	std::vector<VkVertexInputBindingDescription> bindings;
@@ -133,6 +149,18 @@ struct ColorBlendState
 	std::vector<ColorBlendAttachmentState> attachments;
 };
 
+/**
+ * @brief Formats of the attachments a pipeline renders to with VK_KHR_dynamic_rendering, in place of a render pass
+ */
+struct RenderingState
+{
+	std::vector<VkFormat> color_attachment_formats;
+
+	VkFormat depth_attachment_format{VK_FORMAT_UNDEFINED};
+
+	VkFormat stencil_attachment_format{VK_FORMAT_UNDEFINED};
+};
+
 /// Helper class to create specialization constants for a Vulkan pipeline. The state tracks a pipeline globally, and not per shader. Two shaders using the same constant_id will have the same data.
 class SpecializationConstantState
 {
@@ -152,10 +180,19 @@ class SpecializationConstantState
 
 	const std::map<uint32_t, std::vector<uint8_t>> &get_specialization_constant_state() const;
 
+	/**
+	 * @return Hash of the constants, updated when they change
+	 */
+	uint64_t get_hash() const;
+
   private:
 	bool dirty{false};
 	// Map tracking state of the Specialization Constants
 	std::map<uint32_t, std::vector<uint8_t>> specialization_constant_state;
+
+	uint64_t hash{0};
+
+	void update_hash();
 };
 
 template <class T>
@@ -170,15 +207,27 @@ inline void SpecializationConstantState::set_constant<bool>(std::uint32_t consta
 	set_constant(constant_id, to_bytes(static_cast<std::uint32_t>(data)));
 }
 
+/**
+ * @brief The state of a pipeline, as recorded by a command buffer. Each sub-state keeps its own hash,
+ *        updated only when the sub-state is set, so the hash of the pipeline state looking up the
+ *        pipeline in the resource cache only combines a handful of 64-bit values.
+ */
 class PipelineState
 {
   public:
+	PipelineState();
+
 	void reset();
 
 	void set_pipeline_layout(PipelineLayout &pipeline_layout);
 
 	void set_render_pass(const RenderPass &render_pass);
 
+	/**
+	 * @brief Sets the attachment formats of a dynamic rendering scope, the pipeline is then created without a render pass
+	 */
+	void set_rendering_state(const RenderingState &rendering_state);
+
 	void set_specialization_constant(uint32_t constant_id, const std::vector<uint8_t> &data);
 
 	void set_vertex_input_state(const VertexInputState &vertex_input_state);
@@ -197,10 +246,18 @@ class PipelineState
 
 	void set_subpass_index(uint32_t subpass_index);
 
+	/**
+	 * @brief Sets the states recorded as dynamic state, they are left out of the hash of the pipeline state
+	 *        and changing them doesn't make it dirty. Kept on reset.
+	 */
+	void set_extended_dynamic_state(const ExtendedDynamicState &extended_dynamic_state);
+
 	const PipelineLayout &get_pipeline_layout() const;
 
 	const RenderPass *get_render_pass() const;
 
+	const RenderingState &get_rendering_state() const;
+
 	const SpecializationConstantState &get_specialization_constant_state() const;
 
 	const VertexInputState &get_vertex_input_state() const;
@@ -219,17 +276,37 @@ class PipelineState
 
 	uint32_t get_subpass_index() const;
 
+	const ExtendedDynamicState &get_extended_dynamic_state() const;
+
 	bool is_dirty() const;
 
 	void clear_dirty();
 
+	/**
+	 * @return Whether a state recorded as dynamic state changed since clear_dynamic_state_dirty
+	 */
+	bool is_dynamic_state_dirty() const;
+
+	void clear_dynamic_state_dirty();
+
+	/**
+	 * @return Hash of the whole state, combined from the cached hashes of its sub-states
+	 */
+	uint64_t get_hash() const;
+
   private:
 	bool dirty{false};
 
+	bool dynamic_state_dirty{false};
+
+	ExtendedDynamicState extended_dynamic_state{};
+
 	PipelineLayout *pipeline_layout{nullptr};
 
 	const RenderPass *render_pass{nullptr};
 
+	RenderingState rendering_state{};
+
 	SpecializationConstantState specialization_constant_state{};
 
 	VertexInputState vertex_input_state{};
@@ -247,5 +324,26 @@ class PipelineState
 	ColorBlendState color_blend_state{};
 
 	uint32_t subpass_index{0U};
+
+	// Hashes of the sub-states, updated by their setters
+	uint64_t pipeline_layout_hash{0};
+
+	uint64_t vertex_input_state_hash{0};
+
+	uint64_t input_assembly_state_hash{0};
+
+	uint64_t rasterization_state_hash{0};
+
+	uint64_t viewport_state_hash{0};
+
+	uint64_t multisample_state_hash{0};
+
+	uint64_t depth_stencil_state_hash{0};
+
+	uint64_t color_blend_state_hash{0};
+
+	uint64_t rendering_state_hash{0};
+
+	void update_hashes();
 };
 }        // namespace vkb
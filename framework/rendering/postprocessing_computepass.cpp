@@ -19,6 +19,8 @@
 
 #include "postprocessing_pipeline.h"
 
+#include <set>
+
 namespace vkb
 {
 PostProcessingComputePass::PostProcessingComputePass(PostProcessingPipeline *parent, const ShaderSource &cs_source, const ShaderVariant &cs_variant,
@@ -93,7 +95,9 @@ void PostProcessingComputePass::transition_images(CommandBuffer &command_buffer,
 	fallback_barrier_src.pipeline_stage     = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 	fallback_barrier_src.image_read_access  = 0;        // For UNDEFINED -> STORAGE in first CP
 	fallback_barrier_src.image_write_access = 0;
-	const auto prev_pass_barrier_info       = get_predecessor_src_barrier_info(fallback_barrier_src);
+
+	// On the async compute queue, the ownership transfer already waited for the previous pass
+	const auto prev_pass_barrier_info = async ? fallback_barrier_src : get_predecessor_src_barrier_info(fallback_barrier_src);
 
 	// Get compute shader from cache
 	auto &resource_cache  = command_buffer.get_device().get_resource_cache();
@@ -245,6 +249,64 @@ void PostProcessingComputePass::draw(CommandBuffer &command_buffer, RenderTarget
 	command_buffer.dispatch(n_workgroups.x, n_workgroups.y, n_workgroups.z);
 }
 
+void PostProcessingComputePass::transfer_image_ownership(CommandBuffer &command_buffer, RenderTarget &default_render_target, uint32_t src_queue_family, uint32_t dst_queue_family,
+                                                         const BarrierInfo &barrier_info, bool release)
+{
+	std::set<const core::ImageView *> transferred_views;
+
+	auto transfer_images = [&](const SampledImageMap &images) {
+		for (const auto &it : images)
+		{
+			const uint32_t *attachment = it.second.get_target_attachment();
+			if (attachment == nullptr)
+			{
+				continue;
+			}
+
+			auto *image_rt = it.second.get_render_target();
+			if (image_rt == nullptr)
+			{
+				image_rt = &default_render_target;
+			}
+
+			assert(*attachment < image_rt->get_views().size());
+			const auto &view = image_rt->get_views()[*attachment];
+
+			VkImageLayout layout = image_rt->get_layout(*attachment);
+
+			// The contents of images in an undefined layout are discarded, they need no transfer
+			if (layout == VK_IMAGE_LAYOUT_UNDEFINED || !transferred_views.insert(&view).second)
+			{
+				continue;
+			}
+
+			vkb::ImageMemoryBarrier barrier;
+			barrier.old_layout       = layout;
+			barrier.new_layout       = layout;
+			barrier.old_queue_family = src_queue_family;
+			barrier.new_queue_family = dst_queue_family;
+
+			if (release)
+			{
+				barrier.src_stage_mask  = barrier_info.pipeline_stage;
+				barrier.src_access_mask = barrier_info.image_write_access;
+				barrier.dst_stage_mask  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+			}
+			else
+			{
+				barrier.src_stage_mask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+				barrier.dst_stage_mask  = barrier_info.pipeline_stage;
+				barrier.dst_access_mask = barrier_info.image_read_access | barrier_info.image_write_access;
+			}
+
+			command_buffer.image_memory_barrier(view, barrier);
+		}
+	};
+
+	transfer_images(sampled_images);
+	transfer_images(storage_images);
+}
+
 PostProcessingComputePass::BarrierInfo PostProcessingComputePass::get_src_barrier_info() const
 {
 	BarrierInfo info{};
@@ -64,6 +64,26 @@ class PostProcessingComputePass : public PostProcessingPass<PostProcessingComput
 		return n_workgroups;
 	}
 
+	/**
+	 * @brief Sets whether the pass runs on the async compute queue of the render context, alongside graphics work.
+	 *        The images it accesses are transferred between queue families as needed.
+	 * @remarks The commands recorded before the pass are submitted when the pipeline draws it,
+	 *          see vkb::PostProcessingPipeline::draw().
+	 */
+	inline PostProcessingComputePass &set_async(bool enable)
+	{
+		async = enable;
+		return *this;
+	}
+
+	/**
+	 * @brief Returns whether the pass runs on the async compute queue.
+	 */
+	inline bool is_async() const
+	{
+		return async;
+	}
+
 	/**
 	* @brief Maps the names of samplers in the shader to vkb::core::SampledImage.
 	*        These are given as samplers to the subpass, at set 0; they are bound automatically according to their name.
@@ -166,6 +186,9 @@ class PostProcessingComputePass : public PostProcessingPass<PostProcessingComput
 
 	BarrierInfo get_src_barrier_info() const override;
 	BarrierInfo get_dst_barrier_info() const override;
+
+	void transfer_image_ownership(CommandBuffer &command_buffer, RenderTarget &default_render_target, uint32_t src_queue_family, uint32_t dst_queue_family,
+	                              const BarrierInfo &barrier_info, bool release) override;
 };
 
 }        // namespace vkb
\ No newline at end of file
@@ -81,6 +81,9 @@ class PostProcessingPassBase
 	HookFunc pre_draw{};
 	HookFunc post_draw{};
 
+	/// Whether the pass runs on the async compute queue of the render context
+	bool async{false};
+
 	/**
 	 * @brief Returns the parent's render context.
 	 */
@@ -115,6 +118,20 @@ class PostProcessingPassBase
 	 *        if any, or returns the specified default if this is the first pass in the pipeline.
 	 */
 	BarrierInfo get_predecessor_src_barrier_info(BarrierInfo fallback = {}) const;
+
+	/**
+	 * @brief Records the queue family ownership transfer of the render target images this pass accesses,
+	 *        for passes running on another queue than the rest of the pipeline.
+	 * @param command_buffer The command buffer releasing or acquiring the images
+	 * @param default_render_target The render target the pipeline draws to
+	 * @param src_queue_family The queue family releasing the images
+	 * @param dst_queue_family The queue family acquiring the images
+	 * @param barrier_info The stage and accesses of the images on the queue of command_buffer
+	 * @param release Whether command_buffer releases the images, or acquires them
+	 */
+	virtual void transfer_image_ownership(CommandBuffer &command_buffer, RenderTarget &default_render_target, uint32_t src_queue_family, uint32_t dst_queue_family,
+	                                      const BarrierInfo &barrier_info, bool release)
+	{}
 };
 
 /**
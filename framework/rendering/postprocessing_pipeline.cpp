@@ -17,17 +17,32 @@
 
 #include "postprocessing_pipeline.h"
 
+#include <algorithm>
+
 #include "common/utils.h"
+#include "postprocessing_computepass.h"
+#include "postprocessing_renderpass.h"
 
 namespace vkb
 {
+namespace
+{
+// Stages in which a render pass accesses the images of a previous pass, through its attachments or its shaders
+constexpr VkPipelineStageFlags RENDER_PASS_WAIT_STAGES = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                                         VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+}        // namespace
+
 PostProcessingPipeline::PostProcessingPipeline(RenderContext &render_context, ShaderSource triangle_vs) :
     render_context{&render_context},
     triangle_vs{std::move(triangle_vs)}
 {}
 
-void PostProcessingPipeline::draw(CommandBuffer &command_buffer, RenderTarget &default_render_target)
+CommandBuffer &PostProcessingPipeline::draw(CommandBuffer &command_buffer, RenderTarget &default_render_target)
 {
+	CommandBuffer *graphics_command_buffer = &command_buffer;
+
+	assign_intermediate_targets(default_render_target);
+
 	for (current_pass_index = 0; current_pass_index < passes.size(); current_pass_index++)
 	{
 		auto &pass = *passes[current_pass_index];
@@ -36,34 +51,535 @@ void PostProcessingPipeline::draw(CommandBuffer &command_buffer, RenderTarget &d
 		{
 			pass.debug_name = fmt::format("PPP pass #{}", current_pass_index);
 		}
-		ScopedDebugLabel marker{command_buffer, pass.debug_name.c_str()};
 
-		if (!pass.prepared)
+		auto fused_chain = fusion ? get_fused_chain(current_pass_index, default_render_target) : std::vector<PostProcessingRenderPass *>{};
+
+		if (!fused_chain.empty())
 		{
-			ScopedDebugLabel marker{command_buffer, "Prepare"};
+			size_t first_pass_index = current_pass_index;
+
+			if (pending_async_pass && depends_on_async_pass(first_pass_index, first_pass_index + fused_chain.size() - 1, default_render_target))
+			{
+				graphics_command_buffer = &wait_async_pass(*graphics_command_buffer, RENDER_PASS_WAIT_STAGES, default_render_target);
+			}
+
+			std::string debug_name = fmt::format("PPP fused passes #{}-#{}", first_pass_index, first_pass_index + fused_chain.size() - 1);
+
+			ScopedDebugLabel marker{*graphics_command_buffer, debug_name.c_str()};
+
+			for (auto *fused_pass : fused_chain)
+			{
+				if (fused_pass->debug_name.empty())
+				{
+					fused_pass->debug_name = fmt::format("PPP pass #{}", current_pass_index);
+				}
+
+				if (!fused_pass->prepared)
+				{
+					fused_pass->prepare(*graphics_command_buffer, default_render_target);
+					fused_pass->prepared = true;
+				}
+
+				if (fused_pass->pre_draw)
+				{
+					fused_pass->pre_draw();
+				}
+
+				current_pass_index++;
+			}
+
+			// The chain is drawn as its last pass, which ends the render pass unless it is the last of the pipeline
+			current_pass_index--;
 
-			pass.prepare(command_buffer, default_render_target);
-			pass.prepared = true;
+			auto &render_target = pass.render_target ? *pass.render_target : default_render_target;
+
+			fused_chain.front()->draw_fused(*graphics_command_buffer, default_render_target, fused_chain,
+			                                get_attachments_read_after(current_pass_index, render_target, default_render_target));
+
+			recorded_since_async = pending_async_pass != nullptr;
+
+			continue;
 		}
 
-		if (pass.pre_draw)
+		if (pending_async_pass && (pass.async || depends_on_async_pass(current_pass_index, current_pass_index, default_render_target)))
 		{
-			ScopedDebugLabel marker{command_buffer, "Pre-draw"};
+			// Asynchronous passes are submitted after the graphics work they follow, which waits for the previous one
+			VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+			if (!pass.async)
+			{
+				wait_stage = dynamic_cast<PostProcessingRenderPass *>(&pass) ? RENDER_PASS_WAIT_STAGES : pass.get_dst_barrier_info().pipeline_stage;
+			}
 
-			pass.pre_draw();
+			graphics_command_buffer = &wait_async_pass(*graphics_command_buffer, wait_stage, default_render_target);
 		}
 
-		pass.draw(command_buffer, default_render_target);
+		auto &pass_command_buffer = pass.async ? begin_async_pass(*graphics_command_buffer, pass, default_render_target) : *graphics_command_buffer;
 
-		if (pass.post_draw)
 		{
-			ScopedDebugLabel marker{command_buffer, "Post-draw"};
+			ScopedDebugLabel marker{pass_command_buffer, pass.debug_name.c_str()};
+
+			if (!pass.prepared)
+			{
+				ScopedDebugLabel marker{pass_command_buffer, "Prepare"};
+
+				pass.prepare(pass_command_buffer, default_render_target);
+				pass.prepared = true;
+			}
+
+			if (pass.pre_draw)
+			{
+				ScopedDebugLabel marker{pass_command_buffer, "Pre-draw"};
 
-			pass.post_draw();
+				pass.pre_draw();
+			}
+
+			pass.draw(pass_command_buffer, default_render_target);
+
+			if (pass.post_draw)
+			{
+				ScopedDebugLabel marker{pass_command_buffer, "Post-draw"};
+
+				pass.post_draw();
+			}
 		}
+
+		if (pass.async)
+		{
+			graphics_command_buffer = &end_async_pass(pass_command_buffer, pass, default_render_target);
+		}
+		else
+		{
+			recorded_since_async = pending_async_pass != nullptr;
+		}
+	}
+
+	// The pipeline ended with an asynchronous pass, the commands recorded after the pipeline wait for it
+	if (pending_async_pass)
+	{
+		graphics_command_buffer = &wait_async_pass(*graphics_command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, default_render_target);
 	}
 
 	current_pass_index = 0;
+
+	return *graphics_command_buffer;
+}
+
+std::vector<PostProcessingRenderPass *> PostProcessingPipeline::get_fused_chain(size_t first_pass_index, RenderTarget &default_render_target)
+{
+	std::vector<PostProcessingRenderPass *> chain;
+
+	auto *render_target = passes[first_pass_index]->render_target ? passes[first_pass_index]->render_target : &default_render_target;
+
+	// Attachments written by the passes of the chain so far
+	std::unordered_set<uint32_t> written_attachments;
+
+	for (size_t i = first_pass_index; i < passes.size(); ++i)
+	{
+		auto *pass = dynamic_cast<PostProcessingRenderPass *>(passes[i].get());
+
+		if (!pass || pass->async || (pass->render_target ? pass->render_target : &default_render_target) != render_target)
+		{
+			break;
+		}
+
+		// Attachments of a render pass cannot be sampled while they are written
+		bool samples_written_attachment = false;
+
+		for (auto &step_ptr : pass->pipeline.get_subpasses())
+		{
+			auto &step = *dynamic_cast<PostProcessingSubpass *>(step_ptr.get());
+
+			for (auto &it : step.get_sampled_images())
+			{
+				const uint32_t *attachment = it.second.get_target_attachment();
+
+				if (attachment && &it.second.get_render_target(*render_target) == render_target && written_attachments.count(*attachment) != 0)
+				{
+					samples_written_attachment = true;
+				}
+			}
+		}
+
+		if (samples_written_attachment)
+		{
+			break;
+		}
+
+		for (auto &step_ptr : pass->pipeline.get_subpasses())
+		{
+			for (uint32_t output : step_ptr->get_output_attachments())
+			{
+				written_attachments.insert(output);
+			}
+		}
+
+		chain.push_back(pass);
+	}
+
+	if (chain.size() < 2)
+	{
+		chain.clear();
+	}
+
+	return chain;
+}
+
+std::unordered_set<uint32_t> PostProcessingPipeline::get_attachments_read_after(size_t last_pass_index, const RenderTarget &render_target, RenderTarget &default_render_target)
+{
+	std::unordered_set<uint32_t> read_attachments;
+
+	auto add_sampled_image = [&](const core::SampledImage &image, RenderTarget &fallback_render_target) {
+		const uint32_t *attachment = image.get_target_attachment();
+
+		if (attachment && &image.get_render_target(fallback_render_target) == &render_target)
+		{
+			read_attachments.insert(*attachment);
+		}
+	};
+
+	for (size_t i = last_pass_index + 1; i < passes.size(); ++i)
+	{
+		auto &pass_render_target = passes[i]->render_target ? *passes[i]->render_target : default_render_target;
+
+		if (auto *render_pass = dynamic_cast<PostProcessingRenderPass *>(passes[i].get()))
+		{
+			for (auto &step_ptr : render_pass->pipeline.get_subpasses())
+			{
+				auto &step = *dynamic_cast<PostProcessingSubpass *>(step_ptr.get());
+
+				if (&pass_render_target == &render_target)
+				{
+					for (auto &it : step.get_input_attachments())
+					{
+						read_attachments.insert(it.second);
+					}
+				}
+
+				for (auto &it : step.get_sampled_images())
+				{
+					add_sampled_image(it.second, pass_render_target);
+				}
+			}
+		}
+		else if (auto *compute_pass = dynamic_cast<PostProcessingComputePass *>(passes[i].get()))
+		{
+			for (auto &it : compute_pass->get_sampled_images())
+			{
+				add_sampled_image(it.second, default_render_target);
+			}
+
+			for (auto &it : compute_pass->get_storage_images())
+			{
+				add_sampled_image(it.second, default_render_target);
+			}
+		}
+		else
+		{
+			// Other passes may read any attachment
+			for (uint32_t j = 0; j < to_u32(render_target.get_attachments().size()); ++j)
+			{
+				read_attachments.insert(j);
+			}
+		}
+	}
+
+	return read_attachments;
+}
+
+void PostProcessingPipeline::assign_intermediate_targets(RenderTarget &default_render_target)
+{
+	std::unordered_map<const PostProcessingPassBase *, size_t> pass_indices;
+
+	// Last pass reading the intermediate output of each pass
+	std::vector<size_t> last_reads(passes.size(), 0);
+
+	bool has_intermediate_outputs = false;
+
+	for (size_t i = 0; i < passes.size(); ++i)
+	{
+		pass_indices[passes[i].get()] = i;
+
+		auto *render_pass = dynamic_cast<PostProcessingRenderPass *>(passes[i].get());
+
+		if (!render_pass)
+		{
+			continue;
+		}
+
+		has_intermediate_outputs |= render_pass->intermediate_format != VK_FORMAT_UNDEFINED;
+
+		for (auto &step_ptr : render_pass->pipeline.get_subpasses())
+		{
+			auto &step = *dynamic_cast<PostProcessingSubpass *>(step_ptr.get());
+
+			for (auto &it : step.intermediate_outputs)
+			{
+				auto pass_it = pass_indices.find(it.second);
+				assert(pass_it != pass_indices.end() && pass_it->second < i && "Intermediate outputs are read by later passes");
+
+				last_reads[pass_it->second] = std::max(last_reads[pass_it->second], i);
+			}
+		}
+	}
+
+	if (!has_intermediate_outputs)
+	{
+		return;
+	}
+
+	intermediate_targets.resize(render_context->get_render_frames().size());
+
+	auto &frame_targets = intermediate_targets[render_context->get_active_frame_index()];
+
+	// Each frame has its own targets, the previous frames may still be reading theirs
+	const auto &extent = default_render_target.get_extent();
+	if (!frame_targets.empty() && (frame_targets.front()->get_extent().width != extent.width || frame_targets.front()->get_extent().height != extent.height))
+	{
+		frame_targets.clear();
+	}
+
+	// Pass after which each target can be written again, or none if it is not used yet
+	std::vector<size_t> target_last_reads(frame_targets.size(), ~size_t{0});
+
+	for (size_t i = 0; i < passes.size(); ++i)
+	{
+		auto *render_pass = dynamic_cast<PostProcessingRenderPass *>(passes[i].get());
+
+		if (!render_pass || render_pass->intermediate_format == VK_FORMAT_UNDEFINED)
+		{
+			continue;
+		}
+
+		// A pass cannot write the target it reads, so the target must be free before this pass
+		size_t target_index = 0;
+		for (; target_index < frame_targets.size(); ++target_index)
+		{
+			if (frame_targets[target_index]->get_attachments()[0].format == render_pass->intermediate_format &&
+			    (target_last_reads[target_index] == ~size_t{0} || target_last_reads[target_index] < i))
+			{
+				break;
+			}
+		}
+
+		if (target_index == frame_targets.size())
+		{
+			core::Image image{render_context->get_device(),
+			                  VkExtent3D{extent.width, extent.height, 1},
+			                  render_pass->intermediate_format,
+			                  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
+			                  VMA_MEMORY_USAGE_GPU_ONLY};
+
+			std::vector<core::Image> images;
+			images.push_back(std::move(image));
+
+			frame_targets.push_back(std::make_unique<RenderTarget>(std::move(images)));
+			target_last_reads.push_back(~size_t{0});
+		}
+
+		target_last_reads[target_index] = std::max(i, last_reads[i]);
+
+		if (render_pass->render_target != frame_targets[target_index].get())
+		{
+			render_pass->render_target     = frame_targets[target_index].get();
+			render_pass->load_stores_dirty = true;
+		}
+	}
+
+	// Point the readers to the targets of this frame
+	for (auto &pass : passes)
+	{
+		auto *render_pass = dynamic_cast<PostProcessingRenderPass *>(pass.get());
+
+		if (!render_pass)
+		{
+			continue;
+		}
+
+		for (auto &step_ptr : render_pass->pipeline.get_subpasses())
+		{
+			auto &step = *dynamic_cast<PostProcessingSubpass *>(step_ptr.get());
+
+			for (auto &it : step.intermediate_outputs)
+			{
+				auto &sampled_image = step.sampled_images.at(it.first);
+
+				if (sampled_image.get_render_target() != it.second->render_target)
+				{
+					sampled_image.set_render_target(it.second->render_target);
+					render_pass->load_stores_dirty = true;
+				}
+			}
+		}
+	}
+}
+
+CommandBuffer &PostProcessingPipeline::begin_async_pass(CommandBuffer &command_buffer, PostProcessingPassBase &pass, RenderTarget &default_render_target)
+{
+	const auto &compute_queue  = render_context->get_async_compute_queue();
+	const auto &graphics_queue = render_context->get_queue();
+
+	uint32_t graphics_family = graphics_queue.get_family_index();
+	uint32_t compute_family  = compute_queue.get_family_index();
+
+	PostProcessingPassBase::BarrierInfo compute_barrier_info{VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT};
+
+	if (graphics_family != compute_family)
+	{
+		pass.transfer_image_ownership(command_buffer, default_render_target, graphics_family, compute_family,
+		                              pass.get_predecessor_src_barrier_info(compute_barrier_info), true);
+	}
+
+	command_buffer.end();
+
+	async_wait_semaphore = render_context->submit_partial({&command_buffer});
+
+	auto &compute_command_buffer = render_context->get_active_frame().request_command_buffer(compute_queue);
+	compute_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+	if (graphics_family != compute_family)
+	{
+		pass.transfer_image_ownership(compute_command_buffer, default_render_target, graphics_family, compute_family, compute_barrier_info, false);
+	}
+
+	return compute_command_buffer;
+}
+
+CommandBuffer &PostProcessingPipeline::end_async_pass(CommandBuffer &compute_command_buffer, PostProcessingPassBase &pass, RenderTarget &default_render_target)
+{
+	const auto &compute_queue  = render_context->get_async_compute_queue();
+	const auto &graphics_queue = render_context->get_queue();
+
+	uint32_t graphics_family = graphics_queue.get_family_index();
+	uint32_t compute_family  = compute_queue.get_family_index();
+
+	if (graphics_family != compute_family)
+	{
+		pass.transfer_image_ownership(compute_command_buffer, default_render_target, compute_family, graphics_family, pass.get_src_barrier_info(), true);
+	}
+
+	compute_command_buffer.end();
+
+	// The graphics commands wait for the compute work from the first pass accessing its images, see wait_async_pass()
+	pending_async_pass     = &pass;
+	async_signal_semaphore = render_context->submit(compute_queue, {&compute_command_buffer}, async_wait_semaphore, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+	recorded_since_async   = false;
+
+	async_images.clear();
+	async_images_known = get_accessed_images(pass, default_render_target, async_images);
+
+	auto &graphics_command_buffer = render_context->get_active_frame().request_command_buffer(graphics_queue);
+	graphics_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+	return graphics_command_buffer;
+}
+
+CommandBuffer &PostProcessingPipeline::wait_async_pass(CommandBuffer &command_buffer, VkPipelineStageFlags wait_stage, RenderTarget &default_render_target)
+{
+	const auto &compute_queue  = render_context->get_async_compute_queue();
+	const auto &graphics_queue = render_context->get_queue();
+
+	uint32_t graphics_family = graphics_queue.get_family_index();
+	uint32_t compute_family  = compute_queue.get_family_index();
+
+	CommandBuffer *graphics_command_buffer = &command_buffer;
+
+	// The passes recorded since the compute work was submitted do not access its images, they run alongside it
+	if (recorded_since_async)
+	{
+		command_buffer.end();
+
+		render_context->submit_partial({&command_buffer});
+
+		graphics_command_buffer = &render_context->get_active_frame().request_command_buffer(graphics_queue);
+		graphics_command_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	}
+
+	render_context->add_wait_semaphore(async_signal_semaphore, wait_stage);
+
+	if (graphics_family != compute_family)
+	{
+		// The following passes sample or transition the images the compute pass wrote
+		PostProcessingPassBase::BarrierInfo graphics_barrier_info{wait_stage, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT};
+
+		pending_async_pass->transfer_image_ownership(*graphics_command_buffer, default_render_target, compute_family, graphics_family, graphics_barrier_info, false);
+	}
+
+	pending_async_pass     = nullptr;
+	async_signal_semaphore = VK_NULL_HANDLE;
+	recorded_since_async   = false;
+
+	async_images.clear();
+
+	return *graphics_command_buffer;
+}
+
+bool PostProcessingPipeline::depends_on_async_pass(size_t first_pass_index, size_t last_pass_index, RenderTarget &default_render_target)
+{
+	// The last pass may leave its render pass open to the commands following the pipeline
+	if (!async_images_known || last_pass_index + 1 == passes.size())
+	{
+		return true;
+	}
+
+	std::unordered_set<VkImage> images;
+
+	for (size_t i = first_pass_index; i <= last_pass_index; ++i)
+	{
+		if (!get_accessed_images(*passes[i], default_render_target, images))
+		{
+			return true;
+		}
+	}
+
+	return std::any_of(images.begin(), images.end(), [this](VkImage image) { return async_images.count(image) != 0; });
+}
+
+bool PostProcessingPipeline::get_accessed_images(PostProcessingPassBase &pass, RenderTarget &default_render_target, std::unordered_set<VkImage> &images)
+{
+	if (auto *render_pass = dynamic_cast<PostProcessingRenderPass *>(&pass))
+	{
+		auto &render_target = pass.render_target ? *pass.render_target : default_render_target;
+
+		for (auto &view : render_target.get_views())
+		{
+			images.insert(view.get_image().get_handle());
+		}
+
+		for (auto &step_ptr : render_pass->pipeline.get_subpasses())
+		{
+			auto &step = *dynamic_cast<PostProcessingSubpass *>(step_ptr.get());
+
+			for (auto &it : step.get_sampled_images())
+			{
+				images.insert(it.second.get_image_view(render_target).get_image().get_handle());
+			}
+
+			for (auto &it : step.get_storage_images())
+			{
+				images.insert(it.second->get_image().get_handle());
+			}
+		}
+
+		return true;
+	}
+
+	if (auto *compute_pass = dynamic_cast<PostProcessingComputePass *>(&pass))
+	{
+		for (auto &it : compute_pass->get_sampled_images())
+		{
+			images.insert(it.second.get_image_view(default_render_target).get_image().get_handle());
+		}
+
+		for (auto &it : compute_pass->get_storage_images())
+		{
+			images.insert(it.second.get_image_view(default_render_target).get_image().get_handle());
+		}
+
+		return true;
+	}
+
+	return false;
 }
 
 }        // namespace vkb
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <unordered_set>
+
+#include "common/error.h"
 #include "postprocessing_pass.h"
 
 namespace vkb
@@ -48,8 +51,17 @@ class PostProcessingPipeline
 	 * @brief Runs all renderpasses in this pipeline, recording commands into the given command buffer.
 	 * @remarks vkb::PostProcessingRenderpass that do not explicitly have a vkb::RenderTarget set will render
 	 *          to default_render_target.
+	 * @remarks For each asynchronous compute pass, the commands recorded so far are ended and submitted with
+	 *          RenderContext::submit_partial(), the pass is submitted to the async compute queue, and the following
+	 *          passes are recorded into a new command buffer of the active frame. The passes which do not access the
+	 *          images of the compute pass are submitted without waiting for it, so that they overlap with it. The first
+	 *          pass accessing them, or the last pass of the pipeline, waits for it at the stages it accesses them in.
+	 * @remarks If fusion is enabled, chains of render passes are drawn as a single render pass, see set_fusion().
+	 * @remarks Passes with an intermediate output are first given one of the intermediate render targets of the
+	 *          active frame, see PostProcessingRenderPass::set_intermediate_output().
+	 * @return The command buffer recording continues in, which is command_buffer unless a pass ran asynchronously
 	 */
-	void draw(CommandBuffer &command_buffer, RenderTarget &default_render_target);
+	VKBP_NODISCARD CommandBuffer &draw(CommandBuffer &command_buffer, RenderTarget &default_render_target);
 
 	/**
 	 * @brief Gets all of the passes in the pipeline.
@@ -95,11 +107,109 @@ class PostProcessingPipeline
 		return current_pass_index;
 	}
 
+	/**
+	 * @brief Sets whether consecutive vkb::PostProcessingRenderPass drawing to the same render target are fused
+	 *        into a single render pass, the steps of each pass becoming subpasses of it. Passes reading the output
+	 *        of a previous pass of the chain through input attachments then read it from tile memory.
+	 * @remarks A pass is not fused if it samples an attachment written earlier in the chain. The pre-draw functions
+	 *          of the passes of a chain are all invoked before its render pass begins.
+	 * @remarks Attachments written by a pass of a chain, read as input attachments by the following passes of the
+	 *          chain, and neither written by its last pass nor read by the rest of the pipeline are not stored.
+	 *          The bytes these intermediates would have written and read back are reported as
+	 *          StatIndex::postprocessing_bytes_avoided.
+	 */
+	inline PostProcessingPipeline &set_fusion(bool enable)
+	{
+		fusion = enable;
+		return *this;
+	}
+
+	/**
+	 * @brief Returns whether render passes are fused, see set_fusion().
+	 */
+	inline bool is_fusion_enabled() const
+	{
+		return fusion;
+	}
+
   private:
+	/**
+	 * @brief Submits the commands recorded so far, and begins a command buffer of the async compute queue
+	 *        to record an asynchronous pass into
+	 * @return The compute command buffer
+	 */
+	CommandBuffer &begin_async_pass(CommandBuffer &command_buffer, PostProcessingPassBase &pass, RenderTarget &default_render_target);
+
+	/**
+	 * @brief Submits an asynchronous pass, and begins the graphics command buffer the following passes are recorded into
+	 * @return The graphics command buffer
+	 */
+	CommandBuffer &end_async_pass(CommandBuffer &compute_command_buffer, PostProcessingPassBase &pass, RenderTarget &default_render_target);
+
+	/**
+	 * @brief Makes the graphics commands recorded from now on wait for the pending asynchronous pass. The commands
+	 *        recorded since it was submitted are submitted first, as they do not depend on it.
+	 * @param wait_stage The stages of the graphics commands accessing the images of the asynchronous pass
+	 * @return The graphics command buffer the following passes are recorded into
+	 */
+	CommandBuffer &wait_async_pass(CommandBuffer &command_buffer, VkPipelineStageFlags wait_stage, RenderTarget &default_render_target);
+
+	/**
+	 * @brief Returns whether the passes from first_pass_index to last_pass_index access an image of the pending
+	 *        asynchronous pass. The last pass of the pipeline always does, as it is followed by unknown commands.
+	 */
+	bool depends_on_async_pass(size_t first_pass_index, size_t last_pass_index, RenderTarget &default_render_target);
+
+	/**
+	 * @brief Collects the images a pass accesses through its render target, sampled images and storage images
+	 * @return Whether the images the pass accesses are known, which is not the case of other types of passes
+	 */
+	bool get_accessed_images(PostProcessingPassBase &pass, RenderTarget &default_render_target, std::unordered_set<VkImage> &images);
+
+	/**
+	 * @brief Collects the render passes fused with the pass at first_pass_index
+	 * @return The passes of the chain, starting with the pass at first_pass_index, empty if it cannot be fused
+	 */
+	std::vector<PostProcessingRenderPass *> get_fused_chain(size_t first_pass_index, RenderTarget &default_render_target);
+
+	/**
+	 * @brief Returns the attachments of render_target the passes after last_pass_index read
+	 */
+	std::unordered_set<uint32_t> get_attachments_read_after(size_t last_pass_index, const RenderTarget &render_target, RenderTarget &default_render_target);
+
+	/**
+	 * @brief Assigns the intermediate render targets of the active frame to the passes with an intermediate output,
+	 *        and points the sampled images reading them to these render targets. An output is live from the pass
+	 *        writing it to the last pass reading it, outputs with disjoint lifetimes share a render target.
+	 */
+	void assign_intermediate_targets(RenderTarget &default_render_target);
+
+	/// Intermediate render targets of each render frame, shared by the intermediate outputs
+	std::vector<std::vector<std::unique_ptr<RenderTarget>>> intermediate_targets{};
+
+	/// Semaphore signaled by the graphics commands an asynchronous pass waits for
+	VkSemaphore async_wait_semaphore{VK_NULL_HANDLE};
+
+	/// Asynchronous pass the graphics commands have not waited for yet
+	PostProcessingPassBase *pending_async_pass{nullptr};
+
+	/// Semaphore signaled by the pending asynchronous pass
+	VkSemaphore async_signal_semaphore{VK_NULL_HANDLE};
+
+	/// Images the pending asynchronous pass accesses
+	std::unordered_set<VkImage> async_images{};
+
+	/// Whether the images the pending asynchronous pass accesses are known
+	bool async_images_known{false};
+
+	/// Whether graphics commands were recorded since the pending asynchronous pass was submitted
+	bool recorded_since_async{false};
+
 	RenderContext *                                      render_context{nullptr};
 	ShaderSource                                         triangle_vs;
 	std::vector<std::unique_ptr<PostProcessingPassBase>> passes{};
 	size_t                                               current_pass_index{0};
+	bool                                                 fusion{false};
 };
 
 }        // namespace vkb
\ No newline at end of file
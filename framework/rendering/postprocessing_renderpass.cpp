@@ -45,7 +45,8 @@ PostProcessingSubpass::PostProcessingSubpass(PostProcessingSubpass &&to_move) :
     parent{std::move(to_move.parent)},
     fs_variant{std::move(to_move.fs_variant)},
     input_attachments{std::move(to_move.input_attachments)},
-    sampled_images{std::move(to_move.sampled_images)}
+    sampled_images{std::move(to_move.sampled_images)},
+    intermediate_outputs{std::move(to_move.intermediate_outputs)}
 {}
 
 PostProcessingSubpass &PostProcessingSubpass::bind_input_attachment(const std::string &name, uint32_t new_input_attachment)
@@ -66,6 +67,7 @@ PostProcessingSubpass &PostProcessingSubpass::bind_input_attachment(const std::s
 void PostProcessingSubpass::unbind_sampled_image(const std::string &name)
 {
 	sampled_images.erase(name);
+	intermediate_outputs.erase(name);
 }
 
 PostProcessingSubpass &PostProcessingSubpass::bind_sampled_image(const std::string &name, core::SampledImage &&new_image)
@@ -80,10 +82,23 @@ PostProcessingSubpass &PostProcessingSubpass::bind_sampled_image(const std::stri
 		sampled_images.emplace(name, std::move(new_image));
 	}
 
+	intermediate_outputs.erase(name);
+
 	parent->load_stores_dirty = true;
 	return *this;
 }
 
+PostProcessingSubpass &PostProcessingSubpass::bind_intermediate_output(const std::string &name, const PostProcessingRenderPass &pass, core::Sampler *sampler)
+{
+	assert(pass.get_intermediate_format() != VK_FORMAT_UNDEFINED && "The pass has no intermediate output");
+
+	bind_sampled_image(name, core::SampledImage{0, pass.get_render_target(), sampler});
+
+	intermediate_outputs[name] = &pass;
+
+	return *this;
+}
+
 PostProcessingSubpass &PostProcessingSubpass::bind_storage_image(const std::string &name, const core::ImageView &new_image)
 {
 	auto it = storage_images.find(name);
@@ -530,4 +545,232 @@ void PostProcessingRenderPass::draw(CommandBuffer &command_buffer, RenderTarget
 	}
 }
 
+void PostProcessingRenderPass::draw_fused(CommandBuffer                                 &command_buffer,
+                                          RenderTarget                                  &default_render_target,
+                                          const std::vector<PostProcessingRenderPass *> &chain,
+                                          const std::unordered_set<uint32_t>            &read_after)
+{
+	auto       &render_target = this->render_target ? *this->render_target : default_render_target;
+	const auto &views         = render_target.get_views();
+
+	// Inputs read before the chain writes them must be loaded, the other ones are produced by the chain itself
+	AttachmentSet        loaded_attachments, written_attachments, read_in_chain;
+	SampledAttachmentSet sampled_attachments;
+
+	// Index in the chain of the pass writing each attachment last
+	std::unordered_map<uint32_t, size_t> last_writers;
+
+	std::vector<Subpass *> subpasses;
+
+	for (size_t i = 0; i < chain.size(); ++i)
+	{
+		for (auto &step_ptr : chain[i]->pipeline.get_subpasses())
+		{
+			auto &step = *dynamic_cast<PostProcessingSubpass *>(step_ptr.get());
+
+			for (auto &it : step.get_input_attachments())
+			{
+				if (written_attachments.find(it.second) == written_attachments.end())
+				{
+					loaded_attachments.insert(it.second);
+				}
+				else
+				{
+					read_in_chain.insert(it.second);
+				}
+			}
+
+			for (auto &it : step.get_sampled_images())
+			{
+				if (const uint32_t *sampled_attachment = it.second.get_target_attachment())
+				{
+					auto packed_sampled_attachment = *sampled_attachment;
+
+					// pack sampled attachment
+					if (it.second.is_depth_resolve())
+					{
+						packed_sampled_attachment |= DEPTH_RESOLVE_BITMASK;
+					}
+
+					sampled_attachments.insert({it.second.get_render_target(), packed_sampled_attachment});
+				}
+			}
+
+			for (uint32_t output : step.get_output_attachments())
+			{
+				written_attachments.insert(output);
+				last_writers[output] = i;
+			}
+
+			subpasses.push_back(step_ptr.get());
+		}
+	}
+
+	AttachmentSet output_attachments;
+	for (uint32_t output : written_attachments)
+	{
+		if (loaded_attachments.find(output) == loaded_attachments.end())
+		{
+			output_attachments.insert(output);
+		}
+	}
+
+	transition_attachments(loaded_attachments, sampled_attachments, output_attachments, command_buffer, default_render_target);
+
+	std::vector<LoadStoreInfo> fused_load_stores;
+	uint32_t                   intermediate_count = 0;
+	uint64_t                   bytes_avoided      = 0;
+
+	for (uint32_t j = 0; j < static_cast<uint32_t>(views.size()); j++)
+	{
+		const bool is_loaded  = loaded_attachments.find(j) != loaded_attachments.end();
+		const bool is_sampled = std::find_if(sampled_attachments.begin(), sampled_attachments.end(),
+		                                     [&render_target, j](auto &pair) {
+			                                     auto *sampled_rt = pair.first ? pair.first : &render_target;
+			                                     return (pair.second & ATTACHMENT_BITMASK) == j && sampled_rt == &render_target;
+		                                     }) != sampled_attachments.end();
+		const bool is_written = written_attachments.find(j) != written_attachments.end();
+
+		// An attachment written by a pass and only read by the next passes of the chain never leaves tile memory
+		const bool is_intermediate = is_written && last_writers[j] < chain.size() - 1 &&
+		                             read_in_chain.find(j) != read_in_chain.end() &&
+		                             read_after.find(j) == read_after.end();
+
+		LoadStoreInfo load_store{};
+		if (is_loaded || is_sampled)
+		{
+			load_store.load_op = VK_ATTACHMENT_LOAD_OP_LOAD;
+		}
+		else if (is_written)
+		{
+			load_store.load_op = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		}
+		else
+		{
+			load_store.load_op = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		}
+
+		load_store.store_op = is_written && !is_intermediate ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+		if (is_intermediate)
+		{
+			// Each separate pass would have stored the attachment and the next one loaded it back
+			const auto &extent = render_target.get_extent();
+			bytes_avoided += 2ULL * extent.width * extent.height * get_bits_per_pixel(views[j].get_format()) / 8;
+			intermediate_count++;
+		}
+
+		fused_load_stores.push_back(load_store);
+	}
+
+	auto &render_frame = parent->get_render_context().get_active_frame();
+
+	for (auto *pass : chain)
+	{
+		if (!pass->uniform_data.empty())
+		{
+			pass->uniform_buffer_alloc = std::make_shared<BufferAllocation>(render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, pass->uniform_data.size()));
+			pass->uniform_buffer_alloc->update(pass->uniform_data);
+		}
+
+		pass->draw_render_target = &render_target;
+	}
+
+	// Set appropriate viewport & scissor for this RT
+	{
+		auto &extent = render_target.get_extent();
+
+		VkViewport viewport{};
+		viewport.width    = static_cast<float>(extent.width);
+		viewport.height   = static_cast<float>(extent.height);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		command_buffer.set_viewport(0, {viewport});
+
+		VkRect2D scissor{};
+		scissor.extent = extent;
+		command_buffer.set_scissor(0, {scissor});
+	}
+
+	subpasses.front()->update_render_target_attachments(render_target);
+
+	// Clear values of the head pass apply to the whole chain
+	auto clear_values = pipeline.get_clear_value();
+	while (clear_values.size() < views.size())
+	{
+		clear_values.push_back({0.0f, 0.0f, 0.0f, 1.0f});
+	}
+
+	command_buffer.begin_render_pass(render_target, fused_load_stores, clear_values, subpasses);
+
+	size_t subpass_index = 0;
+
+	for (auto *pass : chain)
+	{
+		ScopedDebugLabel marker{command_buffer, pass->debug_name.c_str()};
+
+		for (auto &step_ptr : pass->pipeline.get_subpasses())
+		{
+			if (subpass_index++ > 0)
+			{
+				step_ptr->update_render_target_attachments(render_target);
+				command_buffer.next_subpass();
+			}
+
+			if (step_ptr->get_debug_name().empty())
+			{
+				step_ptr->set_debug_name(fmt::format("RP subpass #{}", subpass_index - 1));
+			}
+			ScopedDebugLabel subpass_debug_label{command_buffer, step_ptr->get_debug_name().c_str()};
+
+			step_ptr->draw(command_buffer);
+		}
+
+		if (pass->post_draw)
+		{
+			ScopedDebugLabel marker{command_buffer, "Post-draw"};
+
+			pass->post_draw();
+		}
+	}
+
+	// Track the final layouts of the render pass, which are those of the last subpass
+	const auto &last_inputs = subpasses.back()->get_input_attachments();
+
+	for (uint32_t j : written_attachments)
+	{
+		const bool is_depth_stencil = vkb::is_depth_format(views[j].get_format());
+
+		if (std::find(last_inputs.begin(), last_inputs.end(), j) != last_inputs.end())
+		{
+			render_target.set_layout(j, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		}
+		else
+		{
+			render_target.set_layout(j, is_depth_stencil ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+		}
+	}
+
+	for (uint32_t j : loaded_attachments)
+	{
+		if (written_attachments.find(j) == written_attachments.end() &&
+		    std::find(last_inputs.begin(), last_inputs.end(), j) == last_inputs.end())
+		{
+			const bool is_depth_stencil = vkb::is_depth_format(views[j].get_format());
+			render_target.set_layout(j, is_depth_stencil ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+		}
+	}
+
+	if (intermediate_count > 0)
+	{
+		parent->get_render_context().add_frame_stat(StatIndex::postprocessing_bytes_avoided, static_cast<double>(bytes_avoided));
+	}
+
+	if (parent->get_current_pass_index() < (parent->get_passes().size() - 1))
+	{
+		// Leave the last renderpass open for user modification (e.g., drawing GUI)
+		command_buffer.end_render_pass();
+	}
+}
+
 }        // namespace vkb
\ No newline at end of file
@@ -71,6 +71,8 @@ class PostProcessingRenderPass;
 class PostProcessingSubpass : public Subpass
 {
   public:
+	friend class PostProcessingPipeline;
+
 	PostProcessingSubpass(PostProcessingRenderPass *parent, RenderContext &render_context, ShaderSource &&triangle_vs,
 	                      ShaderSource &&fs, ShaderVariant &&fs_variant = {});
 
@@ -151,6 +153,13 @@ class PostProcessingSubpass : public Subpass
 	 */
 	PostProcessingSubpass &bind_sampled_image(const std::string &name, core::SampledImage &&new_image);
 
+	/**
+	 * @brief Changes (or adds) the sampled image at name for this step to the intermediate output of an earlier pass.
+	 * @remarks The render target it is sampled from is chosen by the PostProcessingPipeline on each draw,
+	 *          see PostProcessingRenderPass::set_intermediate_output().
+	 */
+	PostProcessingSubpass &bind_intermediate_output(const std::string &name, const PostProcessingRenderPass &pass, core::Sampler *sampler = nullptr);
+
 	/**
 	 * @brief Changes (or adds) the storage image at name for this step.
 	 */
@@ -205,6 +214,9 @@ class PostProcessingSubpass : public Subpass
 	SampledMap      sampled_images{};
 	StorageImageMap storage_images{};
 
+	/// Passes whose intermediate output is sampled at each name
+	std::unordered_map<std::string, const PostProcessingRenderPass *> intermediate_outputs{};
+
 	std::vector<uint8_t> push_constants_data{};
 
 	DrawFunc draw_func{&PostProcessingSubpass::default_draw_func};
@@ -220,6 +232,7 @@ class PostProcessingRenderPass : public PostProcessingPass<PostProcessingRenderP
 {
   public:
 	friend class PostProcessingSubpass;
+	friend class PostProcessingPipeline;
 
 	PostProcessingRenderPass(PostProcessingPipeline *parent, std::unique_ptr<core::Sampler> &&default_sampler = nullptr);
 
@@ -257,6 +270,30 @@ class PostProcessingRenderPass : public PostProcessingPass<PostProcessingRenderP
 		return new_subpass_ref;
 	}
 
+	/**
+	 * @brief Renders this pass to an intermediate render target owned by the pipeline, with a single color attachment
+	 *        of the given format and the extent of the pipeline's render target, instead of its own render target.
+	 *        Later passes sample it with PostProcessingSubpass::bind_intermediate_output().
+	 * @remarks Intermediate outputs whose lifetimes do not overlap share a render target, so a chain of passes
+	 *          each reading the output of the previous one ping-pongs between two render targets.
+	 */
+	inline PostProcessingRenderPass &set_intermediate_output(VkFormat format)
+	{
+		intermediate_format = format;
+		render_target       = nullptr;
+		load_stores_dirty   = true;
+
+		return *this;
+	}
+
+	/**
+	 * @brief Returns the format of the intermediate output, or VK_FORMAT_UNDEFINED if the pass renders to its render target.
+	 */
+	inline VkFormat get_intermediate_format() const
+	{
+		return intermediate_format;
+	}
+
 	/**
 	 * @brief Set the uniform data to be bound at set 0, binding 0.
 	 */
@@ -310,6 +347,19 @@ class PostProcessingRenderPass : public PostProcessingPass<PostProcessingRenderP
 	 */
 	void prepare_draw(CommandBuffer &command_buffer, RenderTarget &fallback_render_target);
 
+	/**
+	 * @brief Draws a chain of passes, starting with this one, as the subpasses of a single render pass.
+	 *        Attachments only read within the chain are not stored, nor reloaded by the next passes.
+	 * @param command_buffer Command buffer to record to
+	 * @param default_render_target Render target of the passes which have none set
+	 * @param chain Passes to draw, which all render to the render target of this pass
+	 * @param read_after Attachments of the render target that are read after the chain
+	 */
+	void draw_fused(CommandBuffer                                 &command_buffer,
+	                RenderTarget                                  &default_render_target,
+	                const std::vector<PostProcessingRenderPass *> &chain,
+	                const std::unordered_set<uint32_t>            &read_after);
+
 	BarrierInfo get_src_barrier_info() const override;
 	BarrierInfo get_dst_barrier_info() const override;
 
@@ -318,6 +368,7 @@ class PostProcessingRenderPass : public PostProcessingPass<PostProcessingRenderP
 	RenderTarget                     *draw_render_target{nullptr};
 	std::vector<LoadStoreInfo>        load_stores{};
 	bool                              load_stores_dirty{true};
+	VkFormat                          intermediate_format{VK_FORMAT_UNDEFINED};
 	std::vector<uint8_t>              uniform_data{};
 	std::shared_ptr<BufferAllocation> uniform_buffer_alloc{};
 };
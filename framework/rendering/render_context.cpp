@@ -47,6 +47,20 @@ RenderContext::RenderContext(Device                                &device,
 			swapchain = std::make_unique<Swapchain>(device, surface, present_mode, present_mode_priority_list, surface_format_priority_list);
 		}
 	}
+
+	// Prefer a queue of a dedicated compute family, which the GPU can schedule alongside graphics work
+	async_compute_queue = &queue;
+
+	uint32_t compute_family_index = device.get_queue_family_index(VK_QUEUE_COMPUTE_BIT);
+
+	if (compute_family_index != queue.get_family_index())
+	{
+		async_compute_queue = &device.get_queue(compute_family_index, 0);
+	}
+	else if (device.get_num_queues_for_queue_family(compute_family_index) > 1)
+	{
+		async_compute_queue = &device.get_queue(compute_family_index, queue.get_index() == 0 ? 1 : 0);
+	}
 }
 
 void RenderContext::prepare(size_t thread_count, RenderTarget::CreateFunc create_render_target_func)
@@ -59,35 +73,92 @@ void RenderContext::prepare(size_t thread_count, RenderTarget::CreateFunc create
 
 		VkExtent3D extent{surface_extent.width, surface_extent.height, 1};
 
-		for (auto &image_handle : swapchain->get_images())
+		if (frames_in_flight == 0)
 		{
-			auto swapchain_image = core::Image{
-			    device, image_handle,
-			    extent,
-			    swapchain->get_format(),
-			    swapchain->get_usage()};
-			auto render_target = create_render_target_func(std::move(swapchain_image));
-			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+			for (auto &image_handle : swapchain->get_images())
+			{
+				auto swapchain_image = core::Image{
+				    device, image_handle,
+				    extent,
+				    swapchain->get_format(),
+				    swapchain->get_usage()};
+				auto render_target = create_render_target_func(std::move(swapchain_image));
+				frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+			}
+		}
+		else
+		{
+			// The frames borrow the render target of the swapchain image they acquire
+			for (uint32_t i = 0; i < frames_in_flight; ++i)
+			{
+				frames.emplace_back(std::make_unique<RenderFrame>(device, nullptr, thread_count));
+			}
 		}
 	}
 	else
 	{
-		// Otherwise, create a single RenderFrame
+		// Otherwise, create a single RenderFrame, or one for each frame in flight
 		swapchain = nullptr;
 
-		auto color_image = core::Image{device,
-		                               VkExtent3D{surface_extent.width, surface_extent.height, 1},
-		                               DEFAULT_VK_FORMAT,        // We can use any format here that we like
-		                               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-		                               VMA_MEMORY_USAGE_GPU_ONLY};
+		for (uint32_t i = 0; i < std::max(frames_in_flight, 1u); ++i)
+		{
+			auto color_image = core::Image{device,
+			                               VkExtent3D{surface_extent.width, surface_extent.height, 1},
+			                               DEFAULT_VK_FORMAT,        // We can use any format here that we like
+			                               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+			                               VMA_MEMORY_USAGE_GPU_ONLY};
 
-		auto render_target = create_render_target_func(std::move(color_image));
-		frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+			auto render_target = create_render_target_func(std::move(color_image));
+			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+		}
 	}
 
 	this->create_render_target_func = create_render_target_func;
 	this->thread_count              = thread_count;
 	this->prepared                  = true;
+
+	update_swapchain_render_targets();
+}
+
+void RenderContext::set_frames_in_flight(uint32_t count)
+{
+	assert(!prepared && "The frames in flight must be set before preparing the RenderContext");
+	frames_in_flight = count;
+}
+
+void RenderContext::update_swapchain_render_targets()
+{
+	if (!swapchain || frames_in_flight == 0)
+	{
+		return;
+	}
+
+	swapchain_render_targets.clear();
+
+	for (uint32_t i = 0; i < to_u32(swapchain->get_images().size()); ++i)
+	{
+		swapchain_render_targets.push_back(create_swapchain_render_target(i));
+	}
+
+	swapchain_image_frames.assign(swapchain_render_targets.size(), frames_in_flight);
+
+	// Keep the frames pointing to valid render targets until they acquire an image
+	for (size_t i = 0; i < frames.size(); ++i)
+	{
+		frames[i]->set_borrowed_render_target(*swapchain_render_targets[i % swapchain_render_targets.size()]);
+	}
+}
+
+std::unique_ptr<RenderTarget> RenderContext::create_swapchain_render_target(uint32_t image_index)
+{
+	VkExtent2D swapchain_extent = swapchain->get_extent();
+
+	core::Image swapchain_image{device, swapchain->get_images()[image_index],
+	                            VkExtent3D{swapchain_extent.width, swapchain_extent.height, 1},
+	                            swapchain->get_format(),
+	                            swapchain->get_usage()};
+
+	return create_render_target_func(std::move(swapchain_image));
 }
 
 VkFormat RenderContext::get_format() const
@@ -110,11 +181,7 @@ void RenderContext::update_swapchain(const VkExtent2D &extent)
 		return;
 	}
 
-	device.get_resource_cache().clear_framebuffers();
-
-	swapchain = std::make_unique<Swapchain>(*swapchain, extent);
-
-	recreate();
+	replace_swapchain(std::make_unique<Swapchain>(*swapchain, extent));
 }
 
 void RenderContext::update_swapchain(const uint32_t image_count)
@@ -125,13 +192,7 @@ void RenderContext::update_swapchain(const uint32_t image_count)
 		return;
 	}
 
-	device.get_resource_cache().clear_framebuffers();
-
-	device.wait_idle();
-
-	swapchain = std::make_unique<Swapchain>(*swapchain, image_count);
-
-	recreate();
+	replace_swapchain(std::make_unique<Swapchain>(*swapchain, image_count));
 }
 
 void RenderContext::update_swapchain(const std::set<VkImageUsageFlagBits> &image_usage_flags)
@@ -142,11 +203,7 @@ void RenderContext::update_swapchain(const std::set<VkImageUsageFlagBits> &image
 		return;
 	}
 
-	device.get_resource_cache().clear_framebuffers();
-
-	swapchain = std::make_unique<Swapchain>(*swapchain, image_usage_flags);
-
-	recreate();
+	replace_swapchain(std::make_unique<Swapchain>(*swapchain, image_usage_flags));
 }
 
 void RenderContext::update_swapchain(const VkExtent2D &extent, const VkSurfaceTransformFlagBitsKHR transform)
@@ -157,8 +214,6 @@ void RenderContext::update_swapchain(const VkExtent2D &extent, const VkSurfaceTr
 		return;
 	}
 
-	device.get_resource_cache().clear_framebuffers();
-
 	auto width  = extent.width;
 	auto height = extent.height;
 	if (transform == VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR || transform == VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR)
@@ -167,46 +222,65 @@ void RenderContext::update_swapchain(const VkExtent2D &extent, const VkSurfaceTr
 		std::swap(width, height);
 	}
 
-	swapchain = std::make_unique<Swapchain>(*swapchain, VkExtent2D{width, height}, transform);
-
 	// Save the preTransform attribute for future rotations
 	pre_transform = transform;
 
+	replace_swapchain(std::make_unique<Swapchain>(*swapchain, VkExtent2D{width, height}, transform));
+}
+
+void RenderContext::replace_swapchain(std::unique_ptr<Swapchain> &&new_swapchain)
+{
+	auto old_swapchain = std::move(swapchain);
+	swapchain          = std::move(new_swapchain);
+
 	recreate();
+
+	// Frames in flight may still render to or present the images of the old swapchain
+	defer_destruction(std::move(old_swapchain));
 }
 
 void RenderContext::recreate()
 {
 	LOGI("Recreated swapchain");
 
-	VkExtent2D swapchain_extent = swapchain->get_extent();
-	VkExtent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
-
-	auto frame_it = frames.begin();
+	defer_destruction(device.get_resource_cache().release_framebuffers());
 
-	for (auto &image_handle : swapchain->get_images())
+	if (frames_in_flight != 0)
 	{
-		core::Image swapchain_image{device, image_handle,
-		                            extent,
-		                            swapchain->get_format(),
-		                            swapchain->get_usage()};
+		// The render target of each image is created when the image is next acquired,
+		// the frames keep pointing to the retired ones until then
+		defer_destruction(std::move(swapchain_render_targets));
+
+		swapchain_render_targets.clear();
+		swapchain_render_targets.resize(swapchain->get_images().size());
 
-		auto render_target = create_render_target_func(std::move(swapchain_image));
+		swapchain_image_frames.assign(swapchain_render_targets.size(), frames_in_flight);
+		return;
+	}
+
+	uint32_t image_count = to_u32(swapchain->get_images().size());
+
+	for (uint32_t i = 0; i < image_count; ++i)
+	{
+		auto render_target = create_swapchain_render_target(i);
 
-		if (frame_it != frames.end())
+		if (i < frames.size())
 		{
-			(*frame_it)->update_render_target(std::move(render_target));
+			defer_destruction(frames[i]->update_render_target(std::move(render_target)));
 		}
 		else
 		{
 			// Create a new frame if the new swapchain has more images than current frames
 			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
 		}
-
-		++frame_it;
 	}
 
-	device.get_resource_cache().clear_framebuffers();
+	// Frames beyond the new image count are not used anymore, so they are not waited on when frames begin
+	for (uint32_t i = image_count; i < to_u32(frames.size()); ++i)
+	{
+		frames[i]->reset();
+		release_deferred_resources(i);
+	}
 }
 
 bool RenderContext::handle_surface_changes(bool force_update)
@@ -234,9 +308,7 @@ bool RenderContext::handle_surface_changes(bool force_update)
 	    surface_properties.currentExtent.height != surface_extent.height ||
 	    force_update)
 	{
-		// Recreate swapchain
-		device.wait_idle();
-
+		// Recreate swapchain, the frames in flight keep using the retired one
 		update_swapchain(surface_properties.currentExtent, pre_transform);
 
 		surface_extent = surface_properties.currentExtent;
@@ -278,17 +350,64 @@ void RenderContext::submit(const std::vector<CommandBuffer *> &command_buffers)
 
 	if (swapchain)
 	{
-		assert(acquired_semaphore && "We do not have acquired_semaphore, it was probably consumed?\n");
-		render_semaphore = submit(queue, command_buffers, acquired_semaphore, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+		assert((acquired_semaphore || !wait_semaphores.empty()) && "We do not have acquired_semaphore, it was probably consumed?\n");
+
+		if (acquired_semaphore)
+		{
+			wait_semaphores.push_back(acquired_semaphore);
+			wait_pipeline_stages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+		}
+
+		render_semaphore = submit(queue, command_buffers, wait_semaphores, wait_pipeline_stages);
+	}
+	else if (!wait_semaphores.empty())
+	{
+		submit(queue, command_buffers, wait_semaphores, wait_pipeline_stages);
 	}
 	else
 	{
 		submit(queue, command_buffers);
 	}
 
+	wait_semaphores.clear();
+	wait_pipeline_stages.clear();
+
 	end_frame(render_semaphore);
 }
 
+VkSemaphore RenderContext::submit_partial(const std::vector<CommandBuffer *> &command_buffers)
+{
+	assert(frame_active && "RenderContext is inactive, cannot submit command buffer. Please call begin()");
+
+	if (acquired_semaphore)
+	{
+		wait_semaphores.push_back(acquired_semaphore);
+		wait_pipeline_stages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+	}
+
+	VkSemaphore signal_semaphore = submit(queue, command_buffers, wait_semaphores, wait_pipeline_stages);
+
+	wait_semaphores.clear();
+	wait_pipeline_stages.clear();
+
+	// The acquired image is available to the rest of the frame once this submission waited for it
+	if (acquired_semaphore)
+	{
+		release_owned_semaphore(acquired_semaphore);
+		acquired_semaphore = VK_NULL_HANDLE;
+	}
+
+	return signal_semaphore;
+}
+
+void RenderContext::add_wait_semaphore(VkSemaphore semaphore, VkPipelineStageFlags wait_pipeline_stage)
+{
+	assert(frame_active && "Frame is not active, please call begin_frame");
+
+	wait_semaphores.push_back(semaphore);
+	wait_pipeline_stages.push_back(wait_pipeline_stage);
+}
+
 void RenderContext::begin_frame()
 {
 	// Only handle surface changes if a swapchain exists
@@ -308,7 +427,7 @@ void RenderContext::begin_frame()
 
 	if (swapchain)
 	{
-		auto result = swapchain->acquire_next_image(active_frame_index, acquired_semaphore, VK_NULL_HANDLE);
+		auto result = swapchain->acquire_next_image(swapchain_image_index, acquired_semaphore, VK_NULL_HANDLE);
 
 		if (result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR)
 		{
@@ -316,7 +435,7 @@ void RenderContext::begin_frame()
 
 			if (swapchain_updated)
 			{
-				result = swapchain->acquire_next_image(active_frame_index, acquired_semaphore, VK_NULL_HANDLE);
+				result = swapchain->acquire_next_image(swapchain_image_index, acquired_semaphore, VK_NULL_HANDLE);
 			}
 		}
 
@@ -327,15 +446,60 @@ void RenderContext::begin_frame()
 		}
 	}
 
+	if (swapchain && frames_in_flight == 0)
+	{
+		active_frame_index = swapchain_image_index;
+	}
+	else
+	{
+		active_frame_index = (active_frame_index + 1) % to_u32(frames.size());
+	}
+
+	if (!swapchain_render_targets.empty())
+	{
+		// Another frame in flight may still be rendering to the acquired image
+		uint32_t &image_frame = swapchain_image_frames[swapchain_image_index];
+
+		if (image_frame < frames.size() && image_frame != active_frame_index)
+		{
+			frames[image_frame]->wait();
+		}
+
+		image_frame = active_frame_index;
+
+		auto &render_target = swapchain_render_targets[swapchain_image_index];
+
+		if (!render_target)
+		{
+			render_target = create_swapchain_render_target(swapchain_image_index);
+		}
+
+		frames[active_frame_index]->set_borrowed_render_target(*render_target);
+	}
+
 	// Now the frame is active again
 	frame_active = true;
 
 	// Wait on all resource to be freed from the previous render to this frame
 	wait_frame();
+
+	release_deferred_resources(active_frame_index);
 }
 
 VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage)
 {
+	if (wait_semaphore == VK_NULL_HANDLE)
+	{
+		return submit(queue, command_buffers, std::vector<VkSemaphore>{}, std::vector<VkPipelineStageFlags>{});
+	}
+
+	return submit(queue, command_buffers, std::vector<VkSemaphore>{wait_semaphore}, std::vector<VkPipelineStageFlags>{wait_pipeline_stage});
+}
+
+VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, const std::vector<VkSemaphore> &wait_semaphores, const std::vector<VkPipelineStageFlags> &wait_pipeline_stages)
+{
+	assert(wait_semaphores.size() == wait_pipeline_stages.size() && "Each wait semaphore needs a wait stage");
+
 	std::vector<VkCommandBuffer> cmd_buf_handles(command_buffers.size(), VK_NULL_HANDLE);
 	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const CommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
@@ -348,19 +512,14 @@ VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandB
 	submit_info.commandBufferCount = to_u32(cmd_buf_handles.size());
 	submit_info.pCommandBuffers    = cmd_buf_handles.data();
 
-	if (wait_semaphore != VK_NULL_HANDLE)
-	{
-		submit_info.waitSemaphoreCount = 1;
-		submit_info.pWaitSemaphores    = &wait_semaphore;
-		submit_info.pWaitDstStageMask  = &wait_pipeline_stage;
-	}
+	submit_info.waitSemaphoreCount = to_u32(wait_semaphores.size());
+	submit_info.pWaitSemaphores    = wait_semaphores.data();
+	submit_info.pWaitDstStageMask  = wait_pipeline_stages.data();
 
 	submit_info.signalSemaphoreCount = 1;
 	submit_info.pSignalSemaphores    = &signal_semaphore;
 
-	VkFence fence = frame.request_fence();
-
-	queue.submit({submit_info}, fence);
+	submit_frame(queue, submit_info);
 
 	return signal_semaphore;
 }
@@ -370,16 +529,59 @@ void RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *
 	std::vector<VkCommandBuffer> cmd_buf_handles(command_buffers.size(), VK_NULL_HANDLE);
 	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const CommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
-	RenderFrame &frame = get_active_frame();
-
 	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
 
 	submit_info.commandBufferCount = to_u32(cmd_buf_handles.size());
 	submit_info.pCommandBuffers    = cmd_buf_handles.data();
 
-	VkFence fence = frame.request_fence();
+	submit_frame(queue, submit_info);
+}
+
+void RenderContext::submit_frame(const Queue &queue, VkSubmitInfo submit_info)
+{
+	RenderFrame &frame = get_active_frame();
+
+	if (!device.uses_timeline_semaphores())
+	{
+		queue.submit({submit_info}, frame.request_fence());
+		return;
+	}
+
+	assert(submit_info.signalSemaphoreCount <= 1 && "Frame submissions signal at most one binary semaphore");
+
+	auto &timeline = queue_timelines[queue.get_handle()];
+	if (!timeline)
+	{
+		timeline = std::make_unique<TimelineSemaphore>(device);
+	}
+
+	// The timeline is signaled after the binary semaphore, whose value is ignored
+	std::array<VkSemaphore, 2> signal_semaphores{};
+	std::array<uint64_t, 2>    signal_values{};
+	std::vector<uint64_t>      wait_values(submit_info.waitSemaphoreCount, 0);
+
+	if (submit_info.signalSemaphoreCount == 1)
+	{
+		signal_semaphores[0] = submit_info.pSignalSemaphores[0];
+	}
 
-	queue.submit({submit_info}, fence);
+	signal_semaphores[submit_info.signalSemaphoreCount] = timeline->get_handle();
+	signal_values[submit_info.signalSemaphoreCount]     = timeline->request_signal_value();
+
+	VkTimelineSemaphoreSubmitInfoKHR timeline_submit_info{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+
+	timeline_submit_info.waitSemaphoreValueCount   = submit_info.waitSemaphoreCount;
+	timeline_submit_info.pWaitSemaphoreValues      = wait_values.data();
+	timeline_submit_info.signalSemaphoreValueCount = submit_info.signalSemaphoreCount + 1;
+	timeline_submit_info.pSignalSemaphoreValues    = signal_values.data();
+
+	frame.add_timeline_signal(*timeline, signal_values[submit_info.signalSemaphoreCount]);
+
+	submit_info.pNext                = &timeline_submit_info;
+	submit_info.signalSemaphoreCount = submit_info.signalSemaphoreCount + 1;
+	submit_info.pSignalSemaphores    = signal_semaphores.data();
+
+	queue.submit({submit_info}, VK_NULL_HANDLE);
 }
 
 void RenderContext::wait_frame()
@@ -402,7 +604,7 @@ void RenderContext::end_frame(VkSemaphore semaphore)
 		present_info.pWaitSemaphores    = &semaphore;
 		present_info.swapchainCount     = 1;
 		present_info.pSwapchains        = &vk_swapchain;
-		present_info.pImageIndices      = &active_frame_index;
+		present_info.pImageIndices      = &swapchain_image_index;
 
 		VkDisplayPresentInfoKHR disp_present_info{};
 		if (device.is_extension_supported(VK_KHR_DISPLAY_SWAPCHAIN_EXTENSION_NAME) &&
@@ -437,6 +639,84 @@ VkSemaphore RenderContext::consume_acquired_semaphore()
 	return sem;
 }
 
+void RenderContext::add_frame_stat(StatIndex index, double value)
+{
+	std::lock_guard<std::mutex> guard{frame_stats_mutex};
+	frame_stats[index] += value;
+}
+
+std::unordered_map<StatIndex, double, StatIndexHash> RenderContext::consume_frame_stats()
+{
+	std::lock_guard<std::mutex> guard{frame_stats_mutex};
+
+	std::unordered_map<StatIndex, double, StatIndexHash> stats;
+	std::swap(stats, frame_stats);
+	return stats;
+}
+
+RenderContext::DeferredDestruction &RenderContext::get_open_deferred_destruction()
+{
+	if (!deferred_destruction_open)
+	{
+		deferred_destructions.emplace_back();
+		deferred_destruction_open = true;
+
+		// Frames beyond the image count are not used anymore if the frames are tied to the swapchain images
+		uint32_t frame_count = to_u32(frames.size());
+
+		if (swapchain && frames_in_flight == 0)
+		{
+			frame_count = std::min(frame_count, to_u32(swapchain->get_images().size()));
+		}
+
+		for (uint32_t i = 0; i < frame_count; ++i)
+		{
+			deferred_destructions.back().pending_frames.insert(i);
+		}
+	}
+
+	return deferred_destructions.back();
+}
+
+void RenderContext::release_deferred_resources(uint32_t frame_index)
+{
+	std::lock_guard<std::mutex> guard{deferred_destruction_mutex};
+
+	// The frame may use the resources handed over from now on
+	deferred_destruction_open = false;
+
+	for (auto &deferred_destruction : deferred_destructions)
+	{
+		deferred_destruction.pending_frames.erase(frame_index);
+	}
+
+	while (!deferred_destructions.empty() && deferred_destructions.front().pending_frames.empty())
+	{
+		for (auto &resource : deferred_destructions.front().resources)
+		{
+			resource.reset();
+		}
+
+		deferred_destructions.pop_front();
+	}
+}
+
+void RenderContext::destroy_deferred_resources()
+{
+	std::lock_guard<std::mutex> guard{deferred_destruction_mutex};
+
+	for (auto &deferred_destruction : deferred_destructions)
+	{
+		for (auto &resource : deferred_destruction.resources)
+		{
+			resource.reset();
+		}
+	}
+
+	deferred_destructions.clear();
+	deferred_destruction_open = false;
+}
+
 RenderFrame &RenderContext::get_active_frame()
 {
 	assert(frame_active && "Frame is not active, please call begin_frame");
@@ -480,28 +760,20 @@ Device &RenderContext::get_device()
 	return device;
 }
 
-void RenderContext::recreate_swapchain()
+const Queue &RenderContext::get_queue() const
 {
-	device.wait_idle();
-	device.get_resource_cache().clear_framebuffers();
-
-	VkExtent2D swapchain_extent = swapchain->get_extent();
-	VkExtent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
-
-	auto frame_it = frames.begin();
-
-	for (auto &image_handle : swapchain->get_images())
-	{
-		core::Image swapchain_image{device, image_handle,
-		                            extent,
-		                            swapchain->get_format(),
-		                            swapchain->get_usage()};
+	return queue;
+}
 
-		auto render_target = create_render_target_func(std::move(swapchain_image));
-		(*frame_it)->update_render_target(std::move(render_target));
+const Queue &RenderContext::get_async_compute_queue() const
+{
+	return *async_compute_queue;
+}
 
-		++frame_it;
-	}
+void RenderContext::recreate_swapchain()
+{
+	// The render targets of the swapchain images are rebuilt, the previous ones are retired
+	recreate();
 }
 
 bool RenderContext::has_swapchain()
@@ -525,6 +797,16 @@ uint32_t RenderContext::get_active_frame_index() const
 	return active_frame_index;
 }
 
+uint32_t RenderContext::get_swapchain_image_index() const
+{
+	return swapchain_image_index;
+}
+
+size_t RenderContext::get_thread_count() const
+{
+	return thread_count;
+}
+
 std::vector<std::unique_ptr<RenderFrame>> &RenderContext::get_render_frames()
 {
 	return frames;
@@ -17,6 +17,11 @@
 
 #pragma once
 
+#include <list>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
 #include "common/helpers.h"
 #include "common/vk_common.h"
 #include "core/command_buffer.h"
@@ -34,6 +39,8 @@
 #include "rendering/render_frame.h"
 #include "rendering/render_target.h"
 #include "resource_cache.h"
+#include "stats/stats_common.h"
+#include "timeline_semaphore.h"
 
 namespace vkb
 {
@@ -53,6 +60,15 @@ class Window;
  *
  * For headless rendering (no swapchain), the RenderContext can be given a valid Device, and
  * a width and height. A single RenderFrame will then be created.
+ *
+ * Alternatively, a number of frames in flight can be set before preparing the RenderContext.
+ * The RenderFrames are then used in turn, independently of the swapchain images: each frame
+ * renders to the RenderTarget of the image it acquired, and headless frames own a RenderTarget each.
+ *
+ * Resources which frames in flight may still be using can be handed over with defer_destruction,
+ * they are destroyed once each frame which may have been using them has been waited on. Updating the
+ * swapchain relies on it rather than waiting for the device to be idle: the old swapchain is passed as
+ * oldSwapchain to the new one, and is destroyed with its RenderTargets and the framebuffers using them.
  */
 class RenderContext
 {
@@ -95,6 +111,14 @@ class RenderContext
 	 */
 	void prepare(size_t thread_count = 1, RenderTarget::CreateFunc create_render_target_func = RenderTarget::DEFAULT_CREATE_FUNC);
 
+	/**
+	 * @brief Sets the number of RenderFrames the CPU can record while the GPU renders the previous ones.
+	 *        Must be called before prepare.
+	 * @param count Number of frames in flight, 0 creates a RenderFrame per swapchain image
+	 *        or a single one in headless mode
+	 */
+	void set_frames_in_flight(uint32_t count);
+
 	/**
 	 * @brief Updates the swapchains extent, if a swapchain exists
 	 * @param extent The width and height of the new swapchain images
@@ -126,7 +150,10 @@ class RenderContext
 	bool has_swapchain();
 
 	/**
-	 * @brief Recreates the RenderFrames, called after every update
+	 * @brief Recreates the RenderFrames, called after every update. The previous render targets and the
+	 *        cached framebuffers are retired, and destroyed once the frames in flight no longer use them.
+	 *        If frames in flight were set, the render target of each swapchain image is created when the
+	 *        image is next acquired.
 	 */
 	void recreate();
 
@@ -162,6 +189,33 @@ class RenderContext
 
 	VkSemaphore submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage);
 
+	/**
+	 * @brief Submits command buffers related to a frame to a queue once the given semaphores are signaled
+	 * @param queue The queue to submit to
+	 * @param command_buffers Command buffers containing recorded commands
+	 * @param wait_semaphores Semaphores to wait for, which can be empty
+	 * @param wait_pipeline_stages The stage waiting for each semaphore
+	 * @return A semaphore signaled once the command buffers complete, which work on other queues can wait for
+	 */
+	VkSemaphore submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, const std::vector<VkSemaphore> &wait_semaphores, const std::vector<VkPipelineStageFlags> &wait_pipeline_stages);
+
+	/**
+	 * @brief Submits command buffers of the active frame to the graphics queue ahead of the frame's final submission,
+	 *        so that work on other queues can start with their results. The submission waits for the acquired
+	 *        swapchain image and the semaphores added with add_wait_semaphore.
+	 * @param command_buffers Command buffers containing recorded commands
+	 * @return A semaphore signaled once the command buffers complete
+	 */
+	VkSemaphore submit_partial(const std::vector<CommandBuffer *> &command_buffers);
+
+	/**
+	 * @brief Makes the next submission of the active frame to the graphics queue, by submit or submit_partial,
+	 *        wait for a semaphore. This chains the work a frame submitted to other queues into its graphics work.
+	 * @param semaphore The semaphore to wait for, owned by the active frame
+	 * @param wait_pipeline_stage The stage waiting for the semaphore
+	 */
+	void add_wait_semaphore(VkSemaphore semaphore, VkPipelineStageFlags wait_pipeline_stage);
+
 	/**
 	 * @brief Submits a command buffer related to a frame to a queue
 	 */
@@ -201,6 +255,18 @@ class RenderContext
 
 	Device &get_device();
 
+	/**
+	 * @return The queue frames are submitted and presented on
+	 */
+	const Queue &get_queue() const;
+
+	/**
+	 * @brief Returns a compute queue running alongside the graphics queue. It is a queue of a dedicated compute
+	 *        family if there is one, another queue of the graphics family if not, and the graphics queue itself
+	 *        as a last resort. Command buffers for it can be requested from the frames like for any queue.
+	 */
+	const Queue &get_async_compute_queue() const;
+
 	/**
 	 * @brief Returns the format that the RenderTargets are created with within the RenderContext
 	 */
@@ -212,6 +278,17 @@ class RenderContext
 
 	uint32_t get_active_frame_index() const;
 
+	/**
+	 * @return The index of the swapchain image the active frame renders to, which is the active
+	 *         frame index unless frames in flight were set
+	 */
+	uint32_t get_swapchain_image_index() const;
+
+	/**
+	 * @return The number of threads the render frames allocate resource pools for
+	 */
+	size_t get_thread_count() const;
+
 	std::vector<std::unique_ptr<RenderFrame>> &get_render_frames();
 
 	/**
@@ -225,6 +302,35 @@ class RenderContext
 	 */
 	VkSemaphore consume_acquired_semaphore();
 
+	/**
+	 * @brief Adds to a counter the framework gathers while recording frames, reported through Stats.
+	 *        Can be called from any recording thread.
+	 * @param index The stat the value is accounted to
+	 * @param value The value to add
+	 */
+	void add_frame_stat(StatIndex index, double value);
+
+	/**
+	 * @brief Returns the counters gathered since the last call and resets them
+	 */
+	std::unordered_map<StatIndex, double, StatIndexHash> consume_frame_stats();
+
+	/**
+	 * @brief Hands over a resource to be destroyed once the frames which may be using it have been waited on,
+	 *        instead of waiting for the device to be idle before destroying it. Can be called from any
+	 *        recording thread. Resources are destroyed in the order they were handed over.
+	 * @param resource The resource, moved into the render context. It can be any movable object, such as a
+	 *        std::unique_ptr to a core::Buffer or a RenderTarget, or the pipelines released from the ResourceCache
+	 */
+	template <typename T>
+	void defer_destruction(T &&resource);
+
+	/**
+	 * @brief Destroys all the resources handed over for deferred destruction. Only to be called once the
+	 *        device no longer uses them, for instance after waiting for it to be idle.
+	 */
+	void destroy_deferred_resources();
+
   protected:
 	VkExtent2D surface_extent;
 
@@ -257,6 +363,97 @@ class RenderContext
 	VkSurfaceTransformFlagBitsKHR pre_transform{VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR};
 
 	size_t thread_count{1};
+
+	std::mutex frame_stats_mutex;
+
+	std::unordered_map<StatIndex, double, StatIndexHash> frame_stats;
+
+	/// Number of frames in flight, 0 if the frames are tied to the swapchain images
+	uint32_t frames_in_flight{0};
+
+	/// Index of the acquired swapchain image
+	uint32_t swapchain_image_index{0};
+
+	/// Render targets of the swapchain images, if the frames are not tied to them
+	std::vector<std::unique_ptr<RenderTarget>> swapchain_render_targets;
+
+	/// Index of the frame which last rendered to each swapchain image
+	std::vector<uint32_t> swapchain_image_frames;
+
+	/// Timelines signaled by the submissions to each queue, if the device uses timeline semaphores
+	std::unordered_map<VkQueue, std::unique_ptr<TimelineSemaphore>> queue_timelines;
+
+	const Queue *async_compute_queue{nullptr};
+
+	/// Semaphores the next graphics submission of the frame waits for
+	std::vector<VkSemaphore> wait_semaphores;
+
+	std::vector<VkPipelineStageFlags> wait_pipeline_stages;
+
+	/**
+	 * @brief Resources handed over for deferred destruction between two frames
+	 */
+	struct DeferredDestruction
+	{
+		/// Resources in the order they were handed over
+		std::vector<std::shared_ptr<void>> resources;
+
+		/// Frames to be waited on before the resources can be destroyed
+		std::set<uint32_t> pending_frames;
+	};
+
+	std::mutex deferred_destruction_mutex;
+
+	std::list<DeferredDestruction> deferred_destructions;
+
+	/// Whether resources handed over join the last deferred destruction, until a frame is waited on
+	bool deferred_destruction_open{false};
+
+	/**
+	 * @brief Creates the render targets of the swapchain images, if the frames are not tied to them
+	 */
+	void update_swapchain_render_targets();
+
+	/**
+	 * @brief Creates the render target of a swapchain image
+	 */
+	std::unique_ptr<RenderTarget> create_swapchain_render_target(uint32_t image_index);
+
+	/**
+	 * @brief Replaces the swapchain and recreates the render targets, retiring the old swapchain
+	 * @param new_swapchain A swapchain created with the current one as its old swapchain
+	 */
+	void replace_swapchain(std::unique_ptr<Swapchain> &&new_swapchain);
+
+	/**
+	 * @brief Returns the deferred destruction resources are handed over to, which is destroyed
+	 *        once each frame in use has been waited on. Must be called with the mutex locked.
+	 */
+	DeferredDestruction &get_open_deferred_destruction();
+
+	/**
+	 * @brief Destroys the deferred resources no frame can be using anymore, called once a frame has been waited on
+	 * @param frame_index The index of the frame
+	 */
+	void release_deferred_resources(uint32_t frame_index);
+
+	/**
+	 * @brief Submits to a queue on behalf of the active frame. The frame's completion is tracked with a fence,
+	 *        or with the timeline of the queue if the device uses timeline semaphores.
+	 * @param queue The queue to submit to
+	 * @param submit_info The submission, which can signal at most one binary semaphore
+	 */
+	void submit_frame(const Queue &queue, VkSubmitInfo submit_info);
 };
 
+template <typename T>
+void RenderContext::defer_destruction(T &&resource)
+{
+	static_assert(!std::is_lvalue_reference<T>::value, "The resource must be moved into the render context");
+
+	std::lock_guard<std::mutex> guard{deferred_destruction_mutex};
+
+	get_open_deferred_destruction().resources.push_back(std::make_shared<T>(std::move(resource)));
+}
+
 }        // namespace vkb
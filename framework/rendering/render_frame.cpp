@@ -22,6 +22,34 @@
 
 namespace vkb
 {
+namespace
+{
+size_t get_descriptor_size(const VkPhysicalDeviceDescriptorBufferPropertiesEXT &properties, VkDescriptorType descriptor_type, bool robust_buffer_access)
+{
+	switch (descriptor_type)
+	{
+		case VK_DESCRIPTOR_TYPE_SAMPLER:
+			return properties.samplerDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+			return properties.combinedImageSamplerDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+			return properties.sampledImageDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+			return properties.storageImageDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+			return properties.inputAttachmentDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+			return robust_buffer_access ? properties.robustUniformBufferDescriptorSize : properties.uniformBufferDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+			return robust_buffer_access ? properties.robustStorageBufferDescriptorSize : properties.storageBufferDescriptorSize;
+		default:
+			return 0;
+	}
+}
+}        // namespace
+
+constexpr VkBufferUsageFlags RenderFrame::DESCRIPTOR_BUFFER_USAGE;
+
 RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_target, size_t thread_count) :
     device{device},
     fence_pool{device},
@@ -49,7 +77,10 @@ RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_
 	{
 		descriptor_pools.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorPool>>());
 		descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorSet>>());
+		templated_descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, VkDescriptorSet>>());
 	}
+
+	descriptor_update_infos.resize(thread_count);
 }
 
 Device &RenderFrame::get_device()
@@ -57,14 +88,27 @@ Device &RenderFrame::get_device()
 	return device;
 }
 
-void RenderFrame::update_render_target(std::unique_ptr<RenderTarget> &&render_target)
+void RenderFrame::wait() const
+{
+	for (auto &timeline_signal : timeline_signals)
+	{
+		VK_CHECK(timeline_signal.first->wait(timeline_signal.second));
+	}
+
+	VK_CHECK(fence_pool.wait());
+}
+
+std::unique_ptr<RenderTarget> RenderFrame::update_render_target(std::unique_ptr<RenderTarget> &&render_target)
 {
-	swapchain_render_target = std::move(render_target);
+	std::swap(swapchain_render_target, render_target);
+	return std::move(render_target);
 }
 
 void RenderFrame::reset()
 {
-	VK_CHECK(fence_pool.wait());
+	wait();
+
+	timeline_signals.clear();
 
 	fence_pool.reset();
 
@@ -91,6 +135,17 @@ void RenderFrame::reset()
 	{
 		clear_descriptors();
 	}
+	else
+	{
+		// Cached descriptor sets outlive the frame, so their pools are not reset but still learn the demand
+		for (auto &desc_pools_per_thread : descriptor_pools)
+		{
+			for (auto &desc_pool : *desc_pools_per_thread)
+			{
+				desc_pool.second.record_usage();
+			}
+		}
+	}
 }
 
 std::vector<std::unique_ptr<CommandPool>> &RenderFrame::get_command_pools(const Queue &queue, CommandBuffer::ResetMode reset_mode)
@@ -183,14 +238,25 @@ void RenderFrame::release_owned_semaphore(VkSemaphore semaphore)
 	semaphore_pool.release_owned_semaphore(semaphore);
 }
 
+void RenderFrame::set_borrowed_render_target(RenderTarget &render_target)
+{
+	borrowed_render_target = &render_target;
+}
+
+void RenderFrame::add_timeline_signal(const TimelineSemaphore &timeline, uint64_t value)
+{
+	auto &signal_value = timeline_signals[&timeline];
+	signal_value       = std::max(signal_value, value);
+}
+
 RenderTarget &RenderFrame::get_render_target()
 {
-	return *swapchain_render_target;
+	return borrowed_render_target ? *borrowed_render_target : *swapchain_render_target;
 }
 
 const RenderTarget &RenderFrame::get_render_target_const() const
 {
-	return *swapchain_render_target;
+	return borrowed_render_target ? *borrowed_render_target : *swapchain_render_target;
 }
 
 CommandBuffer &RenderFrame::request_command_buffer(const Queue &queue, CommandBuffer::ResetMode reset_mode, VkCommandBufferLevel level, size_t thread_index)
@@ -235,6 +301,127 @@ VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &d
 	}
 }
 
+VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &descriptor_set_layout, const ResourceSet &resource_set, size_t thread_index)
+{
+	assert(thread_index < thread_count && "Thread index is out of bounds");
+
+	VkDescriptorUpdateTemplate update_template = descriptor_set_layout.get_update_template();
+
+	if (update_template == VK_NULL_HANDLE || !update_templates || descriptor_management_strategy != DescriptorManagementStrategy::StoreInCache)
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	size_t hash = 0;
+	hash_combine(hash, descriptor_set_layout.get_handle());
+
+	for (auto &template_binding : descriptor_set_layout.get_update_template_bindings())
+	{
+		if (template_binding.binding >= max_resource_bindings || template_binding.descriptor_count > max_resource_array_elements)
+		{
+			return VK_NULL_HANDLE;
+		}
+
+		// Every descriptor is written by the template, partially bound bindings are written individually instead
+		uint32_t all_elements = (1u << template_binding.descriptor_count) - 1;
+		if ((resource_set.get_bound_array_elements(template_binding.binding) & all_elements) != all_elements)
+		{
+			return VK_NULL_HANDLE;
+		}
+
+		bool buffer_descriptor = is_buffer_descriptor_type(template_binding.descriptor_type);
+
+		for (uint32_t array_element = 0; array_element < template_binding.descriptor_count; ++array_element)
+		{
+			auto &resource_info = resource_set.get_resource(template_binding.binding, array_element);
+
+			if (buffer_descriptor ? resource_info.buffer == nullptr : resource_info.image_view == nullptr)
+			{
+				return VK_NULL_HANDLE;
+			}
+		}
+
+		hash_combine(hash, template_binding.binding);
+		hash_combine(hash, resource_set.get_binding_hash(template_binding.binding, is_dynamic_buffer_descriptor_type(template_binding.descriptor_type)));
+	}
+
+	assert(thread_index < templated_descriptor_sets.size());
+	auto &thread_descriptor_sets = *templated_descriptor_sets[thread_index];
+
+	auto descriptor_set_it = thread_descriptor_sets.find(hash);
+	if (descriptor_set_it != thread_descriptor_sets.end())
+	{
+		return descriptor_set_it->second;
+	}
+
+	assert(thread_index < descriptor_pools.size());
+	auto &descriptor_pool = request_resource(device, nullptr, *descriptor_pools[thread_index], descriptor_set_layout);
+
+	VkDescriptorSet descriptor_set = descriptor_pool.allocate();
+
+	const auto &limits = device.get_gpu().get_properties().limits;
+
+	// Every info read by the template is written below, so the scratch infos only grow
+	assert(thread_index < descriptor_update_infos.size());
+	auto &update_infos = descriptor_update_infos[thread_index];
+	if (update_infos.size() < descriptor_set_layout.get_update_template_info_count())
+	{
+		update_infos.resize(descriptor_set_layout.get_update_template_info_count());
+	}
+
+	for (auto &template_binding : descriptor_set_layout.get_update_template_bindings())
+	{
+		for (uint32_t array_element = 0; array_element < template_binding.descriptor_count; ++array_element)
+		{
+			auto &resource_info = resource_set.get_resource(template_binding.binding, array_element);
+			auto &update_info   = update_infos[template_binding.first_info + array_element];
+
+			switch (template_binding.descriptor_type)
+			{
+				case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+				case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+				case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+				case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+				{
+					bool uniform = template_binding.descriptor_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+					               template_binding.descriptor_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+
+					// Clip the buffers range to the limit, as DescriptorSet does
+					VkDeviceSize range_limit = uniform ? limits.maxUniformBufferRange : limits.maxStorageBufferRange;
+
+					update_info.buffer_info.buffer = resource_info.buffer->get_handle();
+					update_info.buffer_info.offset = is_dynamic_buffer_descriptor_type(template_binding.descriptor_type) ? 0 : resource_info.offset;
+					update_info.buffer_info.range  = std::min(resource_info.range, range_limit);
+					break;
+				}
+				case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+					update_info.image_info.sampler     = VK_NULL_HANDLE;
+					update_info.image_info.imageView   = resource_info.image_view->get_handle();
+					update_info.image_info.imageLayout = is_depth_format(resource_info.image_view->get_format()) ?
+					                                         VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL :
+					                                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+					break;
+				case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+					update_info.image_info.sampler     = VK_NULL_HANDLE;
+					update_info.image_info.imageView   = resource_info.image_view->get_handle();
+					update_info.image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+					break;
+				default:
+					update_info.image_info.sampler     = resource_info.sampler ? resource_info.sampler->get_handle() : VK_NULL_HANDLE;
+					update_info.image_info.imageView   = resource_info.image_view->get_handle();
+					update_info.image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+					break;
+			}
+		}
+	}
+
+	vkUpdateDescriptorSetWithTemplateKHR(device.get_handle(), descriptor_set, update_template, update_infos.data());
+
+	thread_descriptor_sets.emplace(hash, descriptor_set);
+
+	return descriptor_set;
+}
+
 void RenderFrame::update_descriptor_sets(size_t thread_index)
 {
 	assert(thread_index < descriptor_sets.size());
@@ -245,6 +432,140 @@ void RenderFrame::update_descriptor_sets(size_t thread_index)
 	}
 }
 
+BufferAllocation RenderFrame::write_descriptor_buffer(const DescriptorSetLayout &descriptor_set_layout, const ResourceSet &resource_set, size_t thread_index)
+{
+	assert(thread_index < thread_count && "Thread index is out of bounds");
+
+	VkDeviceSize size = descriptor_set_layout.get_descriptor_buffer_size();
+
+	if (!device.uses_descriptor_buffers() || size == 0)
+	{
+		return BufferAllocation{};
+	}
+
+	auto allocation = allocate_buffer(DESCRIPTOR_BUFFER_USAGE, size, thread_index);
+
+	if (allocation.empty())
+	{
+		return allocation;
+	}
+
+	const auto &properties = device.get_descriptor_buffer_properties();
+	const auto &limits     = device.get_gpu().get_properties().limits;
+
+	bool robust_buffer_access = device.get_gpu().get_requested_features().robustBufferAccess == VK_TRUE;
+
+	// The descriptors are written in place, the blocks of the buffer pools are persistently mapped
+	auto    &buffer = allocation.get_buffer();
+	uint8_t *data   = buffer.map() + allocation.get_offset();
+
+	for (auto &descriptor_binding : descriptor_set_layout.get_descriptor_buffer_bindings())
+	{
+		if (descriptor_binding.binding >= max_resource_bindings)
+		{
+			continue;
+		}
+
+		uint32_t bound_array_elements = resource_set.get_bound_array_elements(descriptor_binding.binding);
+
+		size_t descriptor_size = get_descriptor_size(properties, descriptor_binding.descriptor_type, robust_buffer_access);
+
+		for (uint32_t array_element = 0; array_element < descriptor_binding.descriptor_count && array_element < max_resource_array_elements; ++array_element)
+		{
+			if (!(bound_array_elements & (1u << array_element)))
+			{
+				continue;
+			}
+
+			auto &resource_info = resource_set.get_resource(descriptor_binding.binding, array_element);
+
+			VkDescriptorGetInfoEXT get_info{VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+			get_info.type = descriptor_binding.descriptor_type;
+
+			VkDescriptorAddressInfoEXT address_info{VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT};
+			VkDescriptorImageInfo      image_info{};
+			VkSampler                  sampler = resource_info.sampler ? resource_info.sampler->get_handle() : VK_NULL_HANDLE;
+
+			switch (descriptor_binding.descriptor_type)
+			{
+				case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+				case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+				{
+					if (resource_info.buffer == nullptr)
+					{
+						continue;
+					}
+
+					bool uniform = descriptor_binding.descriptor_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+					// Clip the buffers range to the limit, as DescriptorSet does
+					VkDeviceSize range_limit = uniform ? limits.maxUniformBufferRange : limits.maxStorageBufferRange;
+
+					address_info.address = resource_info.buffer->get_device_address() + resource_info.offset;
+					address_info.range   = std::min(resource_info.range, range_limit);
+					address_info.format  = VK_FORMAT_UNDEFINED;
+
+					if (uniform)
+					{
+						get_info.data.pUniformBuffer = &address_info;
+					}
+					else
+					{
+						get_info.data.pStorageBuffer = &address_info;
+					}
+					break;
+				}
+				case VK_DESCRIPTOR_TYPE_SAMPLER:
+					if (sampler == VK_NULL_HANDLE)
+					{
+						continue;
+					}
+
+					get_info.data.pSampler = &sampler;
+					break;
+				default:
+					if (resource_info.image_view == nullptr)
+					{
+						continue;
+					}
+
+					image_info.sampler   = sampler;
+					image_info.imageView = resource_info.image_view->get_handle();
+
+					switch (descriptor_binding.descriptor_type)
+					{
+						case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+							image_info.imageLayout      = VK_IMAGE_LAYOUT_GENERAL;
+							get_info.data.pStorageImage = &image_info;
+							break;
+						case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+							image_info.imageLayout              = is_depth_format(resource_info.image_view->get_format()) ?
+							                                          VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL :
+							                                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+							get_info.data.pInputAttachmentImage = &image_info;
+							break;
+						case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+							image_info.imageLayout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+							get_info.data.pSampledImage = &image_info;
+							break;
+						default:
+							image_info.imageLayout              = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+							get_info.data.pCombinedImageSampler = &image_info;
+							break;
+					}
+					break;
+			}
+
+			vkGetDescriptorEXT(device.get_handle(), &get_info, descriptor_size,
+			                   data + descriptor_binding.offset + array_element * descriptor_size);
+		}
+	}
+
+	buffer.flush();
+
+	return allocation;
+}
+
 void RenderFrame::clear_descriptors()
 {
 	for (auto &desc_sets_per_thread : descriptor_sets)
@@ -252,6 +573,11 @@ void RenderFrame::clear_descriptors()
 		desc_sets_per_thread->clear();
 	}
 
+	for (auto &desc_sets_per_thread : templated_descriptor_sets)
+	{
+		desc_sets_per_thread->clear();
+	}
+
 	for (auto &desc_pools_per_thread : descriptor_pools)
 	{
 		for (auto &desc_pool : *desc_pools_per_thread)
@@ -261,6 +587,36 @@ void RenderFrame::clear_descriptors()
 	}
 }
 
+uint32_t RenderFrame::get_descriptor_pool_creation_count() const
+{
+	uint32_t count = 0;
+
+	for (auto &desc_pools_per_thread : descriptor_pools)
+	{
+		for (auto &desc_pool : *desc_pools_per_thread)
+		{
+			count += desc_pool.second.get_pool_creation_count();
+		}
+	}
+
+	return count;
+}
+
+VkDeviceSize RenderFrame::get_descriptor_pool_memory_size() const
+{
+	VkDeviceSize size = 0;
+
+	for (auto &desc_pools_per_thread : descriptor_pools)
+	{
+		for (auto &desc_pool : *desc_pools_per_thread)
+		{
+			size += desc_pool.second.get_estimated_memory_size();
+		}
+	}
+
+	return size;
+}
+
 void RenderFrame::set_buffer_allocation_strategy(BufferAllocationStrategy new_strategy)
 {
 	buffer_allocation_strategy = new_strategy;
@@ -271,6 +627,11 @@ void RenderFrame::set_descriptor_management_strategy(DescriptorManagementStrateg
 	descriptor_management_strategy = new_strategy;
 }
 
+void RenderFrame::set_update_templates_enable(bool enable)
+{
+	update_templates = enable;
+}
+
 BufferAllocation RenderFrame::allocate_buffer(const VkBufferUsageFlags usage, const VkDeviceSize size, size_t thread_index)
 {
 	assert(thread_index < thread_count && "Thread index is out of bounds");
@@ -287,7 +648,8 @@ BufferAllocation RenderFrame::allocate_buffer(const VkBufferUsageFlags usage, co
 	auto &buffer_pool  = buffer_pool_it->second[thread_index].first;
 	auto &buffer_block = buffer_pool_it->second[thread_index].second;
 
-	bool want_minimal_block = buffer_allocation_strategy == BufferAllocationStrategy::OneAllocationPerBuffer;
+	// Descriptor buffers always share blocks, as command buffers rebind them whenever the block changes
+	bool want_minimal_block = buffer_allocation_strategy == BufferAllocationStrategy::OneAllocationPerBuffer && usage != DESCRIPTOR_BUFFER_USAGE;
 
 	if (want_minimal_block || !buffer_block || !buffer_block->can_allocate(size))
 	{
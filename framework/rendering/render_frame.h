@@ -24,6 +24,7 @@
 #include "core/buffer.h"
 #include "core/command_buffer.h"
 #include "core/command_pool.h"
+#include "core/descriptor_set_layout.h"
 #include "core/device.h"
 #include "core/image.h"
 #include "core/query_pool.h"
@@ -31,6 +32,7 @@
 #include "fence_pool.h"
 #include "rendering/render_target.h"
 #include "semaphore_pool.h"
+#include "timeline_semaphore.h"
 
 namespace vkb
 {
@@ -67,12 +69,18 @@ class RenderFrame
 	 */
 	static constexpr uint32_t BUFFER_POOL_BLOCK_SIZE = 256;
 
+	/**
+	 * @brief Usage of the buffers descriptors are written to, if the device uses descriptor buffers
+	 */
+	static constexpr VkBufferUsageFlags DESCRIPTOR_BUFFER_USAGE = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+
 	// A map of the supported usages to a multiplier for the BUFFER_POOL_BLOCK_SIZE
 	const std::unordered_map<VkBufferUsageFlags, uint32_t> supported_usage_map = {
 	    {VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 1},
 	    {VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 2},        // x2 the size of BUFFER_POOL_BLOCK_SIZE since SSBOs are normally much larger than other types of buffers
 	    {VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 1},
-	    {VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 1}};
+	    {VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 1},
+	    {DESCRIPTOR_BUFFER_USAGE, 1}};        // Only allocated from if the device uses descriptor buffers
 
 	RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_target, size_t thread_count = 1);
 
@@ -86,6 +94,12 @@ class RenderFrame
 
 	void reset();
 
+	/**
+	 * @brief Waits for the GPU work submitted by the frame to complete, through both its
+	 *        timeline signals and its fences, without resetting any of its resources
+	 */
+	void wait() const;
+
 	Device &get_device();
 
 	const FencePool &get_fence_pool() const;
@@ -98,11 +112,27 @@ class RenderFrame
 	VkSemaphore request_semaphore_with_ownership();
 	void        release_owned_semaphore(VkSemaphore semaphore);
 
+	/**
+	 * @brief Records a submission of the frame, which completes once a timeline reaches a value.
+	 *        The frame waits for the last value of each timeline when it is reset.
+	 * @param timeline The timeline of the queue the frame submitted to
+	 * @param value The value signaled by the submission
+	 */
+	void add_timeline_signal(const TimelineSemaphore &timeline, uint64_t value);
+
 	/**
 	 * @brief Called when the swapchain changes
 	 * @param render_target A new render target with updated images
+	 * @return The previous render target, which submissions of the frame may still be using
 	 */
-	void update_render_target(std::unique_ptr<RenderTarget> &&render_target);
+	std::unique_ptr<RenderTarget> update_render_target(std::unique_ptr<RenderTarget> &&render_target);
+
+	/**
+	 * @brief Renders the frame to a render target owned by the RenderContext instead of its own,
+	 *        used when the frames in flight are not tied to the swapchain images
+	 * @param render_target The render target of the acquired swapchain image
+	 */
+	void set_borrowed_render_target(RenderTarget &render_target);
 
 	RenderTarget &get_render_target();
 
@@ -129,8 +159,42 @@ class RenderFrame
 	                                       bool                                      update_after_bind,
 	                                       size_t                                    thread_index = 0);
 
+	/**
+	 * @brief Requests a descriptor set for the resources bound to a resource set. The lookup combines the
+	 *        binding hashes maintained by the resource set, and a new set is written with the update template
+	 *        of the layout, so neither builds descriptor info maps.
+	 * @param descriptor_set_layout The layout of the descriptor set
+	 * @param resource_set The resources to write, which must cover every descriptor of the layout
+	 * @param thread_index Index of the descriptor pools to be used by the current thread
+	 * @return The descriptor set, or VK_NULL_HANDLE if the layout has no update template, the resource set
+	 *         doesn't cover it, descriptor sets are not cached or update templates are disabled, in which case the
+	 *         BindingMap overload is used
+	 */
+	VkDescriptorSet request_descriptor_set(const DescriptorSetLayout &descriptor_set_layout, const ResourceSet &resource_set, size_t thread_index = 0);
+
+	/**
+	 * @brief Writes the descriptors of the resources bound to a resource set to descriptor buffer memory of the
+	 *        frame. Writing a set is a plain memory write, no descriptor pool or descriptor set is involved.
+	 * @param descriptor_set_layout The layout of the set, created for descriptor buffers
+	 * @param resource_set The resources to write, unbound descriptors are left undefined
+	 * @param thread_index Index of the buffer pool to be used by the current thread
+	 * @return The allocation holding the descriptors, to be bound with its offset. It is empty if the device
+	 *         doesn't use descriptor buffers
+	 */
+	BufferAllocation write_descriptor_buffer(const DescriptorSetLayout &descriptor_set_layout, const ResourceSet &resource_set, size_t thread_index = 0);
+
 	void clear_descriptors();
 
+	/**
+	 * @return The number of Vulkan descriptor pools created by the frame's descriptor pools
+	 */
+	uint32_t get_descriptor_pool_creation_count() const;
+
+	/**
+	 * @return An estimate of the memory held by the frame's descriptor pools
+	 */
+	VkDeviceSize get_descriptor_pool_memory_size() const;
+
 	/**
 	 * @brief Sets a new buffer allocation strategy
 	 * @param new_strategy The new buffer allocation strategy
@@ -143,6 +207,13 @@ class RenderFrame
 	 */
 	void set_descriptor_management_strategy(DescriptorManagementStrategy new_strategy);
 
+	/**
+	 * @brief Sets whether cached descriptor sets are written with the update templates of their layouts, straight from
+	 *        the resource sets of the command buffers. If disabled, command buffers collect the descriptor infos of each
+	 *        set they flush into BindingMaps, which recording benchmarks use as a baseline. Enabled by default.
+	 */
+	void set_update_templates_enable(bool enable);
+
 	/**
 	 * @param usage Usage of the buffer
 	 * @param size Amount of memory required
@@ -177,17 +248,31 @@ class RenderFrame
 	/// Descriptor sets for the frame
 	std::vector<std::unique_ptr<std::unordered_map<std::size_t, DescriptorSet>>> descriptor_sets;
 
+	/// Descriptor sets written with update templates for the frame, by the hash of their resources
+	std::vector<std::unique_ptr<std::unordered_map<std::size_t, VkDescriptorSet>>> templated_descriptor_sets;
+
+	/// Descriptor infos written by update templates, reused by each thread so writing a new set doesn't allocate
+	std::vector<std::vector<DescriptorUpdateInfo>> descriptor_update_infos;
+
 	FencePool fence_pool;
 
 	SemaphorePool semaphore_pool;
 
+	/// Last value signaled by the frame on each queue timeline
+	std::unordered_map<const TimelineSemaphore *, uint64_t> timeline_signals;
+
 	size_t thread_count;
 
 	std::unique_ptr<RenderTarget> swapchain_render_target;
 
+	/// Render target of the swapchain image acquired for this frame, if the frame does not own one
+	RenderTarget *borrowed_render_target{nullptr};
+
 	BufferAllocationStrategy     buffer_allocation_strategy{BufferAllocationStrategy::MultipleAllocationsPerBuffer};
 	DescriptorManagementStrategy descriptor_management_strategy{DescriptorManagementStrategy::StoreInCache};
 
+	bool update_templates{true};
+
 	std::map<VkBufferUsageFlags, std::vector<std::pair<BufferPool, BufferBlock *>>> buffer_pools;
 
 	static std::vector<uint32_t> collect_bindings_to_update(const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos);
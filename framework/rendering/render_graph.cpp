@@ -0,0 +1,982 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render_graph.h"
+
+#include <algorithm>
+#include <set>
+
+#include "common/logging.h"
+#include "common/utils.h"
+#include "core/debug.h"
+
+namespace vkb
+{
+namespace
+{
+constexpr VkAccessFlags write_access_mask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                            VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+bool is_attachment(RenderGraphUsage usage)
+{
+	return usage == RenderGraphUsage::ColorAttachment || usage == RenderGraphUsage::DepthStencilAttachment || usage == RenderGraphUsage::InputAttachment;
+}
+
+VkImageUsageFlags get_image_usage(RenderGraphUsage usage)
+{
+	switch (usage)
+	{
+		case RenderGraphUsage::ColorAttachment:
+			return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		case RenderGraphUsage::DepthStencilAttachment:
+			return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		case RenderGraphUsage::InputAttachment:
+			return VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+		case RenderGraphUsage::Sampled:
+			return VK_IMAGE_USAGE_SAMPLED_BIT;
+		case RenderGraphUsage::Storage:
+			return VK_IMAGE_USAGE_STORAGE_BIT;
+		case RenderGraphUsage::TransferSrc:
+			return VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		case RenderGraphUsage::TransferDst:
+			return VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		default:
+			return 0;
+	}
+}
+}        // namespace
+
+RenderGraphPass::RenderGraphPass(const std::string &name, Type type) :
+    name{name},
+    type{type}
+{
+}
+
+RenderGraphPass &RenderGraphPass::read(const std::string &image, RenderGraphUsage usage)
+{
+	accesses.push_back({image, usage, false});
+	return *this;
+}
+
+RenderGraphPass &RenderGraphPass::write(const std::string &image, RenderGraphUsage usage)
+{
+	assert(usage != RenderGraphUsage::InputAttachment && usage != RenderGraphUsage::Sampled && usage != RenderGraphUsage::TransferSrc && "Usage cannot write an image");
+
+	accesses.push_back({image, usage, true});
+	return *this;
+}
+
+RenderGraphPass &RenderGraphPass::set_clear_value(const std::string &image, const VkClearValue &clear_value)
+{
+	clear_values[image] = clear_value;
+	return *this;
+}
+
+void RenderGraphPass::set_execute(std::function<void(CommandBuffer &)> &&execute_)
+{
+	execute = std::move(execute_);
+}
+
+const std::string &RenderGraphPass::get_name() const
+{
+	return name;
+}
+
+RenderGraphPass::Type RenderGraphPass::get_type() const
+{
+	return type;
+}
+
+RenderGraph::RenderGraph(Device &device) :
+    device{device}
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+	// Render targets hold views of the transient images
+	steps.clear();
+	destroy_images();
+}
+
+void RenderGraph::add_image(const std::string &name, const RenderGraphImageInfo &info)
+{
+	assert(image_indices.find(name) == image_indices.end() && "Image already declared");
+
+	image_indices[name] = to_u32(images.size());
+
+	images.emplace_back();
+	images.back().name = name;
+	images.back().info = info;
+}
+
+void RenderGraph::import_image(const std::string &name, const RenderGraphImageInfo &info, VkImageLayout initial_layout, VkImageLayout final_layout, VkPipelineStageFlags src_stage_mask)
+{
+	add_image(name, info);
+
+	auto &image                = images.back();
+	image.imported             = true;
+	image.final_layout         = final_layout;
+	image.initial_state.layout = initial_layout;
+	image.initial_state.stage  = src_stage_mask;
+}
+
+void RenderGraph::set_imported_image(const std::string &name, const core::Image &image)
+{
+	auto &imported = images[get_image_index(name)];
+
+	assert(imported.imported && "Only imported images can be bound");
+
+	imported.imported_image = &image;
+}
+
+void RenderGraph::clear_imported_images()
+{
+	for (auto &step : steps)
+	{
+		step.render_targets.clear();
+	}
+
+	for (auto &image : images)
+	{
+		image.imported_image = nullptr;
+	}
+}
+
+RenderGraphPass &RenderGraph::add_pass(const std::string &name, RenderGraphPass::Type type)
+{
+	passes.push_back(std::make_unique<RenderGraphPass>(name, type));
+
+	compiled = false;
+
+	return *passes.back();
+}
+
+void RenderGraph::compile()
+{
+	if (!steps.empty() || !memory_slots.empty())
+	{
+		// Images of the previous compilation may still be in use
+		device.wait_idle();
+		device.get_resource_cache().clear_framebuffers();
+	}
+
+	steps.clear();
+	final_barriers.clear();
+	destroy_images();
+
+	std::vector<uint32_t> live_passes;
+	cull_passes(live_passes);
+
+	// Merge consecutive raster passes into the subpasses of a render pass
+	for (auto pass_index : live_passes)
+	{
+		auto &pass = *passes[pass_index];
+
+		if (!steps.empty() && can_merge(steps.back(), pass))
+		{
+			steps.back().passes.push_back(pass_index);
+			continue;
+		}
+
+		Step step;
+		step.raster = pass.type == RenderGraphPass::Type::Raster;
+		step.passes.push_back(pass_index);
+		steps.push_back(std::move(step));
+	}
+
+	// Image usage and lifetimes
+	for (uint32_t step_index = 0; step_index < to_u32(steps.size()); ++step_index)
+	{
+		for (auto pass_index : steps[step_index].passes)
+		{
+			for (auto &access : passes[pass_index]->accesses)
+			{
+				auto &image = images[get_image_index(access.image)];
+
+				image.usage |= image.info.usage | get_image_usage(access.usage);
+				image.first_step = std::min(image.first_step, step_index);
+				image.last_step  = std::max(image.last_step, step_index);
+				image.attachment_only &= is_attachment(access.usage);
+			}
+		}
+	}
+
+	// Images which are neither loaded nor stored by their render pass do not need memory on tile-based GPUs
+	for (auto &image : images)
+	{
+		if (!image.imported && image.first_step != ~0U && image.first_step == image.last_step && image.attachment_only && steps[image.first_step].raster &&
+		    (image.info.usage & ~(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT)) == 0)
+		{
+			image.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+		}
+	}
+
+	for (uint32_t step_index = 0; step_index < to_u32(steps.size()); ++step_index)
+	{
+		if (steps[step_index].raster)
+		{
+			build_render_pass(step_index);
+		}
+	}
+
+	allocate_images();
+
+	build_barriers();
+
+	compiled = true;
+
+	size_t barrier_count = final_barriers.size();
+	for (auto &step : steps)
+	{
+		barrier_count += step.barriers.size();
+	}
+
+	size_t lazily_allocated_count = std::count_if(images.begin(), images.end(), [](const Image &image) {
+		return image.image && image.image->is_lazily_allocated();
+	});
+
+	VkDeviceSize transient_size = 0;
+	VkDeviceSize aliased_size   = 0;
+	for (auto &slot : memory_slots)
+	{
+		aliased_size += slot.memory_requirements.size;
+
+		for (auto image_index : slot.images)
+		{
+			transient_size += images[image_index].memory_requirements.size;
+		}
+	}
+
+	LOGI("Render graph: {} of {} passes culled, {} steps, {} image barriers, {} KiB of transient images in {} KiB of memory, {} lazily allocated",
+	     passes.size() - live_passes.size(), passes.size(), steps.size(), barrier_count, transient_size / 1024, aliased_size / 1024, lazily_allocated_count);
+}
+
+void RenderGraph::execute(CommandBuffer &command_buffer)
+{
+	assert(compiled && "Render graph must be compiled before it is executed");
+
+	for (auto &step : steps)
+	{
+		record_barriers(command_buffer, step.barriers);
+
+		if (!step.raster)
+		{
+			auto &pass = *passes[step.passes.front()];
+
+			ScopedDebugLabel pass_debug_label{command_buffer, pass.name.c_str()};
+
+			if (pass.execute)
+			{
+				pass.execute(command_buffer);
+			}
+
+			continue;
+		}
+
+		auto &render_target = get_render_target(step);
+		auto &framebuffer   = device.get_resource_cache().request_framebuffer(render_target, *step.render_pass);
+
+		command_buffer.begin_render_pass(render_target, *step.render_pass, framebuffer, step.clear_values);
+
+		VkViewport viewport{};
+		viewport.width    = static_cast<float>(render_target.get_extent().width);
+		viewport.height   = static_cast<float>(render_target.get_extent().height);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		command_buffer.set_viewport(0, {viewport});
+
+		VkRect2D scissor{};
+		scissor.extent = render_target.get_extent();
+		command_buffer.set_scissor(0, {scissor});
+
+		for (size_t i = 0; i < step.passes.size(); ++i)
+		{
+			if (i > 0)
+			{
+				command_buffer.next_subpass();
+			}
+
+			auto &pass = *passes[step.passes[i]];
+
+			ScopedDebugLabel pass_debug_label{command_buffer, pass.name.c_str()};
+
+			if (pass.execute)
+			{
+				pass.execute(command_buffer);
+			}
+		}
+
+		command_buffer.end_render_pass();
+	}
+
+	record_barriers(command_buffer, final_barriers);
+}
+
+const core::ImageView &RenderGraph::get_image_view(const std::string &name) const
+{
+	auto &image = images[get_image_index(name)];
+
+	assert(image.view && "Image is imported or the render graph is not compiled");
+
+	return *image.view;
+}
+
+RenderGraph::ImageState RenderGraph::get_image_state(RenderGraphUsage usage, bool write, RenderGraphPass::Type type, VkFormat format)
+{
+	VkPipelineStageFlags shader_stage = type == RenderGraphPass::Type::Compute ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	VkImageLayout        read_layout  = is_depth_format(format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	ImageState state;
+
+	// Attachments are always written by their load and store operations
+	switch (usage)
+	{
+		case RenderGraphUsage::ColorAttachment:
+			state.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			state.stage  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			state.access = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			break;
+		case RenderGraphUsage::DepthStencilAttachment:
+			state.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+			state.stage  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			state.access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			break;
+		case RenderGraphUsage::InputAttachment:
+			state.layout = read_layout;
+			state.stage  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			state.access = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+			break;
+		case RenderGraphUsage::Sampled:
+			state.layout = read_layout;
+			state.stage  = shader_stage;
+			state.access = VK_ACCESS_SHADER_READ_BIT;
+			break;
+		case RenderGraphUsage::Storage:
+			state.layout = VK_IMAGE_LAYOUT_GENERAL;
+			state.stage  = shader_stage;
+			state.access = write ? VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_SHADER_READ_BIT;
+			break;
+		case RenderGraphUsage::TransferSrc:
+			state.layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			state.stage  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			state.access = VK_ACCESS_TRANSFER_READ_BIT;
+			break;
+		case RenderGraphUsage::TransferDst:
+			state.layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			state.stage  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			state.access = VK_ACCESS_TRANSFER_WRITE_BIT;
+			break;
+	}
+
+	return state;
+}
+
+uint32_t RenderGraph::get_image_index(const std::string &name) const
+{
+	auto it = image_indices.find(name);
+
+	if (it == image_indices.end())
+	{
+		throw std::runtime_error("Render graph image not declared: " + name);
+	}
+
+	return it->second;
+}
+
+VkImage RenderGraph::get_image_handle(const Image &image) const
+{
+	if (!image.imported)
+	{
+		return image.image->get_handle();
+	}
+
+	if (!image.imported_image)
+	{
+		throw std::runtime_error("Render graph imported image not bound: " + image.name);
+	}
+
+	return image.imported_image->get_handle();
+}
+
+bool RenderGraph::can_merge(const Step &step, const RenderGraphPass &pass) const
+{
+	if (!step.raster || pass.type != RenderGraphPass::Type::Raster)
+	{
+		return false;
+	}
+
+	std::set<uint32_t> step_images;
+	std::set<uint32_t> depth_attachments;
+	const VkExtent2D  *extent = nullptr;
+
+	for (auto pass_index : step.passes)
+	{
+		for (auto &access : passes[pass_index]->accesses)
+		{
+			auto  image_index = get_image_index(access.image);
+			auto &image       = images[image_index];
+
+			step_images.insert(image_index);
+
+			if (is_attachment(access.usage))
+			{
+				extent = &image.info.extent;
+
+				if (is_depth_format(image.info.format))
+				{
+					depth_attachments.insert(image_index);
+				}
+			}
+		}
+	}
+
+	for (auto &access : pass.accesses)
+	{
+		auto  image_index = get_image_index(access.image);
+		auto &image       = images[image_index];
+
+		if (is_attachment(access.usage))
+		{
+			if (extent && (image.info.extent.width != extent->width || image.info.extent.height != extent->height))
+			{
+				return false;
+			}
+
+			if (is_depth_format(image.info.format))
+			{
+				depth_attachments.insert(image_index);
+			}
+		}
+
+		// Images of the previous subpasses can only be read as input attachments, for which
+		// the render pass has subpass dependencies. Anything else needs a pipeline barrier.
+		if (step_images.count(image_index) != 0 && (access.write || access.usage != RenderGraphUsage::InputAttachment))
+		{
+			return false;
+		}
+	}
+
+	// The render pass binds its first depth attachment to every subpass
+	return depth_attachments.size() <= 1;
+}
+
+void RenderGraph::cull_passes(std::vector<uint32_t> &live_passes) const
+{
+	std::vector<bool> needed(images.size(), false);
+	std::vector<bool> live(passes.size(), false);
+
+	for (size_t i = 0; i < images.size(); ++i)
+	{
+		needed[i] = images[i].imported;
+	}
+
+	// Walk the passes backwards from the imported images. A live pass needs all the images
+	// it accesses, attachments which are not cleared load the content of previous passes.
+	for (size_t i = passes.size(); i-- > 0;)
+	{
+		for (auto &access : passes[i]->accesses)
+		{
+			if (access.write && needed[get_image_index(access.image)])
+			{
+				live[i] = true;
+			}
+		}
+
+		if (live[i])
+		{
+			for (auto &access : passes[i]->accesses)
+			{
+				needed[get_image_index(access.image)] = true;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < to_u32(passes.size()); ++i)
+	{
+		if (live[i])
+		{
+			live_passes.push_back(i);
+		}
+		else
+		{
+			LOGD("Render graph pass culled: {}", passes[i]->name);
+		}
+	}
+}
+
+void RenderGraph::build_render_pass(uint32_t step_index)
+{
+	auto &step = steps[step_index];
+
+	std::vector<Attachment> attachments;
+
+	for (auto pass_index : step.passes)
+	{
+		auto &pass = *passes[pass_index];
+
+		SubpassInfo subpass_info{};
+		subpass_info.debug_name = pass.name;
+
+		bool uses_depth_attachment = false;
+		bool reads_depth_input     = false;
+
+		for (auto &access : pass.accesses)
+		{
+			if (!is_attachment(access.usage))
+			{
+				continue;
+			}
+
+			auto  image_index = get_image_index(access.image);
+			auto &image       = images[image_index];
+			auto  state       = get_image_state(access.usage, access.write, pass.type, image.info.format);
+
+			auto it         = std::find(step.attachments.begin(), step.attachments.end(), image_index);
+			auto attachment = to_u32(std::distance(step.attachments.begin(), it));
+
+			if (it == step.attachments.end())
+			{
+				step.attachments.push_back(image_index);
+				attachments.push_back(Attachment{image.info.format, VK_SAMPLE_COUNT_1_BIT, image.usage});
+
+				// Clear the content of images written for the first time, and only store the ones read later
+				LoadStoreInfo load_store_info{};
+				bool          discard = step_index == image.first_step && (!image.imported || image.initial_state.layout == VK_IMAGE_LAYOUT_UNDEFINED);
+				load_store_info.load_op  = discard ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+				load_store_info.store_op = image.imported || image.last_step > step_index ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+				step.load_store_infos.push_back(load_store_info);
+
+				VkClearValue clear_value{};
+				auto         clear_it = pass.clear_values.find(access.image);
+				if (clear_it != pass.clear_values.end())
+				{
+					clear_value = clear_it->second;
+				}
+				else if (is_depth_format(image.info.format))
+				{
+					clear_value.depthStencil = {0.0f, ~0U};
+				}
+				else
+				{
+					clear_value.color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+				}
+				step.clear_values.push_back(clear_value);
+
+				step.initial_layouts.push_back(state.layout);
+				step.final_layouts.push_back(VK_IMAGE_LAYOUT_UNDEFINED);
+			}
+
+			switch (access.usage)
+			{
+				case RenderGraphUsage::ColorAttachment:
+					if (std::find(subpass_info.output_attachments.begin(), subpass_info.output_attachments.end(), attachment) == subpass_info.output_attachments.end())
+					{
+						subpass_info.output_attachments.push_back(attachment);
+					}
+					break;
+				case RenderGraphUsage::DepthStencilAttachment:
+					uses_depth_attachment = true;
+					break;
+				default:
+					if (std::find(subpass_info.input_attachments.begin(), subpass_info.input_attachments.end(), attachment) == subpass_info.input_attachments.end())
+					{
+						subpass_info.input_attachments.push_back(attachment);
+					}
+					reads_depth_input |= is_depth_format(image.info.format);
+					break;
+			}
+		}
+
+		subpass_info.disable_depth_stencil_attachment = !uses_depth_attachment || reads_depth_input;
+
+		step.subpass_infos.push_back(subpass_info);
+	}
+
+	if (step.attachments.empty())
+	{
+		throw std::runtime_error("Render graph raster pass without attachments: " + passes[step.passes.front()]->name);
+	}
+
+	// Attachments end in the layout of the last subpass using them, like the render pass does
+	for (size_t i = 0; i < step.attachments.size(); ++i)
+	{
+		step.final_layouts[i] = is_depth_format(attachments[i].format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	}
+
+	auto &last_pass    = *passes[step.passes.back()];
+	auto &last_subpass = step.subpass_infos.back();
+	for (auto &access : last_pass.accesses)
+	{
+		auto image_index = get_image_index(access.image);
+
+		if (!is_attachment(access.usage) || (access.usage == RenderGraphUsage::DepthStencilAttachment && last_subpass.disable_depth_stencil_attachment))
+		{
+			continue;
+		}
+
+		auto attachment = std::distance(step.attachments.begin(), std::find(step.attachments.begin(), step.attachments.end(), image_index));
+
+		step.final_layouts[attachment] = get_image_state(access.usage, access.write, last_pass.type, images[image_index].info.format).layout;
+	}
+
+	step.render_pass = &device.get_resource_cache().request_render_pass(attachments, step.load_store_infos, step.subpass_infos);
+}
+
+void RenderGraph::build_barriers()
+{
+	std::vector<ImageState> states(images.size());
+
+	for (size_t i = 0; i < images.size(); ++i)
+	{
+		states[i] = images[i].initial_state;
+	}
+
+	for (uint32_t step_index = 0; step_index < to_u32(steps.size()); ++step_index)
+	{
+		auto &step = steps[step_index];
+
+		// State each image needs for the whole step, in the layout of its first access
+		std::map<uint32_t, ImageState> required;
+
+		for (auto pass_index : step.passes)
+		{
+			auto &pass = *passes[pass_index];
+
+			for (auto &access : pass.accesses)
+			{
+				auto image_index = get_image_index(access.image);
+				auto state       = get_image_state(access.usage, access.write, pass.type, images[image_index].info.format);
+
+				auto it = required.find(image_index);
+				if (it == required.end())
+				{
+					required[image_index] = state;
+				}
+				else
+				{
+					it->second.stage |= state.stage;
+					it->second.access |= state.access;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < step.attachments.size(); ++i)
+		{
+			required[step.attachments[i]].layout = step.initial_layouts[i];
+		}
+
+		for (auto &it : required)
+		{
+			auto &image = images[it.first];
+			auto &dst   = it.second;
+			auto  src   = states[it.first];
+
+			// The first access of a transient image discards its content, and waits for
+			// the image which used the memory before it
+			if (step_index == image.first_step && !image.imported)
+			{
+				src.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+				if (image.previous_alias != ~0U)
+				{
+					src.stage  = states[image.previous_alias].stage;
+					src.access = states[image.previous_alias].access;
+				}
+			}
+
+			// Reads in the same layout need no barrier between them
+			if (src.layout == dst.layout && (src.access & write_access_mask) == 0 && (dst.access & write_access_mask) == 0)
+			{
+				states[it.first].stage |= dst.stage;
+				states[it.first].access |= dst.access;
+				continue;
+			}
+
+			src.access &= write_access_mask;
+
+			step.barriers.push_back({it.first, src, dst});
+
+			states[it.first] = dst;
+		}
+
+		for (size_t i = 0; i < step.attachments.size(); ++i)
+		{
+			states[step.attachments[i]].layout = step.final_layouts[i];
+		}
+	}
+
+	// The first access of an image owned by the graph waits for the last access of the
+	// previous frame to the same memory, as frames in flight share the graph images
+	auto wait_previous_frame = [&](uint32_t first_index, const ImageState &last) {
+		for (auto &barrier : steps[images[first_index].first_step].barriers)
+		{
+			if (barrier.image == first_index)
+			{
+				barrier.src.stage  = last.stage;
+				barrier.src.access = last.access & write_access_mask;
+			}
+		}
+	};
+
+	for (auto &slot : memory_slots)
+	{
+		wait_previous_frame(slot.images.front(), states[slot.images.back()]);
+	}
+
+	// Transient attachments have dedicated lazily allocated memory outside of the slots
+	for (uint32_t i = 0; i < to_u32(images.size()); ++i)
+	{
+		auto &image = images[i];
+
+		if (!image.imported && image.first_step != ~0U && (image.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT))
+		{
+			wait_previous_frame(i, states[i]);
+		}
+	}
+
+	for (uint32_t i = 0; i < to_u32(images.size()); ++i)
+	{
+		auto &image = images[i];
+
+		if (image.imported && image.first_step != ~0U && image.final_layout != VK_IMAGE_LAYOUT_UNDEFINED)
+		{
+			ImageState dst;
+			dst.layout = image.final_layout;
+			dst.stage  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+			ImageState src = states[i];
+			src.access &= write_access_mask;
+
+			final_barriers.push_back({i, src, dst});
+		}
+	}
+}
+
+void RenderGraph::allocate_images()
+{
+	std::vector<uint32_t> transient_images;
+
+	for (uint32_t i = 0; i < to_u32(images.size()); ++i)
+	{
+		auto &image = images[i];
+
+		if (image.imported || image.first_step == ~0U)
+		{
+			continue;
+		}
+
+		if (image.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+		{
+			image.image = std::make_unique<core::Image>(device, VkExtent3D{image.info.extent.width, image.info.extent.height, 1}, image.info.format, image.usage, VMA_MEMORY_USAGE_GPU_ONLY);
+			image.view  = std::make_unique<core::ImageView>(*image.image, VK_IMAGE_VIEW_TYPE_2D);
+			continue;
+		}
+
+		VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+		image_info.imageType     = VK_IMAGE_TYPE_2D;
+		image_info.format        = image.info.format;
+		image_info.extent        = {image.info.extent.width, image.info.extent.height, 1};
+		image_info.mipLevels     = 1;
+		image_info.arrayLayers   = 1;
+		image_info.samples       = VK_SAMPLE_COUNT_1_BIT;
+		image_info.tiling        = VK_IMAGE_TILING_OPTIMAL;
+		image_info.usage         = image.usage;
+		image_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+		image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		VK_CHECK(vkCreateImage(device.get_handle(), &image_info, nullptr, &image.handle));
+
+		vkGetImageMemoryRequirements(device.get_handle(), image.handle, &image.memory_requirements);
+
+		transient_images.push_back(i);
+	}
+
+	// Greedily place the largest images first, each in the first slot where no image lifetime overlaps
+	std::stable_sort(transient_images.begin(), transient_images.end(), [this](uint32_t a, uint32_t b) {
+		return images[a].memory_requirements.size > images[b].memory_requirements.size;
+	});
+
+	for (auto image_index : transient_images)
+	{
+		auto &image        = images[image_index];
+		auto &requirements = image.memory_requirements;
+
+		auto slot_it = std::find_if(memory_slots.begin(), memory_slots.end(), [&](const MemorySlot &slot) {
+			if ((slot.memory_requirements.memoryTypeBits & requirements.memoryTypeBits) == 0)
+			{
+				return false;
+			}
+
+			return std::none_of(slot.images.begin(), slot.images.end(), [&](uint32_t other_index) {
+				auto &other = images[other_index];
+				return image.first_step <= other.last_step && other.first_step <= image.last_step;
+			});
+		});
+
+		if (slot_it == memory_slots.end())
+		{
+			MemorySlot slot;
+			slot.memory_requirements = requirements;
+			slot.images.push_back(image_index);
+			memory_slots.push_back(std::move(slot));
+			continue;
+		}
+
+		slot_it->memory_requirements.size      = std::max(slot_it->memory_requirements.size, requirements.size);
+		slot_it->memory_requirements.alignment = std::max(slot_it->memory_requirements.alignment, requirements.alignment);
+		slot_it->memory_requirements.memoryTypeBits &= requirements.memoryTypeBits;
+		slot_it->images.push_back(image_index);
+	}
+
+	VmaAllocationCreateInfo allocation_info{};
+	allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+	for (auto &slot : memory_slots)
+	{
+		VK_CHECK(vmaAllocateMemory(device.get_memory_allocator(), &slot.memory_requirements, &allocation_info, &slot.allocation, nullptr));
+
+		// Images in a slot follow each other in the frame
+		std::sort(slot.images.begin(), slot.images.end(), [this](uint32_t a, uint32_t b) {
+			return images[a].first_step < images[b].first_step;
+		});
+
+		for (size_t i = 0; i < slot.images.size(); ++i)
+		{
+			auto &image = images[slot.images[i]];
+
+			VK_CHECK(vmaBindImageMemory(device.get_memory_allocator(), slot.allocation, image.handle));
+
+			image.image = std::make_unique<core::Image>(device, image.handle, VkExtent3D{image.info.extent.width, image.info.extent.height, 1}, image.info.format, image.usage);
+			image.view  = std::make_unique<core::ImageView>(*image.image, VK_IMAGE_VIEW_TYPE_2D);
+
+			image.previous_alias = i > 0 ? slot.images[i - 1] : ~0U;
+		}
+	}
+}
+
+void RenderGraph::destroy_images()
+{
+	for (auto &image : images)
+	{
+		image.view.reset();
+		image.image.reset();
+
+		if (image.handle != VK_NULL_HANDLE)
+		{
+			vkDestroyImage(device.get_handle(), image.handle, nullptr);
+			image.handle = VK_NULL_HANDLE;
+		}
+
+		image.usage           = 0;
+		image.attachment_only = true;
+		image.first_step      = ~0U;
+		image.last_step       = 0;
+		image.previous_alias  = ~0U;
+	}
+
+	for (auto &slot : memory_slots)
+	{
+		vmaFreeMemory(device.get_memory_allocator(), slot.allocation);
+	}
+
+	memory_slots.clear();
+}
+
+RenderTarget &RenderGraph::get_render_target(Step &step)
+{
+	std::vector<VkImage> imported_images;
+
+	for (auto image_index : step.attachments)
+	{
+		if (images[image_index].imported)
+		{
+			imported_images.push_back(get_image_handle(images[image_index]));
+		}
+	}
+
+	auto it = step.render_targets.find(imported_images);
+
+	if (it == step.render_targets.end())
+	{
+		std::vector<core::ImageView> views;
+
+		for (auto image_index : step.attachments)
+		{
+			auto &image = images[image_index];
+
+			if (image.imported)
+			{
+				views.emplace_back(const_cast<core::Image &>(*image.imported_image), VK_IMAGE_VIEW_TYPE_2D, image.info.format);
+			}
+			else
+			{
+				views.emplace_back(*image.image, VK_IMAGE_VIEW_TYPE_2D);
+			}
+		}
+
+		it = step.render_targets.emplace(imported_images, std::make_unique<RenderTarget>(std::move(views))).first;
+	}
+
+	return *it->second;
+}
+
+void RenderGraph::record_barriers(CommandBuffer &command_buffer, const std::vector<Barrier> &barriers)
+{
+	if (barriers.empty())
+	{
+		return;
+	}
+
+	std::vector<VkImageMemoryBarrier> image_barriers;
+	image_barriers.reserve(barriers.size());
+
+	VkPipelineStageFlags src_stage_mask = 0;
+	VkPipelineStageFlags dst_stage_mask = 0;
+
+	for (auto &barrier : barriers)
+	{
+		auto &image = images[barrier.image];
+
+		VkImageMemoryBarrier image_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+		image_barrier.srcAccessMask       = barrier.src.access;
+		image_barrier.dstAccessMask       = barrier.dst.access;
+		image_barrier.oldLayout           = barrier.src.layout;
+		image_barrier.newLayout           = barrier.dst.layout;
+		image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_barrier.image               = get_image_handle(image);
+
+		image_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		if (is_depth_format(image.info.format))
+		{
+			image_barrier.subresourceRange.aspectMask = is_depth_stencil_format(image.info.format) ? VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_DEPTH_BIT;
+		}
+		image_barrier.subresourceRange.levelCount = 1;
+		image_barrier.subresourceRange.layerCount = 1;
+
+		image_barriers.push_back(image_barrier);
+
+		src_stage_mask |= barrier.src.stage;
+		dst_stage_mask |= barrier.dst.stage;
+	}
+
+	vkCmdPipelineBarrier(command_buffer.get_handle(), src_stage_mask, dst_stage_mask, 0,
+	                     0, nullptr, 0, nullptr,
+	                     to_u32(image_barriers.size()), image_barriers.data());
+}
+}        // namespace vkb
@@ -0,0 +1,354 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "core/render_pass.h"
+#include "rendering/render_target.h"
+
+namespace vkb
+{
+/**
+ * @brief How a render graph pass accesses an image
+ */
+enum class RenderGraphUsage
+{
+	ColorAttachment,
+	DepthStencilAttachment,
+	InputAttachment,
+	Sampled,
+	Storage,
+	TransferSrc,
+	TransferDst
+};
+
+/**
+ * @brief Description of an image of the render graph
+ */
+struct RenderGraphImageInfo
+{
+	VkExtent2D extent{};
+
+	VkFormat format{VK_FORMAT_UNDEFINED};
+
+	/// Usage on top of the one derived from the passes accessing the image
+	VkImageUsageFlags usage{0};
+};
+
+/**
+ * @brief A pass of the render graph. It declares the images it reads and writes,
+ *        and records its commands in a callback when the graph is executed.
+ */
+class RenderGraphPass
+{
+  public:
+	enum class Type
+	{
+		/// Draws in a subpass, the attachments are bound by the render graph
+		Raster,
+
+		/// Records commands outside of a render pass
+		Compute
+	};
+
+	RenderGraphPass(const std::string &name, Type type);
+
+	RenderGraphPass(const RenderGraphPass &) = delete;
+
+	RenderGraphPass(RenderGraphPass &&) = delete;
+
+	RenderGraphPass &operator=(const RenderGraphPass &) = delete;
+
+	RenderGraphPass &operator=(RenderGraphPass &&) = delete;
+
+	/**
+	 * @brief Declares that the pass reads an image
+	 * @param image Name of the image
+	 * @param usage How the image is read
+	 */
+	RenderGraphPass &read(const std::string &image, RenderGraphUsage usage);
+
+	/**
+	 * @brief Declares that the pass writes an image
+	 * @param image Name of the image
+	 * @param usage How the image is written
+	 */
+	RenderGraphPass &write(const std::string &image, RenderGraphUsage usage);
+
+	/**
+	 * @brief Sets the value an attachment is cleared to, if the pass is the first to write it
+	 */
+	RenderGraphPass &set_clear_value(const std::string &image, const VkClearValue &clear_value);
+
+	/**
+	 * @brief Sets the callback recording the commands of the pass
+	 */
+	void set_execute(std::function<void(CommandBuffer &)> &&execute);
+
+	const std::string &get_name() const;
+
+	Type get_type() const;
+
+  private:
+	friend class RenderGraph;
+
+	struct Access
+	{
+		std::string image;
+
+		RenderGraphUsage usage;
+
+		bool write;
+	};
+
+	std::string name;
+
+	Type type;
+
+	std::vector<Access> accesses;
+
+	std::unordered_map<std::string, VkClearValue> clear_values;
+
+	std::function<void(CommandBuffer &)> execute;
+};
+
+/**
+ * @brief A frame render graph. Passes are declared in submission order together with the
+ *        images they access, then compile() works out how to run them:
+ *        - Passes which do not contribute to an imported image are culled
+ *        - Consecutive raster passes connected only through input attachments are merged
+ *          into the subpasses of a single render pass
+ *        - Layout transitions and memory dependencies are batched into one pipeline
+ *          barrier before each render pass or compute pass
+ *        - Transient images whose lifetimes do not overlap share the same memory
+ *        - Images which never leave a render pass become transient attachments, in lazily
+ *          allocated memory when available
+ *
+ *        Imported images, such as the swapchain images, are owned by the caller and must be
+ *        bound with set_imported_image() before each execute().
+ */
+class RenderGraph
+{
+  public:
+	RenderGraph(Device &device);
+
+	RenderGraph(const RenderGraph &) = delete;
+
+	RenderGraph(RenderGraph &&) = delete;
+
+	~RenderGraph();
+
+	RenderGraph &operator=(const RenderGraph &) = delete;
+
+	RenderGraph &operator=(RenderGraph &&) = delete;
+
+	/**
+	 * @brief Declares an image created and owned by the render graph, which only lives within a frame
+	 */
+	void add_image(const std::string &name, const RenderGraphImageInfo &info);
+
+	/**
+	 * @brief Declares an image owned by the caller. Its content outlives the frame, so the
+	 *        passes writing it are never culled.
+	 * @param name Name of the image
+	 * @param info Extent, format and usage of the image
+	 * @param initial_layout Layout of the image before the graph executes, undefined if its content can be discarded
+	 * @param final_layout Layout the image is transitioned to after the graph executes
+	 * @param src_stage_mask Stage to wait for before the first access, the swapchain acquire semaphore waits at color attachment output
+	 */
+	void import_image(const std::string &name, const RenderGraphImageInfo &info, VkImageLayout initial_layout, VkImageLayout final_layout,
+	                  VkPipelineStageFlags src_stage_mask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+	/**
+	 * @brief Binds the image backing an imported image for the next executions
+	 */
+	void set_imported_image(const std::string &name, const core::Image &image);
+
+	/**
+	 * @brief Releases the render targets created for imported images, to be called when they are destroyed
+	 */
+	void clear_imported_images();
+
+	/**
+	 * @brief Adds a pass, passes execute in the order they are added
+	 */
+	RenderGraphPass &add_pass(const std::string &name, RenderGraphPass::Type type = RenderGraphPass::Type::Raster);
+
+	/**
+	 * @brief Culls and merges the passes, computes the barriers and allocates the transient images
+	 */
+	void compile();
+
+	/**
+	 * @brief Records the compiled passes
+	 */
+	void execute(CommandBuffer &command_buffer);
+
+	/**
+	 * @return The view of a transient image, to bind it to the shaders of the passes
+	 */
+	const core::ImageView &get_image_view(const std::string &name) const;
+
+  private:
+	struct ImageState
+	{
+		VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+		VkPipelineStageFlags stage{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
+
+		VkAccessFlags access{0};
+	};
+
+	struct Image
+	{
+		std::string name;
+
+		RenderGraphImageInfo info;
+
+		VkImageUsageFlags usage{0};
+
+		bool imported{false};
+
+		VkImageLayout final_layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+		ImageState initial_state;
+
+		/// Image bound by the caller, if imported
+		const core::Image *imported_image{nullptr};
+
+		/// Only accessed as an attachment of a single render pass
+		bool attachment_only{true};
+
+		/// Image aliasing the memory of its slot, unless it is a transient attachment
+		VkImage handle{VK_NULL_HANDLE};
+
+		std::unique_ptr<core::Image> image;
+
+		std::unique_ptr<core::ImageView> view;
+
+		VkMemoryRequirements memory_requirements{};
+
+		/// Steps of the first and last access
+		uint32_t first_step{~0U};
+
+		uint32_t last_step{0};
+
+		/// Image which last used the memory before this one within a frame
+		uint32_t previous_alias{~0U};
+	};
+
+	struct Barrier
+	{
+		uint32_t image;
+
+		ImageState src;
+
+		ImageState dst;
+	};
+
+	/// A render pass made of the merged raster passes, or a single compute pass
+	struct Step
+	{
+		std::vector<uint32_t> passes;
+
+		bool raster{false};
+
+		/// Barriers recorded before the step
+		std::vector<Barrier> barriers;
+
+		/// Images bound as attachments of the render pass
+		std::vector<uint32_t> attachments;
+
+		std::vector<LoadStoreInfo> load_store_infos;
+
+		std::vector<SubpassInfo> subpass_infos;
+
+		std::vector<VkClearValue> clear_values;
+
+		/// Layouts of the attachments when the render pass begins and ends
+		std::vector<VkImageLayout> initial_layouts;
+
+		std::vector<VkImageLayout> final_layouts;
+
+		RenderPass *render_pass{nullptr};
+
+		/// Render targets by the imported images they bind
+		std::map<std::vector<VkImage>, std::unique_ptr<RenderTarget>> render_targets;
+	};
+
+	/// Memory shared by transient images with disjoint lifetimes
+	struct MemorySlot
+	{
+		VmaAllocation allocation{VK_NULL_HANDLE};
+
+		VkMemoryRequirements memory_requirements{};
+
+		std::vector<uint32_t> images;
+	};
+
+	static ImageState get_image_state(RenderGraphUsage usage, bool write, RenderGraphPass::Type type, VkFormat format);
+
+	uint32_t get_image_index(const std::string &name) const;
+
+	VkImage get_image_handle(const Image &image) const;
+
+	bool can_merge(const Step &step, const RenderGraphPass &pass) const;
+
+	void cull_passes(std::vector<uint32_t> &live_passes) const;
+
+	void build_render_pass(uint32_t step_index);
+
+	void build_barriers();
+
+	void allocate_images();
+
+	void destroy_images();
+
+	RenderTarget &get_render_target(Step &step);
+
+	void record_barriers(CommandBuffer &command_buffer, const std::vector<Barrier> &barriers);
+
+	Device &device;
+
+	std::vector<Image> images;
+
+	std::unordered_map<std::string, uint32_t> image_indices;
+
+	std::vector<std::unique_ptr<RenderGraphPass>> passes;
+
+	std::vector<Step> steps;
+
+	std::vector<Barrier> final_barriers;
+
+	std::vector<MemorySlot> memory_slots;
+
+	bool compiled{false};
+};
+}        // namespace vkb
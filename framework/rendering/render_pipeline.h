@@ -86,6 +86,8 @@ class RenderPipeline
 
 	/**
 	 * @brief Record draw commands for each Subpass
+	 * @remarks If the device uses dynamic rendering, each Subpass is recorded in its own dynamic rendering scope
+	 *          instead of a subpass of a render pass, see CommandBuffer::begin_render_pass.
 	 */
 	void draw(CommandBuffer &command_buffer, RenderTarget &render_target, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
@@ -35,16 +35,17 @@ struct CompareExtent2D
 Attachment::Attachment(VkFormat format, VkSampleCountFlagBits samples, VkImageUsageFlags usage) :
     format{format},
     samples{samples},
-    usage{usage}
+    usage{usage},
+    transient{(usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0}
 {
 }
 const RenderTarget::CreateFunc RenderTarget::DEFAULT_CREATE_FUNC = [](core::Image &&swapchain_image) -> std::unique_ptr<RenderTarget> {
 	VkFormat depth_format = get_suitable_depth_format(swapchain_image.get_device().get_gpu().get_handle());
 
-	core::Image depth_image{swapchain_image.get_device(), swapchain_image.get_extent(),
-	                        depth_format,
-	                        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
-	                        VMA_MEMORY_USAGE_GPU_ONLY};
+	Attachment depth_attachment{depth_format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+	depth_attachment.transient = true;
+
+	core::Image depth_image = create_attachment_image(swapchain_image.get_device(), swapchain_image.get_extent(), depth_attachment);
 
 	std::vector<core::Image> images;
 	images.push_back(std::move(swapchain_image));
@@ -53,6 +54,22 @@ const RenderTarget::CreateFunc RenderTarget::DEFAULT_CREATE_FUNC = [](core::Imag
 	return std::make_unique<RenderTarget>(std::move(images));
 };
 
+core::Image RenderTarget::create_attachment_image(Device const &device, const VkExtent3D &extent, const Attachment &attachment)
+{
+	VkImageUsageFlags usage = attachment.usage;
+
+	if (attachment.transient)
+	{
+		// Transient attachments can only be used as attachments
+		assert((usage & ~(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT)) == 0 &&
+		       "Transient attachments cannot have other usages");
+
+		usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+	}
+
+	return core::Image{device, extent, attachment.format, usage, VMA_MEMORY_USAGE_GPU_ONLY, attachment.samples};
+}
+
 vkb::RenderTarget::RenderTarget(std::vector<core::Image> &&images) :
     device{images.back().get_device()},
     images{std::move(images)}
@@ -40,6 +40,10 @@ struct Attachment
 
 	VkImageLayout initial_layout{VK_IMAGE_LAYOUT_UNDEFINED};
 
+	/// The attachment only lives within a render pass, it should neither be loaded nor stored.
+	/// Its image is created with transient usage, in lazily allocated memory when available.
+	bool transient{false};
+
 	Attachment() = default;
 
 	Attachment(VkFormat format, VkSampleCountFlagBits samples, VkImageUsageFlags usage);
@@ -61,6 +65,14 @@ class RenderTarget
 
 	static const CreateFunc DEFAULT_CREATE_FUNC;
 
+	/**
+	 * @brief Creates the image of an attachment, transient attachments are created with transient usage
+	 * @param device Device creating the image
+	 * @param extent Extent of the render target
+	 * @param attachment Description of the attachment
+	 */
+	static core::Image create_attachment_image(Device const &device, const VkExtent3D &extent, const Attachment &attachment);
+
 	RenderTarget(std::vector<core::Image> &&images);
 
 	RenderTarget(std::vector<core::ImageView> &&image_views);
@@ -0,0 +1,354 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/clustered_forward_subpass.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "common/utils.h"
+#include "common/vk_common.h"
+#include "rendering/render_context.h"
+#include "scene_graph/components/camera.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/perspective_camera.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+namespace
+{
+constexpr uint32_t cluster_count = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+
+/// Clusters binned by a workgroup of the light culling shader
+constexpr uint32_t cluster_group_size = 64;
+
+const std::vector<std::string> cluster_definitions = {
+    "CLUSTERED_LIGHTING",
+    "CLUSTER_GRID_X " + std::to_string(CLUSTER_GRID_X) + "U",
+    "CLUSTER_GRID_Y " + std::to_string(CLUSTER_GRID_Y) + "U",
+    "CLUSTER_GRID_Z " + std::to_string(CLUSTER_GRID_Z) + "U",
+    "MAX_LIGHTS_PER_CLUSTER " + std::to_string(MAX_LIGHTS_PER_CLUSTER) + "U"};
+
+template <class T>
+std::vector<uint8_t> to_bytes(const std::vector<T> &values)
+{
+	const uint8_t *data = reinterpret_cast<const uint8_t *>(values.data());
+	return std::vector<uint8_t>(data, data + values.size() * sizeof(T));
+}
+}        // namespace
+
+ClusteredForwardSubpass::ClusteredForwardSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
+    GeometrySubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera},
+    culling_shader{"clustered_light_culling.comp"}
+{
+	culling_variant.add_definitions(cluster_definitions);
+}
+
+void ClusteredForwardSubpass::prepare()
+{
+	prepare_bindless();
+
+	auto &device = render_context.get_device();
+	for (auto &mesh : meshes)
+	{
+		for (auto &sub_mesh : mesh->get_submeshes())
+		{
+			auto &variant = sub_mesh->get_mut_shader_variant();
+
+			variant.add_definitions(cluster_definitions);
+
+			variant.add_definitions(light_type_definitions);
+
+			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), get_variant(*sub_mesh));
+			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), get_variant(*sub_mesh));
+		}
+	}
+
+	device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, culling_shader, culling_variant);
+}
+
+void ClusteredForwardSubpass::cull_lights(CommandBuffer &command_buffer)
+{
+	update_lights();
+
+	auto &render_frame = render_context.get_active_frame();
+
+	// The light index counter in the header of the grid starts at zero
+	grid_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (cluster_count + 1) * sizeof(glm::uvec2));
+	grid_buffer.update(glm::uvec2(0));
+
+	index_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, cluster_count * MAX_LIGHTS_PER_CLUSTER * sizeof(uint32_t));
+
+	auto &resource_cache  = render_context.get_device().get_resource_cache();
+	auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, culling_shader, culling_variant);
+	auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	command_buffer.bind_buffer(uniform_buffer.get_buffer(), uniform_buffer.get_offset(), uniform_buffer.get_size(), 0, 6, 0);
+	command_buffer.bind_buffer(light_buffer.get_buffer(), light_buffer.get_offset(), light_buffer.get_size(), 0, 7, 0);
+	command_buffer.bind_buffer(grid_buffer.get_buffer(), grid_buffer.get_offset(), grid_buffer.get_size(), 0, 8, 0);
+	command_buffer.bind_buffer(index_buffer.get_buffer(), index_buffer.get_offset(), index_buffer.get_size(), 0, 9, 0);
+
+	command_buffer.dispatch((cluster_count + cluster_group_size - 1) / cluster_group_size, 1, 1);
+
+	// Make the light lists visible to the fragment shaders
+	BufferMemoryBarrier barrier{};
+	barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+
+	command_buffer.buffer_memory_barrier(grid_buffer.get_buffer(), grid_buffer.get_offset(), grid_buffer.get_size(), barrier);
+	command_buffer.buffer_memory_barrier(index_buffer.get_buffer(), index_buffer.get_offset(), index_buffer.get_size(), barrier);
+
+	lights_culled = true;
+}
+
+void ClusteredForwardSubpass::draw(CommandBuffer &command_buffer)
+{
+	if (!lights_culled)
+	{
+		update_lights();
+		bin_lights();
+	}
+
+	// The next frame bins its lights again
+	lights_culled = false;
+
+	command_buffer.bind_buffer(uniform_buffer.get_buffer(), uniform_buffer.get_offset(), uniform_buffer.get_size(), 0, 6, 0);
+	command_buffer.bind_buffer(light_buffer.get_buffer(), light_buffer.get_offset(), light_buffer.get_size(), 0, 7, 0);
+	command_buffer.bind_buffer(grid_buffer.get_buffer(), grid_buffer.get_offset(), grid_buffer.get_size(), 0, 8, 0);
+	command_buffer.bind_buffer(index_buffer.get_buffer(), index_buffer.get_offset(), index_buffer.get_size(), 0, 9, 0);
+
+	command_buffer.set_specialization_constant(0, cluster_uniform.directional_light_count);
+
+	GeometrySubpass::draw(command_buffer);
+}
+
+void ClusteredForwardSubpass::update_lights()
+{
+	lights.clear();
+
+	auto scene_lights = scene.get_components<sg::Light>();
+
+	// Directional lights first, they reach every cluster
+	std::stable_partition(scene_lights.begin(), scene_lights.end(), [](sg::Light *light) {
+		return light->get_light_type() == sg::LightType::Directional;
+	});
+
+	uint32_t directional_light_count = 0;
+
+	for (auto &scene_light : scene_lights)
+	{
+		const auto &properties = scene_light->get_properties();
+		auto       &transform  = scene_light->get_node()->get_transform();
+
+		if (scene_light->get_light_type() == sg::LightType::Directional)
+		{
+			directional_light_count++;
+		}
+		else if (scene_light->get_light_type() != sg::LightType::Point && scene_light->get_light_type() != sg::LightType::Spot)
+		{
+			continue;
+		}
+
+		lights.push_back({{transform.get_translation(), static_cast<float>(scene_light->get_light_type())},
+		                  {properties.color, properties.intensity},
+		                  {transform.get_rotation() * properties.direction, properties.range},
+		                  {properties.inner_cone_angle, properties.outer_cone_angle}});
+	}
+
+	const auto &extent = render_context.get_active_frame().get_render_target().get_extent();
+
+	// Orthographic cameras have no near and far planes, their clusters use an arbitrary depth range
+	float z_near = 0.1f;
+	float z_far  = 1000.0f;
+
+	if (auto perspective_camera = dynamic_cast<sg::PerspectiveCamera *>(&camera))
+	{
+		z_near = std::min(perspective_camera->get_near_plane(), perspective_camera->get_far_plane());
+		z_far  = std::max(perspective_camera->get_near_plane(), perspective_camera->get_far_plane());
+	}
+
+	cluster_uniform.view                    = camera.get_view();
+	cluster_uniform.inverse_projection      = glm::inverse(vulkan_style_projection(camera.get_projection()));
+	cluster_uniform.screen_size             = glm::vec2(extent.width, extent.height);
+	cluster_uniform.z_near                  = z_near;
+	cluster_uniform.z_far                   = z_far;
+	cluster_uniform.light_count             = to_u32(lights.size()) - directional_light_count;
+	cluster_uniform.directional_light_count = directional_light_count;
+
+	auto &render_frame = render_context.get_active_frame();
+
+	uniform_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(ClusterUniform));
+	uniform_buffer.update(cluster_uniform);
+
+	// Storage buffers cannot be empty
+	light_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, std::max<size_t>(lights.size(), 1) * sizeof(Light));
+	if (!lights.empty())
+	{
+		light_buffer.update(to_bytes(lights));
+	}
+}
+
+void ClusteredForwardSubpass::bin_lights()
+{
+	update_cluster_bounds();
+
+	const float log_depth_range = std::log(cluster_uniform.z_far / cluster_uniform.z_near);
+
+	auto get_slice = [&](float depth) {
+		float slice = std::log(std::max(depth, cluster_uniform.z_near) / cluster_uniform.z_near) * CLUSTER_GRID_Z / log_depth_range;
+		return std::min(static_cast<uint32_t>(slice), static_cast<uint32_t>(CLUSTER_GRID_Z - 1));
+	};
+
+	// Pairs of cluster and light index
+	std::vector<std::pair<uint32_t, uint32_t>> cluster_lights;
+
+	for (uint32_t i = cluster_uniform.directional_light_count; i < to_u32(lights.size()); ++i)
+	{
+		glm::vec3 center = glm::vec3(cluster_uniform.view * glm::vec4(glm::vec3(lights[i].position), 1.0f));
+		float     radius = lights[i].direction.w;
+
+		// Lights without a range reach every cluster
+		bool     bounded     = radius > 0.0f;
+		uint32_t first_slice = 0;
+		uint32_t last_slice  = CLUSTER_GRID_Z - 1;
+
+		if (bounded)
+		{
+			float depth = -center.z;
+
+			if (depth + radius < cluster_uniform.z_near || depth - radius > cluster_uniform.z_far)
+			{
+				continue;
+			}
+
+			first_slice = get_slice(depth - radius);
+			last_slice  = get_slice(depth + radius);
+		}
+
+		for (uint32_t z = first_slice; z <= last_slice; ++z)
+		{
+			for (uint32_t cluster_index = z * CLUSTER_GRID_X * CLUSTER_GRID_Y; cluster_index < (z + 1) * CLUSTER_GRID_X * CLUSTER_GRID_Y; ++cluster_index)
+			{
+				auto     &bounds = cluster_bounds[cluster_index];
+				glm::vec3 offset = glm::clamp(center, bounds.min, bounds.max) - center;
+
+				if (!bounded || glm::dot(offset, offset) <= radius * radius)
+				{
+					cluster_lights.emplace_back(cluster_index, i);
+				}
+			}
+		}
+	}
+
+	// Group the lights of each cluster, in light order
+	std::stable_sort(cluster_lights.begin(), cluster_lights.end(), [](const std::pair<uint32_t, uint32_t> &a, const std::pair<uint32_t, uint32_t> &b) {
+		return a.first < b.first;
+	});
+
+	// The first element is the header of the grid, the light index count
+	std::vector<glm::uvec2> grid(cluster_count + 1, glm::uvec2(0));
+	std::vector<uint32_t>   indices;
+	indices.reserve(cluster_lights.size());
+
+	for (auto &cluster_light : cluster_lights)
+	{
+		auto &cluster = grid[cluster_light.first + 1];
+
+		if (cluster.y == 0)
+		{
+			cluster.x = to_u32(indices.size());
+		}
+
+		if (cluster.y < MAX_LIGHTS_PER_CLUSTER)
+		{
+			indices.push_back(cluster_light.second);
+			cluster.y++;
+		}
+	}
+
+	grid[0].x = to_u32(indices.size());
+
+	auto &render_frame = render_context.get_active_frame();
+
+	grid_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, grid.size() * sizeof(glm::uvec2));
+	grid_buffer.update(to_bytes(grid));
+
+	index_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, std::max<size_t>(indices.size(), 1) * sizeof(uint32_t));
+	if (!indices.empty())
+	{
+		index_buffer.update(to_bytes(indices));
+	}
+}
+
+void ClusteredForwardSubpass::update_cluster_bounds()
+{
+	if (!cluster_bounds.empty() && cluster_bounds_projection == cluster_uniform.inverse_projection)
+	{
+		return;
+	}
+
+	cluster_bounds.resize(cluster_count);
+	cluster_bounds_projection = cluster_uniform.inverse_projection;
+
+	// Rays through the corners of the tiles, scaled to a view depth of 1
+	std::vector<glm::vec3> rays((CLUSTER_GRID_X + 1) * (CLUSTER_GRID_Y + 1));
+
+	for (uint32_t y = 0; y <= CLUSTER_GRID_Y; ++y)
+	{
+		for (uint32_t x = 0; x <= CLUSTER_GRID_X; ++x)
+		{
+			glm::vec2 ndc   = glm::vec2(x, y) / glm::vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y) * 2.0f - 1.0f;
+			glm::vec4 point = cluster_uniform.inverse_projection * glm::vec4(ndc, 0.5f, 1.0f);
+			glm::vec3 ray   = glm::vec3(point) / point.w;
+
+			rays[y * (CLUSTER_GRID_X + 1) + x] = ray / -ray.z;
+		}
+	}
+
+	for (uint32_t z = 0; z < CLUSTER_GRID_Z; ++z)
+	{
+		float depth_near = cluster_uniform.z_near * std::pow(cluster_uniform.z_far / cluster_uniform.z_near, static_cast<float>(z) / CLUSTER_GRID_Z);
+		float depth_far  = cluster_uniform.z_near * std::pow(cluster_uniform.z_far / cluster_uniform.z_near, static_cast<float>(z + 1) / CLUSTER_GRID_Z);
+
+		for (uint32_t y = 0; y < CLUSTER_GRID_Y; ++y)
+		{
+			for (uint32_t x = 0; x < CLUSTER_GRID_X; ++x)
+			{
+				auto &bounds = cluster_bounds[x + CLUSTER_GRID_X * (y + CLUSTER_GRID_Y * z)];
+				bounds.min   = glm::vec3(std::numeric_limits<float>::max());
+				bounds.max   = glm::vec3(std::numeric_limits<float>::lowest());
+
+				for (uint32_t corner = 0; corner < 4; ++corner)
+				{
+					const auto &ray = rays[(y + (corner >> 1)) * (CLUSTER_GRID_X + 1) + x + (corner & 1)];
+
+					bounds.min = glm::min(bounds.min, glm::min(ray * depth_near, ray * depth_far));
+					bounds.max = glm::max(bounds.max, glm::max(ray * depth_near, ray * depth_far));
+				}
+			}
+		}
+	}
+}
+}        // namespace vkb
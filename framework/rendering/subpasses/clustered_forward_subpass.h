@@ -0,0 +1,135 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "buffer_pool.h"
+#include "rendering/subpasses/geometry_subpass.h"
+
+// Size of the cluster grid, in screen tiles and depth slices
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+
+// Lights beyond this count are dropped from a cluster
+#define MAX_LIGHTS_PER_CLUSTER 64
+
+namespace vkb
+{
+/**
+ * @brief Cluster grid parameters, matches the ClusterUniform of the clustered lighting shaders
+ */
+struct alignas(16) ClusterUniform
+{
+	glm::mat4 view;
+
+	glm::mat4 inverse_projection;
+
+	glm::vec2 screen_size;
+
+	float z_near;
+
+	float z_far;
+
+	/// Number of point and spot lights, after the directional lights
+	uint32_t light_count;
+
+	uint32_t directional_light_count;
+};
+
+/**
+ * @brief Forward renders a Scene with clustered lighting. The view frustum is split in a grid of
+ *        clusters, each with the list of point and spot lights reaching it, so that fragments only
+ *        shade the lights around them and the number of lights is not capped.
+ *
+ *        Lights are binned on the GPU if cull_lights() is recorded before the render pass,
+ *        otherwise on the CPU when the subpass draws. The fragment shader must support the
+ *        CLUSTERED_LIGHTING variant, like base.frag and pbr.frag.
+ */
+class ClusteredForwardSubpass : public GeometrySubpass
+{
+  public:
+	/**
+	 * @brief Constructs a subpass for clustered forward rendering
+	 * @param render_context Render context
+	 * @param vertex_shader Vertex shader source
+	 * @param fragment_shader Fragment shader source
+	 * @param scene Scene to render on this subpass
+	 * @param camera Perspective camera used to look at the scene
+	 */
+	ClusteredForwardSubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Scene &scene, sg::Camera &camera);
+
+	virtual ~ClusteredForwardSubpass() = default;
+
+	virtual void prepare() override;
+
+	/**
+	 * @brief Records a compute dispatch binning the lights of the frame into the clusters.
+	 *        Must be recorded outside of a render pass, before the subpass draws.
+	 */
+	void cull_lights(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Record draw commands
+	 */
+	virtual void draw(CommandBuffer &command_buffer) override;
+
+  private:
+	struct ClusterBounds
+	{
+		glm::vec3 min;
+
+		glm::vec3 max;
+	};
+
+	/**
+	 * @brief Collects the lights of the scene and uploads them with the cluster parameters
+	 */
+	void update_lights();
+
+	/**
+	 * @brief Bins the lights into the clusters on the CPU
+	 */
+	void bin_lights();
+
+	void update_cluster_bounds();
+
+	ShaderSource culling_shader;
+
+	ShaderVariant culling_variant;
+
+	ClusterUniform cluster_uniform{};
+
+	std::vector<Light> lights;
+
+	/// View space bounds of the clusters, for the projection they were computed with
+	std::vector<ClusterBounds> cluster_bounds;
+
+	glm::mat4 cluster_bounds_projection{0.0f};
+
+	BufferAllocation uniform_buffer;
+
+	BufferAllocation light_buffer;
+
+	BufferAllocation grid_buffer;
+
+	BufferAllocation index_buffer;
+
+	/// Whether the lights of the frame were binned by cull_lights()
+	bool lights_culled{false};
+};
+}        // namespace vkb
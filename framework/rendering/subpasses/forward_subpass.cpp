@@ -20,6 +20,7 @@
 #include "common/utils.h"
 #include "common/vk_common.h"
 #include "rendering/render_context.h"
+#include "rendering/subpasses/shadow_subpass.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/material.h"
@@ -39,6 +40,8 @@ ForwardSubpass::ForwardSubpass(RenderContext &render_context, ShaderSource &&ver
 
 void ForwardSubpass::prepare()
 {
+	prepare_bindless();
+
 	auto &device = render_context.get_device();
 	for (auto &mesh : meshes)
 	{
@@ -51,17 +54,37 @@ void ForwardSubpass::prepare()
 
 			variant.add_definitions(light_type_definitions);
 
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+			if (shadow_subpass)
+			{
+				variant.add_definitions(ShadowSubpass::get_shadow_definitions());
+			}
+
+			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), get_variant(*sub_mesh));
+			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), get_variant(*sub_mesh));
 		}
 	}
 }
 
 void ForwardSubpass::draw(CommandBuffer &command_buffer)
+{
+	bind_lights(command_buffer);
+
+	GeometrySubpass::draw(command_buffer);
+}
+
+void ForwardSubpass::bind_lights(CommandBuffer &command_buffer)
 {
 	allocate_lights<ForwardLights>(scene.get_components<sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
 	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
 
-	GeometrySubpass::draw(command_buffer);
+	if (shadow_subpass)
+	{
+		shadow_subpass->bind_shadows(command_buffer, 10, 11);
+	}
+}
+
+void ForwardSubpass::set_shadow_subpass(ShadowSubpass *shadow_subpass_)
+{
+	shadow_subpass = shadow_subpass_;
 }
 }        // namespace vkb
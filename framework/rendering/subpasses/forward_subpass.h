@@ -25,6 +25,8 @@
 
 namespace vkb
 {
+class ShadowSubpass;
+
 namespace sg
 {
 class Scene;
@@ -65,6 +67,21 @@ class ForwardSubpass : public GeometrySubpass
 	 * @brief Record draw commands
 	 */
 	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Samples the cascaded shadow maps of a shadow subpass with the SHADOWS shader variant, must be called
+	 *        before prepare. The shadow atlas is bound at set 0, binding 10 and its uniform at binding 11.
+	 */
+	void set_shadow_subpass(ShadowSubpass *shadow_subpass);
+
+  protected:
+	/**
+	 * @brief Binds the lights of the scene, and the shadows of the shadow subpass if one is set
+	 */
+	void bind_lights(CommandBuffer &command_buffer);
+
+  private:
+	ShadowSubpass *shadow_subpass{nullptr};
 };
 
 }        // namespace vkb
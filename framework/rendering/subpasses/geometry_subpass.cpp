@@ -16,6 +16,10 @@
  */
 
 #include "rendering/subpasses/geometry_subpass.h"
+
+#include <algorithm>
+#include <cstring>
+
 #include "common/utils.h"
 #include "common/vk_common.h"
 #include "rendering/render_context.h"
@@ -24,6 +28,8 @@
 #include "scene_graph/components/material.h"
 #include "scene_graph/components/mesh.h"
 #include "scene_graph/components/pbr_material.h"
+#include "scene_graph/components/sampler.h"
+#include "scene_graph/components/sub_mesh.h"
 #include "scene_graph/components/texture.h"
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
@@ -40,13 +46,15 @@ GeometrySubpass::GeometrySubpass(RenderContext &render_context, ShaderSource &&v
 
 void GeometrySubpass::prepare()
 {
+	prepare_bindless();
+
 	// Build all shader variance upfront
 	auto &device = render_context.get_device();
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
 		{
-			auto &variant     = sub_mesh->get_shader_variant();
+			auto &variant     = get_variant(*sub_mesh);
 			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
 			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
 		}
@@ -92,20 +100,33 @@ void GeometrySubpass::draw(CommandBuffer &command_buffer)
 
 	get_sorted_nodes(opaque_nodes, transparent_nodes);
 
+	uint64_t triangle_count = 0;
+
 	// Draw opaque objects in front-to-back order
 	{
 		ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
 
-		for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+		if (instancing)
 		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+			triangle_count += draw_instanced(command_buffer, opaque_nodes);
+		}
+		else
+		{
+			for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+			{
+				update_uniform(command_buffer, *node_it->second.first, thread_index);
+
+				// Invert the front face if the mesh was flipped
+				const auto &scale      = node_it->second.first->get_transform().get_scale();
+				bool        flipped    = scale.x * scale.y * scale.z < 0;
+				VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
 
-			// Invert the front face if the mesh was flipped
-			const auto &scale      = node_it->second.first->get_transform().get_scale();
-			bool        flipped    = scale.x * scale.y * scale.z < 0;
-			VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+				uint32_t lod_index = select_lod(*node_it->second.first, *node_it->second.second, node_it->first);
 
-			draw_submesh(command_buffer, *node_it->second.second, front_face);
+				draw_submesh(command_buffer, *node_it->second.second, front_face, lod_index);
+
+				triangle_count += get_triangle_count(*node_it->second.second, lod_index);
+			}
 		}
 	}
 
@@ -134,9 +155,380 @@ void GeometrySubpass::draw(CommandBuffer &command_buffer)
 		{
 			update_uniform(command_buffer, *node_it->second.first, thread_index);
 
-			draw_submesh(command_buffer, *node_it->second.second);
+			uint32_t lod_index = select_lod(*node_it->second.first, *node_it->second.second, node_it->first);
+
+			draw_submesh(command_buffer, *node_it->second.second, VK_FRONT_FACE_COUNTER_CLOCKWISE, lod_index);
+
+			triangle_count += get_triangle_count(*node_it->second.second, lod_index);
+		}
+	}
+
+	render_context.add_frame_stat(StatIndex::triangles, static_cast<double>(triangle_count));
+}
+
+uint64_t GeometrySubpass::draw_instanced(CommandBuffer &command_buffer, const std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes)
+{
+	struct InstanceBatch
+	{
+		sg::SubMesh *sub_mesh;
+
+		VkFrontFace front_face;
+
+		uint32_t lod_index;
+
+		std::vector<sg::Node *> nodes;
+	};
+
+	// The material and pipeline state of a draw follow from its submesh and front face
+	std::map<std::tuple<sg::SubMesh *, VkFrontFace, uint32_t>, size_t> batch_indices;
+
+	std::vector<InstanceBatch> batches;
+
+	for (auto &node_it : opaque_nodes)
+	{
+		sg::Node    *node     = node_it.second.first;
+		sg::SubMesh *sub_mesh = node_it.second.second;
+
+		// Invert the front face if the mesh was flipped
+		const auto &scale      = node->get_transform().get_scale();
+		bool        flipped    = scale.x * scale.y * scale.z < 0;
+		VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+		uint32_t lod_index = select_lod(*node, *sub_mesh, node_it.first);
+
+		auto batch_it = batch_indices.emplace(std::make_tuple(sub_mesh, front_face, lod_index), batches.size()).first;
+
+		if (batch_it->second == batches.size())
+		{
+			batches.push_back({sub_mesh, front_face, lod_index, {}});
+		}
+
+		batches[batch_it->second].nodes.push_back(node);
+	}
+
+	uint64_t triangle_count = 0;
+
+	for (auto &batch : batches)
+	{
+		// The global uniform still provides the camera, its model matrix is unused by instanced draws
+		update_uniform(command_buffer, *batch.nodes.front(), thread_index);
+
+		uint32_t instance_count = to_u32(batch.nodes.size());
+
+		if (instance_count > 1 && !supports_instancing(*batch.sub_mesh))
+		{
+			// Without per instance transforms every node needs its own model matrix
+			for (auto *node : batch.nodes)
+			{
+				update_uniform(command_buffer, *node, thread_index);
+
+				draw_submesh(command_buffer, *batch.sub_mesh, batch.front_face, batch.lod_index);
+			}
+
+			triangle_count += static_cast<uint64_t>(get_triangle_count(*batch.sub_mesh, batch.lod_index)) * instance_count;
+
+			continue;
+		}
+
+		if (instance_count > 1)
+		{
+			update_instance_transforms(command_buffer, batch.nodes, thread_index);
+		}
+
+		draw_submesh(command_buffer, *batch.sub_mesh, batch.front_face, batch.lod_index, instance_count);
+
+		triangle_count += static_cast<uint64_t>(get_triangle_count(*batch.sub_mesh, batch.lod_index)) * instance_count;
+	}
+
+	return triangle_count;
+}
+
+void GeometrySubpass::update_instance_transforms(CommandBuffer &command_buffer, const std::vector<sg::Node *> &nodes, size_t thread_index)
+{
+	std::vector<uint8_t> transforms(nodes.size() * sizeof(glm::mat4));
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		glm::mat4 model = nodes[i]->get_transform().get_world_matrix();
+
+		if (nodes[i]->has_component<sg::Mesh>())
+		{
+			model = model * nodes[i]->get_component<sg::Mesh>().get_dequantization();
+		}
+
+		std::memcpy(transforms.data() + i * sizeof(glm::mat4), &model[0][0], sizeof(glm::mat4));
+	}
+
+	auto &render_frame = get_render_context().get_active_frame();
+
+	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, transforms.size(), thread_index);
+
+	allocation.update(transforms);
+
+	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 13, 0);
+}
+
+bool GeometrySubpass::supports_instancing(const sg::SubMesh &sub_mesh)
+{
+	auto &vert_shader_module = get_render_context().get_device().get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), get_instanced_variant(sub_mesh));
+
+	const auto &resources = vert_shader_module.get_resources();
+
+	return std::any_of(resources.begin(), resources.end(), [](const ShaderResource &resource) {
+		return resource.type == ShaderResourceType::BufferStorage && resource.name == "InstanceTransforms";
+	});
+}
+
+const ShaderVariant &GeometrySubpass::get_instanced_variant(const sg::SubMesh &sub_mesh)
+{
+	auto it = instanced_variants.find(&sub_mesh);
+
+	if (it == instanced_variants.end())
+	{
+		ShaderVariant variant = get_variant(sub_mesh);
+		variant.add_define("INSTANCING");
+
+		it = instanced_variants.emplace(&sub_mesh, std::move(variant)).first;
+	}
+
+	return it->second;
+}
+
+const ShaderVariant &GeometrySubpass::get_variant(const sg::SubMesh &sub_mesh)
+{
+	if (!bindless)
+	{
+		return sub_mesh.get_shader_variant();
+	}
+
+	auto it = bindless_variants.find(&sub_mesh);
+
+	if (it == bindless_variants.end())
+	{
+		ShaderVariant variant = sub_mesh.get_shader_variant();
+
+		// Textures are looked up through the material index, so submeshes only differing by their textures share shaders
+		for (auto &texture : sub_mesh.get_material()->textures)
+		{
+			std::string tex_name = texture.first;
+			std::transform(tex_name.begin(), tex_name.end(), tex_name.begin(), ::toupper);
+
+			variant.add_undefine("HAS_" + tex_name);
+		}
+
+		variant.add_define("BINDLESS");
+		variant.add_define("MAX_BINDLESS_TEXTURES " + std::to_string(bindless_textures.size()));
+
+		it = bindless_variants.emplace(&sub_mesh, std::move(variant)).first;
+	}
+
+	return it->second;
+}
+
+void GeometrySubpass::prepare_bindless()
+{
+	if (!bindless)
+	{
+		return;
+	}
+
+	auto &device = render_context.get_device();
+
+	if (device.uses_descriptor_buffers())
+	{
+		LOGW("Bindless materials are not supported with descriptor buffers, disabling them");
+		bindless = false;
+		return;
+	}
+
+	bindless_textures.clear();
+	bindless_material_indices.clear();
+
+	// Index of each texture in the bindless texture array, textures sharing an image and sampler share an entry
+	std::map<std::pair<VkImageView, VkSampler>, int32_t> texture_indices;
+
+	auto get_texture_index = [&](const sg::Material &material, const std::string &name) {
+		auto texture_it = material.textures.find(name);
+
+		if (texture_it == material.textures.end())
+		{
+			return -1;
+		}
+
+		VkDescriptorImageInfo image_info{};
+		image_info.sampler     = texture_it->second->get_sampler()->vk_sampler.get_handle();
+		image_info.imageView   = texture_it->second->get_image()->get_vk_image_view().get_handle();
+		image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		auto index_it = texture_indices.emplace(std::make_pair(image_info.imageView, image_info.sampler), static_cast<int32_t>(bindless_textures.size())).first;
+
+		if (index_it->second == static_cast<int32_t>(bindless_textures.size()))
+		{
+			bindless_textures.push_back(image_info);
+		}
+
+		return index_it->second;
+	};
+
+	std::vector<BindlessMaterial> materials;
+
+	for (auto &mesh : meshes)
+	{
+		for (auto &sub_mesh : mesh->get_submeshes())
+		{
+			auto material = sub_mesh->get_material();
+
+			if (bindless_material_indices.count(material) != 0)
+			{
+				continue;
+			}
+
+			BindlessMaterial bindless_material{};
+			bindless_material.base_color_factor = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+
+			if (auto pbr_material = dynamic_cast<const sg::PBRMaterial *>(material))
+			{
+				bindless_material.base_color_factor = pbr_material->base_color_factor;
+				bindless_material.metallic_factor   = pbr_material->metallic_factor;
+				bindless_material.roughness_factor  = pbr_material->roughness_factor;
+			}
+
+			bindless_material.base_color_texture         = get_texture_index(*material, "base_color_texture");
+			bindless_material.normal_texture             = get_texture_index(*material, "normal_texture");
+			bindless_material.metallic_roughness_texture = get_texture_index(*material, "metallic_roughness_texture");
+
+			bindless_material_indices.emplace(material, to_u32(materials.size()));
+			materials.push_back(bindless_material);
+		}
+	}
+
+	const auto &limits = device.get_gpu().get_properties().limits;
+
+	uint32_t max_textures = std::min(limits.maxPerStageDescriptorSamplers, limits.maxPerStageDescriptorSampledImages);
+
+	if (materials.empty() || bindless_textures.empty() || bindless_textures.size() > max_textures)
+	{
+		LOGW("Bindless materials need between 1 and {} textures, the scene has {}, disabling them", max_textures, bindless_textures.size());
+		bindless = false;
+		bindless_textures.clear();
+		bindless_material_indices.clear();
+		return;
+	}
+
+	bindless_material_buffer = std::make_unique<core::Buffer>(device,
+	                                                          materials.size() * sizeof(BindlessMaterial),
+	                                                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+	                                                          VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+	bindless_material_buffer->update(reinterpret_cast<const uint8_t *>(materials.data()), materials.size() * sizeof(BindlessMaterial));
+
+	bindless_variants.clear();
+	instanced_variants.clear();
+}
+
+void GeometrySubpass::update_bindless_descriptor_set(PipelineLayout &pipeline_layout)
+{
+	if (bindless_descriptor_set != VK_NULL_HANDLE || !pipeline_layout.has_descriptor_set_layout(1))
+	{
+		return;
+	}
+
+	auto &device = render_context.get_device();
+
+	auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(1);
+
+	auto texture_binding  = descriptor_set_layout.get_layout_binding("bindless_textures");
+	auto material_binding = descriptor_set_layout.get_layout_binding("Materials");
+
+	if (!texture_binding || !material_binding)
+	{
+		return;
+	}
+
+	bindless_descriptor_pool = std::make_unique<DescriptorPool>(device, descriptor_set_layout, 1);
+	bindless_descriptor_set  = bindless_descriptor_pool->allocate();
+
+	VkDescriptorBufferInfo material_buffer_info{bindless_material_buffer->get_handle(), 0, bindless_material_buffer->get_size()};
+
+	std::array<VkWriteDescriptorSet, 2> writes{};
+
+	writes[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	writes[0].dstSet          = bindless_descriptor_set;
+	writes[0].dstBinding      = texture_binding->binding;
+	writes[0].descriptorCount = to_u32(bindless_textures.size());
+	writes[0].descriptorType  = texture_binding->descriptorType;
+	writes[0].pImageInfo      = bindless_textures.data();
+
+	writes[1].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	writes[1].dstSet          = bindless_descriptor_set;
+	writes[1].dstBinding      = material_binding->binding;
+	writes[1].descriptorCount = 1;
+	writes[1].descriptorType  = material_binding->descriptorType;
+	writes[1].pBufferInfo     = &material_buffer_info;
+
+	vkUpdateDescriptorSets(device.get_handle(), to_u32(writes.size()), writes.data(), 0, nullptr);
+}
+
+uint32_t GeometrySubpass::select_lod(sg::Node &node, const sg::SubMesh &sub_mesh, float distance)
+{
+	if (sub_mesh.lods.size() < 2)
+	{
+		return 0;
+	}
+
+	auto node_transform = node.get_transform().get_world_matrix();
+
+	// The largest axis scale of the node converts object space errors to world space
+	float node_scale = std::max(glm::length(glm::vec3(node_transform[0])),
+	                            std::max(glm::length(glm::vec3(node_transform[1])), glm::length(glm::vec3(node_transform[2]))));
+
+	float radius = 0.0f;
+	if (node.has_component<sg::Mesh>())
+	{
+		radius = glm::length(node.get_component<sg::Mesh>().get_bounds().get_scale()) * 0.5f * node_scale;
+	}
+
+	auto projection = camera.get_projection();
+
+	// Pixels covered by a world space unit, at unit distance for perspective projections
+	float pixels_per_unit = std::abs(projection[1][1]) * 0.5f * static_cast<float>(render_context.get_surface_extent().height);
+
+	bool perspective = projection[2][3] != 0.0f;
+	if (perspective)
+	{
+		// Measure from the closest point of the bounds, so objects the camera is in always get full detail
+		float closest_distance = distance - radius;
+		if (closest_distance <= std::numeric_limits<float>::epsilon())
+		{
+			return 0;
 		}
+
+		pixels_per_unit /= closest_distance;
+	}
+
+	uint32_t lod_index = 0;
+
+	for (uint32_t i = 1; i < sub_mesh.lods.size(); ++i)
+	{
+		if (sub_mesh.lods[i].error * node_scale * pixels_per_unit > lod_threshold)
+		{
+			break;
+		}
+
+		lod_index = i;
 	}
+
+	return lod_index;
+}
+
+uint32_t GeometrySubpass::get_triangle_count(const sg::SubMesh &sub_mesh, uint32_t lod_index)
+{
+	if (lod_index < sub_mesh.lods.size())
+	{
+		return sub_mesh.lods[lod_index].index_count / 3;
+	}
+
+	return (sub_mesh.vertex_indices != 0 ? sub_mesh.vertex_indices : sub_mesh.vertices_count) / 3;
 }
 
 void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index)
@@ -153,6 +545,12 @@ void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &no
 
 	global_uniform.model = transform.get_world_matrix();
 
+	// Quantized vertex positions are decoded as part of the model matrix
+	if (node.has_component<sg::Mesh>())
+	{
+		global_uniform.model = global_uniform.model * node.get_component<sg::Mesh>().get_dequantization();
+	}
+
 	global_uniform.camera_position = glm::vec3(glm::inverse(camera.get_view())[3]);
 
 	allocation.update(global_uniform);
@@ -160,7 +558,7 @@ void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &no
 	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 1, 0);
 }
 
-void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face)
+void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face, uint32_t lod_index, uint32_t instance_count)
 {
 	auto &device = command_buffer.get_device();
 
@@ -172,8 +570,10 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 	multisample_state.rasterization_samples = sample_count;
 	command_buffer.set_multisample_state(multisample_state);
 
-	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), sub_mesh.get_shader_variant());
-	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), sub_mesh.get_shader_variant());
+	const ShaderVariant &variant = instance_count > 1 ? get_instanced_variant(sub_mesh) : get_variant(sub_mesh);
+
+	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
+	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
 
 	std::vector<ShaderModule *> shader_modules{&vert_shader_module, &frag_shader_module};
 
@@ -181,20 +581,32 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 
 	command_buffer.bind_pipeline_layout(pipeline_layout);
 
-	if (pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
+	if (bindless)
 	{
-		prepare_push_constants(command_buffer, sub_mesh);
-	}
+		// The textures and materials were written once, draws only select their material
+		update_bindless_descriptor_set(pipeline_layout);
 
-	DescriptorSetLayout &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(0);
+		command_buffer.bind_descriptor_set(1, bindless_descriptor_set);
 
-	for (auto &texture : sub_mesh.get_material()->textures)
+		command_buffer.push_constants(bindless_material_indices.at(sub_mesh.get_material()));
+	}
+	else
 	{
-		if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
+		if (pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
 		{
-			command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
-			                          texture.second->get_sampler()->vk_sampler,
-			                          0, layout_binding->binding, 0);
+			prepare_push_constants(command_buffer, sub_mesh);
+		}
+
+		DescriptorSetLayout &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(0);
+
+		for (auto &texture : sub_mesh.get_material()->textures)
+		{
+			if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
+			{
+				command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
+				                          texture.second->get_sampler()->vk_sampler,
+				                          0, layout_binding->binding, 0);
+			}
 		}
 	}
 
@@ -243,7 +655,7 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 		}
 	}
 
-	draw_submesh_command(command_buffer, sub_mesh);
+	draw_submesh_command(command_buffer, sub_mesh, lod_index, instance_count);
 }
 
 void GeometrySubpass::prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material)
@@ -294,7 +706,7 @@ void GeometrySubpass::prepare_push_constants(CommandBuffer &command_buffer, sg::
 	}
 }
 
-void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
+void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, uint32_t lod_index, uint32_t instance_count)
 {
 	// Draw submesh indexed if indices exists
 	if (sub_mesh.vertex_indices != 0)
@@ -302,13 +714,22 @@ void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::Su
 		// Bind index buffer of submesh
 		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
 
-		// Draw submesh using indexed data
-		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, 0);
+		if (lod_index < sub_mesh.lods.size())
+		{
+			// Levels of detail are ranges of the same index buffer
+			const auto &lod = sub_mesh.lods[lod_index];
+			command_buffer.draw_indexed(lod.index_count, instance_count, lod.first_index, 0, 0);
+		}
+		else
+		{
+			// Draw submesh using indexed data
+			command_buffer.draw_indexed(sub_mesh.vertex_indices, instance_count, 0, 0, 0);
+		}
 	}
 	else
 	{
 		// Draw submesh using vertices only
-		command_buffer.draw(sub_mesh.vertices_count, 1, 0, 0);
+		command_buffer.draw(sub_mesh.vertices_count, instance_count, 0, 0);
 	}
 }
 
@@ -316,4 +737,19 @@ void GeometrySubpass::set_thread_index(uint32_t index)
 {
 	thread_index = index;
 }
+
+void GeometrySubpass::set_lod_threshold(float pixels)
+{
+	lod_threshold = pixels;
+}
+
+void GeometrySubpass::set_instancing(bool enabled)
+{
+	instancing = enabled;
+}
+
+void GeometrySubpass::set_bindless(bool enabled)
+{
+	bindless = enabled;
+}
 }        // namespace vkb
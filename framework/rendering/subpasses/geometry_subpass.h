@@ -23,6 +23,8 @@ VKBP_DISABLE_WARNINGS()
 #include "common/glm_common.h"
 VKBP_ENABLE_WARNINGS()
 
+#include "core/buffer.h"
+#include "core/descriptor_pool.h"
 #include "rendering/subpass.h"
 
 namespace vkb
@@ -34,6 +36,7 @@ class Node;
 class Mesh;
 class SubMesh;
 class Camera;
+class Material;
 }        // namespace sg
 
 /**
@@ -60,6 +63,26 @@ struct PBRMaterialUniform
 	float roughness_factor;
 };
 
+/**
+ * @brief Material of the bindless materials storage buffer, matches the Material struct of the shaders
+ *        compiled with BINDLESS. Texture indices point into the bindless texture array, -1 if the
+ *        material has no such texture.
+ */
+struct alignas(16) BindlessMaterial
+{
+	glm::vec4 base_color_factor;
+
+	float metallic_factor;
+
+	float roughness_factor;
+
+	int32_t base_color_texture;
+
+	int32_t normal_texture;
+
+	int32_t metallic_roughness_texture;
+};
+
 /**
  * @brief This subpass is responsible for rendering a Scene
  */
@@ -90,10 +113,76 @@ class GeometrySubpass : public Subpass
 	 */
 	void set_thread_index(uint32_t index);
 
+	/**
+	 * @brief Sets the screen space error, in pixels, a submesh level of detail may have to be selected
+	 */
+	void set_lod_threshold(float pixels);
+
+	/**
+	 * @brief Enables drawing the opaque submeshes shared by several nodes with a single instanced draw.
+	 *        The vertex shader then reads the model matrices from the InstanceTransforms storage buffer
+	 *        at set 0, binding 13, when INSTANCING is defined, as base.vert, pbr.vert and
+	 *        deferred/geometry.vert do. Submeshes whose vertex shader has no such buffer are drawn
+	 *        once per node.
+	 */
+	void set_instancing(bool enabled);
+
+	/**
+	 * @brief Enables bindless materials, must be called before prepare. All the textures of the scene are
+	 *        written once to an array at set 1, binding 0, and the materials to the Materials storage buffer
+	 *        at set 1, binding 1. Draws then only push the index of their material, and shaders compiled
+	 *        with BINDLESS read the material and its textures through it, as base.frag, pbr.frag and
+	 *        deferred/geometry.frag do. Requires the shaderSampledImageArrayDynamicIndexing feature, bindless
+	 *        materials are disabled if the device uses descriptor buffers or the scene has more textures
+	 *        than a shader stage can access.
+	 */
+	void set_bindless(bool enabled);
+
   protected:
 	virtual void update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index);
 
-	void draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE);
+	void draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE, uint32_t lod_index = 0, uint32_t instance_count = 1);
+
+	/**
+	 * @brief Draws the opaque nodes, batching the nodes drawing the same submesh with the same
+	 *        level of detail and front face into instanced draws
+	 * @param command_buffer Command buffer to record to
+	 * @param opaque_nodes Opaque nodes sorted front to back, batches are drawn in the order of their closest node
+	 * @return The number of triangles drawn
+	 */
+	uint64_t draw_instanced(CommandBuffer &command_buffer, const std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes);
+
+	/**
+	 * @brief Binds the model matrices of the instances of an instanced draw
+	 */
+	void update_instance_transforms(CommandBuffer &command_buffer, const std::vector<sg::Node *> &nodes, size_t thread_index);
+
+	/**
+	 * @return Whether the vertex shader reads the InstanceTransforms buffer when compiled with INSTANCING
+	 */
+	bool supports_instancing(const sg::SubMesh &sub_mesh);
+
+	/**
+	 * @return The shader variant of a submesh with INSTANCING defined
+	 */
+	const ShaderVariant &get_instanced_variant(const sg::SubMesh &sub_mesh);
+
+	/**
+	 * @return The shader variant a submesh is drawn with, without its texture definitions and with
+	 *         BINDLESS defined if bindless materials are enabled
+	 */
+	const ShaderVariant &get_variant(const sg::SubMesh &sub_mesh);
+
+	/**
+	 * @brief Collects the textures and materials of the scene and uploads the bindless materials
+	 */
+	void prepare_bindless();
+
+	/**
+	 * @brief Allocates and writes the bindless descriptor set, on the first draw with the pipeline layout
+	 *        defining its set layout
+	 */
+	void update_bindless_descriptor_set(PipelineLayout &pipeline_layout);
 
 	virtual void prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material);
 
@@ -101,7 +190,22 @@ class GeometrySubpass : public Subpass
 
 	virtual void prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
 
-	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
+	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, uint32_t lod_index = 0, uint32_t instance_count = 1);
+
+	/**
+	 * @brief Selects the coarsest level of detail of a submesh whose geometric error,
+	 *        projected on screen, stays below the LOD threshold
+	 * @param node The node the submesh is drawn for
+	 * @param sub_mesh The submesh
+	 * @param distance Distance from the camera to the center of the node bounds
+	 * @return Index into the submesh lods, 0 if it has no LOD chain
+	 */
+	uint32_t select_lod(sg::Node &node, const sg::SubMesh &sub_mesh, float distance);
+
+	/**
+	 * @return The number of triangles drawn for a level of detail of a submesh
+	 */
+	static uint32_t get_triangle_count(const sg::SubMesh &sub_mesh, uint32_t lod_index);
 
 	/**
 	 * @brief Sorts objects based on distance from camera and classifies them
@@ -119,6 +223,29 @@ class GeometrySubpass : public Subpass
 	uint32_t thread_index{0};
 
 	vkb::RasterizationState base_rasterization_state{};
+
+	/// Maximum screen space error in pixels of a selected level of detail
+	float lod_threshold{1.0f};
+
+	bool instancing{false};
+
+	std::unordered_map<const sg::SubMesh *, ShaderVariant> instanced_variants;
+
+	bool bindless{false};
+
+	std::unordered_map<const sg::SubMesh *, ShaderVariant> bindless_variants;
+
+	/// Index of each material in the bindless materials buffer
+	std::unordered_map<const sg::Material *, uint32_t> bindless_material_indices;
+
+	/// Image views and samplers of the bindless texture array
+	std::vector<VkDescriptorImageInfo> bindless_textures;
+
+	std::unique_ptr<core::Buffer> bindless_material_buffer;
+
+	std::unique_ptr<DescriptorPool> bindless_descriptor_pool;
+
+	VkDescriptorSet bindless_descriptor_set{VK_NULL_HANDLE};
 };
 
 }        // namespace vkb
@@ -0,0 +1,929 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/gpu_driven_subpass.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+#include "common/utils.h"
+#include "common/vk_common.h"
+#include "geometry/frustum.h"
+#include "rendering/render_context.h"
+#include "scene_graph/components/camera.h"
+#include "scene_graph/components/material.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+namespace
+{
+/// Instances culled by a workgroup of the culling shader
+constexpr uint32_t instance_group_size = 64;
+
+/// Width and height of the texels reduced by a workgroup of the depth pyramid shader
+constexpr uint32_t depth_pyramid_group_size = 8;
+
+/// Submeshes sharing a shader variant, index type and vertex attribute formats and strides share a geometry
+using GeometryKey = std::tuple<size_t, VkIndexType, std::map<std::string, std::pair<VkFormat, uint32_t>>>;
+
+template <class T>
+std::vector<uint8_t> to_bytes(const std::vector<T> &values)
+{
+	const uint8_t *data = reinterpret_cast<const uint8_t *>(values.data());
+	return std::vector<uint8_t>(data, data + values.size() * sizeof(T));
+}
+
+std::unique_ptr<core::Buffer> create_buffer(Device &device, VkBufferUsageFlags usage, const std::vector<uint8_t> &data)
+{
+	auto buffer = std::make_unique<core::Buffer>(device, data.size(), usage, VMA_MEMORY_USAGE_CPU_TO_GPU);
+	buffer->update(data);
+	return buffer;
+}
+
+uint32_t previous_power_of_two(uint32_t value)
+{
+	uint32_t result = 1;
+
+	while (result * 2 <= value)
+	{
+		result *= 2;
+	}
+
+	return result;
+}
+
+uint32_t get_index_size(VkIndexType index_type)
+{
+	switch (index_type)
+	{
+		case VK_INDEX_TYPE_UINT16:
+			return 2;
+		case VK_INDEX_TYPE_UINT32:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @return The range of the index buffer of the full resolution level of detail of a submesh
+ */
+std::pair<uint32_t, uint32_t> get_index_range(const sg::SubMesh &sub_mesh)
+{
+	if (sub_mesh.lods.empty())
+	{
+		return {0, sub_mesh.vertex_indices};
+	}
+
+	return {sub_mesh.lods[0].first_index, sub_mesh.lods[0].index_count};
+}
+
+/**
+ * @return Whether a submesh can be merged into a geometry, which is built from its host visible
+ *         vertex and index data, with each attribute in its own vertex buffer
+ */
+bool is_mergeable(const sg::SubMesh &sub_mesh)
+{
+	uint32_t index_size = get_index_size(sub_mesh.index_type);
+
+	if (sub_mesh.get_material()->alpha_mode == sg::AlphaMode::Blend || sub_mesh.vertex_indices == 0 ||
+	    !sub_mesh.index_buffer || sub_mesh.index_buffer->get_data() == nullptr || index_size == 0 || sub_mesh.vertex_buffers.empty())
+	{
+		return false;
+	}
+
+	auto index_range = get_index_range(sub_mesh);
+
+	if (sub_mesh.index_offset + static_cast<VkDeviceSize>(index_range.first + index_range.second) * index_size > sub_mesh.index_buffer->get_size())
+	{
+		return false;
+	}
+
+	for (auto &vertex_buffer : sub_mesh.vertex_buffers)
+	{
+		sg::VertexAttribute attribute;
+
+		if (vertex_buffer.second.get_data() == nullptr || !sub_mesh.get_attribute(vertex_buffer.first, attribute) || attribute.offset != 0 ||
+		    vertex_buffer.second.get_size() < static_cast<VkDeviceSize>(sub_mesh.vertices_count) * attribute.stride)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+}        // namespace
+
+GpuDrivenSubpass::GpuDrivenSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
+    ForwardSubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera},
+    culling_shader{"gpu_driven_culling.comp"},
+    depth_pyramid_shader{"depth_pyramid.comp"}
+{
+	// Instances select their material in the shaders
+	bindless = true;
+
+	first_phase_variant.add_define("FIRST_PHASE");
+
+	second_phase_variant.add_define("SECOND_PHASE");
+}
+
+void GpuDrivenSubpass::prepare()
+{
+	// Meshes merged by a previous prepare are drawn by the GPU-driven path again
+	meshes = scene.get_components<sg::Mesh>();
+
+	ForwardSubpass::prepare();
+
+	gpu_driven_variants.clear();
+	geometries.clear();
+	batches.clear();
+	instances.clear();
+	instance_nodes.clear();
+	draw_command_buffers.clear();
+	draw_count_buffers.clear();
+	cull_stat_buffers.clear();
+	cull_stats_written.clear();
+	visibility_buffer.reset();
+	first_phase_culled  = false;
+	first_phase_drawn   = false;
+	second_phase_culled = false;
+	second_phase        = false;
+
+	if (!bindless)
+	{
+		LOGW("GPU-driven rendering requires bindless materials, drawing the scene from the CPU");
+		return;
+	}
+
+	auto &device = render_context.get_device();
+
+	const auto &requested_features = device.get_gpu().get_requested_features();
+
+	if (!requested_features.multiDrawIndirect || !requested_features.drawIndirectFirstInstance)
+	{
+		LOGW("GPU-driven rendering requires the multiDrawIndirect and drawIndirectFirstInstance features, drawing the scene from the CPU");
+		return;
+	}
+
+	compact_draws = device.is_enabled(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+	// Vertex and index data of each geometry, gathered before the megabuffers are created
+	struct GeometryData
+	{
+		sg::SubMesh *sub_mesh;
+
+		std::unordered_map<std::string, std::vector<uint8_t>> vertex_data;
+
+		std::vector<uint8_t> index_data;
+
+		uint32_t vertex_count{0};
+
+		uint32_t index_count{0};
+	};
+
+	std::map<GeometryKey, uint32_t> geometry_indices;
+
+	std::vector<GeometryData> geometry_data;
+
+	std::vector<Draw> draws;
+
+	/// Draw and geometry of each merged submesh
+	std::unordered_map<const sg::SubMesh *, std::pair<uint32_t, uint32_t>> draw_indices;
+
+	std::map<std::tuple<uint32_t, bool, VkFrontFace>, uint32_t> batch_indices;
+
+	/// Node, mesh and submesh of the instances of each batch
+	std::vector<std::vector<std::tuple<sg::Node *, sg::Mesh *, sg::SubMesh *>>> batch_instances;
+
+	std::vector<sg::Mesh *> cpu_meshes;
+
+	for (auto &mesh : meshes)
+	{
+		const auto &sub_meshes = mesh->get_submeshes();
+
+		bool mergeable = std::all_of(sub_meshes.begin(), sub_meshes.end(), [](const sg::SubMesh *sub_mesh) { return is_mergeable(*sub_mesh); });
+
+		if (!mergeable || mesh->get_nodes().empty())
+		{
+			cpu_meshes.push_back(mesh);
+			continue;
+		}
+
+		for (auto &sub_mesh : sub_meshes)
+		{
+			auto draw_it = draw_indices.find(sub_mesh);
+
+			if (draw_it == draw_indices.end())
+			{
+				const ShaderVariant &variant = get_gpu_driven_variant(*sub_mesh);
+
+				device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
+				device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+
+				std::map<std::string, std::pair<VkFormat, uint32_t>> vertex_layout;
+
+				for (auto &vertex_buffer : sub_mesh->vertex_buffers)
+				{
+					sg::VertexAttribute attribute;
+					sub_mesh->get_attribute(vertex_buffer.first, attribute);
+
+					vertex_layout.emplace(vertex_buffer.first, std::make_pair(attribute.format, attribute.stride));
+				}
+
+				auto geometry_it = geometry_indices.emplace(std::make_tuple(variant.get_id(), sub_mesh->index_type, vertex_layout), to_u32(geometry_data.size())).first;
+
+				if (geometry_it->second == geometry_data.size())
+				{
+					geometry_data.push_back({sub_mesh, {}, {}, 0, 0});
+				}
+
+				auto &data = geometry_data[geometry_it->second];
+
+				// Submeshes are appended to the megabuffers, their indices stay relative to their first vertex
+				Draw draw{};
+				draw.first_index   = data.index_count;
+				draw.vertex_offset = static_cast<int32_t>(data.vertex_count);
+
+				for (auto &vertex_buffer : sub_mesh->vertex_buffers)
+				{
+					auto &stream = data.vertex_data[vertex_buffer.first];
+
+					const uint8_t *vertices = vertex_buffer.second.get_data();
+					stream.insert(stream.end(), vertices, vertices + sub_mesh->vertices_count * vertex_layout.at(vertex_buffer.first).second);
+				}
+
+				data.vertex_count += sub_mesh->vertices_count;
+
+				// Only the full resolution level of detail is drawn
+				auto     index_range = get_index_range(*sub_mesh);
+				uint32_t index_size  = get_index_size(sub_mesh->index_type);
+
+				const uint8_t *indices = sub_mesh->index_buffer->get_data() + sub_mesh->index_offset + index_range.first * index_size;
+				data.index_data.insert(data.index_data.end(), indices, indices + index_range.second * index_size);
+
+				draw.index_count = index_range.second;
+				data.index_count += index_range.second;
+
+				draw_it = draw_indices.emplace(sub_mesh, std::make_pair(to_u32(draws.size()), geometry_it->second)).first;
+				draws.push_back(draw);
+			}
+
+			for (auto &node : mesh->get_nodes())
+			{
+				// Invert the front face if the mesh was flipped
+				const auto &scale      = node->get_transform().get_scale();
+				bool        flipped    = scale.x * scale.y * scale.z < 0;
+				VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+				bool double_sided = sub_mesh->get_material()->double_sided;
+
+				auto batch_it = batch_indices.emplace(std::make_tuple(draw_it->second.second, double_sided, front_face), to_u32(batches.size())).first;
+
+				if (batch_it->second == batches.size())
+				{
+					batches.push_back({draw_it->second.second, front_face, double_sided, 0, 0});
+					batch_instances.emplace_back();
+				}
+
+				batch_instances[batch_it->second].emplace_back(node, mesh, sub_mesh);
+			}
+		}
+	}
+
+	if (batches.empty())
+	{
+		return;
+	}
+
+	// Geometries are created at once, as their vertex buffers cannot be copied
+	geometries = std::vector<Geometry>(geometry_data.size());
+
+	for (size_t i = 0; i < geometries.size(); ++i)
+	{
+		geometries[i].sub_mesh = geometry_data[i].sub_mesh;
+
+		for (auto &stream : geometry_data[i].vertex_data)
+		{
+			core::Buffer vertex_buffer{device, stream.second.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU};
+			vertex_buffer.update(stream.second);
+
+			geometries[i].vertex_buffers.emplace(stream.first, std::move(vertex_buffer));
+		}
+
+		geometries[i].index_buffer = create_buffer(device, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, geometry_data[i].index_data);
+	}
+
+	// Instances are sorted by batch, so that each batch draws a contiguous range of the indirect buffer
+	std::vector<uint32_t>                     material_indices;
+	std::vector<VkDrawIndexedIndirectCommand> visible_commands;
+
+	for (uint32_t batch_index = 0; batch_index < batches.size(); ++batch_index)
+	{
+		auto &batch = batches[batch_index];
+
+		batch.first_instance = to_u32(instances.size());
+		batch.instance_count = to_u32(batch_instances[batch_index].size());
+
+		for (auto &batch_instance : batch_instances[batch_index])
+		{
+			sg::SubMesh *sub_mesh = std::get<2>(batch_instance);
+
+			Instance instance{};
+			instance.draw_index           = draw_indices.at(sub_mesh).first;
+			instance.batch_index          = batch_index;
+			instance.batch_first_instance = batch.first_instance;
+
+			const Draw &draw = draws[instance.draw_index];
+
+			VkDrawIndexedIndirectCommand command{};
+			command.indexCount    = draw.index_count;
+			command.instanceCount = 1;
+			command.firstIndex    = draw.first_index;
+			command.vertexOffset  = draw.vertex_offset;
+			command.firstInstance = to_u32(instances.size());
+
+			visible_commands.push_back(command);
+			material_indices.push_back(bindless_material_indices.at(sub_mesh->get_material()));
+			instance_nodes.emplace_back(std::get<0>(batch_instance), std::get<1>(batch_instance));
+			instances.push_back(instance);
+		}
+	}
+
+	draw_buffer            = create_buffer(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, to_bytes(draws));
+	material_index_buffer  = create_buffer(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, to_bytes(material_indices));
+	visible_command_buffer = create_buffer(device, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, to_bytes(visible_commands));
+
+	if (occlusion_culling)
+	{
+		// The first frame draws all the instances in the view frustum in its first phase
+		visibility_buffer = create_buffer(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, to_bytes(std::vector<uint32_t>(instances.size(), 1)));
+	}
+
+	update_instances();
+
+	// The merged meshes are no longer drawn one by one
+	meshes = std::move(cpu_meshes);
+}
+
+void GpuDrivenSubpass::update_instances()
+{
+	if (instances.empty())
+	{
+		return;
+	}
+
+	std::vector<glm::mat4> transforms(instances.size());
+
+	for (size_t i = 0; i < instances.size(); ++i)
+	{
+		sg::Node *node = instance_nodes[i].first;
+		sg::Mesh *mesh = instance_nodes[i].second;
+
+		glm::mat4 node_transform = node->get_transform().get_world_matrix();
+
+		// Quantized vertex positions are decoded as part of the model matrix
+		transforms[i] = node_transform * mesh->get_dequantization();
+
+		const sg::AABB &mesh_bounds = mesh->get_bounds();
+
+		sg::AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
+		world_bounds.transform(node_transform);
+
+		instances[i].bounding_sphere = glm::vec4(world_bounds.get_center(), glm::length(world_bounds.get_scale()) * 0.5f);
+	}
+
+	// Frames in flight may still read the previous instances
+	if (instance_buffer)
+	{
+		render_context.defer_destruction(std::move(instance_buffer));
+		render_context.defer_destruction(std::move(transform_buffer));
+	}
+
+	auto &device = render_context.get_device();
+
+	instance_buffer  = create_buffer(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, to_bytes(instances));
+	transform_buffer = create_buffer(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, to_bytes(transforms));
+}
+
+void GpuDrivenSubpass::set_occlusion_culling(bool enabled)
+{
+	occlusion_culling = enabled;
+}
+
+void GpuDrivenSubpass::cull(CommandBuffer &command_buffer)
+{
+	if (batches.empty())
+	{
+		return;
+	}
+
+	auto &device = render_context.get_device();
+
+	uint32_t frame_index = render_context.get_active_frame_index();
+
+	if (frame_index >= draw_command_buffers.size())
+	{
+		draw_command_buffers.resize(frame_index + 1);
+		draw_count_buffers.resize(frame_index + 1);
+		cull_stat_buffers.resize(frame_index + 1);
+		cull_stats_written.resize(frame_index + 1, false);
+	}
+
+	if (!draw_command_buffers[frame_index])
+	{
+		// Each phase of the draws has its own range of commands and counts
+		VkDeviceSize phase_count = occlusion_culling ? 2 : 1;
+
+		draw_command_buffers[frame_index] = std::make_unique<core::Buffer>(device,
+		                                                                   phase_count * instances.size() * sizeof(VkDrawIndexedIndirectCommand),
+		                                                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+		                                                                   VMA_MEMORY_USAGE_GPU_ONLY);
+
+		draw_count_buffers[frame_index] = std::make_unique<core::Buffer>(device,
+		                                                                 phase_count * batches.size() * sizeof(uint32_t),
+		                                                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                                                                 VMA_MEMORY_USAGE_GPU_ONLY);
+
+		cull_stat_buffers[frame_index] = std::make_unique<core::Buffer>(device,
+		                                                                sizeof(uint32_t),
+		                                                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                                                                VMA_MEMORY_USAGE_GPU_TO_CPU);
+	}
+
+	read_cull_stats(frame_index);
+
+	auto &draw_commands = *draw_command_buffers[frame_index];
+	auto &draw_counts   = *draw_count_buffers[frame_index];
+	auto &cull_stats    = *cull_stat_buffers[frame_index];
+
+	// The draw counts of the batches and the culled instance count start at zero
+	command_buffer.update_buffer(draw_counts, 0, std::vector<uint8_t>(draw_counts.get_size(), 0));
+	command_buffer.update_buffer(cull_stats, 0, std::vector<uint8_t>(cull_stats.get_size(), 0));
+
+	BufferMemoryBarrier clear_barrier{};
+	clear_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	clear_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	clear_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	clear_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+	command_buffer.buffer_memory_barrier(draw_counts, 0, draw_counts.get_size(), clear_barrier);
+	command_buffer.buffer_memory_barrier(cull_stats, 0, cull_stats.get_size(), clear_barrier);
+
+	dispatch_culling(command_buffer, occlusion_culling ? first_phase_variant : culling_variant);
+
+	cull_stats_written[frame_index] = true;
+
+	first_phase_culled = true;
+}
+
+void GpuDrivenSubpass::cull_occluded(CommandBuffer &command_buffer, const core::ImageView &depth)
+{
+	// The draw following this one is the second phase, which only draws the instances culled here
+	second_phase = true;
+
+	// The second phase completes the draws of a culled first phase, which skipped the instances hidden in the previous frame
+	if (!first_phase_drawn)
+	{
+		return;
+	}
+
+	first_phase_drawn = false;
+
+	build_depth_pyramid(command_buffer, depth);
+
+	dispatch_culling(command_buffer, second_phase_variant);
+
+	second_phase_culled = true;
+}
+
+void GpuDrivenSubpass::dispatch_culling(CommandBuffer &command_buffer, const ShaderVariant &variant)
+{
+	auto &device = render_context.get_device();
+
+	uint32_t frame_index = render_context.get_active_frame_index();
+
+	auto &draw_commands = *draw_command_buffers[frame_index];
+	auto &draw_counts   = *draw_count_buffers[frame_index];
+	auto &cull_stats    = *cull_stat_buffers[frame_index];
+
+	bool second_phase_culling = &variant == &second_phase_variant;
+
+	// Both phases are culled with the camera of the frame, the depth pyramid was built from the first phase
+	glm::mat4 view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view();
+
+	auto uniform_buffer = render_context.get_active_frame().allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(GpuCullUniform), thread_index);
+	uniform_buffer.update(get_cull_uniform(view_proj));
+
+	auto &resource_cache  = device.get_resource_cache();
+	auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, culling_shader, variant);
+	auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	command_buffer.bind_buffer(uniform_buffer.get_buffer(), uniform_buffer.get_offset(), uniform_buffer.get_size(), 0, 0, 0);
+	command_buffer.bind_buffer(*instance_buffer, 0, instance_buffer->get_size(), 0, 1, 0);
+	command_buffer.bind_buffer(*draw_buffer, 0, draw_buffer->get_size(), 0, 2, 0);
+	command_buffer.bind_buffer(draw_commands, 0, draw_commands.get_size(), 0, 3, 0);
+	command_buffer.bind_buffer(draw_counts, 0, draw_counts.get_size(), 0, 4, 0);
+	command_buffer.bind_buffer(cull_stats, 0, cull_stats.get_size(), 0, 5, 0);
+
+	if (second_phase_culling)
+	{
+		command_buffer.bind_image(*depth_pyramid_view, *depth_pyramid_sampler, 0, 6, 0);
+	}
+
+	if (occlusion_culling)
+	{
+		command_buffer.bind_buffer(*visibility_buffer, 0, visibility_buffer->get_size(), 0, 7, 0);
+	}
+
+	command_buffer.dispatch((to_u32(instances.size()) + instance_group_size - 1) / instance_group_size, 1, 1);
+
+	// Make the draws visible to the indirect draw commands
+	BufferMemoryBarrier barrier{};
+	barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	barrier.dst_stage_mask  = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+	barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dst_access_mask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+	command_buffer.buffer_memory_barrier(draw_commands, 0, draw_commands.get_size(), barrier);
+	command_buffer.buffer_memory_barrier(draw_counts, 0, draw_counts.get_size(), barrier);
+
+	// The stats are read on the CPU once the frame completes
+	BufferMemoryBarrier stats_barrier{};
+	stats_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	stats_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
+	stats_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+	stats_barrier.dst_access_mask = VK_ACCESS_HOST_READ_BIT;
+
+	command_buffer.buffer_memory_barrier(cull_stats, 0, cull_stats.get_size(), stats_barrier);
+
+	if (second_phase_culling)
+	{
+		// The first phase of the next frame reads the visibility of the instances
+		BufferMemoryBarrier visibility_barrier{};
+		visibility_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		visibility_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		visibility_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		visibility_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+		command_buffer.buffer_memory_barrier(*visibility_buffer, 0, visibility_buffer->get_size(), visibility_barrier);
+	}
+}
+
+void GpuDrivenSubpass::read_cull_stats(uint32_t frame_index)
+{
+	// The render frame was waited for before being recorded again
+	if (!cull_stats_written[frame_index])
+	{
+		return;
+	}
+
+	// GPU_TO_CPU memory may be cached and not coherent
+	auto &cull_stats = *cull_stat_buffers[frame_index];
+	cull_stats.invalidate();
+
+	uint32_t culled_count = *reinterpret_cast<const uint32_t *>(cull_stats.get_data());
+
+	render_context.add_frame_stat(StatIndex::culled_objects, static_cast<double>(culled_count));
+
+	cull_stats_written[frame_index] = false;
+}
+
+GpuCullUniform GpuDrivenSubpass::get_cull_uniform(const glm::mat4 &view_proj) const
+{
+	// Instances are culled in world space
+	Frustum frustum;
+	frustum.update(view_proj);
+
+	GpuCullUniform cull_uniform{};
+	std::copy(frustum.get_planes().begin(), frustum.get_planes().end(), cull_uniform.frustum_planes);
+	cull_uniform.depth_pyramid_view_proj = view_proj;
+	cull_uniform.instance_count          = to_u32(instances.size());
+	cull_uniform.batch_count             = to_u32(batches.size());
+	cull_uniform.compact                 = compact_draws ? 1 : 0;
+
+	if (depth_pyramid)
+	{
+		cull_uniform.depth_pyramid_size = glm::vec2(depth_pyramid->get_extent().width, depth_pyramid->get_extent().height);
+	}
+
+	return cull_uniform;
+}
+
+void GpuDrivenSubpass::build_depth_pyramid(CommandBuffer &command_buffer, const core::ImageView &depth)
+{
+	auto &device = render_context.get_device();
+
+	// Each level halves the previous one exactly, from the largest power of two below the depth
+	const VkExtent3D &depth_extent = depth.get_image().get_extent();
+	VkExtent3D        extent{previous_power_of_two(depth_extent.width), previous_power_of_two(depth_extent.height), 1};
+
+	if (!depth_pyramid || depth_pyramid->get_extent().width != extent.width || depth_pyramid->get_extent().height != extent.height)
+	{
+		create_depth_pyramid(extent);
+	}
+
+	ImageMemoryBarrier depth_barrier{};
+	depth_barrier.old_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	depth_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	depth_barrier.src_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	depth_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+	depth_barrier.src_stage_mask  = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	depth_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+	command_buffer.image_memory_barrier(depth, depth_barrier);
+
+	// The whole pyramid is written again, once the culling of the previous frame read it
+	ImageMemoryBarrier write_barrier{};
+	write_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+	write_barrier.new_layout      = VK_IMAGE_LAYOUT_GENERAL;
+	write_barrier.src_access_mask = 0;
+	write_barrier.dst_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+	write_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	write_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+	command_buffer.image_memory_barrier(*depth_pyramid_view, write_barrier);
+
+	auto &resource_cache = device.get_resource_cache();
+
+	{
+		auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, depth_pyramid_shader, depth_pyramid_variant);
+		auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+		command_buffer.bind_pipeline_layout(pipeline_layout);
+
+		for (size_t level = 0; level < depth_pyramid_levels.size(); ++level)
+		{
+			const core::ImageView &source = level == 0 ? depth : depth_pyramid_levels[level - 1];
+
+			command_buffer.bind_image(source, *depth_pyramid_sampler, 0, 0, 0);
+			command_buffer.bind_image(depth_pyramid_levels[level], 0, 1, 0);
+
+			uint32_t level_width  = std::max(1u, extent.width >> level);
+			uint32_t level_height = std::max(1u, extent.height >> level);
+
+			command_buffer.dispatch((level_width + depth_pyramid_group_size - 1) / depth_pyramid_group_size,
+			                        (level_height + depth_pyramid_group_size - 1) / depth_pyramid_group_size,
+			                        1);
+
+			// The next level and the culling sample this one
+			ImageMemoryBarrier read_barrier{};
+			read_barrier.old_layout      = VK_IMAGE_LAYOUT_GENERAL;
+			read_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			read_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+			read_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+			read_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			read_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+			command_buffer.image_memory_barrier(depth_pyramid_levels[level], read_barrier);
+		}
+	}
+
+	// The second render pass tests against the depth again and completes it
+	ImageMemoryBarrier attachment_barrier{};
+	attachment_barrier.old_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	attachment_barrier.new_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	attachment_barrier.src_access_mask = 0;
+	attachment_barrier.dst_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	attachment_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	attachment_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+	command_buffer.image_memory_barrier(depth, attachment_barrier);
+}
+
+void GpuDrivenSubpass::create_depth_pyramid(const VkExtent3D &extent)
+{
+	auto &device = render_context.get_device();
+
+	// Frames in flight may still sample the previous pyramid, its views are released before it
+	if (depth_pyramid)
+	{
+		render_context.defer_destruction(std::move(depth_pyramid_view));
+		render_context.defer_destruction(std::move(depth_pyramid_levels));
+		render_context.defer_destruction(std::move(depth_pyramid));
+
+		depth_pyramid_levels.clear();
+	}
+
+	uint32_t level_count = 1;
+
+	while ((std::max(extent.width, extent.height) >> level_count) != 0)
+	{
+		level_count++;
+	}
+
+	depth_pyramid = std::make_unique<core::Image>(device,
+	                                              extent,
+	                                              VK_FORMAT_R32_SFLOAT,
+	                                              VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+	                                              VMA_MEMORY_USAGE_GPU_ONLY,
+	                                              VK_SAMPLE_COUNT_1_BIT,
+	                                              level_count);
+
+	depth_pyramid_view = std::make_unique<core::ImageView>(*depth_pyramid, VK_IMAGE_VIEW_TYPE_2D);
+
+	depth_pyramid_levels.reserve(level_count);
+
+	for (uint32_t level = 0; level < level_count; ++level)
+	{
+		depth_pyramid_levels.emplace_back(*depth_pyramid, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_UNDEFINED, level, 0, 1, 1);
+	}
+
+	if (!depth_pyramid_sampler)
+	{
+		VkSamplerCreateInfo sampler_create_info{VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+		sampler_create_info.minFilter    = VK_FILTER_NEAREST;
+		sampler_create_info.magFilter    = VK_FILTER_NEAREST;
+		sampler_create_info.mipmapMode   = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		sampler_create_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		sampler_create_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		sampler_create_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		sampler_create_info.maxLod       = VK_LOD_CLAMP_NONE;
+		depth_pyramid_sampler            = std::make_unique<core::Sampler>(device, sampler_create_info);
+	}
+}
+
+void GpuDrivenSubpass::draw(CommandBuffer &command_buffer)
+{
+	// The second phase only draws the instances found visible by cull_occluded()
+	if (second_phase)
+	{
+		second_phase = false;
+
+		if (second_phase_culled)
+		{
+			draw_phase(command_buffer, 1, true);
+
+			// Transparent meshes blend over all the opaque instances
+			GeometrySubpass::draw(command_buffer);
+
+			second_phase_culled = false;
+		}
+
+		return;
+	}
+
+	if (batches.empty())
+	{
+		ForwardSubpass::draw(command_buffer);
+		return;
+	}
+
+	draw_phase(command_buffer, 0, first_phase_culled);
+
+	// A culled first phase is completed by the second phase, which also draws the meshes left to the CPU
+	first_phase_drawn  = occlusion_culling && first_phase_culled;
+	first_phase_culled = false;
+
+	if (!first_phase_drawn)
+	{
+		// Meshes which could not be merged are drawn one by one
+		GeometrySubpass::draw(command_buffer);
+	}
+}
+
+void GpuDrivenSubpass::draw_phase(CommandBuffer &command_buffer, uint32_t phase, bool culled)
+{
+	bind_lights(command_buffer);
+
+	ScopedDebugLabel gpu_driven_debug_label{command_buffer, phase == 0 ? "GPU-driven objects" : "GPU-driven disoccluded objects"};
+
+	// The global uniform only provides the camera, instances read their model matrix and material index
+	update_uniform(command_buffer, *instance_nodes.front().first, thread_index);
+
+	command_buffer.bind_buffer(*transform_buffer, 0, transform_buffer->get_size(), 0, 13, 0);
+	command_buffer.bind_buffer(*material_index_buffer, 0, material_index_buffer->get_size(), 0, 12, 0);
+
+	for (uint32_t batch_index = 0; batch_index < batches.size(); ++batch_index)
+	{
+		draw_batch(command_buffer, batch_index, phase, culled);
+	}
+}
+
+void GpuDrivenSubpass::draw_batch(CommandBuffer &command_buffer, uint32_t batch_index, uint32_t phase, bool culled)
+{
+	const auto &batch    = batches[batch_index];
+	auto       &geometry = geometries[batch.geometry_index];
+
+	auto &device = command_buffer.get_device();
+
+	prepare_pipeline_state(command_buffer, batch.front_face, batch.double_sided);
+
+	const ShaderVariant &variant = get_gpu_driven_variant(*geometry.sub_mesh);
+
+	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
+	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+
+	std::vector<ShaderModule *> shader_modules{&vert_shader_module, &frag_shader_module};
+
+	auto &pipeline_layout = prepare_pipeline_layout(command_buffer, shader_modules);
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	update_bindless_descriptor_set(pipeline_layout);
+
+	command_buffer.bind_descriptor_set(1, bindless_descriptor_set);
+
+	auto vertex_input_resources = pipeline_layout.get_resources(ShaderResourceType::Input, VK_SHADER_STAGE_VERTEX_BIT);
+
+	VertexInputState vertex_input_state;
+
+	for (auto &input_resource : vertex_input_resources)
+	{
+		sg::VertexAttribute attribute;
+
+		if (!geometry.sub_mesh->get_attribute(input_resource.name, attribute))
+		{
+			continue;
+		}
+
+		VkVertexInputAttributeDescription vertex_attribute{};
+		vertex_attribute.binding  = input_resource.location;
+		vertex_attribute.format   = attribute.format;
+		vertex_attribute.location = input_resource.location;
+		vertex_attribute.offset   = 0;
+
+		vertex_input_state.attributes.push_back(vertex_attribute);
+
+		VkVertexInputBindingDescription vertex_binding{};
+		vertex_binding.binding = input_resource.location;
+		vertex_binding.stride  = attribute.stride;
+
+		vertex_input_state.bindings.push_back(vertex_binding);
+	}
+
+	command_buffer.set_vertex_input_state(vertex_input_state);
+
+	for (auto &input_resource : vertex_input_resources)
+	{
+		const auto &buffer_iter = geometry.vertex_buffers.find(input_resource.name);
+
+		if (buffer_iter != geometry.vertex_buffers.end())
+		{
+			std::vector<std::reference_wrapper<const core::Buffer>> buffers;
+			buffers.emplace_back(std::ref(buffer_iter->second));
+
+			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {0});
+		}
+	}
+
+	command_buffer.bind_index_buffer(*geometry.index_buffer, 0, geometry.sub_mesh->index_type);
+
+	// The commands and counts of each phase follow the ones of the previous phase
+	VkDeviceSize offset       = (phase * instances.size() + batch.first_instance) * sizeof(VkDrawIndexedIndirectCommand);
+	VkDeviceSize count_offset = (phase * batches.size() + batch_index) * sizeof(uint32_t);
+	uint32_t     stride       = to_u32(sizeof(VkDrawIndexedIndirectCommand));
+
+	if (!culled)
+	{
+		command_buffer.draw_indexed_indirect(*visible_command_buffer, offset, batch.instance_count, stride);
+	}
+	else if (compact_draws)
+	{
+		uint32_t frame_index = render_context.get_active_frame_index();
+
+		command_buffer.draw_indexed_indirect_count(*draw_command_buffers[frame_index], offset,
+		                                           *draw_count_buffers[frame_index], count_offset,
+		                                           batch.instance_count, stride);
+	}
+	else
+	{
+		command_buffer.draw_indexed_indirect(*draw_command_buffers[render_context.get_active_frame_index()], offset, batch.instance_count, stride);
+	}
+}
+
+const ShaderVariant &GpuDrivenSubpass::get_gpu_driven_variant(const sg::SubMesh &sub_mesh)
+{
+	auto it = gpu_driven_variants.find(&sub_mesh);
+
+	if (it == gpu_driven_variants.end())
+	{
+		ShaderVariant variant = get_instanced_variant(sub_mesh);
+		variant.add_define("GPU_DRIVEN");
+
+		it = gpu_driven_variants.emplace(&sub_mesh, std::move(variant)).first;
+	}
+
+	return it->second;
+}
+}        // namespace vkb
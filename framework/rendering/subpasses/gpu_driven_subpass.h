@@ -0,0 +1,294 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "core/image.h"
+#include "core/image_view.h"
+#include "core/sampler.h"
+#include "rendering/subpasses/forward_subpass.h"
+
+namespace vkb
+{
+/**
+ * @brief Culling parameters, matches the CullUniform of gpu_driven_culling.comp
+ */
+struct alignas(16) GpuCullUniform
+{
+	glm::vec4 frustum_planes[6];
+
+	/// View projection the depth pyramid was rendered with
+	glm::mat4 depth_pyramid_view_proj;
+
+	glm::vec2 depth_pyramid_size;
+
+	uint32_t instance_count;
+
+	uint32_t batch_count;
+
+	/// 1 if the visible draws are compacted and drawn with a count, 0 if culled draws are written with no instances
+	uint32_t compact;
+};
+
+/**
+ * @brief Forward renders the opaque geometry of a Scene with GPU-driven indirect draws. On prepare, the
+ *        submeshes are merged into geometry megabuffers, one per shader variant and vertex layout, and the
+ *        bounds, transforms and bindless material indices of their instances are uploaded once.
+ *
+ *        Each frame, cull() records a compute dispatch culling the instances against the view frustum
+ *        and writing the draws of the visible ones into an indirect buffer. The subpass then records one
+ *        indirect draw per batch of instances sharing a geometry and pipeline state, so that the CPU cost
+ *        of a frame does not depend on the number of objects. If the sample enables VK_KHR_draw_indirect_count,
+ *        the visible draws are compacted and their count written by the GPU, otherwise culled draws are
+ *        written with no instances.
+ *
+ *        With occlusion culling, the frame is drawn in two render passes. cull() writes the draws of the
+ *        instances visible in the previous frame, which the first render pass draws. cull_occluded() then
+ *        builds a depth pyramid from the depth of the first render pass, tests the remaining instances
+ *        against it, and writes the draws of the disoccluded ones, which the second render pass draws on
+ *        top, before the meshes drawn as by ForwardSubpass. The number of culled instances is read back and
+ *        reported as StatIndex::culled_objects, a few frames late.
+ *
+ *        Requires bindless materials and the multiDrawIndirect and drawIndirectFirstInstance features, the
+ *        scene is drawn as by ForwardSubpass without them. Meshes with transparent submeshes, or whose
+ *        vertex data is not host visible, are also drawn as by ForwardSubpass. The shaders must support
+ *        the GPU_DRIVEN variant, as base.vert and pbr.vert do with the BINDLESS fragment shaders.
+ */
+class GpuDrivenSubpass : public ForwardSubpass
+{
+  public:
+	/**
+	 * @brief Constructs a subpass for GPU-driven forward rendering, with bindless materials enabled
+	 * @param render_context Render context
+	 * @param vertex_shader Vertex shader source
+	 * @param fragment_shader Fragment shader source
+	 * @param scene Scene to render on this subpass
+	 * @param camera Camera used to look at the scene
+	 */
+	GpuDrivenSubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Scene &scene, sg::Camera &camera);
+
+	virtual ~GpuDrivenSubpass() = default;
+
+	virtual void prepare() override;
+
+	/**
+	 * @brief Records a compute dispatch culling the instances and writing the indirect draws of the frame,
+	 *        or of its first phase with occlusion culling. Must be recorded outside of a render pass, before
+	 *        the subpass draws. If it is not, all the instances are drawn.
+	 */
+	void cull(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Records the compute dispatches building the depth pyramid from the depth of the first phase, and
+	 *        writing the draws of the instances it does not hide but which the first phase skipped. Must be
+	 *        recorded between the render pass drawing the first phase and the one drawing the second phase.
+	 *        The depth attachment must have been stored in the DEPTH_STENCIL_ATTACHMENT_OPTIMAL layout, with
+	 *        sampled usage, a single sample and a depth only format. It is left in the same layout, for the
+	 *        second render pass to load.
+	 * @param command_buffer Command buffer to record to
+	 * @param depth Depth attachment of the render target the first phase drew to
+	 */
+	void cull_occluded(CommandBuffer &command_buffer, const core::ImageView &depth);
+
+	/**
+	 * @brief Record draw commands, of the second phase if cull_occluded() was recorded since the first one
+	 */
+	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Uploads the transforms and bounds of the instances again, after their nodes moved
+	 */
+	void update_instances();
+
+	/**
+	 * @brief Enables occlusion culling against the depth pyramid built by cull_occluded(),
+	 *        must be called before prepare
+	 */
+	void set_occlusion_culling(bool enabled);
+
+  private:
+	/// Range of a geometry megabuffer drawn for a submesh
+	struct Draw
+	{
+		uint32_t index_count;
+
+		uint32_t first_index;
+
+		int32_t vertex_offset;
+	};
+
+	/// Instance of a submesh, matches the Instance struct of gpu_driven_culling.comp
+	struct alignas(16) Instance
+	{
+		/// World space bounding sphere, center in xyz and radius in w
+		glm::vec4 bounding_sphere;
+
+		uint32_t draw_index;
+
+		uint32_t batch_index;
+
+		uint32_t batch_first_instance;
+	};
+
+	/// Submeshes sharing a shader variant and vertex layout, merged into a vertex buffer per attribute and an index buffer
+	struct Geometry
+	{
+		/// Submesh the shader variant and vertex layout of the geometry are taken from
+		sg::SubMesh *sub_mesh{nullptr};
+
+		std::unordered_map<std::string, core::Buffer> vertex_buffers;
+
+		std::unique_ptr<core::Buffer> index_buffer;
+	};
+
+	/// Instances sharing a geometry and pipeline state, drawn with a single indirect draw
+	struct Batch
+	{
+		uint32_t geometry_index;
+
+		VkFrontFace front_face;
+
+		bool double_sided;
+
+		uint32_t first_instance;
+
+		uint32_t instance_count;
+	};
+
+	/**
+	 * @return The shader variant of a submesh with INSTANCING and GPU_DRIVEN defined
+	 */
+	const ShaderVariant &get_gpu_driven_variant(const sg::SubMesh &sub_mesh);
+
+	/**
+	 * @brief Records the culling dispatch of a shader variant and makes the draws it writes visible to the indirect draws
+	 */
+	void dispatch_culling(CommandBuffer &command_buffer, const ShaderVariant &variant);
+
+	/**
+	 * @brief Records the compute dispatches building the depth pyramid from a depth attachment
+	 */
+	void build_depth_pyramid(CommandBuffer &command_buffer, const core::ImageView &depth);
+
+	/**
+	 * @brief Records the indirect draws of all the batches for a phase of the draws
+	 * @param culled Whether the draws were written by the culling shader, or all the instances are drawn
+	 */
+	void draw_phase(CommandBuffer &command_buffer, uint32_t phase, bool culled);
+
+	/**
+	 * @brief Records the indirect draw of a batch for a phase of the draws
+	 */
+	void draw_batch(CommandBuffer &command_buffer, uint32_t batch_index, uint32_t phase, bool culled);
+
+	/**
+	 * @brief Creates the depth pyramid and a view of each of its levels
+	 */
+	void create_depth_pyramid(const VkExtent3D &extent);
+
+	/**
+	 * @brief Reads back the number of instances culled the last time the active frame was recorded
+	 */
+	void read_cull_stats(uint32_t frame_index);
+
+	/**
+	 * @return The culling parameters of the frame, whose depth pyramid is rendered with the same view projection
+	 */
+	GpuCullUniform get_cull_uniform(const glm::mat4 &view_proj) const;
+
+	ShaderSource culling_shader;
+
+	ShaderVariant culling_variant;
+
+	/// Culling variant writing the draws of the instances visible in the previous frame
+	ShaderVariant first_phase_variant;
+
+	/// Culling variant testing the instances against the depth pyramid of the first phase
+	ShaderVariant second_phase_variant;
+
+	ShaderSource depth_pyramid_shader;
+
+	ShaderVariant depth_pyramid_variant;
+
+	std::unordered_map<const sg::SubMesh *, ShaderVariant> gpu_driven_variants;
+
+	/// Whether the GPU writes the number of visible draws of each batch
+	bool compact_draws{false};
+
+	bool occlusion_culling{false};
+
+	/// Whether cull() wrote the draws of the first phase since it was drawn
+	bool first_phase_culled{false};
+
+	/// Whether the first phase was drawn from culled draws, which the second phase completes
+	bool first_phase_drawn{false};
+
+	/// Whether cull_occluded() wrote the draws of the second phase since it was drawn
+	bool second_phase_culled{false};
+
+	/// Whether the next draw records the second phase
+	bool second_phase{false};
+
+	std::vector<Geometry> geometries;
+
+	std::vector<Batch> batches;
+
+	/// Culling data of each instance, instances are sorted by batch
+	std::vector<Instance> instances;
+
+	/// Node and mesh of each instance
+	std::vector<std::pair<sg::Node *, sg::Mesh *>> instance_nodes;
+
+	std::unique_ptr<core::Buffer> draw_buffer;
+
+	std::unique_ptr<core::Buffer> instance_buffer;
+
+	/// Model matrix of each instance, read by the vertex shader at set 0, binding 13
+	std::unique_ptr<core::Buffer> transform_buffer;
+
+	/// Bindless material index of each instance, read by the vertex shader at set 0, binding 12
+	std::unique_ptr<core::Buffer> material_index_buffer;
+
+	/// Draws of all the instances, used when the frame was not culled
+	std::unique_ptr<core::Buffer> visible_command_buffer;
+
+	/// Indirect draws written by the culling shader for each render frame
+	std::vector<std::unique_ptr<core::Buffer>> draw_command_buffers;
+
+	/// Number of visible draws of each batch, written by the culling shader for each render frame
+	std::vector<std::unique_ptr<core::Buffer>> draw_count_buffers;
+
+	/// Number of culled instances, written by the culling shader for each render frame and read back when it is recorded again
+	std::vector<std::unique_ptr<core::Buffer>> cull_stat_buffers;
+
+	/// Whether the culling shader wrote the stats of each render frame
+	std::vector<bool> cull_stats_written;
+
+	/// Whether each instance was visible in the previous frame
+	std::unique_ptr<core::Buffer> visibility_buffer;
+
+	/// Farthest depth of the area covered by each texel
+	std::unique_ptr<core::Image> depth_pyramid;
+
+	std::unique_ptr<core::ImageView> depth_pyramid_view;
+
+	/// View of each level of the depth pyramid
+	std::vector<core::ImageView> depth_pyramid_levels;
+
+	std::unique_ptr<core::Sampler> depth_pyramid_sampler;
+};
+}        // namespace vkb
@@ -19,6 +19,7 @@
 
 #include "buffer_pool.h"
 #include "rendering/render_context.h"
+#include "rendering/subpasses/shadow_subpass.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/scene.h"
 
@@ -36,6 +37,12 @@ void LightingSubpass::prepare()
 	lighting_variant.add_definitions({"MAX_LIGHT_COUNT " + std::to_string(MAX_DEFERRED_LIGHT_COUNT)});
 
 	lighting_variant.add_definitions(light_type_definitions);
+
+	if (shadow_subpass)
+	{
+		lighting_variant.add_definitions(ShadowSubpass::get_shadow_definitions());
+	}
+
 	// Build all shaders upfront
 	auto &resource_cache = render_context.get_device().get_resource_cache();
 	resource_cache.request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), lighting_variant);
@@ -58,19 +65,24 @@ void LightingSubpass::draw(CommandBuffer &command_buffer)
 	auto &pipeline_layout = resource_cache.request_pipeline_layout(shader_modules);
 	command_buffer.bind_pipeline_layout(pipeline_layout);
 
-	// Get image views of the attachments
-	auto &render_target = get_render_context().get_active_frame().get_render_target();
-	auto &target_views  = render_target.get_views();
-	assert(3 < target_views.size());
+	// Get image views of the attachments, unless the G-buffer views were set
+	auto input_views = gbuffer_views;
+	if (!input_views[0])
+	{
+		auto &target_views = get_render_context().get_active_frame().get_render_target().get_views();
+		assert(3 < target_views.size());
+
+		input_views = {&target_views[1], &target_views[2], &target_views[3]};
+	}
 
 	// Bind depth, albedo, and normal as input attachments
-	auto &depth_view = target_views[1];
+	auto &depth_view = *input_views[0];
 	command_buffer.bind_input(depth_view, 0, 0, 0);
 
-	auto &albedo_view = target_views[2];
+	auto &albedo_view = *input_views[1];
 	command_buffer.bind_input(albedo_view, 0, 1, 0);
 
-	auto &normal_view = target_views[3];
+	auto &normal_view = *input_views[2];
 	command_buffer.bind_input(normal_view, 0, 2, 0);
 
 	// Set cull mode to front as full screen triangle is clock-wise
@@ -82,8 +94,9 @@ void LightingSubpass::draw(CommandBuffer &command_buffer)
 	LightUniform light_uniform;
 
 	// Inverse resolution
-	light_uniform.inv_resolution.x = 1.0f / render_target.get_extent().width;
-	light_uniform.inv_resolution.y = 1.0f / render_target.get_extent().height;
+	auto &extent                   = depth_view.get_image().get_extent();
+	light_uniform.inv_resolution.x = 1.0f / extent.width;
+	light_uniform.inv_resolution.y = 1.0f / extent.height;
 
 	// Inverse view projection
 	light_uniform.inv_view_proj = glm::inverse(vulkan_style_projection(camera.get_projection()) * camera.get_view());
@@ -94,7 +107,22 @@ void LightingSubpass::draw(CommandBuffer &command_buffer)
 	allocation.update(light_uniform);
 	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 3, 0);
 
+	if (shadow_subpass)
+	{
+		shadow_subpass->bind_shadows(command_buffer, 10, 11);
+	}
+
 	// Draw full screen triangle triangle
 	command_buffer.draw(3, 1, 0, 0);
 }
+
+void LightingSubpass::set_shadow_subpass(ShadowSubpass *shadow_subpass_)
+{
+	shadow_subpass = shadow_subpass_;
+}
+
+void LightingSubpass::set_gbuffer_views(const core::ImageView &depth, const core::ImageView &albedo, const core::ImageView &normal)
+{
+	gbuffer_views = {&depth, &albedo, &normal};
+}
 }        // namespace vkb
@@ -29,6 +29,8 @@ VKBP_ENABLE_WARNINGS()
 
 namespace vkb
 {
+class ShadowSubpass;
+
 namespace sg
 {
 class Camera;
@@ -66,12 +68,29 @@ class LightingSubpass : public Subpass
 
 	void draw(CommandBuffer &command_buffer) override;
 
+	/**
+	 * @brief Samples the cascaded shadow maps of a shadow subpass with the SHADOWS shader variant, must be called
+	 *        before prepare. The shadow atlas is bound at set 0, binding 10 and its uniform at binding 11.
+	 */
+	void set_shadow_subpass(ShadowSubpass *shadow_subpass);
+
+	/**
+	 * @brief Reads the G-buffer from the given views instead of the attachments 1, 2 and 3 of the frame
+	 *        render target, for render passes built from other images such as the ones of a render graph
+	 */
+	void set_gbuffer_views(const core::ImageView &depth, const core::ImageView &albedo, const core::ImageView &normal);
+
   private:
 	sg::Camera &camera;
 
 	sg::Scene &scene;
 
 	ShaderVariant lighting_variant;
+
+	ShadowSubpass *shadow_subpass{nullptr};
+
+	/// Depth, albedo and normal views, if not read from the frame render target
+	std::array<const core::ImageView *, 3> gbuffer_views{};
 };
 
 }        // namespace vkb
@@ -0,0 +1,251 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/meshlet_subpass.h"
+
+#include <algorithm>
+
+#include "common/utils.h"
+#include "common/vk_common.h"
+#include "geometry/frustum.h"
+#include "rendering/render_context.h"
+#include "scene_graph/components/camera.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/material.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/pbr_material.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/components/texture.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+namespace
+{
+/// Meshlets tested by a task shader workgroup, matches MESHLET_TASK_GROUP_SIZE in the shaders
+constexpr uint32_t meshlet_task_group_size = 32;
+
+/// Set 0 binding of the MeshletUniform, the meshlet resources follow it so they stay clear of the fragment shader bindings
+constexpr uint32_t meshlet_uniform_binding = 16;
+}        // namespace
+
+MeshletSubpass::MeshletSubpass(RenderContext &render_context, ShaderSource &&task_source, ShaderSource &&mesh_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
+    ForwardSubpass{render_context, std::move(mesh_source), std::move(fragment_source), scene_, camera},
+    task_shader{std::move(task_source)}
+{
+}
+
+void MeshletSubpass::prepare()
+{
+	auto &device = render_context.get_device();
+	for (auto &mesh : meshes)
+	{
+		for (auto &sub_mesh : mesh->get_submeshes())
+		{
+			if (sub_mesh->meshlet_count == 0)
+			{
+				continue;
+			}
+
+			auto &variant = sub_mesh->get_mut_shader_variant();
+
+			variant.add_definitions({"MAX_LIGHT_COUNT " + std::to_string(MAX_FORWARD_LIGHT_COUNT)});
+
+			variant.add_definitions(light_type_definitions);
+
+			auto &task_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_TASK_BIT_EXT, task_shader, variant);
+			auto &mesh_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_MESH_BIT_EXT, get_vertex_shader(), variant);
+			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+		}
+	}
+}
+
+void MeshletSubpass::draw(CommandBuffer &command_buffer)
+{
+	allocate_lights<ForwardLights>(scene.get_components<sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
+	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
+
+	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> opaque_nodes;
+	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> transparent_nodes;
+
+	get_sorted_nodes(opaque_nodes, transparent_nodes);
+
+	// Meshlets are culled in world space, so the frustum planes and camera position are shared by all submeshes
+	Frustum frustum;
+	frustum.update(camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view());
+
+	MeshletUniform meshlet_uniform{};
+	std::copy(frustum.get_planes().begin(), frustum.get_planes().end(), meshlet_uniform.frustum_planes);
+	meshlet_uniform.camera_position = glm::vec4(glm::vec3(glm::inverse(camera.get_view())[3]), cone_culling ? 1.0f : 0.0f);
+
+	// Mesh pipelines have no vertex input
+	command_buffer.set_vertex_input_state({});
+
+	uint64_t triangle_count = 0;
+
+	// Draw opaque objects in front-to-back order
+	{
+		ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
+
+		for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+		{
+			if (node_it->second.second->meshlet_count == 0)
+			{
+				continue;
+			}
+
+			update_uniform(command_buffer, *node_it->second.first, thread_index);
+
+			// Invert the front face if the mesh was flipped
+			const auto &scale      = node_it->second.first->get_transform().get_scale();
+			bool        flipped    = scale.x * scale.y * scale.z < 0;
+			VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+			draw_meshlets(command_buffer, *node_it->second.second, front_face, meshlet_uniform);
+
+			triangle_count += get_triangle_count(*node_it->second.second, 0);
+		}
+	}
+
+	// Enable alpha blending
+	ColorBlendAttachmentState color_blend_attachment{};
+	color_blend_attachment.blend_enable           = VK_TRUE;
+	color_blend_attachment.src_color_blend_factor = VK_BLEND_FACTOR_SRC_ALPHA;
+	color_blend_attachment.dst_color_blend_factor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	color_blend_attachment.src_alpha_blend_factor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+
+	ColorBlendState color_blend_state{};
+	color_blend_state.attachments.resize(get_output_attachments().size());
+	for (auto &it : color_blend_state.attachments)
+	{
+		it = color_blend_attachment;
+	}
+	command_buffer.set_color_blend_state(color_blend_state);
+
+	command_buffer.set_depth_stencil_state(get_depth_stencil_state());
+
+	// Draw transparent objects in back-to-front order, the meshlets of a submesh are not sorted
+	{
+		ScopedDebugLabel transparent_debug_label{command_buffer, "Transparent objects"};
+
+		for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
+		{
+			if (node_it->second.second->meshlet_count == 0)
+			{
+				continue;
+			}
+
+			update_uniform(command_buffer, *node_it->second.first, thread_index);
+
+			draw_meshlets(command_buffer, *node_it->second.second, VK_FRONT_FACE_COUNTER_CLOCKWISE, meshlet_uniform);
+
+			triangle_count += get_triangle_count(*node_it->second.second, 0);
+		}
+	}
+
+	render_context.add_frame_stat(StatIndex::triangles, static_cast<double>(triangle_count));
+}
+
+void MeshletSubpass::draw_meshlets(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face, MeshletUniform meshlet_uniform)
+{
+	auto &device = command_buffer.get_device();
+
+	ScopedDebugLabel submesh_debug_label{command_buffer, sub_mesh.get_name().c_str()};
+
+	prepare_pipeline_state(command_buffer, front_face, sub_mesh.get_material()->double_sided);
+
+	auto &task_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_TASK_BIT_EXT, task_shader, sub_mesh.get_shader_variant());
+	auto &mesh_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_MESH_BIT_EXT, get_vertex_shader(), sub_mesh.get_shader_variant());
+	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), sub_mesh.get_shader_variant());
+
+	std::vector<ShaderModule *> shader_modules{&task_shader_module, &mesh_shader_module, &frag_shader_module};
+
+	auto &pipeline_layout = prepare_pipeline_layout(command_buffer, shader_modules);
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	if (pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
+	{
+		prepare_push_constants(command_buffer, sub_mesh);
+	}
+
+	DescriptorSetLayout &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(0);
+
+	for (auto &texture : sub_mesh.get_material()->textures)
+	{
+		if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
+		{
+			command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
+			                          texture.second->get_sampler()->vk_sampler,
+			                          0, layout_binding->binding, 0);
+		}
+	}
+
+	auto bind_storage_buffer = [&](const std::string &name, const core::Buffer &buffer) {
+		if (auto layout_binding = descriptor_set_layout.get_layout_binding(name))
+		{
+			command_buffer.bind_buffer(buffer, 0, buffer.get_size(), 0, layout_binding->binding, 0);
+		}
+	};
+
+	bind_storage_buffer("Meshlets", *sub_mesh.meshlet_buffer);
+	bind_storage_buffer("MeshletVertices", *sub_mesh.meshlet_vertex_buffer);
+	bind_storage_buffer("MeshletTriangles", *sub_mesh.meshlet_triangle_buffer);
+
+	// The mesh shader fetches the vertex buffers of the submesh as arrays of floats
+	auto bind_vertex_attribute = [&](const std::string &attribute_name, const std::string &buffer_name, uint32_t &stride) {
+		sg::VertexAttribute attribute;
+
+		const auto &buffer_iter = sub_mesh.vertex_buffers.find(attribute_name);
+
+		if (buffer_iter != sub_mesh.vertex_buffers.end() && sub_mesh.get_attribute(attribute_name, attribute))
+		{
+			stride = attribute.stride / static_cast<uint32_t>(sizeof(float));
+
+			bind_storage_buffer(buffer_name, buffer_iter->second);
+		}
+	};
+
+	bind_vertex_attribute("position", "VertexPositions", meshlet_uniform.position_stride);
+	bind_vertex_attribute("normal", "VertexNormals", meshlet_uniform.normal_stride);
+	bind_vertex_attribute("texcoord_0", "VertexTexcoords", meshlet_uniform.texcoord_stride);
+
+	meshlet_uniform.meshlet_count = sub_mesh.meshlet_count;
+
+	// Both faces of double sided materials are visible
+	if (sub_mesh.get_material()->double_sided)
+	{
+		meshlet_uniform.camera_position.w = 0.0f;
+	}
+
+	auto &render_frame = get_render_context().get_active_frame();
+
+	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(MeshletUniform), thread_index);
+
+	allocation.update(meshlet_uniform);
+
+	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, meshlet_uniform_binding, 0);
+
+	command_buffer.draw_mesh_tasks((sub_mesh.meshlet_count + meshlet_task_group_size - 1) / meshlet_task_group_size, 1, 1);
+}
+
+void MeshletSubpass::set_cone_culling(bool enabled)
+{
+	cone_culling = enabled;
+}
+}        // namespace vkb
@@ -0,0 +1,99 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "rendering/subpasses/forward_subpass.h"
+
+namespace vkb
+{
+/**
+ * @brief Meshlet culling parameters, matches the MeshletUniform of the meshlet shaders
+ */
+struct alignas(16) MeshletUniform
+{
+	glm::vec4 frustum_planes[6];
+
+	/// Camera position in xyz, w is 1 if meshlets facing away from the camera can be culled
+	glm::vec4 camera_position;
+
+	uint32_t meshlet_count;
+
+	/// Strides of the vertex attributes, in floats
+	uint32_t position_stride;
+
+	uint32_t normal_stride;
+
+	uint32_t texcoord_stride;
+};
+
+/**
+ * @brief Forward renders a Scene with task and mesh shaders. The task shader culls the meshlets
+ *        of each submesh against the view frustum and their normal cones, the mesh shader then
+ *        fetches the vertices of the visible meshlets from storage buffers.
+ *
+ *        The scene must be loaded with GLTFLoaderOptions::generate_meshlets, submeshes without
+ *        meshlets are skipped. The sample must enable the taskShader and meshShader features of
+ *        VK_EXT_mesh_shader, and compile shaders for SPIR-V 1.4 or later.
+ *
+ *        The mesh shader outputs the varyings of base.vert, so base.frag and pbr.frag are the
+ *        supported fragment shaders, without the BINDLESS and GPU_DRIVEN variants. Meshlet
+ *        resources use set 0 bindings 16 to 22, which fragment shaders must leave free.
+ */
+class MeshletSubpass : public ForwardSubpass
+{
+  public:
+	/**
+	 * @brief Constructs a subpass rendering meshlets
+	 * @param render_context Render context
+	 * @param task_shader Task shader source, culling meshlets
+	 * @param mesh_shader Mesh shader source, used in place of the vertex shader
+	 * @param fragment_shader Fragment shader source
+	 * @param scene Scene to render on this subpass
+	 * @param camera Camera used to look at the scene
+	 */
+	MeshletSubpass(RenderContext &render_context, ShaderSource &&task_shader, ShaderSource &&mesh_shader, ShaderSource &&fragment_shader, sg::Scene &scene, sg::Camera &camera);
+
+	virtual ~MeshletSubpass() = default;
+
+	virtual void prepare() override;
+
+	/**
+	 * @brief Record draw commands
+	 */
+	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Enables or disables culling of meshlets facing away from the camera
+	 */
+	void set_cone_culling(bool enabled);
+
+  protected:
+	/**
+	 * @brief Records the task and mesh shader dispatch of a submesh
+	 * @param command_buffer Command buffer to record to
+	 * @param sub_mesh The submesh, with meshlets
+	 * @param front_face Front face of the submesh triangles
+	 * @param meshlet_uniform Culling parameters shared by all submeshes of the frame
+	 */
+	void draw_meshlets(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face, MeshletUniform meshlet_uniform);
+
+	ShaderSource task_shader;
+
+	bool cone_culling{true};
+};
+}        // namespace vkb
@@ -0,0 +1,457 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/shadow_subpass.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/utils.h"
+#include "common/vk_common.h"
+#include "rendering/render_context.h"
+#include "scene_graph/components/light.h"
+#include "scene_graph/components/material.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/perspective_camera.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+namespace
+{
+sg::PerspectiveCamera &get_perspective_camera(sg::Camera &camera)
+{
+	auto perspective_camera = dynamic_cast<sg::PerspectiveCamera *>(&camera);
+
+	if (!perspective_camera)
+	{
+		throw std::runtime_error("Cascaded shadow maps require a perspective camera");
+	}
+
+	return *perspective_camera;
+}
+}        // namespace
+
+ShadowSubpass::ShadowSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera, sg::Light &light, uint32_t cascade_count, uint32_t atlas_size) :
+    GeometrySubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera},
+    perspective_camera{get_perspective_camera(camera)},
+    light{light},
+    atlas_size{atlas_size},
+    cascades(std::min<uint32_t>(std::max<uint32_t>(cascade_count, 1), MAX_SHADOW_CASCADES)),
+    thread_pool{static_cast<int>(cascades.size())}
+{
+	if (light.get_light_type() != sg::LightType::Directional)
+	{
+		throw std::runtime_error("Cascaded shadow maps require a directional light");
+	}
+}
+
+void ShadowSubpass::prepare()
+{
+	GeometrySubpass::prepare();
+
+	// Sampled with depth comparison, reversed depth is closer to 1 for the occluders nearest to the light
+	// Fragments outside of the atlas are left lit by the opaque white border
+	VkSamplerCreateInfo sampler_create_info{VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+	sampler_create_info.minFilter     = VK_FILTER_LINEAR;
+	sampler_create_info.magFilter     = VK_FILTER_LINEAR;
+	sampler_create_info.addressModeU  = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+	sampler_create_info.addressModeV  = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+	sampler_create_info.addressModeW  = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+	sampler_create_info.borderColor   = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+	sampler_create_info.compareEnable = VK_TRUE;
+	sampler_create_info.compareOp     = VK_COMPARE_OP_GREATER_OR_EQUAL;
+	shadowmap_sampler                 = std::make_unique<core::Sampler>(render_context.get_device(), sampler_create_info);
+}
+
+void ShadowSubpass::draw(CommandBuffer &command_buffer)
+{
+	update_cascades();
+
+	uint64_t triangle_count = 0;
+
+	for (auto &cascade : cascades)
+	{
+		triangle_count += draw_cascade(command_buffer, cascade, thread_index);
+	}
+
+	render_context.add_frame_stat(StatIndex::triangles, static_cast<double>(triangle_count));
+}
+
+std::vector<CommandBuffer *> ShadowSubpass::record_cascades(const RenderPass &render_pass, const Framebuffer &framebuffer)
+{
+	update_cascades();
+
+	auto &render_frame = render_context.get_active_frame();
+	auto &queue        = render_context.get_device().get_suitable_graphics_queue();
+
+	// Each thread records every n-th cascade, with the resource pools of its own thread index
+	size_t thread_count = std::min(cascades.size(), render_context.get_thread_count());
+
+	std::vector<CommandBuffer *>   command_buffers;
+	std::vector<std::future<void>> futures;
+
+	for (size_t i = 0; i < thread_count; ++i)
+	{
+		auto &command_buffer = render_frame.request_command_buffer(queue, CommandBuffer::ResetMode::ResetPool, VK_COMMAND_BUFFER_LEVEL_SECONDARY, i);
+		command_buffers.push_back(&command_buffer);
+
+		futures.push_back(thread_pool.push(
+		    [this, &command_buffer, &render_pass, &framebuffer, i, thread_count](size_t) {
+			    command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &render_pass, &framebuffer, 0);
+
+			    uint64_t triangle_count = 0;
+
+			    for (size_t cascade_index = i; cascade_index < cascades.size(); cascade_index += thread_count)
+			    {
+				    triangle_count += draw_cascade(command_buffer, cascades[cascade_index], i);
+			    }
+
+			    command_buffer.end();
+
+			    render_context.add_frame_stat(StatIndex::triangles, static_cast<double>(triangle_count));
+		    }));
+	}
+
+	for (auto &future : futures)
+	{
+		future.get();
+	}
+
+	return command_buffers;
+}
+
+void ShadowSubpass::set_split_lambda(float lambda)
+{
+	split_lambda = glm::clamp(lambda, 0.0f, 1.0f);
+}
+
+void ShadowSubpass::set_shadow_distance(float distance)
+{
+	shadow_distance = distance;
+}
+
+RenderTarget &ShadowSubpass::get_render_target()
+{
+	auto frame_index = render_context.get_active_frame_index();
+
+	if (atlases.size() <= frame_index)
+	{
+		atlases.resize(render_context.get_render_frames().size());
+	}
+
+	auto &atlas = atlases[frame_index];
+
+	if (!atlas)
+	{
+		auto &device = render_context.get_device();
+
+		core::Image depth_image{device,
+		                        VkExtent3D{atlas_size, atlas_size, 1},
+		                        get_suitable_depth_format(device.get_gpu().get_handle()),
+		                        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		                        VMA_MEMORY_USAGE_GPU_ONLY};
+
+		std::vector<core::Image> images;
+		images.push_back(std::move(depth_image));
+
+		atlas = std::make_unique<RenderTarget>(std::move(images));
+	}
+
+	return *atlas;
+}
+
+void ShadowSubpass::record_atlas_write_barrier(CommandBuffer &command_buffer)
+{
+	ImageMemoryBarrier memory_barrier{};
+	memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+	memory_barrier.new_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	memory_barrier.src_access_mask = 0;
+	memory_barrier.dst_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+	command_buffer.image_memory_barrier(get_render_target().get_views()[0], memory_barrier);
+}
+
+void ShadowSubpass::record_atlas_read_barrier(CommandBuffer &command_buffer)
+{
+	ImageMemoryBarrier memory_barrier{};
+	memory_barrier.old_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	memory_barrier.src_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+	memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+	command_buffer.image_memory_barrier(get_render_target().get_views()[0], memory_barrier);
+}
+
+void ShadowSubpass::bind_shadows(CommandBuffer &command_buffer, uint32_t atlas_binding, uint32_t uniform_binding)
+{
+	command_buffer.bind_image(get_render_target().get_views()[0], *shadowmap_sampler, 0, atlas_binding, 0);
+
+	auto &render_frame = render_context.get_active_frame();
+
+	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(CascadedShadowUniform));
+	allocation.update(shadow_uniform);
+
+	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, uniform_binding, 0);
+}
+
+std::vector<std::string> ShadowSubpass::get_shadow_definitions()
+{
+	return {"SHADOWS", "MAX_SHADOW_CASCADES " + std::to_string(MAX_SHADOW_CASCADES)};
+}
+
+void ShadowSubpass::prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material)
+{
+	// Depth bias pushes the casters away from the light, taking their slope into account,
+	// so that surfaces do not shadow themselves when compared against the atlas
+	RasterizationState rasterization_state{};
+	rasterization_state.front_face        = front_face;
+	rasterization_state.depth_bias_enable = VK_TRUE;
+
+	if (double_sided_material)
+	{
+		rasterization_state.cull_mode = VK_CULL_MODE_NONE;
+	}
+
+	command_buffer.set_rasterization_state(rasterization_state);
+	command_buffer.set_depth_bias(-1.4f, 0.0f, -1.7f);
+}
+
+PipelineLayout &ShadowSubpass::prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules)
+{
+	// Only the vertex shader is needed to render depth
+	assert(!shader_modules.empty());
+
+	return command_buffer.get_device().get_resource_cache().request_pipeline_layout({shader_modules[0]});
+}
+
+void ShadowSubpass::prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
+{
+	// No push constants are used in the shadow pass
+}
+
+void ShadowSubpass::update_cascades()
+{
+	uint32_t cascade_count = to_u32(cascades.size());
+
+	// Reversed depth cameras swap their planes
+	float z_near = std::min(perspective_camera.get_near_plane(), perspective_camera.get_far_plane());
+	float z_far  = std::min(std::max(perspective_camera.get_near_plane(), perspective_camera.get_far_plane()), shadow_distance);
+
+	float tan_half_fov = std::tan(perspective_camera.get_field_of_view() * 0.5f);
+	float aspect_ratio = perspective_camera.get_aspect_ratio();
+
+	glm::mat4 camera_view         = camera.get_view();
+	glm::mat4 inverse_camera_view = glm::inverse(camera_view);
+
+	// Cascades share the orientation of the light and only differ by their bounds
+	auto     &light_transform = light.get_node()->get_transform();
+	glm::vec3 direction       = glm::normalize(light_transform.get_rotation() * light.get_properties().direction);
+	glm::vec3 up              = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::mat4 light_view      = glm::lookAt(glm::vec3(0.0f), direction, up);
+
+	// Light space bounds of the opaque submeshes, casters in front of a cascade still shadow it
+	std::vector<std::pair<std::pair<sg::Node *, sg::SubMesh *>, sg::AABB>> casters;
+
+	float casters_max_z = std::numeric_limits<float>::lowest();
+
+	for (auto &mesh : meshes)
+	{
+		for (auto &node : mesh->get_nodes())
+		{
+			glm::mat4 node_light_transform = light_view * node->get_transform().get_world_matrix();
+
+			const sg::AABB &mesh_bounds = mesh->get_bounds();
+
+			sg::AABB light_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
+			light_bounds.transform(node_light_transform);
+
+			for (auto &sub_mesh : mesh->get_submeshes())
+			{
+				// Casters are drawn without a fragment shader, so alpha masked submeshes would cast the shadow
+				// of their whole quads rather than of their cutouts. They are left out, as blended ones are.
+				if (sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Opaque)
+				{
+					casters.emplace_back(std::make_pair(node, sub_mesh), light_bounds);
+					casters_max_z = std::max(casters_max_z, light_bounds.get_max().z);
+				}
+			}
+		}
+	}
+
+	uint32_t tiles_per_row = cascade_count > 1 ? 2 : 1;
+	uint32_t tile_size     = atlas_size / tiles_per_row;
+	float    tile_scale    = static_cast<float>(tile_size) / static_cast<float>(atlas_size);
+
+	float split_near = z_near;
+
+	for (uint32_t i = 0; i < cascade_count; ++i)
+	{
+		auto &cascade = cascades[i];
+
+		// Blend of the logarithmic and uniform split schemes
+		float ratio           = static_cast<float>(i + 1) / static_cast<float>(cascade_count);
+		float log_split       = z_near * std::pow(z_far / z_near, ratio);
+		float uniform_split   = z_near + (z_far - z_near) * ratio;
+		float split_far       = split_lambda * log_split + (1.0f - split_lambda) * uniform_split;
+		float far_half_height = split_far * tan_half_fov;
+
+		// The bounding sphere of the frustum slice does not change as the camera turns, which keeps the
+		// size of the texels constant. Its center lies on the view axis, equidistant from the near and far corners.
+		float near_half_diagonal = split_near * tan_half_fov * std::sqrt(1.0f + aspect_ratio * aspect_ratio);
+		float far_half_diagonal  = far_half_height * std::sqrt(1.0f + aspect_ratio * aspect_ratio);
+		float diagonal_offset    = (far_half_diagonal * far_half_diagonal - near_half_diagonal * near_half_diagonal) / (2.0f * (split_far - split_near));
+		float center_depth       = std::min((split_near + split_far) * 0.5f + diagonal_offset, split_far);
+
+		float radius = std::sqrt(far_half_diagonal * far_half_diagonal + (split_far - center_depth) * (split_far - center_depth));
+		radius       = std::max(radius, std::sqrt(near_half_diagonal * near_half_diagonal + (center_depth - split_near) * (center_depth - split_near)));
+		radius       = std::ceil(radius * 16.0f) / 16.0f;
+
+		glm::vec3 center = glm::vec3(light_view * inverse_camera_view * glm::vec4(0.0f, 0.0f, -center_depth, 1.0f));
+
+		// Move the cascade by whole texels, so that the rasterization of the casters does not change
+		float texel_size = 2.0f * radius / static_cast<float>(tile_size);
+		center.x         = std::floor(center.x / texel_size) * texel_size;
+		center.y         = std::floor(center.y / texel_size) * texel_size;
+
+		glm::vec3 bounds_min = center - glm::vec3(radius);
+		glm::vec3 bounds_max = center + glm::vec3(radius);
+		bounds_max.z         = std::max(bounds_max.z, casters_max_z);
+
+		// Light space looks down -z, reversed depth keeps the closest casters at 1
+		glm::mat4 projection = glm::ortho(bounds_min.x, bounds_max.x, bounds_min.y, bounds_max.y, -bounds_min.z, -bounds_max.z);
+
+		cascade.view_proj = vulkan_style_projection(projection) * light_view;
+
+		cascade.tile.offset = {static_cast<int32_t>((i % tiles_per_row) * tile_size), static_cast<int32_t>((i / tiles_per_row) * tile_size)};
+		cascade.tile.extent = {tile_size, tile_size};
+
+		glm::vec2 atlas_offset = glm::vec2(cascade.tile.offset.x, cascade.tile.offset.y) / static_cast<float>(atlas_size);
+
+		// Maps the clip space of the cascade to its tile of the atlas
+		glm::mat4 atlas_transform{1.0f};
+		atlas_transform[0][0] = 0.5f * tile_scale;
+		atlas_transform[1][1] = 0.5f * tile_scale;
+		atlas_transform[3][0] = 0.5f * tile_scale + atlas_offset.x;
+		atlas_transform[3][1] = 0.5f * tile_scale + atlas_offset.y;
+
+		shadow_uniform.light_matrices[i] = atlas_transform * cascade.view_proj;
+		shadow_uniform.atlas_rects[i]    = glm::vec4(atlas_offset, atlas_offset + tile_scale);
+		shadow_uniform.cascade_splits[i] = split_far;
+
+		cascade.casters.clear();
+
+		for (auto &caster : casters)
+		{
+			const auto &caster_min = caster.second.get_min();
+			const auto &caster_max = caster.second.get_max();
+
+			if (caster_max.x >= bounds_min.x && caster_min.x <= bounds_max.x &&
+			    caster_max.y >= bounds_min.y && caster_min.y <= bounds_max.y &&
+			    caster_max.z >= bounds_min.z)
+			{
+				cascade.casters.push_back(caster.first);
+			}
+		}
+
+		split_near = split_far;
+	}
+
+	shadow_uniform.camera_view   = camera_view;
+	shadow_uniform.cascade_count = cascade_count;
+
+	// Lights are bound in the order of the scene, only counting lights of the same type
+	shadow_uniform.light_index = 0;
+
+	for (auto scene_light : scene.get_components<sg::Light>())
+	{
+		if (scene_light == &light)
+		{
+			break;
+		}
+
+		if (scene_light->get_light_type() == sg::LightType::Directional)
+		{
+			shadow_uniform.light_index++;
+		}
+	}
+}
+
+uint64_t ShadowSubpass::draw_cascade(CommandBuffer &command_buffer, const Cascade &cascade, size_t thread_index)
+{
+	ScopedDebugLabel cascade_debug_label{command_buffer, "Shadow cascade"};
+
+	VkViewport viewport{};
+	viewport.x        = static_cast<float>(cascade.tile.offset.x);
+	viewport.y        = static_cast<float>(cascade.tile.offset.y);
+	viewport.width    = static_cast<float>(cascade.tile.extent.width);
+	viewport.height   = static_cast<float>(cascade.tile.extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	command_buffer.set_viewport(0, {viewport});
+
+	command_buffer.set_scissor(0, {cascade.tile});
+
+	uint64_t triangle_count = 0;
+
+	for (auto &caster : cascade.casters)
+	{
+		update_cascade_uniform(command_buffer, *caster.first, cascade, thread_index);
+
+		// Invert the front face if the mesh was flipped
+		const auto &scale      = caster.first->get_transform().get_scale();
+		bool        flipped    = scale.x * scale.y * scale.z < 0;
+		VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+		draw_submesh(command_buffer, *caster.second, front_face);
+
+		triangle_count += get_triangle_count(*caster.second, 0);
+	}
+
+	return triangle_count;
+}
+
+void ShadowSubpass::update_cascade_uniform(CommandBuffer &command_buffer, sg::Node &node, const Cascade &cascade, size_t thread_index)
+{
+	GlobalUniform global_uniform;
+
+	global_uniform.camera_view_proj = cascade.view_proj;
+
+	global_uniform.model = node.get_transform().get_world_matrix();
+
+	// Quantized vertex positions are decoded as part of the model matrix
+	if (node.has_component<sg::Mesh>())
+	{
+		global_uniform.model = global_uniform.model * node.get_component<sg::Mesh>().get_dequantization();
+	}
+
+	global_uniform.camera_position = glm::vec3(glm::inverse(camera.get_view())[3]);
+
+	auto &render_frame = render_context.get_active_frame();
+
+	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(GlobalUniform), thread_index);
+	allocation.update(global_uniform);
+
+	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 1, 0);
+}
+}        // namespace vkb
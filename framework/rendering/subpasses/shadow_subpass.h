@@ -0,0 +1,205 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <limits>
+
+#include <ctpl_stl.h>
+
+#include "core/sampler.h"
+#include "rendering/render_target.h"
+#include "rendering/subpasses/geometry_subpass.h"
+
+// Maximum number of cascades, they are packed in a 2x2 grid of the shadow atlas
+#define MAX_SHADOW_CASCADES 4
+
+namespace vkb
+{
+namespace sg
+{
+class Light;
+class PerspectiveCamera;
+}        // namespace sg
+
+/**
+ * @brief Shadow uniform structure of the SHADOWS shader variant, matches the ShadowUniform of cascaded_shadows.h
+ */
+struct alignas(16) CascadedShadowUniform
+{
+	/// View matrix of the camera, cascades are selected by the view depth of the fragments
+	glm::mat4 camera_view;
+
+	/// Transforms world positions to the atlas coordinates and depth of each cascade
+	glm::mat4 light_matrices[MAX_SHADOW_CASCADES];
+
+	/// Atlas coordinates of the tile of each cascade, as (min.x, min.y, max.x, max.y)
+	glm::vec4 atlas_rects[MAX_SHADOW_CASCADES];
+
+	/// Far view depth of each cascade
+	glm::vec4 cascade_splits;
+
+	uint32_t cascade_count;
+
+	/// Index of the shadowed light among the directional lights of the scene
+	uint32_t light_index;
+};
+
+/**
+ * @brief Renders the cascaded shadow maps of a directional light. The view frustum of the camera is split
+ *        into cascades, each rendered with its own orthographic projection into a tile of a depth atlas.
+ *
+ *        Cascades are fitted to the bounding sphere of their frustum slice and snapped to the texels of
+ *        their tile, so that shadow edges do not shimmer as the camera moves or turns. Shadow casters are
+ *        culled against each cascade. Only opaque submeshes cast shadows: casters are drawn without alpha
+ *        testing, so alpha masked and blended submeshes are left out.
+ *
+ *        The subpass draws all the cascades when its render pipeline draws. They can also be recorded in
+ *        parallel with record_cascades(), and executed in a render pass begun with secondary command buffer
+ *        contents. Subpasses bind the atlas with bind_shadows() and sample it with the SHADOWS variant of
+ *        their shaders, as ForwardSubpass and LightingSubpass do.
+ */
+class ShadowSubpass : public GeometrySubpass
+{
+  public:
+	/**
+	 * @brief Constructs a subpass rendering cascaded shadow maps
+	 * @param render_context Render context
+	 * @param vertex_shader Vertex shader source, which only needs the vertex positions and the GlobalUniform
+	 * @param fragment_shader Fragment shader source
+	 * @param scene Scene casting the shadows
+	 * @param camera Perspective camera the cascades are fitted to
+	 * @param light Directional light casting the shadows
+	 * @param cascade_count Number of cascades, at most MAX_SHADOW_CASCADES
+	 * @param atlas_size Width and height of the shadow atlas, in texels
+	 */
+	ShadowSubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Scene &scene, sg::Camera &camera, sg::Light &light, uint32_t cascade_count = MAX_SHADOW_CASCADES, uint32_t atlas_size = 4096);
+
+	virtual ~ShadowSubpass() = default;
+
+	virtual void prepare() override;
+
+	/**
+	 * @brief Record draw commands for all the cascades
+	 */
+	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Records the cascades in parallel into secondary command buffers, one per recording thread.
+	 *        The render context must have been prepared with as many threads as cascades for all of them
+	 *        to be recorded concurrently.
+	 * @param render_pass Render pass the secondary command buffers are executed in
+	 * @param framebuffer Framebuffer of the shadow atlas of the active frame
+	 * @return The secondary command buffers to execute
+	 */
+	std::vector<CommandBuffer *> record_cascades(const RenderPass &render_pass, const Framebuffer &framebuffer);
+
+	/**
+	 * @brief Sets how the cascade splits are distributed, from uniform (0) to logarithmic (1)
+	 */
+	void set_split_lambda(float lambda);
+
+	/**
+	 * @brief Sets the view distance shadows are rendered to, clamped to the far plane of the camera
+	 */
+	void set_shadow_distance(float distance);
+
+	/**
+	 * @return The shadow atlas the active frame renders to
+	 */
+	RenderTarget &get_render_target();
+
+	/**
+	 * @brief Transitions the shadow atlas of the active frame to be rendered to,
+	 *        must be recorded before its render pass begins
+	 */
+	void record_atlas_write_barrier(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Transitions the shadow atlas of the active frame to be sampled by fragment shaders,
+	 *        must be recorded after its render pass ends
+	 */
+	void record_atlas_read_barrier(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Binds the shadow atlas of the active frame and the shadow uniform of the cascades it was rendered with
+	 * @param command_buffer Command buffer to bind to
+	 * @param atlas_binding Binding of the shadow atlas in set 0
+	 * @param uniform_binding Binding of the shadow uniform in set 0
+	 */
+	void bind_shadows(CommandBuffer &command_buffer, uint32_t atlas_binding, uint32_t uniform_binding);
+
+	/**
+	 * @return The shader definitions enabling the SHADOWS variant
+	 */
+	static std::vector<std::string> get_shadow_definitions();
+
+  protected:
+	virtual void prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material) override;
+
+	virtual PipelineLayout &prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules) override;
+
+	virtual void prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh) override;
+
+  private:
+	struct Cascade
+	{
+		glm::mat4 view_proj;
+
+		/// Tile of the atlas the cascade renders to
+		VkRect2D tile;
+
+		/// Opaque submeshes casting shadows in the cascade
+		std::vector<std::pair<sg::Node *, sg::SubMesh *>> casters;
+	};
+
+	/**
+	 * @brief Fits the cascades to the camera and culls their shadow casters
+	 */
+	void update_cascades();
+
+	/**
+	 * @brief Draws the shadow casters of a cascade into its tile
+	 * @return The number of triangles drawn
+	 */
+	uint64_t draw_cascade(CommandBuffer &command_buffer, const Cascade &cascade, size_t thread_index);
+
+	void update_cascade_uniform(CommandBuffer &command_buffer, sg::Node &node, const Cascade &cascade, size_t thread_index);
+
+	sg::PerspectiveCamera &perspective_camera;
+
+	sg::Light &light;
+
+	uint32_t atlas_size;
+
+	float split_lambda{0.75f};
+
+	float shadow_distance{std::numeric_limits<float>::max()};
+
+	std::vector<Cascade> cascades;
+
+	CascadedShadowUniform shadow_uniform{};
+
+	/// Shadow atlas of each render frame
+	std::vector<std::unique_ptr<RenderTarget>> atlases;
+
+	std::unique_ptr<core::Sampler> shadowmap_sampler;
+
+	ctpl::thread_pool thread_pool;
+};
+
+}        // namespace vkb
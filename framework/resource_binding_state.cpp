@@ -17,124 +17,252 @@
 
 #include "resource_binding_state.h"
 
+#include "common/helpers.h"
+
 namespace vkb
 {
 void ResourceBindingState::reset()
 {
-	clear_dirty();
+	for (uint32_t set = 0; set < max_resource_sets; ++set)
+	{
+		if (bound_sets & (1u << set))
+		{
+			resource_sets[set].reset();
+		}
+	}
 
-	resource_sets.clear();
+	dirty_sets = 0;
+	bound_sets = 0;
 }
 
 bool ResourceBindingState::is_dirty()
 {
-	return dirty;
+	return dirty_sets != 0;
 }
 
 void ResourceBindingState::clear_dirty()
 {
-	dirty = false;
+	for (uint32_t set = 0; set < max_resource_sets; ++set)
+	{
+		if (dirty_sets & (1u << set))
+		{
+			resource_sets[set].clear_dirty();
+		}
+	}
+
+	dirty_sets = 0;
 }
 
 void ResourceBindingState::clear_dirty(uint32_t set)
 {
+	assert(set < max_resource_sets && "Resource set index is out of bounds");
+
 	resource_sets[set].clear_dirty();
+
+	dirty_sets &= ~(1u << set);
 }
 
 void ResourceBindingState::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_buffer(buffer, offset, range, binding, array_element);
-
-	dirty = true;
+	get_resource_set_for_binding(set).bind_buffer(buffer, offset, range, binding, array_element);
 }
 
 void ResourceBindingState::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_image(image_view, sampler, binding, array_element);
-
-	dirty = true;
+	get_resource_set_for_binding(set).bind_image(image_view, sampler, binding, array_element);
 }
 
 void ResourceBindingState::bind_image(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_image(image_view, binding, array_element);
-
-	dirty = true;
+	get_resource_set_for_binding(set).bind_image(image_view, binding, array_element);
 }
 
 void ResourceBindingState::bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_input(image_view, binding, array_element);
+	get_resource_set_for_binding(set).bind_input(image_view, binding, array_element);
+}
 
-	dirty = true;
+uint32_t ResourceBindingState::get_dirty_sets() const
+{
+	return dirty_sets;
 }
 
-const std::unordered_map<uint32_t, ResourceSet> &ResourceBindingState::get_resource_sets()
+uint32_t ResourceBindingState::get_bound_sets() const
 {
-	return resource_sets;
+	return bound_sets;
+}
+
+const ResourceSet &ResourceBindingState::get_resource_set(uint32_t set) const
+{
+	assert(set < max_resource_sets && "Resource set index is out of bounds");
+
+	return resource_sets[set];
+}
+
+ResourceSet &ResourceBindingState::get_resource_set_for_binding(uint32_t set)
+{
+	if (set >= max_resource_sets)
+	{
+		throw std::runtime_error("Resource set " + std::to_string(set) + " is out of bounds, at most " + std::to_string(max_resource_sets) + " sets are supported");
+	}
+
+	dirty_sets |= 1u << set;
+	bound_sets |= 1u << set;
+
+	return resource_sets[set];
 }
 
 void ResourceSet::reset()
 {
-	clear_dirty();
+	for (uint32_t binding = 0; binding < max_resource_bindings; ++binding)
+	{
+		if (bound_bindings & (1u << binding))
+		{
+			for (auto &resource : resources[binding])
+			{
+				resource = {};
+			}
 
-	resource_bindings.clear();
+			bound_array_elements[binding] = 0;
+		}
+	}
+
+	dirty_bindings = 0;
+	bound_bindings = 0;
 }
 
 bool ResourceSet::is_dirty() const
 {
-	return dirty;
+	return dirty_bindings != 0;
 }
 
 void ResourceSet::clear_dirty()
 {
-	dirty = false;
+	dirty_bindings = 0;
 }
 
 void ResourceSet::clear_dirty(uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty = false;
+	assert(binding < max_resource_bindings && array_element < max_resource_array_elements && "Resource binding is out of bounds");
+
+	resources[binding][array_element].dirty = false;
 }
 
 void ResourceSet::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty  = true;
-	resource_bindings[binding][array_element].buffer = &buffer;
-	resource_bindings[binding][array_element].offset = offset;
-	resource_bindings[binding][array_element].range  = range;
+	auto &resource = bind(binding, array_element);
+
+	resource.buffer = &buffer;
+	resource.offset = offset;
+	resource.range  = range;
 
-	dirty = true;
+	update_binding_hash(binding);
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = &sampler;
+	auto &resource = bind(binding, array_element);
 
-	dirty = true;
+	resource.image_view = &image_view;
+	resource.sampler    = &sampler;
+
+	update_binding_hash(binding);
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = nullptr;
+	auto &resource = bind(binding, array_element);
+
+	resource.image_view = &image_view;
+	resource.sampler    = nullptr;
 
-	dirty = true;
+	update_binding_hash(binding);
 }
 
 void ResourceSet::bind_input(const core::ImageView &image_view, const uint32_t binding, const uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
+	auto &resource = bind(binding, array_element);
+
+	resource.image_view = &image_view;
+
+	update_binding_hash(binding);
+}
+
+uint32_t ResourceSet::get_bound_bindings() const
+{
+	return bound_bindings;
+}
+
+uint32_t ResourceSet::get_bound_array_elements(uint32_t binding) const
+{
+	assert(binding < max_resource_bindings && "Resource binding is out of bounds");
+
+	return bound_array_elements[binding];
+}
+
+const ResourceInfo &ResourceSet::get_resource(uint32_t binding, uint32_t array_element) const
+{
+	assert(binding < max_resource_bindings && array_element < max_resource_array_elements && "Resource binding is out of bounds");
 
-	dirty = true;
+	return resources[binding][array_element];
 }
 
-const BindingMap<ResourceInfo> &ResourceSet::get_resource_bindings() const
+size_t ResourceSet::get_binding_hash(uint32_t binding, bool dynamic) const
 {
-	return resource_bindings;
+	assert(binding < max_resource_bindings && "Resource binding is out of bounds");
+
+	return dynamic ? dynamic_binding_hashes[binding] : binding_hashes[binding];
 }
 
+void ResourceSet::update_binding_hash(uint32_t binding)
+{
+	size_t hash         = 0;
+	size_t dynamic_hash = 0;
+
+	for (uint32_t array_element = 0; array_element < max_resource_array_elements; ++array_element)
+	{
+		if (!(bound_array_elements[binding] & (1u << array_element)))
+		{
+			continue;
+		}
+
+		auto &resource = resources[binding][array_element];
+
+		size_t element_hash = 0;
+
+		hash_combine(element_hash, array_element);
+		hash_combine(element_hash, resource.buffer ? resource.buffer->get_handle() : VK_NULL_HANDLE);
+		hash_combine(element_hash, resource.range);
+		hash_combine(element_hash, resource.image_view ? resource.image_view->get_handle() : VK_NULL_HANDLE);
+		hash_combine(element_hash, resource.sampler ? resource.sampler->get_handle() : VK_NULL_HANDLE);
+
+		hash_combine(dynamic_hash, element_hash);
+
+		hash_combine(element_hash, resource.offset);
+
+		hash_combine(hash, element_hash);
+	}
+
+	binding_hashes[binding]         = hash;
+	dynamic_binding_hashes[binding] = dynamic_hash;
+}
+
+ResourceInfo &ResourceSet::bind(uint32_t binding, uint32_t array_element)
+{
+	if (binding >= max_resource_bindings || array_element >= max_resource_array_elements)
+	{
+		throw std::runtime_error("Resource binding " + std::to_string(binding) + "[" + std::to_string(array_element) + "] is out of bounds");
+	}
+
+	dirty_bindings |= 1u << binding;
+	bound_bindings |= 1u << binding;
+
+	bound_array_elements[binding] |= 1u << array_element;
+
+	auto &resource = resources[binding][array_element];
+
+	resource.dirty = true;
+
+	return resource;
+}
 }        // namespace vkb
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "common/vk_common.h"
 #include "core/buffer.h"
 #include "core/image_view.h"
@@ -24,6 +26,15 @@
 
 namespace vkb
 {
+/// Maximum number of descriptor sets a command buffer binds resources to
+constexpr uint32_t max_resource_sets = 4;
+
+/// Maximum number of bindings of a resource set, bindings are tracked in 32 bit masks
+constexpr uint32_t max_resource_bindings = 32;
+
+/// Maximum number of array elements of a binding
+constexpr uint32_t max_resource_array_elements = 4;
+
 /**
  * @brief A resource info is a struct containing the actual resource data.
  *
@@ -48,7 +59,8 @@ struct ResourceInfo
  * @brief A resource set is a set of bindings containing resources that were bound 
  *        by a command buffer.
  *
- * The ResourceSet has a one to one mapping with a DescriptorSet.
+ * The ResourceSet has a one to one mapping with a DescriptorSet. Resources are stored in a
+ * fixed size table indexed by binding and array element, so binding a resource never allocates.
  */
 class ResourceSet
 {
@@ -69,12 +81,46 @@ class ResourceSet
 
 	void bind_input(const core::ImageView &image_view, uint32_t binding, uint32_t array_element);
 
-	const BindingMap<ResourceInfo> &get_resource_bindings() const;
+	/**
+	 * @return A mask of the bindings with at least one resource bound, bit i is set for binding i
+	 */
+	uint32_t get_bound_bindings() const;
+
+	/**
+	 * @return A mask of the array elements of a binding with a resource bound
+	 */
+	uint32_t get_bound_array_elements(uint32_t binding) const;
+
+	const ResourceInfo &get_resource(uint32_t binding, uint32_t array_element) const;
+
+	/**
+	 * @brief Gets the hash of the resources bound to a binding, kept up to date as resources are bound
+	 * @param binding The binding
+	 * @param dynamic If true, buffer offsets are left out of the hash, as they are dynamic offsets
+	 *                passed when binding the descriptor set
+	 */
+	size_t get_binding_hash(uint32_t binding, bool dynamic) const;
 
   private:
-	bool dirty{false};
+	/**
+	 * @brief Marks an array element of a binding as bound and dirty
+	 * @return The resource info of the array element
+	 */
+	ResourceInfo &bind(uint32_t binding, uint32_t array_element);
+
+	void update_binding_hash(uint32_t binding);
+
+	uint32_t dirty_bindings{0};
 
-	BindingMap<ResourceInfo> resource_bindings;
+	uint32_t bound_bindings{0};
+
+	std::array<uint32_t, max_resource_bindings> bound_array_elements{};
+
+	std::array<std::array<ResourceInfo, max_resource_array_elements>, max_resource_bindings> resources{};
+
+	std::array<size_t, max_resource_bindings> binding_hashes{};
+
+	std::array<size_t, max_resource_bindings> dynamic_binding_hashes{};
 };
 
 /**
@@ -102,11 +148,25 @@ class ResourceBindingState
 
 	void bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element);
 
-	const std::unordered_map<uint32_t, ResourceSet> &get_resource_sets();
+	/**
+	 * @return A mask of the sets with resources bound since they were last flushed, bit i is set for set i
+	 */
+	uint32_t get_dirty_sets() const;
+
+	/**
+	 * @return A mask of the sets with at least one resource bound
+	 */
+	uint32_t get_bound_sets() const;
+
+	const ResourceSet &get_resource_set(uint32_t set) const;
 
   private:
-	bool dirty{false};
+	ResourceSet &get_resource_set_for_binding(uint32_t set);
+
+	uint32_t dirty_sets{0};
+
+	uint32_t bound_sets{0};
 
-	std::unordered_map<uint32_t, ResourceSet> resource_sets;
+	std::array<ResourceSet, max_resource_sets> resource_sets;
 };
 }        // namespace vkb
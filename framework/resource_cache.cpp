@@ -107,6 +107,23 @@ void ResourceCache::clear_pipelines()
 	state.compute_pipelines.clear();
 }
 
+ResourceCacheState ResourceCache::release_pipelines()
+{
+	ResourceCacheState released_state;
+
+	{
+		std::lock_guard<std::mutex> guard(graphics_pipeline_mutex);
+		std::swap(released_state.graphics_pipelines, state.graphics_pipelines);
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(compute_pipeline_mutex);
+		std::swap(released_state.compute_pipelines, state.compute_pipelines);
+	}
+
+	return released_state;
+}
+
 void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &old_views, const std::vector<core::ImageView> &new_views)
 {
 	// Find descriptor sets referring to the old image view
@@ -197,6 +214,16 @@ void ResourceCache::clear_framebuffers()
 	state.framebuffers.clear();
 }
 
+std::unordered_map<std::size_t, Framebuffer> ResourceCache::release_framebuffers()
+{
+	std::lock_guard<std::mutex> guard(framebuffer_mutex);
+
+	std::unordered_map<std::size_t, Framebuffer> framebuffers;
+	std::swap(framebuffers, state.framebuffers);
+
+	return framebuffers;
+}
+
 void ResourceCache::clear()
 {
 	state.shader_modules.clear();
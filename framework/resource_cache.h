@@ -120,6 +120,13 @@ class ResourceCache
 
 	void clear_pipelines();
 
+	/**
+	 * @brief Removes all the pipelines from the cache without destroying them, so that they can be
+	 *        kept alive until the frames in flight which use them complete
+	 * @return A cache state holding only the pipelines which were cached
+	 */
+	ResourceCacheState release_pipelines();
+
 	/// @brief Update those descriptor sets referring to old views
 	/// @param old_views Old image views referred by descriptor sets
 	/// @param new_views New image views to be referred
@@ -127,6 +134,13 @@ class ResourceCache
 
 	void clear_framebuffers();
 
+	/**
+	 * @brief Removes all the framebuffers from the cache without destroying them, so that they can be
+	 *        kept alive until the frames in flight which use them complete
+	 * @return The framebuffers which were cached
+	 */
+	std::unordered_map<std::size_t, Framebuffer> release_framebuffers();
+
 	void clear();
 
 	const ResourceCacheState &get_internal_state() const;
@@ -17,6 +17,8 @@
 
 #include "resource_record.h"
 
+#include <limits>
+
 #include "core/pipeline.h"
 #include "core/pipeline_layout.h"
 #include "core/render_pass.h"
@@ -111,10 +113,11 @@ size_t ResourceRecord::register_graphics_pipeline(VkPipelineCache /*pipeline_cac
 	auto &pipeline_layout = pipeline_state.get_pipeline_layout();
 	auto  render_pass     = pipeline_state.get_render_pass();
 
+	// Pipelines of dynamic rendering scopes have no render pass, they are recorded with an out of range index
 	write(stream,
 	      ResourceType::GraphicsPipeline,
 	      pipeline_layout_to_index.at(&pipeline_layout),
-	      render_pass_to_index.at(render_pass),
+	      render_pass ? render_pass_to_index.at(render_pass) : std::numeric_limits<size_t>::max(),
 	      pipeline_state.get_subpass_index());
 
 	auto &specialization_constant_state = pipeline_state.get_specialization_constant_state().get_specialization_constant_state();
@@ -142,6 +145,13 @@ size_t ResourceRecord::register_graphics_pipeline(VkPipelineCache /*pipeline_cac
 	      color_blend_state.logic_op_enable,
 	      color_blend_state.attachments);
 
+	auto &rendering_state = pipeline_state.get_rendering_state();
+
+	write(stream,
+	      rendering_state.color_attachment_formats,
+	      rendering_state.depth_attachment_format,
+	      rendering_state.stencil_attachment_format);
+
 	return graphics_pipeline_indices.back();
 }
 
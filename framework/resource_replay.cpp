@@ -193,11 +193,24 @@ void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, std
 	     color_blend_state.logic_op_enable,
 	     color_blend_state.attachments);
 
+	RenderingState rendering_state{};
+
+	read(stream,
+	     rendering_state.color_attachment_formats,
+	     rendering_state.depth_attachment_format,
+	     rendering_state.stencil_attachment_format);
+
 	PipelineState pipeline_state{};
 	assert(pipeline_layout_index < pipeline_layouts.size());
 	pipeline_state.set_pipeline_layout(*pipeline_layouts[pipeline_layout_index]);
-	assert(render_pass_index < render_passes.size());
-	pipeline_state.set_render_pass(*render_passes[render_pass_index]);
+	if (render_pass_index < render_passes.size())
+	{
+		pipeline_state.set_render_pass(*render_passes[render_pass_index]);
+	}
+	else
+	{
+		pipeline_state.set_rendering_state(rendering_state);
+	}
 
 	for (auto &item : specialization_constant_state)
 	{
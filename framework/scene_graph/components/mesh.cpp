@@ -40,6 +40,16 @@ const AABB &Mesh::get_bounds() const
 	return bounds;
 }
 
+void Mesh::set_dequantization(const glm::mat4 &transform)
+{
+	dequantization = transform;
+}
+
+const glm::mat4 &Mesh::get_dequantization() const
+{
+	return dequantization;
+}
+
 void Mesh::add_submesh(SubMesh &submesh)
 {
 	submeshes.push_back(&submesh);
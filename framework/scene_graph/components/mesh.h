@@ -44,6 +44,17 @@ class Mesh : public Component
 
 	const AABB &get_bounds() const;
 
+	/**
+	 * @brief Sets the transform decoding the vertex positions of the submeshes to the space of the bounds,
+	 *        if they were stored quantized
+	 */
+	void set_dequantization(const glm::mat4 &transform);
+
+	/**
+	 * @return The transform applied to the stored vertex positions before the node transform
+	 */
+	const glm::mat4 &get_dequantization() const;
+
 	void add_submesh(SubMesh &submesh);
 
 	const std::vector<SubMesh *> &get_submeshes() const;
@@ -55,6 +66,8 @@ class Mesh : public Component
   private:
 	AABB bounds;
 
+	glm::mat4 dequantization{1.0f};
+
 	std::vector<SubMesh *> submeshes;
 
 	std::vector<Node *> nodes;
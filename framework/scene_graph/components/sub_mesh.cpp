@@ -92,6 +92,13 @@ void SubMesh::compute_shader_variant()
 		std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::toupper);
 		shader_variant.add_define("HAS_" + attrib_name);
 	}
+
+	// Normals stored as two components are octahedral encoded, and decoded by the vertex shader
+	auto normal_it = vertex_attributes.find("normal");
+	if (normal_it != vertex_attributes.end() && (normal_it->second.format == VK_FORMAT_R16G16_SNORM || normal_it->second.format == VK_FORMAT_R8G8_SNORM))
+	{
+		shader_variant.add_define("OCTAHEDRAL_NORMAL");
+	}
 }
 
 ShaderVariant &SubMesh::get_mut_shader_variant()
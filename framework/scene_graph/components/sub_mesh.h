@@ -43,6 +43,20 @@ struct VertexAttribute
 	std::uint32_t offset = 0;
 };
 
+/**
+ * @brief A level of detail of a submesh, stored as a range of its index buffer
+ */
+struct SubMeshLod
+{
+	/// First index of the level in the index buffer
+	std::uint32_t first_index = 0;
+
+	std::uint32_t index_count = 0;
+
+	/// Object space geometric error of the level compared to the full resolution mesh
+	float error = 0.0f;
+};
+
 class SubMesh : public Component
 {
   public:
@@ -64,6 +78,22 @@ class SubMesh : public Component
 
 	std::unique_ptr<core::Buffer> index_buffer;
 
+	/// Levels of detail in increasing error order, the first one being the full resolution mesh.
+	/// Empty if no LOD chain was generated for the submesh.
+	std::vector<SubMeshLod> lods;
+
+	/// Number of meshlets of the submesh, 0 if none were generated
+	std::uint32_t meshlet_count = 0;
+
+	/// Device local array of vkb::Meshlet
+	std::unique_ptr<core::Buffer> meshlet_buffer;
+
+	/// Device local array of the vertex indices used by each meshlet
+	std::unique_ptr<core::Buffer> meshlet_vertex_buffer;
+
+	/// Device local array of the triangles of each meshlet, packed as three 8 bit local vertex indices
+	std::unique_ptr<core::Buffer> meshlet_triangle_buffer;
+
 	void set_attribute(const std::string &name, const VertexAttribute &attribute);
 
 	bool get_attribute(const std::string &name, VertexAttribute &attribute) const;
@@ -0,0 +1,92 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "framework_stats_provider.h"
+
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+namespace
+{
+/// The stats accumulated by the framework itself
+const std::set<StatIndex> framework_stats = {
+    StatIndex::triangles,
+    StatIndex::descriptor_pool_creations,
+    StatIndex::descriptor_pool_memory,
+    StatIndex::postprocessing_bytes_avoided,
+    StatIndex::culled_objects};
+}        // namespace
+
+FrameworkStatsProvider::FrameworkStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context{render_context}
+{
+	for (auto stat : framework_stats)
+	{
+		if (requested_stats.erase(stat) != 0)
+		{
+			stat_indices.insert(stat);
+		}
+	}
+}
+
+bool FrameworkStatsProvider::is_available(StatIndex index) const
+{
+	return stat_indices.count(index) != 0;
+}
+
+StatsProvider::Counters FrameworkStatsProvider::sample(float delta_time)
+{
+	auto frame_stats = render_context.consume_frame_stats();
+
+	Counters res;
+	for (auto stat : stat_indices)
+	{
+		auto stat_it = frame_stats.find(stat);
+
+		// Stats which were not recorded during the frame are reported as zero
+		res[stat].result = stat_it != frame_stats.end() ? stat_it->second : 0.0;
+	}
+
+	// Descriptor pool usage is read from the render frames rather than accumulated during the frame
+	if (is_available(StatIndex::descriptor_pool_creations) || is_available(StatIndex::descriptor_pool_memory))
+	{
+		uint32_t     pool_creations = 0;
+		VkDeviceSize pool_memory    = 0;
+
+		for (auto &frame : render_context.get_render_frames())
+		{
+			pool_creations += frame->get_descriptor_pool_creation_count();
+			pool_memory += frame->get_descriptor_pool_memory_size();
+		}
+
+		if (is_available(StatIndex::descriptor_pool_creations))
+		{
+			res[StatIndex::descriptor_pool_creations].result = static_cast<double>(pool_creations - last_descriptor_pool_creations);
+		}
+
+		if (is_available(StatIndex::descriptor_pool_memory))
+		{
+			res[StatIndex::descriptor_pool_memory].result = static_cast<double>(pool_memory);
+		}
+
+		last_descriptor_pool_creations = pool_creations;
+	}
+
+	return res;
+}
+}        // namespace vkb
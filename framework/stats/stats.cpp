@@ -20,6 +20,7 @@
 #include "core/device.h"
 
 #include "frame_time_stats_provider.h"
+#include "framework_stats_provider.h"
 #include "hwcpipe_stats_provider.h"
 #include "vulkan_stats_provider.h"
 
@@ -63,12 +64,14 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	// All supported stats will be removed from the given 'stats' set by the provider's constructor
 	// so subsequent providers only see requests for stats that aren't already supported.
 	providers.emplace_back(std::make_unique<FrameTimeStatsProvider>(stats));
+	providers.emplace_back(std::make_unique<FrameworkStatsProvider>(stats, render_context));
 	providers.emplace_back(std::make_unique<HWCPipeStatsProvider>(stats));
 	providers.emplace_back(std::make_unique<VulkanStatsProvider>(stats, sampling_config, render_context));
 
-	// In continuous sampling mode we still need to update the frame times as if we are polling
-	// Store the frame time provider here so we can easily access it later.
+	// In continuous sampling mode we still need to update the frame times and framework counters as if we are polling
+	// Store these providers here so we can easily access them later.
 	frame_time_provider = providers[0].get();
+	framework_provider  = providers[1].get();
 
 	for (const auto &stat : requested_stats)
 	{
@@ -202,9 +205,12 @@ void Stats::update(float delta_time)
 			// Clamp the number of samples
 			sample_count = std::max<size_t>(1, std::min<size_t>(sample_count, pending_samples.size()));
 
-			// Get the frame time stats (not a continuous stat)
+			// Get the frame time and framework stats (not continuous stats)
 			StatsProvider::Counters frame_time_sample = frame_time_provider->sample(delta_time);
 
+			StatsProvider::Counters framework_sample = framework_provider->sample(delta_time);
+			frame_time_sample.insert(framework_sample.begin(), framework_sample.end());
+
 			// Push the samples to circular buffers
 			std::for_each(pending_samples.begin(), pending_samples.begin() + sample_count, [this, frame_time_sample](auto &s) {
 				// Write the correct frame time into the continuous stats
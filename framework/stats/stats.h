@@ -143,6 +143,9 @@ class Stats
 	/// Provider that tracks frame times
 	StatsProvider *frame_time_provider;
 
+	/// Provider that tracks the counters accumulated by the framework
+	StatsProvider *framework_provider;
+
 	/// A list of stats providers to use in priority order
 	std::vector<std::unique_ptr<StatsProvider>> providers;
 
@@ -63,6 +63,12 @@ enum class StatIndex
 	gpu_ext_read_bytes,
 	gpu_ext_write_bytes,
 	gpu_tex_cycles,
+
+	triangles,
+	descriptor_pool_creations,
+	descriptor_pool_memory,
+	postprocessing_bytes_avoided,
+	culled_objects,
 };
 
 struct StatIndexHash
@@ -0,0 +1,77 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief A VK_KHR_timeline_semaphore semaphore counting the submissions to a queue. Each submission
+ *        signals the next value of the timeline, so that the CPU can poll or wait for the completion
+ *        of any of them without a fence per submission.
+ */
+class TimelineSemaphore
+{
+  public:
+	TimelineSemaphore(Device &device);
+
+	TimelineSemaphore(const TimelineSemaphore &) = delete;
+
+	TimelineSemaphore(TimelineSemaphore &&other) = delete;
+
+	~TimelineSemaphore();
+
+	TimelineSemaphore &operator=(const TimelineSemaphore &) = delete;
+
+	TimelineSemaphore &operator=(TimelineSemaphore &&) = delete;
+
+	VkSemaphore get_handle() const;
+
+	/**
+	 * @brief Returns the value the next submission to the queue has to signal
+	 */
+	uint64_t request_signal_value();
+
+	/**
+	 * @return The last value signaled by the queue
+	 */
+	uint64_t get_completed_value() const;
+
+	/**
+	 * @brief Waits for the queue to signal a value, returns immediately if it is known to be signaled
+	 * @param value The value to wait for
+	 * @param timeout Timeout in nanoseconds
+	 */
+	VkResult wait(uint64_t value, uint64_t timeout = std::numeric_limits<uint64_t>::max()) const;
+
+  private:
+	Device &device;
+
+	VkSemaphore handle{VK_NULL_HANDLE};
+
+	/// Last value requested for a submission
+	uint64_t signal_value{0};
+
+	/// Last value known to be signaled, to skip querying the semaphore
+	mutable uint64_t completed_value{0};
+};
+}        // namespace vkb
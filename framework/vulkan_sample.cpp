@@ -151,6 +151,52 @@ bool VulkanSample::prepare(const ApplicationOptions &options)
 	// Request sample required GPU features
 	request_gpu_features(gpu);
 
+	// Request the features of descriptor buffers, they are left disabled by GPUs which don't support them
+	gpu.set_descriptor_buffers_enable(descriptor_buffers);
+	if (descriptor_buffers)
+	{
+		gpu.request_extension_features<VkPhysicalDeviceBufferDeviceAddressFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES_KHR);
+		gpu.request_extension_features<VkPhysicalDeviceDescriptorBufferFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT);
+
+		add_device_extension(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME, /*optional=*/true);
+		add_device_extension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, /*optional=*/true);
+		add_device_extension(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME, /*optional=*/true);
+		add_device_extension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, /*optional=*/true);
+	}
+
+	// Request the features of extended dynamic state, each extension is only used if its features are supported
+	gpu.set_extended_dynamic_state_enable(extended_dynamic_state);
+	if (extended_dynamic_state)
+	{
+		gpu.request_extension_features<VkPhysicalDeviceExtendedDynamicStateFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT);
+		gpu.request_extension_features<VkPhysicalDeviceExtendedDynamicState2FeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT);
+		gpu.request_extension_features<VkPhysicalDeviceExtendedDynamicState3FeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT);
+
+		add_device_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME, /*optional=*/true);
+		add_device_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME, /*optional=*/true);
+		add_device_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME, /*optional=*/true);
+	}
+
+	// Request the feature of timeline semaphores, frames are paced with fences if it is not supported
+	gpu.set_timeline_semaphores_enable(timeline_semaphores);
+	if (timeline_semaphores)
+	{
+		gpu.request_extension_features<VkPhysicalDeviceTimelineSemaphoreFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR);
+
+		add_device_extension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, /*optional=*/true);
+	}
+
+	// Request the feature of dynamic rendering, render passes are used if it is not supported
+	gpu.set_dynamic_rendering_enable(dynamic_rendering);
+	if (dynamic_rendering)
+	{
+		gpu.request_extension_features<VkPhysicalDeviceDynamicRenderingFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR);
+
+		add_device_extension(VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME, /*optional=*/true);
+		add_device_extension(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME, /*optional=*/true);
+		add_device_extension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME, /*optional=*/true);
+	}
+
 	// Creating vulkan device, specifying the swapchain extension always
 	if (!headless || instance->is_enabled(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME))
 	{
@@ -162,6 +208,9 @@ bool VulkanSample::prepare(const ApplicationOptions &options)
 		}
 	}
 
+	// Descriptor sets are written through update templates when available
+	add_device_extension(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME, /*optional=*/true);
+
 #ifdef VKB_VULKAN_DEBUG
 	if (!debug_utils)
 	{
@@ -203,6 +252,7 @@ bool VulkanSample::prepare(const ApplicationOptions &options)
 	}
 
 	create_render_context();
+	render_context->set_frames_in_flight(frames_in_flight);
 	prepare_render_context();
 
 	stats = std::make_unique<vkb::Stats>(*render_context);
@@ -539,7 +589,12 @@ void VulkanSample::set_viewport_and_scissor(vkb::CommandBuffer &command_buffer,
 
 void VulkanSample::load_scene(const std::string &path)
 {
-	GLTFLoader loader{*device};
+	load_scene(path, GLTFLoaderOptions{});
+}
+
+void VulkanSample::load_scene(const std::string &path, const GLTFLoaderOptions &options)
+{
+	GLTFLoader loader{*device, options};
 
 	scene = loader.read_scene_from_file(path);
 
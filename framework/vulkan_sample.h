@@ -31,6 +31,8 @@
 
 namespace vkb
 {
+struct GLTFLoaderOptions;
+
 /**
  * @mainpage Overview of the framework
  *
@@ -141,6 +143,14 @@ class VulkanSample : public Application
 	 */
 	void load_scene(const std::string &path);
 
+	/**
+	 * @brief Loads the scene, processing its meshes as requested
+	 *
+	 * @param path The path of the glTF file
+	 * @param options The mesh processing applied by the loader
+	 */
+	void load_scene(const std::string &path, const GLTFLoaderOptions &options);
+
 	VkSurfaceKHR get_surface();
 
 	Device &get_device();
@@ -331,6 +341,63 @@ class VulkanSample : public Application
 		high_priority_graphics_queue = enable;
 	}
 
+	/**
+	 * @brief Sets whether the framework writes descriptors to descriptor buffers instead of descriptor sets.
+	 * Descriptor buffers are only used if the GPU supports VK_EXT_descriptor_buffer, and the vulkan.hpp
+	 * framework and the Gui draw call taking a VkCommandBuffer don't support them.
+	 * Needs to be called before prepare().
+	 * @param enable If true, descriptor buffers are used when supported. Default state is false.
+	 */
+	void set_descriptor_buffers_enable(bool enable)
+	{
+		descriptor_buffers = enable;
+	}
+
+	/**
+	 * @brief Sets whether the framework records cull mode, front face, depth stencil and blend states as dynamic state,
+	 * so that they don't multiply the pipelines. Each of the VK_EXT_extended_dynamic_state, _2 and _3 extensions is used
+	 * if the GPU supports it, and the vulkan.hpp framework always bakes these states into its pipelines.
+	 * Needs to be called before prepare().
+	 * @param enable If true, extended dynamic state is used when supported. Default state is false.
+	 */
+	void set_extended_dynamic_state_enable(bool enable)
+	{
+		extended_dynamic_state = enable;
+	}
+
+	/**
+	 * @brief Sets the number of frames the CPU may record ahead of the GPU, independently of the number of swapchain images.
+	 * Headless samples otherwise render a single frame at a time. Needs to be called before prepare().
+	 * @param count Number of frames in flight, 0 uses one frame per swapchain image. Default state is 0.
+	 */
+	void set_frames_in_flight(uint32_t count)
+	{
+		frames_in_flight = count;
+	}
+
+	/**
+	 * @brief Sets whether the RenderContext tracks the completion of frames with a VK_KHR_timeline_semaphore timeline per queue,
+	 * instead of a fence per submission. Fences are used if the GPU doesn't support timeline semaphores.
+	 * Needs to be called before prepare().
+	 * @param enable If true, timeline semaphores are used when supported. Default state is false.
+	 */
+	void set_timeline_semaphores_enable(bool enable)
+	{
+		timeline_semaphores = enable;
+	}
+
+	/**
+	 * @brief Sets whether the subpasses of render pipelines are recorded as VK_KHR_dynamic_rendering scopes, so that no
+	 * render pass and framebuffer are looked up in the resource cache. Render passes are used if the GPU doesn't support
+	 * dynamic rendering, for render pipelines with input attachments, and by the vulkan.hpp framework.
+	 * Needs to be called before prepare().
+	 * @param enable If true, dynamic rendering is used when supported. Default state is false.
+	 */
+	void set_dynamic_rendering_enable(bool enable)
+	{
+		dynamic_rendering = enable;
+	}
+
 	/**
 	 * @brief A helper to create a render context
 	 */
@@ -348,5 +415,20 @@ class VulkanSample : public Application
 
 	/** @brief Whether or not we want a high priority graphics queue. */
 	bool high_priority_graphics_queue{false};
+
+	/** @brief Whether or not we want descriptor buffers in place of descriptor sets. */
+	bool descriptor_buffers{false};
+
+	/** @brief Whether or not we want extended dynamic state to reduce the number of pipelines. */
+	bool extended_dynamic_state{false};
+
+	/** @brief Number of frames in flight, 0 if tied to the swapchain images. */
+	uint32_t frames_in_flight{0};
+
+	/** @brief Whether or not we want frames paced with timeline semaphores. */
+	bool timeline_semaphores{false};
+
+	/** @brief Whether or not we want dynamic rendering in place of render passes. */
+	bool dynamic_rendering{false};
 };
 }        // namespace vkb
@@ -475,7 +475,7 @@ void ConstantData::BufferArraySubpass::prepare_push_constants(vkb::CommandBuffer
 	return;
 }
 
-void ConstantData::BufferArraySubpass::draw_submesh_command(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh)
+void ConstantData::BufferArraySubpass::draw_submesh_command(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, uint32_t lod_index, uint32_t instance_count)
 {
 	/**
 	 * POI
@@ -492,10 +492,19 @@ void ConstantData::BufferArraySubpass::draw_submesh_command(vkb::CommandBuffer &
 		// Bind index buffer of submesh
 		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
 
-		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, instance_index++);
+		if (lod_index < sub_mesh.lods.size())
+		{
+			command_buffer.draw_indexed(sub_mesh.lods[lod_index].index_count, instance_count, sub_mesh.lods[lod_index].first_index, 0, instance_index);
+		}
+		else
+		{
+			command_buffer.draw_indexed(sub_mesh.vertex_indices, instance_count, 0, 0, instance_index);
+		}
 	}
 	else
 	{
-		command_buffer.draw(sub_mesh.vertices_count, 1, 0, instance_index++);
+		command_buffer.draw(sub_mesh.vertices_count, instance_count, 0, instance_index);
 	}
+
+	instance_index += instance_count;
 }
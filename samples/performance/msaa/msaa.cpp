@@ -600,14 +600,17 @@ void MSAASample::postprocessing(vkb::CommandBuffer &command_buffer, vkb::RenderT
 
 	// Second render pass
 	// NOTE: Color and depth attachments are automatically transitioned to be bound as textures
-	postprocessing_pipeline->draw(command_buffer, render_target);
+	auto &postprocessing_command_buffer = postprocessing_pipeline->draw(command_buffer, render_target);
+
+	// The outline pass is not asynchronous, so recording continues in the command buffer the sample submits
+	assert(&postprocessing_command_buffer == &command_buffer);
 
 	if (gui)
 	{
-		gui->draw(command_buffer);
+		gui->draw(postprocessing_command_buffer);
 	}
 
-	command_buffer.end_render_pass();
+	postprocessing_command_buffer.end_render_pass();
 }
 
 void MSAASample::resolve_color_separate_pass(vkb::CommandBuffer &command_buffer, const std::vector<vkb::core::ImageView> &views,
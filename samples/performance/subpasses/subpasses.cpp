@@ -49,6 +49,11 @@ Subpasses::Subpasses()
 	config.insert<vkb::IntSetting>(3, configs[Config::RenderTechnique].value, 0);
 	config.insert<vkb::IntSetting>(3, configs[Config::TransientAttachments].value, 0);
 	config.insert<vkb::IntSetting>(3, configs[Config::GBufferSize].value, 1);
+
+	// Use the render graph
+	config.insert<vkb::IntSetting>(4, configs[Config::RenderTechnique].value, 2);
+	config.insert<vkb::IntSetting>(4, configs[Config::TransientAttachments].value, 0);
+	config.insert<vkb::IntSetting>(4, configs[Config::GBufferSize].value, 0);
 }
 
 std::unique_ptr<vkb::RenderTarget> Subpasses::create_render_target(vkb::core::Image &&swapchain_image)
@@ -228,6 +233,9 @@ void Subpasses::update(float delta_time)
 			frame->reset();
 		}
 
+		// The render graph is rebuilt on the next draw, for the new G-buffer formats and swapchain images
+		render_graph.reset();
+
 		LOGI("Recreating render target");
 		render_context->recreate();
 	}
@@ -426,6 +434,93 @@ void Subpasses::draw_renderpasses(vkb::CommandBuffer &command_buffer, vkb::Rende
 	draw_pipeline(command_buffer, render_target, *lighting_render_pipeline, gui.get());
 }
 
+void Subpasses::create_render_graph(const VkExtent2D &extent, VkFormat swapchain_format)
+{
+	// Frames in flight may still be rendering with the images and subpasses of the previous render graph
+	if (render_graph)
+	{
+		get_render_context().defer_destruction(std::move(render_graph));
+		get_render_context().defer_destruction(std::move(graph_geometry_subpass));
+		get_render_context().defer_destruction(std::move(graph_lighting_subpass));
+	}
+
+	render_graph = std::make_unique<vkb::RenderGraph>(get_device());
+
+	// The swapchain image is cleared by the lighting pass, and stays in the color attachment layout the sample presents from
+	render_graph->import_image("swapchain", {extent, swapchain_format}, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+	// The G-buffer only lives within the frame, the render graph makes it transient as it never leaves the render pass
+	render_graph->add_image("depth", {extent, vkb::get_suitable_depth_format(get_device().get_gpu().get_handle())});
+	render_graph->add_image("albedo", {extent, albedo_format});
+	render_graph->add_image("normal", {extent, normal_format});
+
+	auto clear_value = vkb::gbuffer::get_clear_value();
+
+	auto geometry_vs      = vkb::ShaderSource{"deferred/geometry.vert"};
+	auto geometry_fs      = vkb::ShaderSource{"deferred/geometry.frag"};
+	auto geometry_subpass = std::make_unique<vkb::GeometrySubpass>(get_render_context(), std::move(geometry_vs), std::move(geometry_fs), *scene, *camera);
+
+	// The render graph builds the render pass, the subpass only needs to know it outputs albedo and normal
+	geometry_subpass->set_output_attachments({1, 2});
+	geometry_subpass->prepare();
+
+	auto lighting_vs      = vkb::ShaderSource{"deferred/lighting.vert"};
+	auto lighting_fs      = vkb::ShaderSource{"deferred/lighting.frag"};
+	auto lighting_subpass = std::make_unique<vkb::LightingSubpass>(get_render_context(), std::move(lighting_vs), std::move(lighting_fs), *camera, *scene);
+	lighting_subpass->prepare();
+
+	auto &geometry_pass = render_graph->add_pass("Geometry");
+	geometry_pass.write("depth", vkb::RenderGraphUsage::DepthStencilAttachment)
+	    .write("albedo", vkb::RenderGraphUsage::ColorAttachment)
+	    .write("normal", vkb::RenderGraphUsage::ColorAttachment)
+	    .set_clear_value("depth", clear_value[1])
+	    .set_clear_value("albedo", clear_value[2])
+	    .set_clear_value("normal", clear_value[3]);
+	geometry_pass.set_execute([this](vkb::CommandBuffer &command_buffer) {
+		graph_geometry_subpass->draw(command_buffer);
+	});
+
+	// Reading the G-buffer as input attachments lets the render graph merge both passes into subpasses
+	auto &lighting_pass = render_graph->add_pass("Lighting");
+	lighting_pass.read("depth", vkb::RenderGraphUsage::InputAttachment)
+	    .read("albedo", vkb::RenderGraphUsage::InputAttachment)
+	    .read("normal", vkb::RenderGraphUsage::InputAttachment)
+	    .write("swapchain", vkb::RenderGraphUsage::ColorAttachment)
+	    .set_clear_value("swapchain", clear_value[0]);
+	lighting_pass.set_execute([this](vkb::CommandBuffer &command_buffer) {
+		graph_lighting_subpass->draw(command_buffer);
+
+		if (gui)
+		{
+			gui->draw(command_buffer);
+		}
+	});
+
+	render_graph->compile();
+
+	lighting_subpass->set_gbuffer_views(render_graph->get_image_view("depth"), render_graph->get_image_view("albedo"), render_graph->get_image_view("normal"));
+
+	graph_geometry_subpass = std::move(geometry_subpass);
+	graph_lighting_subpass = std::move(lighting_subpass);
+	render_graph_extent    = extent;
+}
+
+void Subpasses::draw_render_graph(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+{
+	auto &extent         = render_target.get_extent();
+	auto &swapchain_view = render_target.get_views()[0];
+
+	// A resize recreates the swapchain, and the render graph with images of the new extent
+	if (!render_graph || extent.width != render_graph_extent.width || extent.height != render_graph_extent.height)
+	{
+		create_render_graph(extent, swapchain_view.get_format());
+	}
+
+	render_graph->set_imported_image("swapchain", swapchain_view.get_image());
+
+	render_graph->execute(command_buffer);
+}
+
 void Subpasses::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
 {
 	if (configs[Config::RenderTechnique].value == 0)
@@ -433,6 +528,11 @@ void Subpasses::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderT
 		// Efficient way
 		draw_subpasses(command_buffer, render_target);
 	}
+	else if (configs[Config::RenderTechnique].value == 2)
+	{
+		// Subpasses worked out by the render graph
+		draw_render_graph(command_buffer, render_target);
+	}
 	else
 	{
 		// Inefficient way
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "rendering/render_graph.h"
 #include "rendering/render_pipeline.h"
 #include "scene_graph/components/perspective_camera.h"
 #include "vulkan_sample.h"
@@ -26,7 +27,8 @@
  *        (L2 cache ext reads and writes) can be saved, by using sub-passes instead
  *        of multiple render passes. In order to highlight the difference, it
  *        implements deferred rendering with and without sub-passes, giving the
- *        user the possibility to change some key settings.
+ *        user the possibility to change some key settings. A third technique
+ *        declares the passes in a render graph, which merges them into sub-passes.
  */
 class Subpasses : public vkb::VulkanSample
 {
@@ -75,6 +77,16 @@ class Subpasses : public vkb::VulkanSample
 	 */
 	void draw_renderpasses(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target);
 
+	/**
+	 * @brief Declares the geometry and lighting passes in a render graph, with the G-buffer as transient images
+	 */
+	void create_render_graph(const VkExtent2D &extent, VkFormat swapchain_format);
+
+	/**
+	 * @brief Draws using the render graph, which works out the subpasses and barriers from the declared images
+	 */
+	void draw_render_graph(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target);
+
 	std::unique_ptr<vkb::RenderTarget> create_render_target(vkb::core::Image &&swapchain_image);
 
 	/// Good pipeline with two subpasses within one render pass
@@ -86,6 +98,15 @@ class Subpasses : public vkb::VulkanSample
 	/// 2. Bad pipeline with a lighting subpass in the second render pass
 	std::unique_ptr<vkb::RenderPipeline> lighting_render_pipeline{};
 
+	/// Render graph with the geometry and lighting passes, rebuilt when the render target changes
+	std::unique_ptr<vkb::RenderGraph> render_graph{};
+
+	std::unique_ptr<vkb::Subpass> graph_geometry_subpass{};
+
+	std::unique_ptr<vkb::Subpass> graph_lighting_subpass{};
+
+	VkExtent2D render_graph_extent{};
+
 	vkb::sg::PerspectiveCamera *camera{};
 
 	/**
@@ -125,7 +146,7 @@ class Subpasses : public vkb::VulkanSample
 	std::vector<Config> configs = {
 	    {/* config      = */ Config::RenderTechnique,
 	     /* description = */ "Render technique",
-	     /* options     = */ {"Subpasses", "Renderpasses"},
+	     /* options     = */ {"Subpasses", "Renderpasses", "Render graph"},
 	     /* value       = */ 0},
 	    {/* config      = */ Config::TransientAttachments,
 	     /* description = */ "Transient attachments",
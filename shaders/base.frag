@@ -18,6 +18,10 @@
 
 precision highp float;
 
+#ifdef BINDLESS
+#include "bindless_material.h"
+#endif
+
 #ifdef HAS_BASE_COLOR_TEXTURE
 layout(set = 0, binding = 0) uniform sampler2D base_color_texture;
 #endif
@@ -36,6 +40,7 @@ layout(set = 0, binding = 1) uniform GlobalUniform
 }
 global_uniform;
 
+#ifndef BINDLESS
 // Push constants come with a limitation in the size of data.
 // The standard requires at least 128 bytes
 layout(push_constant, std430) uniform PBRMaterialUniform
@@ -45,9 +50,34 @@ layout(push_constant, std430) uniform PBRMaterialUniform
 	float roughness_factor;
 }
 pbr_material_uniform;
+#endif
 
 #include "lighting.h"
 
+#ifdef CLUSTERED_LIGHTING
+#include "clustered_lighting.h"
+
+// Directional lights first, followed by the point and spot lights binned into clusters
+layout(std430, set = 0, binding = 7) readonly buffer ClusterLights
+{
+	Light lights[];
+}
+cluster_lights;
+
+layout(std430, set = 0, binding = 8) readonly buffer ClusterLightGrid
+{
+	uint  light_index_count;
+	uint  padding;
+	uvec2 clusters[];
+}
+cluster_grid;
+
+layout(std430, set = 0, binding = 9) readonly buffer ClusterLightIndices
+{
+	uint indices[];
+}
+cluster_light_indices;
+#else
 layout(set = 0, binding = 4) uniform LightsInfo
 {
 	Light directional_lights[MAX_LIGHT_COUNT];
@@ -55,20 +85,67 @@ layout(set = 0, binding = 4) uniform LightsInfo
 	Light spot_lights[MAX_LIGHT_COUNT];
 }
 lights_info;
+#endif
 
 layout(constant_id = 0) const uint DIRECTIONAL_LIGHT_COUNT = 0U;
 layout(constant_id = 1) const uint POINT_LIGHT_COUNT       = 0U;
 layout(constant_id = 2) const uint SPOT_LIGHT_COUNT        = 0U;
 
+#ifdef SHADOWS
+#include "cascaded_shadows.h"
+#endif
+
 void main(void)
 {
 	vec3 normal = normalize(in_normal);
 
 	vec3 light_contribution = vec3(0.0);
 
+#ifdef CLUSTERED_LIGHTING
 	for (uint i = 0U; i < DIRECTIONAL_LIGHT_COUNT; ++i)
 	{
-		light_contribution += apply_directional_light(lights_info.directional_lights[i], normal);
+		vec3 directional_contribution = apply_directional_light(cluster_lights.lights[i], normal);
+
+#ifdef SHADOWS
+		if (i == shadow_uniform.light_index)
+		{
+			directional_contribution *= calculate_shadow(in_pos.xyz);
+		}
+#endif
+
+		light_contribution += directional_contribution;
+	}
+
+	// Only the lights binned into the cluster of the fragment are shaded
+	float view_depth = -(cluster_uniform.view * vec4(in_pos.xyz, 1.0)).z;
+	uvec2 cluster    = cluster_grid.clusters[get_cluster_index(get_cluster(gl_FragCoord.xy, view_depth))];
+
+	for (uint i = 0U; i < cluster.y; ++i)
+	{
+		Light light = cluster_lights.lights[cluster_light_indices.indices[cluster.x + i]];
+
+		if (light.position.w == POINT_LIGHT)
+		{
+			light_contribution += apply_point_light(light, in_pos.xyz, normal);
+		}
+		else
+		{
+			light_contribution += apply_spot_light(light, in_pos.xyz, normal);
+		}
+	}
+#else
+	for (uint i = 0U; i < DIRECTIONAL_LIGHT_COUNT; ++i)
+	{
+		vec3 directional_contribution = apply_directional_light(lights_info.directional_lights[i], normal);
+
+#ifdef SHADOWS
+		if (i == shadow_uniform.light_index)
+		{
+			directional_contribution *= calculate_shadow(in_pos.xyz);
+		}
+#endif
+
+		light_contribution += directional_contribution;
 	}
 
 	for (uint i = 0U; i < POINT_LIGHT_COUNT; ++i)
@@ -80,10 +157,14 @@ void main(void)
 	{
 		light_contribution += apply_spot_light(lights_info.spot_lights[i], in_pos.xyz, normal);
 	}
+#endif
 
 	vec4 base_color = vec4(1.0, 0.0, 0.0, 1.0);
 
-#ifdef HAS_BASE_COLOR_TEXTURE
+#if defined(BINDLESS)
+	Material material = get_material();
+	base_color        = material.base_color_texture >= 0 ? texture(bindless_textures[material.base_color_texture], in_uv) : material.base_color_factor;
+#elif defined(HAS_BASE_COLOR_TEXTURE)
 	base_color = texture(base_color_texture, in_uv);
 #else
 	base_color = pbr_material_uniform.base_color_factor;
@@ -18,7 +18,11 @@
 
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec2 texcoord_0;
+#ifdef OCTAHEDRAL_NORMAL
+layout(location = 2) in vec2 normal;
+#else
 layout(location = 2) in vec3 normal;
+#endif
 
 layout(set = 0, binding = 1) uniform GlobalUniform {
     mat4 model;
@@ -26,17 +30,59 @@ layout(set = 0, binding = 1) uniform GlobalUniform {
     vec3 camera_position;
 } global_uniform;
 
+#ifdef INSTANCING
+layout(std430, set = 0, binding = 13) readonly buffer InstanceTransforms {
+    mat4 transforms[];
+} instances;
+#endif
+
+#ifdef GPU_DRIVEN
+layout(std430, set = 0, binding = 12) readonly buffer InstanceMaterials {
+    uint material_indices[];
+} instance_materials;
+#endif
+
 layout (location = 0) out vec4 o_pos;
 layout (location = 1) out vec2 o_uv;
 layout (location = 2) out vec3 o_normal;
+#ifdef GPU_DRIVEN
+layout (location = 3) flat out uint o_material_index;
+#endif
+
+#ifdef OCTAHEDRAL_NORMAL
+vec3 decode_normal(vec2 encoded)
+{
+    // Unfold the lower hemisphere of the octahedron
+    vec3  n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+#else
+vec3 decode_normal(vec3 value)
+{
+    return value;
+}
+#endif
 
 void main(void)
 {
-    o_pos = global_uniform.model * vec4(position, 1.0);
+#ifdef INSTANCING
+    mat4 model = instances.transforms[gl_InstanceIndex];
+#else
+    mat4 model = global_uniform.model;
+#endif
+
+    o_pos = model * vec4(position, 1.0);
 
     o_uv = texcoord_0;
 
-    o_normal = mat3(global_uniform.model) * normal;
+    o_normal = mat3(model) * decode_normal(normal);
 
     gl_Position = global_uniform.view_proj * o_pos;
+
+#ifdef GPU_DRIVEN
+    o_material_index = instance_materials.material_indices[gl_InstanceIndex];
+#endif
 }
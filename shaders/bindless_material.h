@@ -0,0 +1,61 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Bindless materials, the textures of the scene are written once to a single array and the materials
+// to a storage buffer, draws only push the index of their material. GPU-driven draws instead read the
+// material index of each instance in the vertex shader, which passes it along
+
+// Matches vkb::BindlessMaterial, texture indices are -1 if the material has no such texture
+struct Material
+{
+	vec4  base_color_factor;
+	float metallic_factor;
+	float roughness_factor;
+	int   base_color_texture;
+	int   normal_texture;
+	int   metallic_roughness_texture;
+};
+
+layout(set = 1, binding = 0) uniform sampler2D bindless_textures[MAX_BINDLESS_TEXTURES];
+
+layout(set = 1, binding = 1) readonly buffer Materials
+{
+	Material materials[];
+};
+
+#ifdef GPU_DRIVEN
+layout(location = 3) flat in uint in_material_index;
+
+// Each indirect draw has a single instance, and separate draws of a multi-draw are separate invocation groups,
+// so the texture array is still indexed with dynamically uniform values
+Material get_material()
+{
+	return materials[in_material_index];
+}
+#else
+layout(push_constant, std430) uniform BindlessMaterialIndex
+{
+	uint index;
+}
+bindless_material;
+
+// The material index is the same for the whole draw, so the texture array is indexed with dynamically uniform values
+Material get_material()
+{
+	return materials[bindless_material.index];
+}
+#endif
@@ -0,0 +1,61 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Cascaded shadow maps of a directional light, rendered by vkb::ShadowSubpass into the tiles of an atlas
+
+precision highp sampler2DShadow;
+
+layout(set = 0, binding = 10) uniform sampler2DShadow shadow_atlas;
+
+layout(set = 0, binding = 11) uniform ShadowUniform
+{
+	mat4 camera_view;
+	mat4 light_matrices[MAX_SHADOW_CASCADES];
+	vec4 atlas_rects[MAX_SHADOW_CASCADES];
+	vec4 cascade_splits;
+	uint cascade_count;
+	uint light_index;
+}
+shadow_uniform;
+
+// Returns 0 if the world position is in the shadow of the light, 1 if it is lit
+float calculate_shadow(vec3 pos)
+{
+	float view_depth = -(shadow_uniform.camera_view * vec4(pos, 1.0)).z;
+
+	// Fragments past the last cascade are lit
+	if (view_depth > shadow_uniform.cascade_splits[shadow_uniform.cascade_count - 1U])
+	{
+		return 1.0;
+	}
+
+	uint cascade = 0U;
+	while (cascade + 1U < shadow_uniform.cascade_count && view_depth > shadow_uniform.cascade_splits[cascade])
+	{
+		++cascade;
+	}
+
+	vec4 projected_coord = shadow_uniform.light_matrices[cascade] * vec4(pos, 1.0);
+	projected_coord /= projected_coord.w;
+
+	// Keep the filtered texels within the tile of the cascade
+	vec4 rect       = shadow_uniform.atlas_rects[cascade];
+	vec2 texel_size = 1.0 / vec2(textureSize(shadow_atlas, 0));
+	vec2 uv         = clamp(projected_coord.xy, rect.xy + texel_size, rect.zw - texel_size);
+
+	return texture(shadow_atlas, vec3(uv, projected_coord.z));
+}
@@ -0,0 +1,52 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The view frustum is split in CLUSTER_GRID_X * CLUSTER_GRID_Y screen tiles and CLUSTER_GRID_Z
+// depth slices, exponentially distributed between the near and far planes.
+// The grid size is defined by vkb::ClusteredForwardSubpass.
+
+#define CLUSTER_COUNT (CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z)
+
+layout(set = 0, binding = 6) uniform ClusterUniform
+{
+	mat4  view;
+	mat4  inverse_projection;
+	vec2  screen_size;
+	float z_near;
+	float z_far;
+	uint  light_count;
+	uint  directional_light_count;
+}
+cluster_uniform;
+
+float get_slice_depth(uint slice)
+{
+	return cluster_uniform.z_near * pow(cluster_uniform.z_far / cluster_uniform.z_near, float(slice) / float(CLUSTER_GRID_Z));
+}
+
+uint get_cluster_index(uvec3 cluster)
+{
+	return cluster.x + CLUSTER_GRID_X * (cluster.y + CLUSTER_GRID_Y * cluster.z);
+}
+
+uvec3 get_cluster(vec2 frag_coord, float view_depth)
+{
+	uvec2 tile  = uvec2(frag_coord / cluster_uniform.screen_size * vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y));
+	float slice = log(max(view_depth, cluster_uniform.z_near) / cluster_uniform.z_near) * float(CLUSTER_GRID_Z) / log(cluster_uniform.z_far / cluster_uniform.z_near);
+
+	return min(uvec3(tile, uint(slice)), uvec3(CLUSTER_GRID_X - 1U, CLUSTER_GRID_Y - 1U, CLUSTER_GRID_Z - 1U));
+}
@@ -18,6 +18,10 @@
 
 precision highp float;
 
+#ifdef BINDLESS
+#include "bindless_material.h"
+#endif
+
 #ifdef HAS_BASE_COLOR_TEXTURE
 layout (set=0, binding=0) uniform sampler2D base_color_texture;
 #endif
@@ -35,11 +39,13 @@ layout(set = 0, binding = 1) uniform GlobalUniform {
     vec3 camera_position;
 } global_uniform;
 
+#ifndef BINDLESS
 layout(push_constant, std430) uniform PBRMaterialUniform {
     vec4 base_color_factor;
     float metallic_factor;
     float roughness_factor;
 } pbr_material_uniform;
+#endif
 
 void main(void)
 {
@@ -49,7 +55,10 @@ void main(void)
 
     vec4 base_color = vec4(1.0, 0.0, 0.0, 1.0);
 
-#ifdef HAS_BASE_COLOR_TEXTURE
+#if defined(BINDLESS)
+    Material material = get_material();
+    base_color = material.base_color_texture >= 0 ? texture(bindless_textures[material.base_color_texture], in_uv) : material.base_color_factor;
+#elif defined(HAS_BASE_COLOR_TEXTURE)
     base_color = texture(base_color_texture, in_uv);
 #else
     base_color = pbr_material_uniform.base_color_factor;
@@ -45,6 +45,10 @@ layout(constant_id = 0) const uint DIRECTIONAL_LIGHT_COUNT = 0U;
 layout(constant_id = 1) const uint POINT_LIGHT_COUNT       = 0U;
 layout(constant_id = 2) const uint SPOT_LIGHT_COUNT        = 0U;
 
+#ifdef SHADOWS
+#include "cascaded_shadows.h"
+#endif
+
 void main()
 {
 	// Retrieve position from depth
@@ -59,7 +63,14 @@ void main()
 	vec3 L = vec3(0.0);
 	for (uint i = 0U; i < DIRECTIONAL_LIGHT_COUNT; ++i)
 	{
-		L += apply_directional_light(lights_info.directional_lights[i], normal);
+		vec3 directional_contribution = apply_directional_light(lights_info.directional_lights[i], normal);
+#ifdef SHADOWS
+		if (i == shadow_uniform.light_index)
+		{
+			directional_contribution *= calculate_shadow(pos);
+		}
+#endif
+		L += directional_contribution;
 	}
 	for (uint i = 0U; i < POINT_LIGHT_COUNT; ++i)
 	{
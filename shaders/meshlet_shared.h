@@ -0,0 +1,68 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Must match vkb::max_meshlet_vertices and vkb::max_meshlet_triangles
+#define MAX_MESHLET_VERTICES 64
+#define MAX_MESHLET_TRIANGLES 124
+
+// Meshlets tested by a task shader workgroup, one per invocation
+#define MESHLET_TASK_GROUP_SIZE 32
+
+#define MESHLET_MESH_GROUP_SIZE 32
+
+// Matches vkb::Meshlet
+struct Meshlet
+{
+	vec4 bounding_sphere;
+	vec4 normal_cone;
+	uint vertex_offset;
+	uint triangle_offset;
+	uint vertex_count;
+	uint triangle_count;
+};
+
+struct MeshletPayload
+{
+	uint meshlet_indices[MESHLET_TASK_GROUP_SIZE];
+};
+
+layout(set = 0, binding = 1) uniform GlobalUniform
+{
+	mat4 model;
+	mat4 view_proj;
+	vec3 camera_position;
+}
+global_uniform;
+
+// Meshlet resources start at binding 16, after the bindings of the fragment shaders sharing set 0
+layout(set = 0, binding = 16) uniform MeshletUniform
+{
+	vec4 frustum_planes[6];
+	// Camera position in xyz, w is 1.0 if meshlets facing away from the camera can be culled
+	vec4 camera_position;
+	uint meshlet_count;
+	// Strides of the vertex attributes, in floats
+	uint position_stride;
+	uint normal_stride;
+	uint texcoord_stride;
+}
+meshlet_uniform;
+
+layout(std430, set = 0, binding = 17) readonly buffer Meshlets
+{
+	Meshlet meshlets[];
+};
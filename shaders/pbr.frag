@@ -29,6 +29,10 @@
 
 precision highp float;
 
+#ifdef BINDLESS
+#include "bindless_material.h"
+#endif
+
 #ifdef HAS_BASE_COLOR_TEXTURE
 layout(set = 0, binding = 0) uniform sampler2D base_color_texture;
 #endif
@@ -63,13 +67,39 @@ struct Light
 	vec2 info;             // (only used for spot lights) info.x represents light inner cone angle, info.y represents light outer cone angle
 };
 
+#ifdef CLUSTERED_LIGHTING
+#include "clustered_lighting.h"
+
+// Directional lights first, followed by the point and spot lights binned into clusters
+layout(std430, set = 0, binding = 7) readonly buffer ClusterLights
+{
+	Light lights[];
+}
+cluster_lights;
+
+layout(std430, set = 0, binding = 8) readonly buffer ClusterLightGrid
+{
+	uint  light_index_count;
+	uint  padding;
+	uvec2 clusters[];
+}
+cluster_grid;
+
+layout(std430, set = 0, binding = 9) readonly buffer ClusterLightIndices
+{
+	uint indices[];
+}
+cluster_light_indices;
+#else
 layout(set = 0, binding = 4) uniform LightsInfo
 {
 	uint  count;
 	Light lights[MAX_FORWARD_LIGHT_COUNT];
 }
 lights;
+#endif
 
+#ifndef BINDLESS
 layout(push_constant, std430) uniform PBRMaterialUniform
 {
 	vec4  base_color_factor;
@@ -77,6 +107,7 @@ layout(push_constant, std430) uniform PBRMaterialUniform
 	float roughness_factor;
 }
 pbr_material_uniform;
+#endif
 
 const float PI = 3.14159265359;
 
@@ -142,7 +173,15 @@ vec3 normal()
 	vec3 B      = normalize(cross(N, T));
 	mat3 TBN    = mat3(T, B, N);
 
-#ifdef HAS_NORMAL_TEXTURE
+#if defined(BINDLESS)
+	int normal_texture = get_material().normal_texture;
+	if (normal_texture >= 0)
+	{
+		vec3 n = texture(bindless_textures[normal_texture], in_uv).rgb;
+		return normalize(TBN * (2.0 * n - 1.0));
+	}
+	return normalize(TBN[2].xyz);
+#elif defined(HAS_NORMAL_TEXTURE)
 	vec3 n = texture(normal_texture, in_uv).rgb;
 	return normalize(TBN * (2.0 * n - 1.0));
 #else
@@ -165,20 +204,20 @@ vec3 saturate(vec3 t)
 	return clamp(t, 0.0, 1.0);
 }
 
-vec3 apply_directional_light(uint index, vec3 normal)
+vec3 apply_directional_light(Light light, vec3 normal)
 {
-	vec3 world_to_light = -lights.lights[index].direction.xyz;
+	vec3 world_to_light = -light.direction.xyz;
 
 	world_to_light = normalize(world_to_light);
 
 	float ndotl = clamp(dot(normal, world_to_light), 0.0, 1.0);
 
-	return ndotl * lights.lights[index].color.w * lights.lights[index].color.rgb;
+	return ndotl * light.color.w * light.color.rgb;
 }
 
-vec3 apply_point_light(uint index, vec3 normal)
+vec3 apply_point_light(Light light, vec3 normal)
 {
-	vec3 world_to_light = lights.lights[index].position.xyz - in_pos.xyz;
+	vec3 world_to_light = light.position.xyz - in_pos.xyz;
 
 	float dist = length(world_to_light);
 
@@ -188,19 +227,47 @@ vec3 apply_point_light(uint index, vec3 normal)
 
 	float ndotl = clamp(dot(normal, world_to_light), 0.0, 1.0);
 
-	return ndotl * lights.lights[index].color.w * atten * lights.lights[index].color.rgb;
+	return ndotl * light.color.w * atten * light.color.rgb;
+}
+
+vec3 get_light_direction(Light light)
+{
+	if (light.position.w == DIRECTIONAL_LIGHT)
+	{
+		return -light.direction.xyz;
+	}
+	if (light.position.w == POINT_LIGHT)
+	{
+		return light.position.xyz - in_pos.xyz;
+	}
+	return vec3(0.0);
 }
 
-vec3 get_light_direction(uint index)
+vec3 apply_light(Light light, vec3 N, vec3 V, float NdotV, vec3 diffuse_color, float F90, float roughness)
 {
-	if (lights.lights[index].position.w == DIRECTIONAL_LIGHT)
+	vec3 L = get_light_direction(light);
+	vec3 H = normalize(V + L);
+
+	float LdotH = saturate(dot(L, H));
+	float NdotH = saturate(dot(N, H));
+	float NdotL = saturate(dot(N, L));
+
+	vec3  F   = F_Schlick(F0, F90, LdotH);
+	float Vis = V_SmithGGXCorrelated(NdotV, NdotL, roughness);
+	float D   = D_GGX(NdotH, roughness);
+	vec3  Fr  = F * D * Vis;
+
+	float Fd = Fr_DisneyDiffuse(NdotV, NdotL, LdotH, roughness);
+
+	if (light.position.w == DIRECTIONAL_LIGHT)
 	{
-		return -lights.lights[index].direction.xyz;
+		return apply_directional_light(light, N) * (diffuse_color * (vec3(1.0) - F) * Fd + Fr);
 	}
-	if (lights.lights[index].position.w == POINT_LIGHT)
+	if (light.position.w == POINT_LIGHT)
 	{
-		return lights.lights[index].position.xyz - in_pos.xyz;
+		return apply_point_light(light, N) * (diffuse_color * (vec3(1.0) - F) * Fd + Fr);
 	}
+	return vec3(0.0);
 }
 
 void main(void)
@@ -210,6 +277,19 @@ void main(void)
 	float F90        = saturate(50.0 * F0.r);
 	vec4  base_color = vec4(1.0, 0.0, 0.0, 1.0);
 
+#if defined(BINDLESS)
+	Material material = get_material();
+	base_color        = material.base_color_texture >= 0 ? texture(bindless_textures[material.base_color_texture], in_uv) : material.base_color_factor;
+
+	float roughness = material.roughness_factor;
+	float metallic  = material.metallic_factor;
+	if (material.metallic_roughness_texture >= 0)
+	{
+		vec4 metallic_roughness = texture(bindless_textures[material.metallic_roughness_texture], in_uv);
+		roughness               = saturate(metallic_roughness.g);
+		metallic                = saturate(metallic_roughness.b);
+	}
+#else
 #ifdef HAS_BASE_COLOR_TEXTURE
 	base_color = texture(base_color_texture, in_uv);
 #else
@@ -222,6 +302,7 @@ void main(void)
 #else
 	float roughness = pbr_material_uniform.roughness_factor;
 	float metallic  = pbr_material_uniform.metallic_factor;
+#endif
 #endif
 
 	vec3  N     = normal();
@@ -231,31 +312,26 @@ void main(void)
 	vec3 LightContribution = vec3(0.0);
 	vec3 diffuse_color     = base_color.rgb * (1.0 - metallic);
 
+#ifdef CLUSTERED_LIGHTING
+	for (uint i = 0U; i < cluster_uniform.directional_light_count; ++i)
+	{
+		LightContribution += apply_light(cluster_lights.lights[i], N, V, NdotV, diffuse_color, F90, roughness);
+	}
+
+	// Only the lights binned into the cluster of the fragment are shaded
+	float view_depth = -(cluster_uniform.view * vec4(in_pos, 1.0)).z;
+	uvec2 cluster    = cluster_grid.clusters[get_cluster_index(get_cluster(gl_FragCoord.xy, view_depth))];
+
+	for (uint i = 0U; i < cluster.y; ++i)
+	{
+		LightContribution += apply_light(cluster_lights.lights[cluster_light_indices.indices[cluster.x + i]], N, V, NdotV, diffuse_color, F90, roughness);
+	}
+#else
 	for (uint i = 0U; i < lights.count; ++i)
 	{
-		vec3 L = get_light_direction(i);
-		vec3 H = normalize(V + L);
-
-		float LdotH = saturate(dot(L, H));
-		float NdotH = saturate(dot(N, H));
-		float NdotL = saturate(dot(N, L));
-
-		vec3  F   = F_Schlick(F0, F90, LdotH);
-		float Vis = V_SmithGGXCorrelated(NdotV, NdotL, roughness);
-		float D   = D_GGX(NdotH, roughness);
-		vec3  Fr  = F * D * Vis;
-
-		float Fd = Fr_DisneyDiffuse(NdotV, NdotL, LdotH, roughness);
-
-		if (lights.lights[i].position.w == DIRECTIONAL_LIGHT)
-		{
-			LightContribution += apply_directional_light(i, N) * (diffuse_color * (vec3(1.0) - F) * Fd + Fr);
-		}
-		if (lights.lights[i].position.w == POINT_LIGHT)
-		{
-			LightContribution += apply_point_light(i, N) * (diffuse_color * (vec3(1.0) - F) * Fd + Fr);
-		}
+		LightContribution += apply_light(lights.lights[i], N, V, NdotV, diffuse_color, F90, roughness);
 	}
+#endif
 
 	// [1] Tempory irradiance to fix dark metals
 	// TODO: add specular irradiance for realistic metals
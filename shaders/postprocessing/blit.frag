@@ -0,0 +1,29 @@
+#version 450
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+precision highp float;
+
+// Source of the same size as the render target, each fragment copies its texel
+layout(set = 0, binding = 0) uniform sampler2D source;
+
+layout(location = 0) out vec4 o_color;
+
+void main()
+{
+	o_color = texelFetch(source, ivec2(gl_FragCoord.xy), 0);
+}
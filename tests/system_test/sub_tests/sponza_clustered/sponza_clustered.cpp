@@ -0,0 +1,48 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sponza_clustered.h"
+
+SponzaClusteredTest::SponzaClusteredTest() :
+    vkbtest::GLTFLoaderTest("scenes/sponza/Sponza01.gltf")
+{
+}
+
+std::unique_ptr<vkb::Subpass> SponzaClusteredTest::create_scene_subpass(vkb::sg::Camera &camera)
+{
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+
+	auto subpass = std::make_unique<vkb::ClusteredForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, camera);
+
+	clustered_subpass = subpass.get();
+
+	return subpass;
+}
+
+void SponzaClusteredTest::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+{
+	// The lights are binned on the GPU outside of the render pass
+	clustered_subpass->cull_lights(command_buffer);
+
+	vkbtest::GLTFLoaderTest::draw_renderpass(command_buffer, render_target);
+}
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_clustered_test()
+{
+	return std::make_unique<SponzaClusteredTest>();
+}
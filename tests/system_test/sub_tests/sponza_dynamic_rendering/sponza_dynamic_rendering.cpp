@@ -0,0 +1,29 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sponza_dynamic_rendering.h"
+
+SponzaDynamicRenderingTest::SponzaDynamicRenderingTest() :
+    vkbtest::GLTFLoaderTest("scenes/sponza/Sponza01.gltf")
+{
+	set_dynamic_rendering_enable(true);
+}
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_dynamic_rendering_test()
+{
+	return std::make_unique<SponzaDynamicRenderingTest>();
+}
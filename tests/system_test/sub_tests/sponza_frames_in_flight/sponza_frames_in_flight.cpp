@@ -0,0 +1,32 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sponza_frames_in_flight.h"
+
+SponzaFramesInFlightTest::SponzaFramesInFlightTest() :
+    vkbtest::GLTFLoaderTest("scenes/sponza/Sponza01.gltf")
+{
+	set_frames_in_flight(3);
+
+	// Each frame is recorded at least twice
+	frames_before_screenshot = 6;
+}
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_frames_in_flight_test()
+{
+	return std::make_unique<SponzaFramesInFlightTest>();
+}
@@ -0,0 +1,34 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "gltf_loader_test.h"
+
+/**
+ * @brief Renders Sponza with more frames in flight than a headless sample has by default,
+ *        cycling through all of them before taking the screenshot
+ */
+class SponzaFramesInFlightTest : public vkbtest::GLTFLoaderTest
+{
+  public:
+	SponzaFramesInFlightTest();
+
+	virtual ~SponzaFramesInFlightTest() = default;
+};
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_frames_in_flight_test();
@@ -0,0 +1,61 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sponza_gpu_driven.h"
+
+SponzaGpuDrivenTest::SponzaGpuDrivenTest() :
+    vkbtest::GLTFLoaderTest("scenes/sponza/Sponza01.gltf")
+{
+	// The draws of each batch are compacted when the count is written by the GPU
+	add_device_extension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME, true);
+}
+
+void SponzaGpuDrivenTest::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	auto &features = gpu.get_features();
+
+	auto &requested_features = gpu.get_mutable_requested_features();
+
+	requested_features.multiDrawIndirect                      = features.multiDrawIndirect;
+	requested_features.drawIndirectFirstInstance              = features.drawIndirectFirstInstance;
+	requested_features.shaderSampledImageArrayDynamicIndexing = features.shaderSampledImageArrayDynamicIndexing;
+}
+
+std::unique_ptr<vkb::Subpass> SponzaGpuDrivenTest::create_scene_subpass(vkb::sg::Camera &camera)
+{
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+
+	auto subpass = std::make_unique<vkb::GpuDrivenSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, camera);
+
+	gpu_driven_subpass = subpass.get();
+
+	return subpass;
+}
+
+void SponzaGpuDrivenTest::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+{
+	// The instances are culled outside of the render pass
+	gpu_driven_subpass->cull(command_buffer);
+
+	vkbtest::GLTFLoaderTest::draw_renderpass(command_buffer, render_target);
+}
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_gpu_driven_test()
+{
+	return std::make_unique<SponzaGpuDrivenTest>();
+}
@@ -0,0 +1,113 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sponza_hiz.h"
+
+#include "gui.h"
+
+SponzaHiZTest::SponzaHiZTest() :
+    vkbtest::GLTFLoaderTest("scenes/sponza/Sponza01.gltf")
+{
+	// The draws of each batch are compacted when the count is written by the GPU
+	add_device_extension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME, true);
+}
+
+void SponzaHiZTest::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	auto &features = gpu.get_features();
+
+	auto &requested_features = gpu.get_mutable_requested_features();
+
+	requested_features.multiDrawIndirect                      = features.multiDrawIndirect;
+	requested_features.drawIndirectFirstInstance              = features.drawIndirectFirstInstance;
+	requested_features.shaderSampledImageArrayDynamicIndexing = features.shaderSampledImageArrayDynamicIndexing;
+}
+
+void SponzaHiZTest::prepare_render_context()
+{
+	get_render_context().prepare(1, [this](vkb::core::Image &&swapchain_image) { return create_render_target(std::move(swapchain_image)); });
+}
+
+std::unique_ptr<vkb::RenderTarget> SponzaHiZTest::create_render_target(vkb::core::Image &&swapchain_image)
+{
+	auto &device = swapchain_image.get_device();
+
+	vkb::core::Image depth_image{device,
+	                             swapchain_image.get_extent(),
+	                             vkb::get_suitable_depth_format(device.get_gpu().get_handle(), true),
+	                             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+	                             VMA_MEMORY_USAGE_GPU_ONLY};
+
+	std::vector<vkb::core::Image> images;
+	images.push_back(std::move(swapchain_image));
+	images.push_back(std::move(depth_image));
+
+	return std::make_unique<vkb::RenderTarget>(std::move(images));
+}
+
+std::unique_ptr<vkb::Subpass> SponzaHiZTest::create_scene_subpass(vkb::sg::Camera &camera)
+{
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+
+	auto subpass = std::make_unique<vkb::GpuDrivenSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, camera);
+	subpass->set_occlusion_culling(true);
+
+	gpu_driven_subpass = subpass.get();
+
+	return subpass;
+}
+
+void SponzaHiZTest::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+{
+	auto &render_pipeline = get_render_pipeline();
+
+	// The instances visible in the previous frame are culled before the first render pass
+	gpu_driven_subpass->cull(command_buffer);
+
+	// The first render pass stores its depth for the depth pyramid, and its color for the second render pass
+	render_pipeline.set_load_store({{VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE},
+	                                {VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE}});
+
+	set_viewport_and_scissor(command_buffer, render_target.get_extent());
+
+	render(command_buffer);
+
+	command_buffer.end_render_pass();
+
+	gpu_driven_subpass->cull_occluded(command_buffer, render_target.get_views()[1]);
+
+	// The second render pass draws the disoccluded instances on top of the first one
+	render_pipeline.set_load_store({{VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE},
+	                                {VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_DONT_CARE}});
+
+	set_viewport_and_scissor(command_buffer, render_target.get_extent());
+
+	render(command_buffer);
+
+	if (gui)
+	{
+		gui->draw(command_buffer);
+	}
+
+	command_buffer.end_render_pass();
+}
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_hiz_test()
+{
+	return std::make_unique<SponzaHiZTest>();
+}
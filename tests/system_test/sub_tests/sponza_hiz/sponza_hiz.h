@@ -0,0 +1,53 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "gltf_loader_test.h"
+#include "rendering/subpasses/gpu_driven_subpass.h"
+
+/**
+ * @brief Renders Sponza with GPU-driven draws and two-phase occlusion culling: the instances visible in the
+ *        previous frame are drawn in a first render pass, the others are tested against the depth pyramid
+ *        of its depth and the disoccluded ones drawn in a second render pass
+ */
+class SponzaHiZTest : public vkbtest::GLTFLoaderTest
+{
+  public:
+	SponzaHiZTest();
+
+	virtual ~SponzaHiZTest() = default;
+
+  protected:
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
+
+	virtual void prepare_render_context() override;
+
+	virtual std::unique_ptr<vkb::Subpass> create_scene_subpass(vkb::sg::Camera &camera) override;
+
+	virtual void draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target) override;
+
+  private:
+	/**
+	 * @brief Creates a render target whose depth can be sampled to build the depth pyramid
+	 */
+	std::unique_ptr<vkb::RenderTarget> create_render_target(vkb::core::Image &&swapchain_image);
+
+	vkb::GpuDrivenSubpass *gpu_driven_subpass{nullptr};
+};
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_hiz_test();
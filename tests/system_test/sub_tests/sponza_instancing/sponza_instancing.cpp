@@ -0,0 +1,41 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sponza_instancing.h"
+
+#include "rendering/subpasses/forward_subpass.h"
+
+SponzaInstancingTest::SponzaInstancingTest() :
+    vkbtest::GLTFLoaderTest("scenes/sponza/Sponza01.gltf")
+{
+}
+
+std::unique_ptr<vkb::Subpass> SponzaInstancingTest::create_scene_subpass(vkb::sg::Camera &camera)
+{
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+
+	auto subpass = std::make_unique<vkb::ForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, camera);
+	subpass->set_instancing(true);
+
+	return subpass;
+}
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_instancing_test()
+{
+	return std::make_unique<SponzaInstancingTest>();
+}
@@ -0,0 +1,91 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sponza_meshlets.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "glsl_compiler.h"
+#include "rendering/subpasses/meshlet_subpass.h"
+
+SponzaMeshletsTest::SponzaMeshletsTest() :
+    vkbtest::GLTFLoaderTest("scenes/sponza/Sponza01.gltf")
+{
+	set_api_version(VK_API_VERSION_1_1);
+
+	add_device_extension(VK_KHR_SPIRV_1_4_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME, true);
+	add_device_extension(VK_EXT_MESH_SHADER_EXTENSION_NAME, true);
+}
+
+void SponzaMeshletsTest::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	uint32_t extension_count{0};
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(gpu.get_handle(), nullptr, &extension_count, nullptr));
+
+	std::vector<VkExtensionProperties> extensions(extension_count);
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(gpu.get_handle(), nullptr, &extension_count, extensions.data()));
+
+	auto has_extension = [&extensions](const char *name) {
+		return std::find_if(extensions.begin(), extensions.end(), [name](const VkExtensionProperties &extension) {
+			       return strcmp(extension.extensionName, name) == 0;
+		       }) != extensions.end();
+	};
+
+	if (!has_extension(VK_EXT_MESH_SHADER_EXTENSION_NAME) || !has_extension(VK_KHR_SPIRV_1_4_EXTENSION_NAME) || !has_extension(VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME))
+	{
+		LOGW("Mesh shaders are not supported, drawing the scene with a forward subpass");
+		return;
+	}
+
+	auto &mesh_shader_features = gpu.request_extension_features<VkPhysicalDeviceMeshShaderFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT);
+
+	mesh_shading = mesh_shader_features.taskShader && mesh_shader_features.meshShader;
+
+	// Only the task and mesh shader stages are enabled, the queried features are all requested otherwise
+	mesh_shader_features.multiviewMeshShader                    = VK_FALSE;
+	mesh_shader_features.primitiveFragmentShadingRateMeshShader = VK_FALSE;
+	mesh_shader_features.meshShaderQueries                      = VK_FALSE;
+
+	if (mesh_shading)
+	{
+		// The scene is loaded after the device is created
+		loader_options.generate_meshlets = true;
+
+		vkb::GLSLCompiler::set_target_environment(glslang::EShTargetSpv, glslang::EShTargetSpv_1_4);
+	}
+}
+
+std::unique_ptr<vkb::Subpass> SponzaMeshletsTest::create_scene_subpass(vkb::sg::Camera &camera)
+{
+	if (!mesh_shading)
+	{
+		return vkbtest::GLTFLoaderTest::create_scene_subpass(camera);
+	}
+
+	vkb::ShaderSource task_shader("meshlet.task");
+	vkb::ShaderSource mesh_shader("meshlet.mesh");
+	vkb::ShaderSource frag_shader("base.frag");
+
+	return std::make_unique<vkb::MeshletSubpass>(get_render_context(), std::move(task_shader), std::move(mesh_shader), std::move(frag_shader), *scene, camera);
+}
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_meshlets_test()
+{
+	return std::make_unique<SponzaMeshletsTest>();
+}
@@ -0,0 +1,43 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "gltf_loader_test.h"
+
+/**
+ * @brief Renders Sponza with task and mesh shaders culling its meshlets, or with a forward subpass
+ *        on devices without VK_EXT_mesh_shader
+ */
+class SponzaMeshletsTest : public vkbtest::GLTFLoaderTest
+{
+  public:
+	SponzaMeshletsTest();
+
+	virtual ~SponzaMeshletsTest() = default;
+
+  protected:
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
+
+	virtual std::unique_ptr<vkb::Subpass> create_scene_subpass(vkb::sg::Camera &camera) override;
+
+  private:
+	/// Whether the device supports task and mesh shaders
+	bool mesh_shading{false};
+};
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_meshlets_test();
@@ -0,0 +1,220 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sponza_postprocessing.h"
+
+#include "gui.h"
+#include "rendering/postprocessing_computepass.h"
+#include "rendering/postprocessing_renderpass.h"
+
+namespace
+{
+/// Workgroup size of postprocessing/copy.comp in each dimension
+constexpr uint32_t copy_group_size = 8;
+
+/// Passes copying the scene from one intermediate output to the next, the third one reuses the target of the first
+constexpr uint32_t intermediate_pass_count = 3;
+}        // namespace
+
+SponzaPostProcessingTest::SponzaPostProcessingTest() :
+    vkbtest::GLTFLoaderTest("scenes/sponza/Sponza01.gltf")
+{
+}
+
+bool SponzaPostProcessingTest::prepare(const vkb::ApplicationOptions &options)
+{
+	if (!vkbtest::GLTFLoaderTest::prepare(options))
+	{
+		return false;
+	}
+
+	postprocessing_pipeline = std::make_unique<vkb::PostProcessingPipeline>(get_render_context(), vkb::ShaderSource{"postprocessing/postprocessing.vert"});
+
+	postprocessing_pipeline->add_pass<vkb::PostProcessingComputePass>(vkb::ShaderSource{"postprocessing/copy.comp"})
+	    .set_async(true);
+
+	vkb::PostProcessingRenderPass *previous_pass = nullptr;
+
+	for (uint32_t i = 0; i < intermediate_pass_count; ++i)
+	{
+		auto &intermediate_pass = postprocessing_pipeline->add_pass();
+		intermediate_pass.set_intermediate_output(VK_FORMAT_R16G16B16A16_SFLOAT);
+
+		auto &subpass = intermediate_pass.add_subpass(vkb::ShaderSource{"postprocessing/blit.frag"});
+
+		// The first pass reads the copy of the compute pass, bound for each frame
+		if (previous_pass)
+		{
+			subpass.bind_intermediate_output("source", *previous_pass);
+		}
+
+		previous_pass = &intermediate_pass;
+	}
+
+	postprocessing_pipeline->add_pass()
+	    .add_subpass(vkb::ShaderSource{"postprocessing/blit.frag"})
+	    .bind_intermediate_output("source", *previous_pass);
+
+	return true;
+}
+
+void SponzaPostProcessingTest::update(float delta_time)
+{
+	update_scene(delta_time);
+
+	update_gui(delta_time);
+
+	auto &render_context = get_render_context();
+
+	auto &command_buffer = render_context.begin();
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+	auto &render_target = render_context.get_active_frame().get_render_target();
+
+	draw_scene(command_buffer, render_target);
+
+	{
+		// The last pass draws to the swapchain image
+		vkb::ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+		command_buffer.image_memory_barrier(render_target.get_views()[0], memory_barrier);
+		render_target.set_layout(0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+	}
+
+	// The compute pass is submitted on its own, recording continues in another command buffer after it
+	auto &frame_command_buffer = postprocessing_pipeline->draw(command_buffer, render_target);
+
+	if (gui)
+	{
+		gui->draw(frame_command_buffer);
+	}
+
+	frame_command_buffer.end_render_pass();
+
+	{
+		vkb::ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		memory_barrier.src_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+		frame_command_buffer.image_memory_barrier(render_target.get_views()[0], memory_barrier);
+	}
+
+	frame_command_buffer.end();
+
+	render_context.submit(frame_command_buffer);
+
+	screenshot(render_context, get_name());
+
+	close();
+}
+
+void SponzaPostProcessingTest::draw_scene(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+{
+	auto &device = get_render_context().get_device();
+
+	const VkExtent2D &extent = render_target.get_extent();
+
+	uint32_t frame_index = get_render_context().get_active_frame_index();
+
+	if (frame_index >= scene_targets.size())
+	{
+		scene_targets.resize(frame_index + 1);
+		copy_targets.resize(frame_index + 1);
+	}
+
+	if (!scene_targets[frame_index] || scene_targets[frame_index]->get_extent().width != extent.width || scene_targets[frame_index]->get_extent().height != extent.height)
+	{
+		VkExtent3D image_extent{extent.width, extent.height, 1};
+
+		std::vector<vkb::core::Image> scene_images;
+		scene_images.emplace_back(device, image_extent, render_target.get_views()[0].get_format(),
+		                          VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+		scene_images.emplace_back(device, image_extent, vkb::get_suitable_depth_format(device.get_gpu().get_handle()),
+		                          VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+
+		scene_targets[frame_index] = std::make_unique<vkb::RenderTarget>(std::move(scene_images));
+
+		// The copy is kept in half floats, which hold the 8-bit colors of the scene exactly
+		std::vector<vkb::core::Image> copy_images;
+		copy_images.emplace_back(device, image_extent, VK_FORMAT_R16G16B16A16_SFLOAT,
+		                         VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+
+		copy_targets[frame_index] = std::make_unique<vkb::RenderTarget>(std::move(copy_images));
+	}
+
+	auto &scene_target = *scene_targets[frame_index];
+	auto &copy_target  = *copy_targets[frame_index];
+
+	auto &views = scene_target.get_views();
+
+	{
+		vkb::ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+		command_buffer.image_memory_barrier(views[0], memory_barrier);
+	}
+
+	{
+		vkb::ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+		command_buffer.image_memory_barrier(views[1], memory_barrier);
+	}
+
+	set_viewport_and_scissor(command_buffer, extent);
+
+	get_render_pipeline().draw(command_buffer, scene_target);
+
+	command_buffer.end_render_pass();
+
+	scene_target.set_layout(0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+	scene_target.set_layout(1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+
+	// The copy is overwritten entirely, its previous contents are discarded
+	copy_target.set_layout(0, VK_IMAGE_LAYOUT_UNDEFINED);
+
+	postprocessing_pipeline->get_pass<vkb::PostProcessingComputePass>(0)
+	    .bind_sampled_image("source", {0, &scene_target})
+	    .bind_storage_image("destination", {0, &copy_target})
+	    .set_dispatch_size({(extent.width + copy_group_size - 1) / copy_group_size, (extent.height + copy_group_size - 1) / copy_group_size, 1});
+
+	postprocessing_pipeline->get_pass(1).get_subpass(0).bind_sampled_image("source", {0, &copy_target});
+}
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_postprocessing_test()
+{
+	return std::make_unique<SponzaPostProcessingTest>();
+}
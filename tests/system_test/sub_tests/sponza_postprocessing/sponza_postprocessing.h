@@ -0,0 +1,54 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "gltf_loader_test.h"
+#include "rendering/postprocessing_pipeline.h"
+
+/**
+ * @brief Renders Sponza to an offscreen target and presents it through a post-processing pipeline: an
+ *        asynchronous compute pass copies the scene color, a chain of render passes copies it from one
+ *        intermediate output to the next, and the last render pass copies it to the swapchain
+ */
+class SponzaPostProcessingTest : public vkbtest::GLTFLoaderTest
+{
+  public:
+	SponzaPostProcessingTest();
+
+	virtual ~SponzaPostProcessingTest() = default;
+
+	virtual bool prepare(const vkb::ApplicationOptions &options) override;
+
+	virtual void update(float delta_time) override;
+
+  private:
+	/**
+	 * @brief Draws the scene to the offscreen target of the active frame, and binds it to the post-processing passes
+	 */
+	void draw_scene(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target);
+
+	std::unique_ptr<vkb::PostProcessingPipeline> postprocessing_pipeline;
+
+	/// Color and depth the scene is drawn to, for each render frame
+	std::vector<std::unique_ptr<vkb::RenderTarget>> scene_targets;
+
+	/// Storage image the compute pass copies the scene color to, for each render frame
+	std::vector<std::unique_ptr<vkb::RenderTarget>> copy_targets;
+};
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_postprocessing_test();
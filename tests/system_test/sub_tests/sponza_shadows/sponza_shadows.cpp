@@ -0,0 +1,80 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sponza_shadows.h"
+
+#include "rendering/subpasses/forward_subpass.h"
+#include "scene_graph/components/light.h"
+
+SponzaShadowsTest::SponzaShadowsTest() :
+    vkbtest::GLTFLoaderTest("scenes/sponza/Sponza01.gltf")
+{
+}
+
+std::unique_ptr<vkb::Subpass> SponzaShadowsTest::create_scene_subpass(vkb::sg::Camera &camera)
+{
+	// The directional light added by the loader test casts the shadows
+	auto &light = *scene->get_components<vkb::sg::Light>()[0];
+
+	vkb::ShaderSource shadowmap_vs("shadows/shadowmap.vert");
+	vkb::ShaderSource shadowmap_fs("shadows/shadowmap.frag");
+
+	auto subpass = std::make_unique<vkb::ShadowSubpass>(get_render_context(), std::move(shadowmap_vs), std::move(shadowmap_fs), *scene, camera, light);
+
+	shadow_subpass = subpass.get();
+
+	// The atlas is the only attachment, cleared to the far plane of reversed depth and stored to be sampled
+	vkb::LoadStoreInfo load_store{};
+	load_store.load_op  = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	load_store.store_op = VK_ATTACHMENT_STORE_OP_STORE;
+
+	VkClearValue clear_value{};
+	clear_value.depthStencil = {0.0f, ~0U};
+
+	shadow_render_pipeline = std::make_unique<vkb::RenderPipeline>();
+	shadow_render_pipeline->add_subpass(std::move(subpass));
+	shadow_render_pipeline->set_load_store({load_store});
+	shadow_render_pipeline->set_clear_value({clear_value});
+
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+
+	auto forward_subpass = std::make_unique<vkb::ForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, camera);
+
+	// Selects the SHADOWS variant, so must be set before the subpass is prepared
+	forward_subpass->set_shadow_subpass(shadow_subpass);
+
+	return forward_subpass;
+}
+
+void SponzaShadowsTest::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+{
+	// The cascades are drawn into the atlas outside of the render pass of the scene
+	shadow_subpass->record_atlas_write_barrier(command_buffer);
+
+	shadow_render_pipeline->draw(command_buffer, shadow_subpass->get_render_target());
+	command_buffer.end_render_pass();
+
+	shadow_subpass->record_atlas_read_barrier(command_buffer);
+
+	vkbtest::GLTFLoaderTest::draw_renderpass(command_buffer, render_target);
+}
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_shadows_test()
+{
+	return std::make_unique<SponzaShadowsTest>();
+}
@@ -0,0 +1,74 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sponza_state_changes.h"
+
+namespace
+{
+/// Pipeline state changes recorded before the state of each draw
+constexpr uint32_t state_changes_per_draw = 16;
+}        // namespace
+
+StateChangeSubpass::StateChangeSubpass(vkb::RenderContext &render_context, vkb::ShaderSource &&vertex_shader, vkb::ShaderSource &&fragment_shader, vkb::sg::Scene &scene, vkb::sg::Camera &camera) :
+    vkb::ForwardSubpass{render_context, std::move(vertex_shader), std::move(fragment_shader), scene, camera}
+{
+}
+
+void StateChangeSubpass::prepare_pipeline_state(vkb::CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material)
+{
+	for (uint32_t i = 0; i < state_changes_per_draw; ++i)
+	{
+		vkb::RasterizationState rasterization_state{};
+		rasterization_state.cull_mode         = i % 2 ? VK_CULL_MODE_FRONT_BIT : VK_CULL_MODE_NONE;
+		rasterization_state.depth_bias_enable = VK_TRUE;
+		command_buffer.set_rasterization_state(rasterization_state);
+
+		// Setting the same state twice must not change anything
+		command_buffer.set_rasterization_state(rasterization_state);
+
+		vkb::InputAssemblyState input_assembly_state{};
+		input_assembly_state.topology = i % 2 ? VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP : VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+		command_buffer.set_input_assembly_state(input_assembly_state);
+
+		vkb::MultisampleState multisample_state{};
+		multisample_state.sample_shading_enable = VK_TRUE;
+		command_buffer.set_multisample_state(multisample_state);
+	}
+
+	// The draws use the default input assembly, the other states are set by the forward subpass
+	command_buffer.set_input_assembly_state({});
+
+	vkb::ForwardSubpass::prepare_pipeline_state(command_buffer, front_face, double_sided_material);
+}
+
+SponzaStateChangesTest::SponzaStateChangesTest() :
+    vkbtest::RecordingBenchmark("scenes/sponza/Sponza01.gltf")
+{
+}
+
+std::unique_ptr<vkb::Subpass> SponzaStateChangesTest::create_scene_subpass(vkb::sg::Camera &camera)
+{
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+
+	return std::make_unique<StateChangeSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, camera);
+}
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_state_changes_test()
+{
+	return std::make_unique<SponzaStateChangesTest>();
+}
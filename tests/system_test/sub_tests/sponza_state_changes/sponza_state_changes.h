@@ -0,0 +1,53 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "recording_benchmark.h"
+#include "rendering/subpasses/forward_subpass.h"
+
+/**
+ * @brief Forward subpass setting several pipeline states before the state of each draw, which leaves the
+ *        pipeline state of every draw unchanged but dirty
+ */
+class StateChangeSubpass : public vkb::ForwardSubpass
+{
+  public:
+	StateChangeSubpass(vkb::RenderContext &render_context, vkb::ShaderSource &&vertex_shader, vkb::ShaderSource &&fragment_shader, vkb::sg::Scene &scene, vkb::sg::Camera &camera);
+
+	virtual ~StateChangeSubpass() = default;
+
+  protected:
+	virtual void prepare_pipeline_state(vkb::CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material) override;
+};
+
+/**
+ * @brief Measures the CPU cost of recording Sponza when every draw changes the pipeline state many times,
+ *        which stresses the dirty tracking and hashing of PipelineState
+ */
+class SponzaStateChangesTest : public vkbtest::RecordingBenchmark
+{
+  public:
+	SponzaStateChangesTest();
+
+	virtual ~SponzaStateChangesTest() = default;
+
+  protected:
+	virtual std::unique_ptr<vkb::Subpass> create_scene_subpass(vkb::sg::Camera &camera) override;
+};
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_state_changes_test();
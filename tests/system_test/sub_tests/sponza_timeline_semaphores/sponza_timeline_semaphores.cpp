@@ -0,0 +1,33 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sponza_timeline_semaphores.h"
+
+SponzaTimelineSemaphoresTest::SponzaTimelineSemaphoresTest() :
+    vkbtest::GLTFLoaderTest("scenes/sponza/Sponza01.gltf")
+{
+	set_timeline_semaphores_enable(true);
+	set_frames_in_flight(3);
+
+	// Each frame is recorded at least twice, waiting on the timeline value of its previous submission
+	frames_before_screenshot = 6;
+}
+
+std::unique_ptr<vkb::VulkanSample> create_sponza_timeline_semaphores_test()
+{
+	return std::make_unique<SponzaTimelineSemaphoresTest>();
+}
@@ -39,6 +39,24 @@ image_ext         = ".png"
 android_timeout   = 60 # How long in seconds should we wait before timing out on Android
 check_step        = 5
 threshold         = 0.999 # How similar the images are allowed to be before they pass
+# Tests rendering the same image as another test, they are compared against the gold of that test
+gold_tests        = {
+    "sponza_recording": "sponza",
+    "sponza_state_changes": "sponza",
+    "sponza_hiz": "sponza",
+    "sponza_frames_in_flight": "sponza",
+    "sponza_meshlets": "sponza",
+    "sponza_instancing": "sponza",
+    "sponza_gpu_driven": "sponza",
+    "sponza_clustered": "sponza",
+    "sponza_postprocessing": "sponza",
+    "sponza_descriptor_buffers": "sponza",
+    "sponza_extended_dynamic_state": "sponza",
+    "sponza_timeline_semaphores": "sponza",
+    "sponza_dynamic_rendering": "sponza",
+}
+# Tests without a gold image yet, they pass once they rendered a screenshot, which is kept to become their gold
+new_tests         = ("sponza_shadows",)
 
 class Subtest:
     result = False
@@ -185,7 +203,11 @@ def test(test_name, screenshot_path):
     result = False
     image = test_name + image_ext
     base_image = screenshot_path + image
-    test_image = root_path + "assets/gold/{0}/{1}.png".format(test_name, get_resolution(base_image))
+    gold_name = gold_tests.get(test_name, test_name)
+    test_image = root_path + "assets/gold/{0}/{1}.png".format(gold_name, get_resolution(base_image))
+    if not os.path.isfile(test_image) and test_name in new_tests:
+        print("\t\t\t(Note) No gold image yet, keeping the screenshot ({})".format(base_image))
+        return True
     if not os.path.isfile(test_image):
         print("\t\t\t(Error) Resolution not supported, gold image not found ({})".format(test_image))
         return False
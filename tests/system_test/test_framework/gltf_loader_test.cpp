@@ -46,7 +46,7 @@ bool GLTFLoaderTest::prepare(const vkb::ApplicationOptions &options)
 		return false;
 	}
 
-	load_scene(scene_path);
+	load_scene(scene_path, loader_options);
 
 	scene->clear_components<vkb::sg::Light>();
 
@@ -63,17 +63,20 @@ bool GLTFLoaderTest::prepare(const vkb::ApplicationOptions &options)
 
 	auto &camera = camera_node->get_component<vkb::sg::Camera>();
 
-	vkb::ShaderSource vert_shader("base.vert");
-	vkb::ShaderSource frag_shader("base.frag");
-
-	auto scene_subpass = std::make_unique<vkb::ForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, camera);
-
 	auto render_pipeline = vkb::RenderPipeline();
-	render_pipeline.add_subpass(std::move(scene_subpass));
+	render_pipeline.add_subpass(create_scene_subpass(camera));
 
 	VulkanSample::set_render_pipeline(std::move(render_pipeline));
 
 	return true;
 }
 
+std::unique_ptr<vkb::Subpass> GLTFLoaderTest::create_scene_subpass(vkb::sg::Camera &camera)
+{
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+
+	return std::make_unique<vkb::ForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, camera);
+}
+
 }        // namespace vkbtest
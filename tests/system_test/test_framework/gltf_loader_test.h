@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "gltf_loader.h"
 #include "rendering/render_pipeline.h"
 #include "scene_graph/components/camera.h"
 #include "vulkan_test.h"
@@ -33,6 +34,14 @@ class GLTFLoaderTest : public VulkanTest
 	virtual bool prepare(const vkb::ApplicationOptions &options) override;
 
   protected:
+	/**
+	 * @brief Creates the subpass rendering the scene, a forward subpass with base.vert and base.frag by default
+	 */
+	virtual std::unique_ptr<vkb::Subpass> create_scene_subpass(vkb::sg::Camera &camera);
+
 	std::string scene_path{};
+
+	/// Processing applied to the meshes of the scene while it is loaded
+	vkb::GLTFLoaderOptions loader_options{};
 };
 }        // namespace vkbtest
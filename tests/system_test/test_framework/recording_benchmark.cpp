@@ -0,0 +1,86 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "recording_benchmark.h"
+
+#include <algorithm>
+
+#include "timer.h"
+
+namespace vkbtest
+{
+RecordingBenchmark::RecordingBenchmark(const std::string &scene_path, uint32_t frame_count) :
+    GLTFLoaderTest{scene_path},
+    frame_count{frame_count}
+{
+}
+
+void RecordingBenchmark::update(float delta_time)
+{
+	if (baseline_run.frames + template_run.frames + 1 < 2 * frame_count)
+	{
+		VulkanSample::update(delta_time);
+		return;
+	}
+
+	// The last frame is screenshot and closes the test
+	VulkanTest::update(delta_time);
+
+	log_run("baseline", baseline_run);
+	log_run("update templates", template_run);
+
+	if (baseline_run.get_draws_per_second() > 0.0)
+	{
+		LOGI("{}: {:.2f}x the draws per second of the baseline", get_name(), template_run.get_draws_per_second() / baseline_run.get_draws_per_second());
+	}
+}
+
+void RecordingBenchmark::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+{
+	// The baseline run records the first frames, and keeps collecting BindingMaps when flushing descriptor sets
+	bool  baseline   = baseline_run.frames < frame_count;
+	auto &active_run = baseline ? baseline_run : template_run;
+
+	get_render_context().get_active_frame().set_update_templates_enable(!baseline);
+
+	uint32_t draw_count = command_buffer.get_draw_count();
+
+	vkb::Timer timer;
+	timer.start();
+
+	VulkanSample::draw_renderpass(command_buffer, render_target);
+
+	double recording_time = timer.stop<vkb::Timer::Milliseconds>();
+
+	active_run.draws += command_buffer.get_draw_count() - draw_count;
+	active_run.total_time += recording_time;
+	active_run.min_time = std::min(active_run.min_time, recording_time);
+
+	active_run.frames++;
+}
+
+double RecordingBenchmark::Run::get_draws_per_second() const
+{
+	return total_time > 0.0 ? static_cast<double>(draws) * 1000.0 / total_time : 0.0;
+}
+
+void RecordingBenchmark::log_run(const char *name, const Run &recorded_run)
+{
+	LOGI("{}: {} run recorded {} frames, {:.0f} draws per second, {:.3f} ms per frame on average, {:.3f} ms at best",
+	     get_name(), name, recorded_run.frames, recorded_run.get_draws_per_second(), recorded_run.total_time / recorded_run.frames, recorded_run.min_time);
+}
+}        // namespace vkbtest
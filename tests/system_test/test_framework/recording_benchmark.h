@@ -0,0 +1,74 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <limits>
+
+#include "gltf_loader_test.h"
+
+namespace vkbtest
+{
+/**
+ * @brief Renders a scene for a number of frames and logs the draws recorded per second of CPU time spent
+ *        recording its render pass, before the last frame is compared to the gold image like any other test.
+ *        A baseline run first records the frames with descriptor update templates disabled, so that every
+ *        descriptor set flushed collects its infos into BindingMaps, and both runs are logged for comparison.
+ */
+class RecordingBenchmark : public GLTFLoaderTest
+{
+  public:
+	/**
+	 * @param scene_path Path of the scene to render
+	 * @param frame_count Frames rendered by each run
+	 */
+	RecordingBenchmark(const std::string &scene_path, uint32_t frame_count = 100);
+
+	virtual ~RecordingBenchmark() = default;
+
+	virtual void update(float delta_time) override;
+
+  protected:
+	virtual void draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target) override;
+
+  private:
+	struct Run
+	{
+		uint32_t frames{0};
+
+		uint64_t draws{0};
+
+		/// Recording times in milliseconds
+		double total_time{0.0};
+
+		double min_time{std::numeric_limits<double>::max()};
+
+		double get_draws_per_second() const;
+	};
+
+	void log_run(const char *name, const Run &recorded_run);
+
+	/// Frames rendered by each run
+	uint32_t frame_count;
+
+	/// Frames recorded with descriptor update templates disabled
+	Run baseline_run;
+
+	/// Frames recorded with descriptor update templates
+	Run template_run;
+};
+}        // namespace vkbtest
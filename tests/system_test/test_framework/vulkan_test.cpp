@@ -41,6 +41,11 @@ void VulkanTest::update(float delta_time)
 {
 	VulkanSample::update(delta_time);
 
+	if (frame_count++ < frames_before_screenshot)
+	{
+		return;
+	}
+
 	screenshot(get_render_context(), get_name());
 
 	close();
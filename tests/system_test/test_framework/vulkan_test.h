@@ -33,5 +33,12 @@ class VulkanTest : public vkb::VulkanSample
 	virtual bool prepare(const vkb::ApplicationOptions &options) override;
 
 	virtual void update(float delta_time) override;
+
+  protected:
+	/// Number of frames rendered before the one the screenshot is taken of, so that the test cycles through the frames in flight
+	uint32_t frames_before_screenshot{0};
+
+  private:
+	uint32_t frame_count{0};
 };
 }        // namespace vkbtest